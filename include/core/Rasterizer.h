@@ -13,14 +13,217 @@
 #define RASTERIZER_H
 #include <Eigen/Core>
 #include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
 #include "core/resource.h"
 #include "utils/MVP.h"
 namespace Rasterizer {
 
+/**
+ * @brief 屏幕空间顶点
+ * @details x, y 为像素坐标（左上角为原点，x 向右，y 向下），z 为 NDC 深度，w 为 1 / w_clip。
+ * 深度沿用 MVP::cal_projection_matrix 的约定：近平面 z = 1，远平面 z = -1，即 z 越大越近。
+ */
+using ScreenVertex = Eigen::Vector4f;
+
 class Rasterizer {
 public:
+    Rasterizer(int width, int height);
+
+    void set_viewport(int width, int height);
+    void set_model(const Eigen::Matrix4f& model);
+    void set_view(const Eigen::Matrix4f& view);
+    void set_projection(const Eigen::Matrix4f& projection);
+
+    int get_width() const { return width; }
+    int get_height() const { return height; }
+    const Eigen::Matrix4f& get_model() const { return model; }
+    const Eigen::Matrix4f& get_view() const { return view; }
+    const Eigen::Matrix4f& get_projection() const { return projection; }
+
+    /**
+     * @brief 模型-视图-投影矩阵
+     */
+    Eigen::Matrix4f get_mvp() const;
+
+    /**
+     * @brief 法线变换矩阵（模型矩阵左上角 3x3 的逆转置）
+     */
+    Eigen::Matrix3f get_normal_matrix() const;
+
+    /**
+     * @brief 世界空间中的相机位置
+     */
+    Eigen::Vector3f get_eye_position() const;
+
+    /**
+     * @brief 把顶点变换到屏幕空间
+     * @param mvp 变换矩阵
+     * @param position 顶点位置
+     * @param out 屏幕空间顶点
+     * @return 顶点在相机后方（w_clip <= 0）时返回 false，此时不做裁剪，整个三角形直接丢弃
+     */
+    bool to_screen(const Eigen::Matrix4f& mvp, const Eigen::Vector3f& position, ScreenVertex& out) const;
+
+    /**
+     * @brief 屏幕空间像素中心还原为世界空间坐标
+     * @param inv_view_projection (projection * view) 的逆矩阵
+     * @param x 像素 x
+     * @param y 像素 y
+     * @param depth NDC 深度
+     */
+    Eigen::Vector3f unproject(const Eigen::Matrix4f& inv_view_projection, int x, int y, float depth) const;
+
+    /**
+     * @brief 遍历三角形在矩形 [x_begin, x_end) x [y_begin, y_end) 内覆盖的像素
+     * @param fragment 回调 fragment(x, y, z, bary)，bary 为透视校正后的重心坐标
+     * @details 采样点为像素中心，不区分三角形朝向。矩形参数可以是整个屏幕，也可以是一个 tile，
+     * 这样同一个三角形可以被不同线程按 tile 分别光栅化。
+     */
+    template <typename Fragment>
+    static void rasterize_triangle(const ScreenVertex& s0, const ScreenVertex& s1, const ScreenVertex& s2,
+                                   int x_begin, int y_begin, int x_end, int y_end, Fragment&& fragment);
+
+    /**
+     * @brief 只计算深度的光栅化
+     * @param fragment 回调 fragment(x, y, z)
+     * @details 不做透视校正插值，用于 visibility buffer、阴影贴图等只需要深度和图元 ID 的阶段
+     */
+    template <typename Fragment>
+    static void rasterize_depth(const ScreenVertex& s0, const ScreenVertex& s1, const ScreenVertex& s2,
+                                int x_begin, int y_begin, int x_end, int y_end, Fragment&& fragment);
+
+    /**
+     * @brief 像素中心处的透视校正重心坐标
+     * @return 三角形退化时返回 false
+     */
+    static bool barycentric(const ScreenVertex& s0, const ScreenVertex& s1, const ScreenVertex& s2,
+                            int x, int y, Eigen::Vector3f& bary);
+
+private:
+    /**
+     * @brief 遍历覆盖的像素，回调 visit(x, y, b0, b1, b2)，b 为屏幕空间线性重心坐标
+     */
+    template <typename Visit>
+    static void traverse_triangle(const ScreenVertex& s0, const ScreenVertex& s1, const ScreenVertex& s2,
+                                  int x_begin, int y_begin, int x_end, int y_end, Visit&& visit);
+
+    int width;
+    int height;
+    Eigen::Matrix4f model;
+    Eigen::Matrix4f view;
+    Eigen::Matrix4f projection;
 };
 
+/**
+ * @brief 边函数：有向边 a->b 与点 p 构成的有向面积（两倍）
+ * @details 两个端点按固定顺序参与计算，相邻三角形在共享边上得到的值严格互为相反数，
+ * 不会因为舍入误差同时判定为外部而在共享边上留下空洞
+ */
+inline float edge_function(const ScreenVertex& a, const ScreenVertex& b, float px, float py)
+{
+    if (a.x() < b.x() || (a.x() == b.x() && a.y() < b.y()))
+    {
+        return (b.x() - a.x()) * (py - a.y()) - (b.y() - a.y()) * (px - a.x());
+    }
+    return -((a.x() - b.x()) * (py - b.y()) - (a.y() - b.y()) * (px - b.x()));
+}
+
+/**
+ * @brief 像素中心恰好落在边上时是否属于该三角形（top-left 规则）
+ * @details 共享边在两个三角形中方向相反，只有其中一个会返回 true
+ */
+inline bool edge_owns_tie(const ScreenVertex& a, const ScreenVertex& b)
+{
+    const float dy = b.y() - a.y();
+    return dy > 0.0f || (dy == 0.0f && b.x() < a.x());
+}
+
+template <typename Visit>
+void Rasterizer::traverse_triangle(const ScreenVertex& s0, const ScreenVertex& s1, const ScreenVertex& s2,
+                                   int x_begin, int y_begin, int x_end, int y_end, Visit&& visit)
+{
+    // 有向面积，两种朝向都接受：反向的三角形交换 s1、s2 后统一按正向处理
+    const float area = (s1.x() - s0.x()) * (s2.y() - s0.y()) - (s1.y() - s0.y()) * (s2.x() - s0.x());
+    if (std::abs(area) < 1e-12f)
+    {
+        return;
+    }
+    const bool flipped = area < 0.0f;
+    const ScreenVertex& a = s0;
+    const ScreenVertex& b = flipped ? s2 : s1;
+    const ScreenVertex& c = flipped ? s1 : s2;
+    const float inv_area = 1.0f / std::abs(area);
+
+    // 包围盒与矩形求交
+    const int min_x = std::max(x_begin, static_cast<int>(std::floor(std::min({s0.x(), s1.x(), s2.x()}))));
+    const int max_x = std::min(x_end - 1, static_cast<int>(std::ceil(std::max({s0.x(), s1.x(), s2.x()}))));
+    const int min_y = std::max(y_begin, static_cast<int>(std::floor(std::min({s0.y(), s1.y(), s2.y()}))));
+    const int max_y = std::min(y_end - 1, static_cast<int>(std::ceil(std::max({s0.y(), s1.y(), s2.y()}))));
+    if (min_x > max_x || min_y > max_y)
+    {
+        return;
+    }
+
+    // 边函数 e_i 对应顶点 i 的重心坐标，每个像素直接求值，保证共享边的判定一致
+    const bool tie_a = edge_owns_tie(b, c);
+    const bool tie_b = edge_owns_tie(c, a);
+    const bool tie_c = edge_owns_tie(a, b);
+    for (int y = min_y; y <= max_y; y++)
+    {
+        const float py = static_cast<float>(y) + 0.5f;
+        for (int x = min_x; x <= max_x; x++)
+        {
+            const float px = static_cast<float>(x) + 0.5f;
+            const float ea = edge_function(b, c, px, py);
+            const float eb = edge_function(c, a, px, py);
+            const float ec = edge_function(a, b, px, py);
+            if (ea < 0.0f || eb < 0.0f || ec < 0.0f ||
+                (ea == 0.0f && !tie_a) || (eb == 0.0f && !tie_b) || (ec == 0.0f && !tie_c))
+            {
+                continue;
+            }
+            const float b0 = ea * inv_area;
+            const float bb = eb * inv_area;
+            const float bc = ec * inv_area;
+            if (flipped)
+            {
+                visit(x, y, b0, bc, bb);
+            }
+            else
+            {
+                visit(x, y, b0, bb, bc);
+            }
+        }
+    }
+}
+
+template <typename Fragment>
+void Rasterizer::rasterize_triangle(const ScreenVertex& s0, const ScreenVertex& s1, const ScreenVertex& s2,
+                                    int x_begin, int y_begin, int x_end, int y_end, Fragment&& fragment)
+{
+    traverse_triangle(s0, s1, s2, x_begin, y_begin, x_end, y_end,
+        [&](int x, int y, float b0, float b1, float b2)
+        {
+            // NDC 深度在屏幕空间线性，属性需要按 1/w 做透视校正
+            const float z = b0 * s0.z() + b1 * s1.z() + b2 * s2.z();
+            Eigen::Vector3f bary(b0 * s0.w(), b1 * s1.w(), b2 * s2.w());
+            bary /= bary.sum();
+            fragment(x, y, z, bary);
+        });
+}
+
+template <typename Fragment>
+void Rasterizer::rasterize_depth(const ScreenVertex& s0, const ScreenVertex& s1, const ScreenVertex& s2,
+                                 int x_begin, int y_begin, int x_end, int y_end, Fragment&& fragment)
+{
+    traverse_triangle(s0, s1, s2, x_begin, y_begin, x_end, y_end,
+        [&](int x, int y, float b0, float b1, float b2)
+        {
+            fragment(x, y, b0 * s0.z() + b1 * s1.z() + b2 * s2.z());
+        });
+}
+
 } // Rasterizer
 
 #endif //RASTERIZER_H
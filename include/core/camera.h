@@ -40,6 +40,19 @@ public:
            float yaw = -90.0f,
            float pitch = 0.0f);
 
+    /**
+     * @brief 视图矩阵
+     */
+    Eigen::Matrix4f get_view_matrix() const;
+
+    /**
+     * @brief 以 zoom 为视场角的透视投影矩阵
+     * @param aspect 宽高比
+     * @param near 近平面距离
+     * @param far 远平面距离
+     */
+    Eigen::Matrix4f get_projection_matrix(float aspect, float near, float far) const;
+
 private:
     void update_camera_vectors();
 };
@@ -0,0 +1,96 @@
+/**
+ * @file cluster.h
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 分簇光源剔除（3D froxel）
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef CLUSTER_H
+#define CLUSTER_H
+#include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "core/light.h"
+
+namespace Rasterizer {
+
+/**
+ * @brief 视锥体的三维网格划分
+ * @details 屏幕方向按 tile_size 像素划分，深度方向在 [near, far] 之间按指数划分为 slices 层，
+ * 每层的远近比相同，因此远处的 cluster 不会像均匀划分那样拉得很长。
+ * assign_lights 每帧并行地把光源分配到 cluster，结果是一个扁平的下标数组，
+ * 着色时由像素坐标和视空间深度 O(1) 找到所在 cluster 的光源列表。
+ */
+class ClusterGrid {
+public:
+    /**
+     * @param tile_size cluster 在屏幕上的边长（像素）
+     * @param slices 深度方向的层数
+     */
+    explicit ClusterGrid(int tile_size = 32, int slices = 24);
+
+    /**
+     * @brief 根据视口和投影矩阵计算每个 cluster 的视空间包围盒
+     * @details 近远平面从投影矩阵中反推，投影或视口改变时需要重新调用
+     */
+    void build(int width, int height, const Eigen::Matrix4f& projection);
+
+    /**
+     * @brief 把光源分配到 cluster，每帧调用一次
+     * @param lights 光源列表
+     * @param view 视图矩阵
+     */
+    void assign_lights(const std::vector<Light>& lights, const Eigen::Matrix4f& view);
+
+    /**
+     * @brief 像素所在的 cluster
+     * @param x 像素 x
+     * @param y 像素 y
+     * @param distance 视空间深度（到相机平面的距离，正数）
+     */
+    uint32_t cluster_index(int x, int y, float distance) const
+    {
+        int slice = 0;
+        if (distance > near_distance)
+        {
+            slice = std::min(slices - 1, static_cast<int>(std::log(distance / near_distance) * slice_scale));
+        }
+        return static_cast<uint32_t>((slice * clusters_y + y / tile_size) * clusters_x + x / tile_size);
+    }
+
+    /**
+     * @brief cluster 的光源下标
+     */
+    const uint32_t* lights_begin(uint32_t cluster) const { return light_indices.data() + offsets[cluster]; }
+    const uint32_t* lights_end(uint32_t cluster) const { return light_indices.data() + offsets[cluster + 1]; }
+
+    size_t cluster_count() const { return bounds_min.size(); }
+    float get_near() const { return near_distance; }
+    float get_far() const { return far_distance; }
+
+private:
+    int tile_size;
+    int slices;
+    int clusters_x = 0;
+    int clusters_y = 0;
+    float near_distance = 0.1f;
+    float far_distance = 100.0f;
+    float slice_scale = 1.0f;                       // slices / log(far / near)
+    std::vector<Eigen::Vector3f> bounds_min;        // cluster 视空间包围盒
+    std::vector<Eigen::Vector3f> bounds_max;
+    std::vector<uint32_t> offsets;                  // cluster i 的光源为 light_indices[offsets[i], offsets[i + 1])
+    std::vector<uint32_t> light_indices;
+    std::vector<std::vector<uint32_t>> slice_lights; // 每层的临时结果
+
+    float slice_distance(int slice) const;
+};
+
+} // Rasterizer
+
+#endif //CLUSTER_H
@@ -0,0 +1,126 @@
+/**
+ * @file deferred.h
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 延迟渲染管线
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef DEFERRED_H
+#define DEFERRED_H
+#include <Eigen/Core>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <ModelLoader.h>
+#include "core/Rasterizer.h"
+#include "core/draw_batch.h"
+#include "core/gbuffer.h"
+#include "core/light.h"
+#include "core/texture.h"
+
+namespace Rasterizer {
+
+/**
+ * @brief 延迟渲染
+ * @details 分两个阶段：
+ * 1. geometry_pass 光栅化三角形，只把法线、材质和深度写入 G-buffer，不做光照；
+ * 2. lighting_pass 按 tile 并行读取 G-buffer 计算光照。
+ * 光照开销只和 像素数 x 光源数 有关，与场景三角形数量和重叠无关。
+ * 每个 tile 会先用自身像素的世界空间包围盒剔除影响不到的光源。
+ */
+class DeferredRenderer {
+public:
+    static constexpr int TILE_SIZE = 16;
+    static constexpr size_t MAX_AMBIENT_COLORS = 256;   // 每帧不同 Ka 的个数上限，超出时使用最接近的颜色
+
+    DeferredRenderer(int width, int height);
+
+    /**
+     * @brief 光栅化器，用于设置模型、视图和投影矩阵
+     */
+    Rasterizer& get_rasterizer() { return rasterizer; }
+
+    void set_ambient(const Eigen::Vector3f& ambient) { this->ambient = ambient; }
+    void set_background(const Eigen::Vector3f& background) { this->background = background; }
+
+    /**
+     * @brief 清空 G-buffer，每帧开始时调用一次
+     */
+    void clear();
+
+    /**
+     * @brief 几何阶段，可以多次调用以绘制多个模型（每次使用当前的模型矩阵）
+     * @param triangles ModelLoader 输出的三角形
+     * @param materials 三角形的材质表（ModelLoader::getMaterials）
+     * @param textures 漫反射纹理表，为空时只使用材质颜色
+     */
+    void geometry_pass(const std::vector<Triangle>& triangles, const std::vector<Material>& materials,
+                       const TextureMap* textures = nullptr);
+
+    /**
+     * @brief 按批次执行几何阶段，材质常量和纹理每个批次只设置一次
+     * @param batches 由 DrawBatchList::build 构建的批次
+     */
+    void geometry_pass(const DrawBatchList& batches);
+
+    /**
+     * @brief 光照阶段，结果写入颜色缓冲
+     * @param lights 光源列表，见 LightList::get_lights
+     */
+    void lighting_pass(const std::vector<Light>& lights);
+
+    const GBuffer& get_gbuffer() const { return gbuffer; }
+
+    /**
+     * @brief 颜色缓冲，按行存储，RGB 范围 [0, 1]（未做色调映射）
+     */
+    const std::vector<Eigen::Vector3f>& get_color_buffer() const { return color_buffer; }
+
+private:
+    Rasterizer rasterizer;
+    GBuffer gbuffer;
+    std::vector<Eigen::Vector3f> color_buffer;
+    Eigen::Vector3f ambient;
+    Eigen::Vector3f background;
+    std::vector<Eigen::Vector3f> ambient_colors;          // 本帧用到的 Ka，下标写在 albedo 的 A 通道
+    std::unordered_map<uint32_t, uint32_t> ambient_slots; // 按 RGB8 量化的 Ka 到 ambient_colors 的下标
+    std::vector<std::vector<const Light*>> tile_lights;   // 每个 tile 剔除后的光源，跨帧复用
+
+    /**
+     * @brief 写入 G-buffer 的材质常量
+     */
+    struct MaterialState {
+        Eigen::Vector3f diffuse;
+        uint32_t ambient;           // Ka 在 ambient_colors 中的下标
+        uint32_t specular;          // 打包的 Ks 和 Ns
+        const Texture* texture;
+    };
+
+    /**
+     * @brief 几何阶段使用的变换，每次 geometry_pass 只取一次
+     */
+    struct Transform {
+        Eigen::Matrix4f mvp;
+        Eigen::Matrix4f model;
+        Eigen::Matrix3f normal_matrix;
+    };
+
+    Transform current_transform() const;
+    MaterialState material_state(const Material& material, const Texture* texture);
+    uint32_t ambient_slot(const Eigen::Vector3f& color);
+    bool project(const Triangle& triangle, const Transform& transform, ScreenVertex s[3]) const;
+    void rasterize(const Triangle& triangle, const ScreenVertex s[3], const Transform& transform,
+                   const MaterialState& state);
+
+    void shade_tile(int tile_x, int tile_y, const std::vector<Light>& lights,
+                    const Eigen::Matrix4f& inv_view_projection, const Eigen::Vector3f& eye,
+                    std::vector<const Light*>& tile_lights);
+};
+
+} // Rasterizer
+
+#endif //DEFERRED_H
@@ -0,0 +1,96 @@
+/**
+ * @file draw_batch.h
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 按材质和着色器变体排序的绘制批次
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef DRAW_BATCH_H
+#define DRAW_BATCH_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <ModelLoader.h>
+#include "core/texture.h"
+
+namespace Rasterizer {
+
+/**
+ * @brief 着色器变体标志，按位组合
+ */
+enum ShaderPermutation : uint8_t {
+    SHADER_DEFAULT = 0,
+    SHADER_TEXTURED = 1 << 0,       // 采样漫反射纹理
+    SHADER_VERTEX_NORMALS = 1 << 1  // 插值顶点法线，否则使用面法线
+};
+
+/**
+ * @brief 一个绘制批次：着色器变体和材质都相同的一组三角形
+ */
+struct DrawBatch {
+    uint32_t key;               // 排序键，高 8 位为着色器变体，低 24 位为材质序号
+    uint8_t permutation;        // ShaderPermutation 的组合
+    const Material* material;   // 材质，三角形没有材质时为默认材质
+    const Texture* texture;     // 漫反射纹理，只有 SHADER_TEXTURED 时非空
+    uint32_t first;             // 在 get_order() 中的起始位置
+    uint32_t count;             // 三角形数
+};
+
+/**
+ * @brief 把 ModelLoader 输出的三角形按 (着色器变体, 材质) 分组
+ * @details OBJ 中交错的 usemtl 会让相邻三角形的材质几乎每个都不同，逐三角形绘制时
+ * 材质常量和纹理查找（按文件名哈希）也要逐三角形重复。build 之后每个批次的着色状态
+ * 只设置一次，渲染器按 get_order() 的顺序遍历三角形即可。
+ *
+ * 排序是稳定的计数排序，O(n)：批次内保持三角形在文件中的原始顺序。
+ * 材质按指针区分，序号按第一次出现的顺序分配。
+ * 静态模型只需在加载后 build 一次，三角形数组、材质表和纹理表在使用期间必须保持有效。
+ */
+class DrawBatchList {
+public:
+    /**
+     * @brief 构建批次
+     * @param triangles ModelLoader 输出的三角形
+     * @param materials 三角形的材质表（ModelLoader::getMaterials），按 MaterialId 查找
+     * @param textures 漫反射纹理表，可以为空
+     */
+    void build(const std::vector<Triangle>& triangles, const std::vector<Material>& materials,
+               const TextureMap* textures = nullptr);
+
+    void clear();
+
+    const std::vector<Triangle>* get_triangles() const { return triangles; }
+    const std::vector<Material>* get_materials() const { return materials; }
+    const TextureMap* get_textures() const { return textures; }
+
+    /**
+     * @brief 批次列表，按排序键升序
+     */
+    const std::vector<DrawBatch>& get_batches() const { return batches; }
+
+    /**
+     * @brief 按批次排列的三角形下标，批次 b 对应 [first, first + count)
+     */
+    const std::vector<uint32_t>& get_order() const { return order; }
+
+    /**
+     * @brief 按原始顺序绘制时的着色状态切换次数，用于和 get_batches().size() 对比
+     */
+    size_t get_unsorted_state_changes() const { return unsorted_state_changes; }
+
+private:
+    const std::vector<Triangle>* triangles = nullptr;
+    const std::vector<Material>* materials = nullptr;
+    const TextureMap* textures = nullptr;
+    std::vector<DrawBatch> batches;
+    std::vector<uint32_t> order;
+    size_t unsorted_state_changes = 0;
+};
+
+} // Rasterizer
+
+#endif //DRAW_BATCH_H
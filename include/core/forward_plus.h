@@ -0,0 +1,154 @@
+/**
+ * @file forward_plus.h
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief Forward+ 渲染（按 tile 剔除光源的前向渲染）
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef FORWARD_PLUS_H
+#define FORWARD_PLUS_H
+#include <Eigen/Core>
+#include <cstdint>
+#include <vector>
+#include <ModelLoader.h>
+#include "core/Rasterizer.h"
+#include "core/cluster.h"
+#include "core/draw_batch.h"
+#include "core/light.h"
+#include "core/texture.h"
+
+namespace Rasterizer {
+
+/**
+ * @brief Forward+ 渲染
+ * @details render 分为以下阶段，除分箱外都按 16x16 tile 并行：
+ * 1. 顶点变换并把三角形分到覆盖的 tile；
+ * 2. 深度预渲染，同时统计每个 tile 的最小/最大深度；
+ * 3. 光源剔除：tile 在视空间构成一个小视锥，前后由深度范围截断，
+ *    只保留影响范围（球）与之相交的点光源和聚光灯，平行光总是保留；
+ * 4. 着色：只对通过深度相等测试的片元做 Blinn-Phong，每个片元只遍历所在 tile 的光源。
+ * 着色开销与局部光源密度成正比，而不是光源总数。
+ *
+ * 场景很深时 tile 的深度范围会很大，剔除效果变差，此时可以改用 LightCulling::Clustered，
+ * 按 ClusterGrid 的三维 cluster 分配光源，片元根据自身深度查找所在 cluster 的光源列表。
+ */
+class ForwardPlusRenderer {
+public:
+    static constexpr int TILE_SIZE = 16;
+
+    enum class LightCulling {
+        None,      // 不剔除，每个片元遍历所有光源
+        Tiled,     // 按屏幕 tile 和 tile 深度范围剔除
+        Clustered  // 按三维 cluster 剔除
+    };
+
+    ForwardPlusRenderer(int width, int height);
+
+    /**
+     * @brief 光栅化器，用于设置视图和投影矩阵（模型矩阵由每次 draw 指定）
+     */
+    Rasterizer& get_rasterizer() { return rasterizer; }
+
+    void set_ambient(const Eigen::Vector3f& ambient) { this->ambient = ambient; }
+    void set_background(const Eigen::Vector3f& background) { this->background = background; }
+    void set_light_culling(LightCulling light_culling) { this->light_culling = light_culling; }
+
+    /**
+     * @brief 清空绘制列表，每帧开始时调用一次
+     */
+    void clear();
+
+    /**
+     * @brief 记录一次绘制，三角形数组在 render 之前必须保持有效
+     * @param triangles ModelLoader 输出的三角形
+     * @param materials 三角形的材质表（ModelLoader::getMaterials），同样需要保持有效
+     * @param model 模型矩阵
+     * @param textures 漫反射纹理表，可以为空
+     */
+    void draw(const std::vector<Triangle>& triangles, const std::vector<Material>& materials,
+              const Eigen::Matrix4f& model, const TextureMap* textures = nullptr);
+
+    /**
+     * @brief 按批次记录一次绘制，批次在 render 之前必须保持有效
+     * @param batches 由 DrawBatchList::build 构建的批次
+     * @param model 模型矩阵
+     * @details 三角形按批次顺序分箱，tile 内相邻三角形的材质相同，着色时只在批次变化时设置材质
+     */
+    void draw(const DrawBatchList& batches, const Eigen::Matrix4f& model);
+
+    /**
+     * @brief 渲染所有记录的绘制
+     * @param lights 光源列表，见 LightList::get_lights
+     */
+    void render(const std::vector<Light>& lights);
+
+    const std::vector<Eigen::Vector3f>& get_color_buffer() const { return color_buffer; }
+    const std::vector<float>& get_depth_buffer() const { return depth; }
+
+    /**
+     * @brief 上一帧每个 tile 剔除后剩下的光源下标，按行存储（LightCulling::Tiled）
+     */
+    const std::vector<std::vector<uint32_t>>& get_tile_lights() const { return tile_lights; }
+
+    /**
+     * @brief 上一帧的 cluster 光源分配结果（LightCulling::Clustered）
+     */
+    const ClusterGrid& get_cluster_grid() const { return cluster_grid; }
+
+private:
+    struct Draw {
+        const std::vector<Triangle>* triangles;
+        const std::vector<Material>* materials;
+        const TextureMap* textures;
+        const DrawBatchList* batches;   // 为空时逐三角形查找材质
+        Eigen::Matrix4f model;
+        Eigen::Matrix3f normal_matrix;
+    };
+
+    /**
+     * @brief 变换后的三角形
+     */
+    struct ScreenTriangle {
+        ScreenVertex s[3];
+        uint32_t draw;
+        uint32_t triangle;
+        uint32_t batch;                 // 批次下标，没有批次时为 NO_BATCH
+    };
+
+    static constexpr uint32_t NO_BATCH = 0xFFFFFFFFu;
+
+    Rasterizer rasterizer;
+    std::vector<Draw> draws;
+    std::vector<ScreenTriangle> screen_triangles;
+    std::vector<std::vector<uint32_t>> tile_bins;   // 每个 tile 覆盖的三角形
+    std::vector<std::vector<uint32_t>> tile_lights; // 每个 tile 的光源
+    std::vector<float> tile_depth_min;
+    std::vector<float> tile_depth_max;
+    std::vector<float> depth;
+    std::vector<Eigen::Vector3f> color_buffer;
+    ClusterGrid cluster_grid;
+    Eigen::Matrix4f cluster_projection;             // cluster_grid 对应的投影矩阵
+    int cluster_width;                              // cluster_grid 对应的视口
+    int cluster_height;
+    Eigen::Vector3f ambient;
+    Eigen::Vector3f background;
+    LightCulling light_culling;
+    int tiles_x;
+    int tiles_y;
+
+    void resize_buffers();
+    void bin_triangles();
+    void bin_triangle(const ScreenTriangle& screen, const Triangle& triangle, const Eigen::Matrix4f& mvp);
+    void depth_prepass(int tile);
+    void cull_lights(int tile, const std::vector<Light>& lights, const Eigen::Matrix4f& inv_projection);
+    void shade(int tile, const std::vector<Light>& lights, const Eigen::Vector3f& eye,
+               const Eigen::Vector4f& view_depth_row);
+};
+
+} // Rasterizer
+
+#endif //FORWARD_PLUS_H
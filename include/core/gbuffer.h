@@ -0,0 +1,80 @@
+/**
+ * @file gbuffer.h
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 延迟渲染使用的紧凑 G-buffer
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef GBUFFER_H
+#define GBUFFER_H
+#include <Eigen/Core>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Rasterizer {
+
+/**
+ * @brief 紧凑 G-buffer，每个像素 16 字节
+ * @details 每个属性单独一个数组（SoA），光照阶段按 tile 读取时访问是连续的：
+ * - normal   八面体编码的世界空间法线，两个 snorm16
+ * - albedo   RGB8 为材质漫反射颜色（Kd）乘以漫反射纹理，A 为环境光颜色（Ka）在渲染器本帧 Ka 表中的下标
+ * - specular RGB8 镜面反射颜色（Ks）+ 8 位编码的光泽度（Ns）
+ * - depth    NDC 深度，越大越近，没有几何体的像素为 EMPTY_DEPTH
+ */
+struct GBuffer {
+    static constexpr float EMPTY_DEPTH = -std::numeric_limits<float>::infinity();
+
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> normal;
+    std::vector<uint32_t> albedo;
+    std::vector<uint32_t> specular;
+    std::vector<float> depth;
+
+    void resize(int width, int height);
+    void clear();
+};
+
+/**
+ * @brief 单位向量八面体编码
+ * @param n 单位向量
+ * @return 低 16 位为 x，高 16 位为 y
+ */
+uint32_t encode_octahedral(const Eigen::Vector3f& n);
+
+/**
+ * @brief 八面体编码解码
+ */
+Eigen::Vector3f decode_octahedral(uint32_t packed);
+
+/**
+ * @brief 颜色打包为 RGBA8
+ * @param color RGB，范围 [0, 1]
+ * @param alpha 第四个分量，范围 [0, 255]
+ */
+uint32_t pack_rgba8(const Eigen::Vector3f& color, uint32_t alpha = 255);
+
+/**
+ * @brief RGBA8 解包为 RGB
+ */
+Eigen::Vector3f unpack_rgb8(uint32_t packed);
+
+/**
+ * @brief 光泽度编码为 8 位
+ * @details MTL 的 Ns 范围为 [0, 1000]，按平方根映射，低光泽度的精度更高
+ */
+uint32_t encode_shininess(float shininess);
+
+/**
+ * @brief 8 位光泽度解码
+ */
+float decode_shininess(uint32_t code);
+
+} // Rasterizer
+
+#endif //GBUFFER_H
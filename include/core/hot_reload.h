@@ -0,0 +1,158 @@
+/**
+ * @file hot_reload.h
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 模型文件修改后的增量热重载
+ * @version 0.1
+ * @date 2026/10/19
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef HOT_RELOAD_H
+#define HOT_RELOAD_H
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include <FileWatcher.h>
+#include <ModelLoader.h>
+#include "core/texture.h"
+
+namespace Rasterizer {
+
+/**
+ * @brief 模型在某一时刻的全部数据，发布后不再修改
+ * @details 渲染线程每帧取一次快照，之后整帧都使用它，重载线程同时构建下一份快照互不影响。
+ * 没有变化的部分在前后快照之间共享：只改了 MTL 时几何体不变，只改了某张贴图时其他纹理的像素不变。
+ */
+struct ModelSnapshot {
+    std::shared_ptr<const ModelLoader> geometry;            // 最近一次解析 OBJ 的结果（顶点、索引网格）
+    std::shared_ptr<const std::vector<Material>> materials; // 材质表，MaterialId 与 geometry 一致
+    std::shared_ptr<const std::vector<Triangle>> triangles; // 三角形，MaterialId 在 materials 中查找
+    TextureMap textures;                                    // 所有材质用到的漫反射纹理，键为 Material::diffuseTexture
+    uint64_t version = 0;                                   // 每次发布加一
+};
+
+/**
+ * @brief 用一次加载的结果创建快照，材质表和三角形与 loader 共享生命周期
+ * @details 纹理表为空，版本为 0，由调用方填充
+ */
+std::shared_ptr<ModelSnapshot> make_snapshot(const std::shared_ptr<const ModelLoader>& loader);
+
+/**
+ * @brief 一次重载做了什么
+ */
+struct ReloadResult {
+    bool geometry = false;          // 重新解析了 OBJ
+    bool materials = false;         // 只重新解析了 MTL
+    size_t changed_materials = 0;   // 参数或纹理路径发生变化的材质数
+    size_t decoded_textures = 0;    // 重新解码的纹理数
+    size_t reused_textures = 0;     // 沿用上一份快照的纹理数
+    bool failed = false;            // 加载失败，快照保持不变
+    bool published() const { return geometry || materials || decoded_textures > 0; }
+};
+
+/**
+ * @brief 解码一张纹理，参数是纹理文件的路径；失败时返回空纹理（采样为白色）
+ */
+using TextureDecoder = std::function<Texture(const std::string& path)>;
+
+/**
+ * @brief 监视模型的 OBJ、MTL 和纹理文件，只重新加载变化的部分
+ * @details 文件变化由 FileWatcher（Linux 上为 inotify）报告，按变化的文件决定重载的范围：
+ * - OBJ 变化：重新解析整个模型（MTL 随之解析，代价很小）
+ * - 只有 MTL 变化：ModelLoader::reloadMaterials 生成新的材质表，MaterialId 不变，
+ *   几何体和三角形都沿用
+ * - 纹理文件变化：只重新解码这张纹理
+ * 新材质表与旧表逐项比较，只有纹理路径变化（或纹理文件本身变化）的纹理才会重新解码，
+ * 其余纹理与旧快照共享像素。
+ *
+ * 新快照构建完成后通过 std::atomic<std::shared_ptr> 一次性替换，渲染线程的 current()
+ * 只是一次原子读取，不会等待解析或解码；旧快照在最后一个使用者释放后销毁。
+ * 加载失败（例如文件只写了一半）时保留旧快照，等待下一次修改。
+ */
+class ModelReloader {
+public:
+    /**
+     * @param path OBJ 文件路径
+     * @param options 每次解析 OBJ 使用的选项
+     * @param decoder 纹理解码函数，在重载线程中调用
+     */
+    ModelReloader(std::string path, const LoadOptions& options, TextureDecoder decoder);
+    ~ModelReloader();
+
+    ModelReloader(const ModelReloader&) = delete;
+    ModelReloader& operator=(const ModelReloader&) = delete;
+
+    /**
+     * @brief 完整加载一次模型并开始监视它的文件
+     * @return false 表示 OBJ 无法加载，此时没有快照
+     */
+    bool load();
+
+    /**
+     * @brief 当前快照，渲染线程每帧调用一次；load 之前为空
+     */
+    std::shared_ptr<const ModelSnapshot> current() const { return snapshot.load(); }
+
+    /**
+     * @brief 等待文件变化并重载
+     * @param timeout_ms 等待第一个变化的毫秒数，0 只检查一次，-1 一直等待
+     * @return 本次重载的结果，没有变化时 published() 为 false
+     * @note 可以在任意非渲染线程中调用，也可以用 start 交给后台线程
+     */
+    ReloadResult update(int timeout_ms = 0);
+
+    /**
+     * @brief 在后台线程中循环调用 update
+     * @param on_reload 每次发布新快照后在后台线程中调用，可以为空
+     */
+    void start(std::function<void(const ReloadResult&)> on_reload = nullptr);
+
+    /**
+     * @brief 停止后台线程（最多等待一个轮询周期）
+     */
+    void stop();
+
+    /**
+     * @brief 最近一次失败的原因，没有失败时为空
+     */
+    std::string get_last_error() const;
+
+private:
+    std::string path;
+    LoadOptions options;
+    TextureDecoder decoder;
+    FileWatcher watcher;
+    std::atomic<std::shared_ptr<const ModelSnapshot>> snapshot;
+    std::mutex update_mutex;                // update 不会并发执行
+    std::thread worker;
+    std::atomic<bool> running{false};
+    mutable std::mutex error_mutex;
+    std::string last_error;
+
+    /**
+     * @brief 按新材质表组装纹理表，未变化的纹理从 previous 中沿用
+     * @param changed_files 本次变化的文件（FileWatcher::normalize 之后的路径）
+     */
+    TextureMap build_textures(const ModelLoader& geometry, const std::vector<Material>& materials,
+                              const ModelSnapshot* previous, const std::unordered_set<std::string>& changed_files,
+                              ReloadResult& result) const;
+
+    /**
+     * @brief 监视 OBJ、MTL 和所有纹理文件（重复监视无影响）
+     */
+    void watch_files(const ModelLoader& geometry, const std::vector<Material>& materials);
+
+    void set_error(const std::string& message);
+};
+
+} // Rasterizer
+
+#endif //HOT_RELOAD_H
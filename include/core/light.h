@@ -0,0 +1,116 @@
+/**
+ * @file light.h
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 光源
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef LIGHT_H
+#define LIGHT_H
+#include <Eigen/Core>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace Rasterizer {
+
+class CascadedShadowMap;
+
+enum class LightType {
+    Point,       // 点光源
+    Spot,        // 聚光灯
+    Directional  // 平行光
+};
+
+/**
+ * @brief 光源
+ * @details 点光源和聚光灯在 range 之外光照为 0，便于按 tile / cluster 剔除；平行光影响所有像素。
+ */
+struct Light {
+    LightType type = LightType::Point;
+    Eigen::Vector3f position = Eigen::Vector3f::Zero();    // 世界空间位置（点光源、聚光灯）
+    Eigen::Vector3f direction = -Eigen::Vector3f::UnitY(); // 光线传播方向（聚光灯、平行光），单位向量
+    Eigen::Vector3f color = Eigen::Vector3f::Ones();       // 光源颜色
+    float intensity = 1.0f;                                // 强度
+    float range = 10.0f;                                   // 影响半径
+    float cos_inner = 1.0f;                                // 聚光灯内锥角余弦，内锥内光照不衰减
+    float cos_outer = 0.0f;                                // 聚光灯外锥角余弦，外锥外光照为 0
+    const CascadedShadowMap* shadow_map = nullptr;         // 平行光的阴影贴图，为空时不产生阴影
+};
+
+/**
+ * @brief 光源列表
+ */
+class LightList {
+public:
+    /**
+     * @brief 添加点光源
+     * @return 光源下标
+     */
+    size_t add_point_light(const Eigen::Vector3f& position, const Eigen::Vector3f& color,
+                           float intensity, float range);
+
+    /**
+     * @brief 添加聚光灯
+     * @param inner_angle 内锥半角（度）
+     * @param outer_angle 外锥半角（度）
+     * @return 光源下标
+     */
+    size_t add_spot_light(const Eigen::Vector3f& position, const Eigen::Vector3f& direction,
+                          const Eigen::Vector3f& color, float intensity, float range,
+                          float inner_angle, float outer_angle);
+
+    /**
+     * @brief 添加平行光
+     * @param direction 光线传播方向
+     * @return 光源下标
+     */
+    size_t add_directional_light(const Eigen::Vector3f& direction, const Eigen::Vector3f& color,
+                                 float intensity);
+
+    void clear() { lights.clear(); }
+    size_t size() const { return lights.size(); }
+    Light& operator[](size_t index) { return lights[index]; }
+    const Light& operator[](size_t index) const { return lights[index]; }
+    const std::vector<Light>& get_lights() const { return lights; }
+
+private:
+    std::vector<Light> lights;
+};
+
+/**
+ * @brief 距离衰减
+ * @param distance 到光源的距离
+ * @param range 光源影响半径
+ * @return 衰减系数，distance >= range 时为 0
+ * @details 平方反比衰减乘以一个在 range 处平滑降到 0 的窗口函数
+ */
+inline float light_attenuation(float distance, float range)
+{
+    const float ratio = distance / range;
+    const float ratio2 = ratio * ratio;
+    const float window = std::clamp(1.0f - ratio2 * ratio2, 0.0f, 1.0f);
+    return window * window / (distance * distance + 1.0f);
+}
+
+/**
+ * @brief 光源是否可能照亮轴对齐包围盒内的点
+ * @details 平行光总是返回 true，点光源和聚光灯用影响半径构成的球测试
+ */
+inline bool light_affects_box(const Light& light, const Eigen::Vector3f& box_min, const Eigen::Vector3f& box_max)
+{
+    if (light.type == LightType::Directional)
+    {
+        return true;
+    }
+    Eigen::Vector3f closest = light.position.cwiseMax(box_min).cwiseMin(box_max);
+    return (closest - light.position).squaredNorm() < light.range * light.range;
+}
+
+} // Rasterizer
+
+#endif //LIGHT_H
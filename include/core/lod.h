@@ -0,0 +1,64 @@
+/**
+ * @file lod.h
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 按屏幕投影误差选择细节层次的模型
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef LOD_H
+#define LOD_H
+#include <cstddef>
+#include <vector>
+#include <Eigen/Core>
+#include <ModelLoader.h>
+#include <MeshSimplifier.h>
+#include "core/Rasterizer.h"
+
+namespace Rasterizer {
+
+/**
+ * @brief 一个物体的细节层次链，每层预先展开成渲染器使用的三角形
+ * @details 层次由 MeshSimplifier::buildLodChain 生成，每层记录相对原始网格的最大几何误差。
+ * select 把包围球最近点处的误差投影到屏幕上，选择误差不超过 max_pixel_error 像素的最粗层次，
+ * 所以物体越远、越小，使用的三角形越少，而画面上的变化始终小于一个像素（默认）。
+ * 选出的层次直接用于 DrawBatchList::build 或渲染器的 draw。
+ */
+class LodModel {
+public:
+    /**
+     * @brief 展开所有层次
+     * @param chain MeshSimplifier::buildLodChain 的结果
+     * @param mesh 生成 chain 的网格
+     */
+    void build(const LodChain& chain, const IndexedMesh& mesh);
+
+    /**
+     * @brief 当前视图下的层次
+     * @param rasterizer 提供视口高度、视图和投影矩阵
+     * @param model 物体的模型矩阵
+     * @param max_pixel_error 允许的屏幕误差，单位为像素
+     * @return 层次编号，0 为原始网格
+     */
+    size_t select(const Rasterizer& rasterizer, const Eigen::Matrix4f& model, float max_pixel_error = 1.0f) const;
+
+    /**
+     * @brief 模型空间中一个单位在屏幕上的像素数，按包围球离相机最近的点计算
+     */
+    float pixels_per_unit(const Rasterizer& rasterizer, const Eigen::Matrix4f& model) const;
+
+    size_t level_count() const { return levels.size(); }
+    const std::vector<Triangle>& get_triangles(size_t level) const { return levels[level]; }
+    float get_error(size_t level) const { return chain.levels[level].error; }
+
+private:
+    LodChain chain;
+    std::vector<std::vector<Triangle>> levels;
+};
+
+} // Rasterizer
+
+#endif //LOD_H
@@ -0,0 +1,134 @@
+/**
+ * @file meshlet.h
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 按 meshlet 整体剔除（视锥、背面、遮挡）
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef MESHLET_H
+#define MESHLET_H
+#include <Eigen/Core>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <ModelLoader.h>
+#include <MeshletBuilder.h>
+#include "core/Rasterizer.h"
+
+namespace Rasterizer {
+
+/**
+ * @brief meshlet 剔除方式，按位组合
+ */
+enum MeshletCulling : uint8_t {
+    CULL_NONE = 0,
+    CULL_FRUSTUM = 1 << 0,    // 包围球完全在视锥外
+    CULL_BACKFACE = 1 << 1,   // 法线锥表明所有三角形背对相机，只适用于单面绘制的封闭模型
+    CULL_OCCLUSION = 1 << 2,  // 包围球最近点被深度金字塔中已有的深度完全遮挡
+    CULL_DEFAULT = CULL_FRUSTUM | CULL_OCCLUSION
+};
+
+/**
+ * @brief 剔除统计，每帧 clear 时清零
+ */
+struct MeshletCullStats {
+    size_t meshlets = 0;          // 参与测试的 meshlet 数
+    size_t frustum_culled = 0;
+    size_t backface_culled = 0;
+    size_t occlusion_culled = 0;
+    size_t triangles = 0;         // 通过测试、实际光栅化的三角形数
+};
+
+/**
+ * @brief 按 meshlet 顺序展开的三角形和每个 meshlet 的包围数据
+ * @details meshlet m 的三角形在 get_triangles() 中是连续的
+ * [triangleOffset / 3, triangleOffset / 3 + triangleCount)，渲染器可以按 meshlet 整段跳过。
+ */
+class MeshletModel {
+public:
+    /**
+     * @brief 展开三角形
+     * @param meshlets MeshletBuilder::build 的结果
+     * @param mesh 生成 meshlets 的网格
+     */
+    void build(const MeshletMesh& meshlets, const IndexedMesh& mesh);
+
+    const std::vector<Triangle>& get_triangles() const { return triangles; }
+    const std::vector<Meshlet>& get_meshlets() const { return meshlets; }
+
+private:
+    std::vector<Triangle> triangles;
+    std::vector<Meshlet> meshlets;
+};
+
+/**
+ * @brief 深度缓冲的最远深度金字塔（Hi-Z）
+ * @details 第 0 层是深度缓冲本身，之后每层的纹素取下一层 2x2 纹素中最远的深度（最小值，
+ * 深度越大越近）。查询一个屏幕矩形时选择使矩形只覆盖少量纹素的层，结果是保守的：
+ * 返回值不会比矩形内任何像素更近。空像素为负无穷，不会遮挡任何物体。
+ */
+class DepthPyramid {
+public:
+    void build(const std::vector<float>& depth, int width, int height);
+    void clear() { levels.clear(); }
+    bool empty() const { return levels.empty(); }
+
+    /**
+     * @brief 像素矩形 [x_begin, x_end] x [y_begin, y_end] 内最远的深度
+     */
+    float farthest(int x_begin, int y_begin, int x_end, int y_end) const;
+
+private:
+    struct Level {
+        int width;
+        int height;
+        std::vector<float> depth;
+    };
+    std::vector<Level> levels;
+};
+
+/**
+ * @brief 一次绘制的 meshlet 可见性测试
+ * @details 所有测试只用 meshlet 的包围球和法线锥，不变换任何顶点：
+ * - 视锥：包围球在模型空间中和六个裁剪平面比较；
+ * - 背面：相机变换到模型空间后用 MeshletBuilder::isBackfacing 判断，模型矩阵有非均匀缩放时跳过；
+ * - 遮挡：包围球在视空间的包围盒投影成屏幕矩形，最近点的深度比矩形内深度金字塔的最远深度还远时剔除。
+ *   包围球与近平面相交时不做遮挡测试。
+ */
+class MeshletCuller {
+public:
+    /**
+     * @brief 准备测试
+     * @param rasterizer 提供视图、投影矩阵和视口
+     * @param model 模型矩阵
+     * @param culling MeshletCulling 的组合
+     * @param pyramid 遮挡测试使用的深度金字塔，为空时不做遮挡测试
+     */
+    void begin(const Rasterizer& rasterizer, const Eigen::Matrix4f& model, uint8_t culling,
+               const DepthPyramid* pyramid);
+
+    /**
+     * @brief 测试一个 meshlet，并更新统计
+     * @return 需要绘制时返回 true
+     */
+    bool visible(const Meshlet& meshlet, MeshletCullStats& stats) const;
+
+private:
+    bool occluded(const Eigen::Vector3f& center, float radius) const;
+
+    const Rasterizer* rasterizer = nullptr;
+    const DepthPyramid* pyramid = nullptr;
+    uint8_t culling = CULL_NONE;
+    Eigen::Vector4f planes[6];            // 模型空间的裁剪平面，法线已归一化
+    Eigen::Matrix4f model_view;
+    float eye[3];                         // 模型空间的相机位置
+    float scale = 1.0f;                   // 模型矩阵的最大缩放
+};
+
+} // Rasterizer
+
+#endif //MESHLET_H
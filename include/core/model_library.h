@@ -0,0 +1,189 @@
+/**
+ * @file model_library.h
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 在线程池上并发加载多个模型，共享 MTL 和纹理
+ * @version 0.1
+ * @date 2026/10/19
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef MODEL_LIBRARY_H
+#define MODEL_LIBRARY_H
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <MaterialCache.h>
+#include <ModelLoader.h>
+#include "core/hot_reload.h"
+#include "core/texture.h"
+
+namespace Rasterizer {
+
+/**
+ * @brief 模型所处的加载阶段
+ */
+enum class ModelState {
+    Queued,     // 等待空闲线程
+    Parsing,    // 解析 OBJ 和 MTL
+    Decoding,   // 解码纹理
+    Loaded,     // 完成，model() 可用
+    Failed      // 失败，原因见 ModelStatus::error
+};
+
+/**
+ * @brief 一个模型的加载进度
+ */
+struct ModelStatus {
+    std::string path;
+    ModelState state = ModelState::Queued;
+    size_t textures_total = 0;      // 模型用到的纹理数
+    size_t textures_ready = 0;      // 已就绪的纹理数
+    size_t shared_textures = 0;     // 其中由其他模型解码、直接共享的纹理数
+    size_t missing_textures = 0;    // 解码结果为空的纹理数（采样为白色）
+    double seconds = 0.0;           // 从开始解析到完成的耗时
+    std::string error;              // 失败原因
+    bool finished() const { return state == ModelState::Loaded || state == ModelState::Failed; }
+};
+
+/**
+ * @brief 整个库的统计
+ */
+struct LibraryStats {
+    size_t models = 0;              // 加入的模型数
+    size_t loaded = 0;              // 加载成功的模型数
+    size_t failed = 0;              // 加载失败的模型数
+    size_t material_files = 0;      // 解析过的 MTL 文件数
+    size_t shared_material_files = 0; // 直接使用已解析 MTL 的次数
+    size_t textures = 0;            // 解码过的纹理数
+    size_t shared_textures = 0;     // 直接使用已解码纹理的次数
+};
+
+/**
+ * @brief 模型状态变化时调用，参数为模型序号和最新状态
+ */
+using ModelCallback = std::function<void(size_t index, const ModelStatus& status)>;
+
+/**
+ * @brief 场景的模型库：并发加载一组模型，相同的 MTL 文件和纹理只处理一次
+ * @details 每个模型使用自己的 ModelLoader，加载完成后以 ModelSnapshot 的形式提供，与热重载的快照相同。
+ * ModelLoader 内部状态可变、不能跨线程共享，这里改为在固定的线程池上同时加载多个模型：
+ * - 每个模型单线程解析，并行来自同时加载多个模型，避免线程数超过核数
+ * - 所有 ModelLoader 共用一个 MaterialCache，同一个 MTL 文件只解析一次，各模型仍有自己的 MaterialId
+ * - 纹理按规范化后的文件路径缓存，只解码一次，各模型的 TextureMap 共享同一份像素
+ * 同一个文件被两个模型同时需要时，后到的模型等待先到的模型处理完成。
+ *
+ * 模型按加入的顺序分配序号，进度通过 status() 查询，或通过回调在工作线程中得到通知。
+ * MTL 和纹理在库的生命周期内只读取一次，文件修改后需要新的库（或用 ModelReloader）。
+ */
+class ModelLibrary {
+public:
+    /**
+     * @param options 每个模型的加载选项
+     * @param decoder 纹理解码函数，在工作线程中并发调用
+     * @param threads 工作线程数，0 为硬件线程数
+     */
+    ModelLibrary(const LoadOptions& options, TextureDecoder decoder, unsigned int threads = 0);
+
+    /**
+     * @brief 放弃还在排队的模型，等待正在加载的模型完成
+     */
+    ~ModelLibrary();
+
+    ModelLibrary(const ModelLibrary&) = delete;
+    ModelLibrary& operator=(const ModelLibrary&) = delete;
+
+    /**
+     * @brief 设置状态回调，应在 add 之前调用
+     */
+    void set_callback(ModelCallback callback);
+
+    /**
+     * @brief 加入一个模型并排队加载
+     * @return 模型序号
+     */
+    size_t add(const std::string& path);
+
+    /**
+     * @brief 按顺序加入一组模型
+     * @return 第一个模型的序号，其余依次加一
+     */
+    size_t add(const std::vector<std::string>& paths);
+
+    /**
+     * @brief 等待所有已加入的模型完成（成功或失败）
+     */
+    void wait();
+
+    /**
+     * @brief 已加入的模型数
+     */
+    size_t size() const;
+
+    /**
+     * @brief 模型的当前状态
+     */
+    ModelStatus status(size_t index) const;
+
+    /**
+     * @brief 加载成功的模型，未完成或失败时为空
+     */
+    std::shared_ptr<const ModelSnapshot> model(size_t index) const;
+
+    LibraryStats stats() const;
+
+private:
+    struct Entry {
+        ModelStatus status;
+        std::shared_ptr<const ModelSnapshot> model;
+    };
+
+    LoadOptions options;
+    TextureDecoder decoder;
+    ModelCallback callback;
+    MaterialCache material_cache;
+
+    mutable std::mutex mutex;               // 保护 entries、queue、pending 和 stopping
+    std::condition_variable work_ready;     // 有模型排队或正在停止
+    std::condition_variable all_done;       // pending 变为 0
+    std::deque<Entry> entries;              // 按序号存放，追加时不移动已有元素
+    std::deque<size_t> queue;               // 排队的模型序号
+    size_t pending = 0;                     // 排队和正在加载的模型数
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    mutable std::mutex texture_mutex;       // 保护 textures 和 texture_reuses
+    std::unordered_map<std::string, std::shared_future<Texture>> textures; // 规范化路径到（可能仍在解码的）纹理
+    size_t texture_reuses = 0;
+
+    void work();
+
+    /**
+     * @brief 在工作线程中加载一个模型
+     */
+    void load(size_t index);
+
+    /**
+     * @brief 取一张纹理，第一次需要时解码
+     * @param shared 输出，是否由其他模型解码
+     */
+    Texture acquire_texture(const std::string& file, bool& shared);
+
+    /**
+     * @brief 修改模型状态并通知回调
+     */
+    void update_status(size_t index, const std::function<void(ModelStatus&)>& change);
+};
+
+} // Rasterizer
+
+#endif //MODEL_LIBRARY_H
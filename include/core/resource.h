@@ -14,7 +14,12 @@
 
 
 #include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <ModelLoader.h>
 
+namespace Rasterizer {
+
+// 渲染端顶点，放在命名空间内以免与 loader 的 Vertex 冲突
 struct Vertex {
  // 位置信息 (必需)
  Eigen::Vector4f position;     // 齐次坐标 (x, y, z, w)
@@ -42,4 +47,37 @@ struct Vertex {
   bitangent.setZero();
  }
 };
+
+/**
+ * @brief 用索引网格的第 i 个顶点构造渲染端顶点
+ * @details 网格带有切线（LoadOptions::generateTangents）时同时填充切线和副切线，
+ * 副切线 = w * cross(normal, tangent)，与 MikkTSpace 烘焙的法线贴图一致
+ */
+inline Vertex make_vertex(const IndexedMeshView& mesh, size_t i)
+{
+ Vertex vertex;
+ if (mesh.vertices != nullptr)
+ {
+  const MeshVertex& source = mesh.vertices[i];
+  vertex.position = Eigen::Vector4f(source.position.x, source.position.y, source.position.z, 1.0f);
+  vertex.texCoord = Eigen::Vector2f(source.texCoord.u, source.texCoord.v);
+  vertex.normal = Eigen::Vector3f(source.normal.x, source.normal.y, source.normal.z);
+ }
+ else
+ {
+  const VertexStreamsView& streams = mesh.streams;
+  vertex.position = Eigen::Vector4f(streams.positionX[i], streams.positionY[i], streams.positionZ[i], 1.0f);
+  vertex.texCoord = Eigen::Vector2f(streams.texCoordU[i], streams.texCoordV[i]);
+  vertex.normal = Eigen::Vector3f(streams.normalX[i], streams.normalY[i], streams.normalZ[i]);
+ }
+ if (mesh.tangents != nullptr)
+ {
+  const Tangent& tangent = mesh.tangents[i];
+  vertex.tangent = Eigen::Vector3f(tangent.x, tangent.y, tangent.z);
+  vertex.bitangent = tangent.w * vertex.normal.cross(vertex.tangent);
+ }
+ return vertex;
+}
+
+} // Rasterizer
 #endif //RESOURCE_H
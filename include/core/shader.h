@@ -12,10 +12,74 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <Eigen/Core>
+#include <ModelLoader.h>
+#include "core/light.h"
+#include "core/texture.h"
 
+namespace Rasterizer {
+
+/**
+ * @brief 着色点的几何与材质信息（世界空间）
+ */
+struct Surface {
+    Eigen::Vector3f position;   // 位置
+    Eigen::Vector3f normal;     // 单位法线
+    Eigen::Vector3f ambient;    // 环境光反射颜色 (Ka)
+    Eigen::Vector3f albedo;     // 漫反射颜色 (Kd * 纹理)
+    Eigen::Vector3f specular;   // 镜面反射颜色 (Ks)
+    float shininess;            // 光泽度 (Ns)
+};
+
+} // Rasterizer
 
 class shader {
+public:
+    shader() = delete;
+    shader(const shader&) = delete;
+    shader& operator=(const shader&) = delete;
+
+    /**
+     * @brief Blinn-Phong 光照
+     * @param surface 着色点
+     * @param light 光源（点光源、聚光灯或平行光）
+     * @param eye 相机位置
+     * @return 该光源贡献的漫反射与镜面反射颜色
+     * @details 漫反射 Kd * max(N.L, 0)，镜面反射 Ks * max(N.H, 0)^Ns，环境光项由 ambient 单独计算
+     */
+    static Eigen::Vector3f blinn_phong(const Rasterizer::Surface& surface,
+                                       const Rasterizer::Light& light,
+                                       const Eigen::Vector3f& eye);
+
+    /**
+     * @brief 环境光项 Ka * 场景环境光
+     */
+    static Eigen::Vector3f ambient(const Rasterizer::Surface& surface, const Eigen::Vector3f& scene_ambient)
+    {
+        return surface.ambient.cwiseProduct(scene_ambient);
+    }
+
+    /**
+     * @brief 用 MTL 材质参数（Ka, Kd, Ks, Ns）填充着色点
+     */
+    static void apply_material(const Material& material, Rasterizer::Surface& surface);
+
+    /**
+     * @brief 三角形使用的材质，没有材质时返回默认材质
+     * @param materials 三角形所属模型的材质表，按 Triangle::materialId 查找
+     */
+    static const Material& triangle_material(const Triangle& triangle, const std::vector<Material>& materials);
 
+    /**
+     * @brief 三角形的漫反射纹理
+     * @param triangle 三角形
+     * @param materials 三角形所属模型的材质表
+     * @param textures 纹理表，可以为空
+     * @return 三角形没有纹理坐标、材质没有纹理或纹理表中找不到时返回 nullptr
+     */
+    static const Rasterizer::Texture* diffuse_texture(const Triangle& triangle,
+                                                      const std::vector<Material>& materials,
+                                                      const Rasterizer::TextureMap* textures);
 };
 
 
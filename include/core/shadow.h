@@ -0,0 +1,141 @@
+/**
+ * @file shadow.h
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 平行光级联阴影贴图
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef SHADOW_H
+#define SHADOW_H
+#include <Eigen/Core>
+#include <vector>
+#include <ModelLoader.h>
+
+namespace Rasterizer {
+
+/**
+ * @brief 平行光的级联阴影贴图（CSM）
+ * @details 相机视锥在 [near, shadow_distance] 之间按对数 / 均匀混合的方式切分为若干级联，
+ * 每个级联用包围球拟合并在光源空间中按 texel 对齐，相机移动和旋转时阴影边缘不会闪烁。
+ * 各级联的深度图由 render 在多个线程上同时渲染（级联之间、同一级联的不同行带之间都并行）。
+ * 投射阴影的物体在光源近平面之前时深度被钳制到近平面，因此不需要场景包围盒。
+ *
+ * 使用方法：把平行光的 Light::shadow_map 指向本对象，每帧依次调用
+ * update、clear、draw、render，之后着色器在 Blinn-Phong 中自动乘上 visibility。
+ */
+class CascadedShadowMap {
+public:
+    static constexpr int MAX_CASCADES = 4;
+    static constexpr int MAX_PCF_RADIUS = 3;
+
+    /**
+     * @brief 单个级联
+     */
+    struct Cascade {
+        Eigen::Matrix4f view_projection;    // 世界空间到光源 NDC
+        float split_far = 0.0f;             // 级联覆盖到的视空间距离
+        float texel_size = 0.0f;            // 一个 texel 对应的世界空间尺寸
+        std::vector<float> depth;           // 深度图，四周有 BORDER 宽的空白边框
+    };
+
+    /**
+     * @param resolution 每个级联深度图的边长（texel）
+     * @param cascade_count 级联数，不超过 MAX_CASCADES
+     */
+    explicit CascadedShadowMap(int resolution = 1024, int cascade_count = 4);
+
+    /**
+     * @brief 对数划分与均匀划分的混合系数，1 为纯对数划分
+     */
+    void set_split_lambda(float lambda) { split_lambda = lambda; }
+
+    /**
+     * @brief 阴影的最远距离，0 表示使用相机远平面
+     */
+    void set_shadow_distance(float distance) { shadow_distance = distance; }
+
+    /**
+     * @brief 深度偏移（NDC）和法线偏移（texel 的倍数），用于消除自阴影条纹
+     */
+    void set_bias(float depth_bias, float normal_bias)
+    {
+        this->depth_bias = depth_bias;
+        this->normal_bias = normal_bias;
+    }
+
+    /**
+     * @brief PCF 半径，滤波核为 (2 * radius + 1)^2 个 texel 的双线性加权
+     */
+    void set_pcf_radius(int radius);
+
+    /**
+     * @brief 根据相机和光源方向拟合各级联
+     * @param view 相机视图矩阵（例如 camera::get_view_matrix）
+     * @param projection 相机透视投影矩阵
+     * @param light_direction 光线传播方向
+     */
+    void update(const Eigen::Matrix4f& view, const Eigen::Matrix4f& projection,
+                const Eigen::Vector3f& light_direction);
+
+    /**
+     * @brief 清空投射阴影的绘制列表
+     */
+    void clear() { draws.clear(); }
+
+    /**
+     * @brief 记录一次投射阴影的绘制，三角形数组在 render 之前必须保持有效
+     */
+    void draw(const std::vector<Triangle>& triangles, const Eigen::Matrix4f& model);
+
+    /**
+     * @brief 并行渲染所有级联的深度图
+     */
+    void render();
+
+    /**
+     * @brief 世界空间点的光照可见度
+     * @param position 着色点位置
+     * @param normal 着色点单位法线
+     * @return 0 为完全在阴影中，1 为完全受光；超出阴影距离时返回 1
+     */
+    float visibility(const Eigen::Vector3f& position, const Eigen::Vector3f& normal) const;
+
+    /**
+     * @brief 着色点所在的级联，超出阴影距离时返回 -1
+     */
+    int select_cascade(const Eigen::Vector3f& position) const;
+
+    int get_resolution() const { return resolution; }
+    int get_cascade_count() const { return cascade_count; }
+    const Cascade& get_cascade(int index) const { return cascades[index]; }
+
+private:
+    static constexpr int BORDER = MAX_PCF_RADIUS + 2;
+
+    struct Draw {
+        const std::vector<Triangle>* triangles;
+        Eigen::Matrix4f model;
+    };
+
+    int resolution;
+    int cascade_count;
+    int stride;                             // 深度图每行的 texel 数（含边框）
+    int pcf_radius = 1;
+    float split_lambda = 0.75f;
+    float shadow_distance = 0.0f;
+    float depth_bias = 0.002f;
+    float normal_bias = 1.5f;
+    Eigen::Vector4f view_depth_row;         // 视空间深度 = view_depth_row . 世界坐标
+    Cascade cascades[MAX_CASCADES];
+    std::vector<Draw> draws;
+
+    void render_band(int cascade, int y_begin, int y_end);
+};
+
+} // Rasterizer
+
+#endif //SHADOW_H
@@ -0,0 +1,59 @@
+/**
+ * @file texture.h
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 纹理采样
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef TEXTURE_H
+#define TEXTURE_H
+#include <Eigen/Core>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Rasterizer {
+
+/**
+ * @brief 解码后的 8 位纹理
+ * @details 像素按行存储，第一行是图像顶部（stb_image 默认的顺序），采样时会翻转 v。
+ * 纹理的解码由调用方完成（例如 stb_image），渲染器只负责采样。
+ * 像素数据是共享的，复制 Texture 只复制指针，所以同一张纹理可以同时出现在多个 TextureMap 中
+ * （例如热重载前后的两份纹理表）。
+ */
+struct Texture {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    std::shared_ptr<const std::vector<unsigned char>> data;  // 像素，不会被修改
+
+    Texture() = default;
+    Texture(int width, int height, int channels, const unsigned char* pixels);
+
+    bool empty() const { return data == nullptr || data->empty(); }
+
+    /**
+     * @brief 双线性采样，uv 超出 [0, 1] 时重复
+     * @param u 纹理坐标 u
+     * @param v 纹理坐标 v（向上）
+     * @return RGB 颜色，范围 [0, 1]
+     */
+    Eigen::Vector3f sample(float u, float v) const;
+
+private:
+    Eigen::Vector3f texel(int x, int y) const;
+};
+
+/**
+ * @brief 纹理表，键为材质中的纹理文件名（Material::diffuseTexture）
+ */
+using TextureMap = std::unordered_map<std::string, Texture>;
+
+} // Rasterizer
+
+#endif //TEXTURE_H
@@ -0,0 +1,135 @@
+/**
+ * @file visibility.h
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief Visibility buffer 渲染
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef VISIBILITY_H
+#define VISIBILITY_H
+#include <Eigen/Core>
+#include <cstdint>
+#include <vector>
+#include <ModelLoader.h>
+#include "core/Rasterizer.h"
+#include "core/light.h"
+#include "core/meshlet.h"
+#include "core/texture.h"
+
+namespace Rasterizer {
+
+/**
+ * @brief Visibility buffer 渲染
+ * @details 比 G-buffer 占用更少带宽的延迟方案：
+ * 1. draw 只光栅化深度，每个像素写入 32 位 ID（高 8 位 draw ID，低 24 位三角形 ID）；
+ * 2. resolve 按 tile 并行，根据 ID 找回原始三角形，在像素中心重新计算重心坐标并插值属性，
+ *    每个像素只着色一次。
+ * 对子像素三角形很多的模型，被覆盖的片元不会做任何属性插值。
+ * 三角形数组在 resolve 之前必须保持有效。
+ */
+class VisibilityRenderer {
+public:
+    static constexpr int TILE_SIZE = 16;
+    static constexpr int TRIANGLE_ID_BITS = 24;
+    static constexpr uint32_t TRIANGLE_ID_MASK = (1u << TRIANGLE_ID_BITS) - 1;
+    static constexpr uint32_t MAX_DRAWS = (1u << (32 - TRIANGLE_ID_BITS)) - 1; // 最大 ID 保留给空像素
+    static constexpr uint32_t EMPTY_ID = 0xFFFFFFFFu;
+
+    VisibilityRenderer(int width, int height);
+
+    /**
+     * @brief 光栅化器，用于设置视图和投影矩阵（模型矩阵由每次 draw 指定）
+     */
+    Rasterizer& get_rasterizer() { return rasterizer; }
+
+    void set_ambient(const Eigen::Vector3f& ambient) { this->ambient = ambient; }
+    void set_background(const Eigen::Vector3f& background) { this->background = background; }
+
+    /**
+     * @brief 清空 ID、深度缓冲和绘制列表，每帧开始时调用一次
+     */
+    void clear();
+
+    /**
+     * @brief 光栅化一个模型，只写入深度和 ID
+     * @param triangles ModelLoader 输出的三角形
+     * @param materials 三角形的材质表（ModelLoader::getMaterials），resolve 之前必须保持有效
+     * @param model 模型矩阵
+     * @param textures 漫反射纹理表，可以为空
+     * @return 绘制数超过 MAX_DRAWS 或三角形数超过 TRIANGLE_ID_MASK 时返回 false
+     */
+    bool draw(const std::vector<Triangle>& triangles, const std::vector<Material>& materials,
+              const Eigen::Matrix4f& model, const TextureMap* textures = nullptr);
+
+    /**
+     * @brief 按 meshlet 剔除后光栅化一个模型，只写入深度和 ID
+     * @param meshlets 展开后的 meshlet 模型，resolve 之前必须保持有效
+     * @param materials 生成 meshlet 的网格的材质表，resolve 之前必须保持有效
+     * @param model 模型矩阵
+     * @param textures 漫反射纹理表，可以为空
+     * @param culling MeshletCulling 的组合
+     * @return 绘制数超过 MAX_DRAWS 或三角形数超过 TRIANGLE_ID_MASK 时返回 false
+     * @details 被剔除的 meshlet 不变换任何顶点。遮挡测试使用本帧之前的 draw 写入的深度，
+     * 同一次 draw 内的 meshlet 之间不互相遮挡，所以先画近处的大物体效果最好。
+     */
+    bool draw(const MeshletModel& meshlets, const std::vector<Material>& materials, const Eigen::Matrix4f& model,
+              const TextureMap* textures = nullptr, uint8_t culling = CULL_DEFAULT);
+
+    /**
+     * @brief 根据 ID 重建属性并着色，结果写入颜色缓冲
+     * @param lights 光源列表，见 LightList::get_lights
+     */
+    void resolve(const std::vector<Light>& lights);
+
+    static uint32_t pack_id(uint32_t draw_id, uint32_t triangle_id)
+    {
+        return (draw_id << TRIANGLE_ID_BITS) | triangle_id;
+    }
+
+    const std::vector<uint32_t>& get_visibility_buffer() const { return ids; }
+    const std::vector<float>& get_depth_buffer() const { return depth; }
+    const std::vector<Eigen::Vector3f>& get_color_buffer() const { return color_buffer; }
+
+    /**
+     * @brief 本帧 meshlet 剔除的统计
+     */
+    const MeshletCullStats& get_meshlet_stats() const { return meshlet_stats; }
+
+private:
+    struct Draw {
+        const std::vector<Triangle>* triangles;
+        const std::vector<Material>* materials;
+        const TextureMap* textures;
+        Eigen::Matrix4f model;
+        Eigen::Matrix4f mvp;
+        Eigen::Matrix3f normal_matrix;
+    };
+
+    Rasterizer rasterizer;
+    std::vector<Draw> draws;
+    std::vector<uint32_t> ids;
+    std::vector<float> depth;
+    std::vector<Eigen::Vector3f> color_buffer;
+    Eigen::Vector3f ambient;
+    Eigen::Vector3f background;
+    DepthPyramid depth_pyramid;
+    bool depth_pyramid_valid;             // 深度缓冲在上次构建金字塔之后没有变化
+    MeshletCullStats meshlet_stats;
+
+    /**
+     * @brief 登记一次绘制
+     * @return draw ID，超出限制时返回 EMPTY_ID
+     */
+    uint32_t add_draw(const std::vector<Triangle>& triangles, const std::vector<Material>& materials,
+                      const Eigen::Matrix4f& model, const TextureMap* textures);
+    void rasterize(const Triangle& triangle, const Eigen::Matrix4f& mvp, uint32_t id);
+    void resolve_tile(int tile_x, int tile_y, const std::vector<Light>& lights, const Eigen::Vector3f& eye);
+};
+
+} // Rasterizer
+
+#endif //VISIBILITY_H
@@ -56,6 +56,23 @@ namespace utils
                                                      const double& aspect,
                                                      const double& near,
                                                      const double& far);
+
+        /**
+         * @brief 计算正交投影矩阵
+         * @param left 左边界
+         * @param right 右边界
+         * @param bottom 下边界
+         * @param top 上边界
+         * @param near 近平面离相机的距离
+         * @param far 远平面离相机的距离
+         * @return 正交投影矩阵，深度约定与 cal_projection_matrix 相同（近平面 z = 1，远平面 z = -1）
+         */
+        static Eigen::Matrix4d cal_orthographic_matrix(const double& left,
+                                                       const double& right,
+                                                       const double& bottom,
+                                                       const double& top,
+                                                       const double& near,
+                                                       const double& far);
     };
 }
 
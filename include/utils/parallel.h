@@ -0,0 +1,80 @@
+/**
+ * @file parallel.h
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 简单的多线程任务分发
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace utils
+{
+    /**
+     * @brief 可用的工作线程数
+     * @return 硬件线程数，无法获取时返回 1
+     */
+    inline unsigned int worker_count()
+    {
+        unsigned int count = std::thread::hardware_concurrency();
+        return count == 0 ? 1 : count;
+    }
+
+    /**
+     * @brief 并行执行 func(0) ... func(count - 1)
+     * @param count 任务数
+     * @param func 任务函数，参数为任务下标
+     * @details 各线程通过原子计数器领取任务（动态调度），适合每个任务耗时不均的情况，
+     * 例如按 tile 划分的像素处理。任务数只有一个或只有一个线程时直接在调用线程上执行。
+     */
+    template <typename Func>
+    void parallel_for(std::size_t count, Func&& func)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        const std::size_t threads = std::min<std::size_t>(worker_count(), count);
+        if (threads <= 1)
+        {
+            for (std::size_t i = 0; i < count; i++)
+            {
+                func(i);
+            }
+            return;
+        }
+
+        std::atomic<std::size_t> next(0);
+        auto worker = [&]()
+        {
+            for (std::size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+            {
+                func(i);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        for (std::size_t t = 1; t < threads; t++)
+        {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : pool)
+        {
+            thread.join();
+        }
+    }
+}
+
+#endif //PARALLEL_H
@@ -0,0 +1,54 @@
+/**
+ * @file AlignedAllocator.h
+ * @author zhywyt (zhywyt@yeah.net)
+ * @brief Allocator for over-aligned std::vector storage
+ * @version 0.2
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#pragma once
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+ * @brief Standard allocator returning memory aligned to Alignment bytes
+ * @tparam T Element type
+ * @tparam Alignment Alignment in bytes, a power of two (64 matches a cache line and an AVX-512 register)
+ */
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* pointer, std::size_t) noexcept {
+        ::operator delete(pointer, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+/**
+ * @brief Float array whose data() is 64-byte aligned
+ */
+using AlignedFloatArray = std::vector<float, AlignedAllocator<float, 64>>;
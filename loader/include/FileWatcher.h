@@ -0,0 +1,101 @@
+/**
+ * @file FileWatcher.h
+ * @author zhywyt (zhywyt@yeah.net)
+ * @brief Change notification for model, material and texture files
+ * @version 0.2
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief Reports which of a set of files were written
+ * @details On Linux the directories of the watched files are registered with inotify, so a
+ * file is reported both when it is rewritten in place and when an editor saves a temporary
+ * file and renames it over the original. Elsewhere (or if inotify is unavailable) poll()
+ * compares modification times and sizes instead.
+ *
+ * Saving usually produces several events in a row (truncate, write, close, rename), so poll()
+ * keeps collecting until the files have been quiet for SETTLE_MS and reports every file once.
+ */
+class FileWatcher {
+public:
+    /**
+     * @brief Quiet time after the last event before poll() returns
+     */
+    static constexpr int SETTLE_MS = 50;
+
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Start watching a file (watching it again does nothing)
+     * @param path File to watch, it does not have to exist yet
+     * @return false if its directory cannot be watched
+     */
+    bool watch(const std::string& path);
+
+    /**
+     * @brief Stop watching every file
+     */
+    void clear();
+
+    /**
+     * @brief Wait for watched files to change
+     * @param timeoutMs Milliseconds to wait for the first change, 0 to only check, -1 to wait forever
+     * @return Changed files as passed to watch(), each once, empty on timeout
+     */
+    std::vector<std::string> poll(int timeoutMs = 0);
+
+    /**
+     * @brief Normalized absolute form of a path, the form poll() compares against
+     */
+    static std::string normalize(const std::string& path);
+
+    /**
+     * @brief Whether changes come from the system (inotify) rather than from comparing timestamps
+     */
+    bool isNative() const { return descriptor >= 0; }
+
+private:
+    /**
+     * @brief Modification time and size of a file, all zero if it does not exist
+     */
+    struct Stamp {
+        int64_t modified = 0;
+        uint64_t size = 0;
+        bool exists = false;
+
+        bool operator==(const Stamp& other) const {
+            return modified == other.modified && size == other.size && exists == other.exists;
+        }
+    };
+
+    int descriptor = -1;                  ///< inotify instance, -1 if timestamps are compared
+    std::unordered_map<int, std::string> directories; ///< inotify watch descriptors to watched directories
+    std::unordered_map<std::string, std::string> files; ///< Normalized paths to the paths passed to watch()
+    std::unordered_map<std::string, Stamp> stamps; ///< Last seen state of every file, without inotify
+
+    static Stamp stat(const std::string& path);
+
+    /**
+     * @brief Read the pending inotify events and add the watched files they name
+     * @return true if there was at least one event
+     */
+    bool readEvents(std::unordered_set<std::string>& changed);
+
+    /**
+     * @brief Add the files whose timestamp or size differ from the last check
+     */
+    void compareStamps(std::unordered_set<std::string>& changed);
+};
@@ -0,0 +1,274 @@
+/**
+ * @file GltfLoader.h
+ * @author zhywyt (zhywyt@yeah.net)
+ * @brief glTF 2.0 / GLB loader exposing the binary buffers in place
+ * @version 0.2
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#pragma once
+#include <ModelLoader.h>
+#include <MappedFile.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Elements of type T at a fixed byte stride, pointing into a mapped buffer
+ * @details glTF requires every accessor to be aligned to its component size, so when the
+ * elements are tightly packed the view can be used as a plain array (data()).
+ */
+template <typename T>
+struct StridedView {
+    const char* bytes = nullptr;          ///< First element
+    size_t count = 0;                     ///< Number of elements
+    size_t stride = sizeof(T);            ///< Bytes from one element to the next
+
+    /**
+     * @brief Element i, copied out (works for any stride)
+     */
+    T operator[](size_t i) const {
+        T value;
+        std::memcpy(&value, bytes + i * stride, sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Whether the elements are tightly packed and aligned for T
+     */
+    bool contiguous() const {
+        return stride == sizeof(T) && reinterpret_cast<uintptr_t>(bytes) % alignof(T) == 0;
+    }
+
+    /**
+     * @brief The elements as an array, nullptr unless contiguous
+     */
+    const T* data() const {
+        return contiguous() ? reinterpret_cast<const T*>(bytes) : nullptr;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+};
+
+/**
+ * @brief Component types of glTF accessors (the GL enum values used in the file)
+ */
+enum class GltfComponentType : uint32_t {
+    Int8 = 5120,
+    UInt8 = 5121,
+    Int16 = 5122,
+    UInt16 = 5123,
+    UInt32 = 5125,
+    Float = 5126
+};
+
+/**
+ * @brief A typed array inside a buffer (glTF accessor)
+ */
+struct GltfAccessor {
+    const char* bytes = nullptr;          ///< First element, nullptr if the accessor has no (valid) buffer view
+    size_t count = 0;                     ///< Number of elements
+    size_t stride = 0;                    ///< Bytes between elements
+    GltfComponentType componentType = GltfComponentType::Float;
+    uint32_t componentCount = 1;          ///< 1 (SCALAR), 2, 3, 4 (VECn) or 4, 9, 16 (MATn)
+    bool normalized = false;              ///< Integer components map to [0, 1] or [-1, 1]
+    float min[3] = {0.0f, 0.0f, 0.0f};    ///< Bounds of POSITION accessors (first three components)
+    float max[3] = {0.0f, 0.0f, 0.0f};
+
+    /**
+     * @brief Bytes of one element
+     */
+    size_t elementSize() const;
+
+    /**
+     * @brief View the elements as T
+     * @return Empty view if the accessor has no data or an element is not sizeof(T) bytes;
+     * T must match the component type (e.g. Vertex for float VEC3, uint16_t for UInt16 SCALAR)
+     */
+    template <typename T>
+    StridedView<T> as() const {
+        StridedView<T> view;
+        if (bytes != nullptr && elementSize() == sizeof(T)) {
+            view.bytes = bytes;
+            view.count = count;
+            view.stride = stride;
+        }
+        return view;
+    }
+
+    /**
+     * @brief Read element i of an unsigned integer SCALAR accessor (indices)
+     */
+    uint32_t index(size_t i) const;
+};
+
+/**
+ * @brief Accessor numbers of one draw of a mesh (glTF primitive), -1 if absent
+ */
+struct GltfPrimitive {
+    int position = -1;                    ///< POSITION, float VEC3
+    int normal = -1;                      ///< NORMAL, float VEC3
+    int texCoord = -1;                    ///< TEXCOORD_0, float VEC2 (or normalized integers)
+    int tangent = -1;                     ///< TANGENT, float VEC4
+    int indices = -1;                     ///< Indices, -1 for non-indexed geometry
+    int material = -1;                    ///< Index into getMaterials(), -1 for the default material
+    uint32_t mode = 4;                    ///< Topology, 4 is a triangle list (the only one converted to IndexedMesh)
+};
+
+/**
+ * @brief A mesh: a list of primitives, drawn by every node that references it
+ */
+struct GltfMesh {
+    std::string name;
+    std::vector<GltfPrimitive> primitives;
+};
+
+/**
+ * @brief Reference to a texture from a material, with the texture coordinate set it uses
+ */
+struct GltfTextureRef {
+    int image = -1;                       ///< Index into getImages(), -1 if the slot is empty
+    uint32_t texCoord = 0;                ///< TEXCOORD_n used for the lookup
+};
+
+/**
+ * @brief Alpha handling of a material
+ */
+enum class GltfAlphaMode {
+    Opaque,
+    Mask,                                 ///< Alpha below alphaCutoff is discarded
+    Blend
+};
+
+/**
+ * @brief Metallic-roughness PBR material
+ */
+struct GltfMaterial {
+    std::string name;
+    float baseColorFactor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    float metallicFactor = 1.0f;
+    float roughnessFactor = 1.0f;
+    float emissiveFactor[3] = {0.0f, 0.0f, 0.0f};
+    GltfTextureRef baseColorTexture;      ///< sRGB base color (RGB) and alpha
+    GltfTextureRef metallicRoughnessTexture; ///< Roughness in G, metalness in B
+    GltfTextureRef normalTexture;         ///< Tangent space normal map
+    GltfTextureRef occlusionTexture;      ///< Ambient occlusion in R
+    GltfTextureRef emissiveTexture;       ///< sRGB emissive color
+    float normalScale = 1.0f;
+    float occlusionStrength = 1.0f;
+    GltfAlphaMode alphaMode = GltfAlphaMode::Opaque;
+    float alphaCutoff = 0.5f;
+    bool doubleSided = false;
+};
+
+/**
+ * @brief An image: a file next to the glTF, or encoded bytes inside a buffer
+ */
+struct GltfImage {
+    std::string name;
+    std::string uri;                      ///< Path relative to the glTF file, empty for embedded images
+    std::string mimeType;                 ///< image/png or image/jpeg for embedded images
+    const char* bytes = nullptr;          ///< Encoded embedded image inside the mapping, nullptr otherwise
+    size_t size = 0;                      ///< Bytes of the embedded image
+};
+
+/**
+ * @brief A node of the scene hierarchy
+ */
+struct GltfNode {
+    std::string name;
+    int parent = -1;                      ///< Parent node, -1 for roots
+    std::vector<int> children;
+    int mesh = -1;                        ///< Drawn mesh, -1 if none
+    float localMatrix[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}; ///< Transform relative to the parent, column major
+    float worldMatrix[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}; ///< Transform to the scene, column major
+};
+
+/**
+ * @brief One drawn copy of a mesh
+ */
+struct GltfInstance {
+    int node;                             ///< Node the instance comes from
+    int mesh;                             ///< Index into getMeshes()
+    float worldMatrix[16];                ///< Model matrix, column major
+};
+
+/**
+ * @brief Loads glTF 2.0 files (.glb, or .gltf with external buffers)
+ * @details The file and all external buffers are memory mapped and never copied: accessors point
+ * straight into the mappings and are read through StridedView. Only the JSON part is parsed,
+ * which for binary glTF is a small fraction of the file, so a load is mostly the bounds checking
+ * of accessors against their buffer views.
+ *
+ * Nodes of the default scene (or of all root nodes if there is no scene) are walked to compute
+ * world matrices; every node with a mesh yields a GltfInstance, so a mesh referenced by many
+ * nodes is stored once and drawn many times.
+ *
+ * Not supported: base64 data URIs, sparse accessors (their data is left empty), morph targets,
+ * skins, animations and cameras.
+ */
+class GltfLoader {
+public:
+    /**
+     * @brief Load a .glb or .gltf file
+     * @param filename Path to the file
+     * @return false if the file cannot be mapped or is not valid glTF 2.0
+     * @note Accessor and embedded image bytes stay valid until the next load or the destruction
+     * of the loader
+     */
+    bool load(const std::string& filename);
+
+    const std::vector<GltfAccessor>& getAccessors() const { return accessors; }
+    const std::vector<GltfMesh>& getMeshes() const { return meshes; }
+    const std::vector<GltfMaterial>& getMaterials() const { return materials; }
+    const std::vector<GltfImage>& getImages() const { return images; }
+    const std::vector<GltfNode>& getNodes() const { return nodes; }
+    const std::vector<GltfInstance>& getInstances() const { return instances; }
+
+    /**
+     * @brief Directory of the loaded file, image uris are relative to it
+     */
+    const std::string& getBasePath() const { return basePath; }
+
+    /**
+     * @brief Copy the triangle list primitives of a mesh into an IndexedMesh
+     * @details Texture coordinates are converted to the OBJ convention (v = 0 at the bottom of
+     * the image) and the tangent signs with them. Tangents are kept only if every primitive has
+     * them; integer texture coordinates are converted to float.
+     * @param mesh Index into getMeshes()
+     * @param layout Vertex layout of the result
+     * @return One submesh per primitive, MaterialId is the glTF material index (NO_MATERIAL for
+     * none), so getMaterialTable() resolves it
+     */
+    IndexedMesh buildIndexedMesh(int mesh, VertexLayout layout = VertexLayout::Interleaved) const;
+
+    /**
+     * @brief The materials as the Material table used by the renderer
+     * @details Kd is the base color factor and map_Kd the path of an external base color image;
+     * the PBR parameters themselves are only in getMaterials().
+     */
+    std::vector<Material> getMaterialTable() const;
+
+private:
+    MappedFile file;                      ///< The .glb / .gltf file
+    std::vector<MappedFile> externalBuffers; ///< Mapped buffers with a file uri
+    std::vector<std::pair<const char*, size_t>> buffers; ///< Every buffer's bytes
+    std::string basePath;                 ///< Directory of the file, for uris
+    std::vector<GltfAccessor> accessors;
+    std::vector<GltfMesh> meshes;
+    std::vector<GltfMaterial> materials;
+    std::vector<GltfImage> images;
+    std::vector<GltfNode> nodes;
+    std::vector<GltfInstance> instances;
+};
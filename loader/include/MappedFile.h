@@ -0,0 +1,75 @@
+/**
+ * @file MappedFile.h
+ * @author zhywyt (zhywyt@yeah.net)
+ * @brief Read-only memory mapped file
+ * @version 0.2
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Read-only view of a whole file mapped into memory
+ * @details Uses mmap on POSIX systems and CreateFileMapping on Windows. The parser walks
+ * std::string_view slices of the mapping directly, so no line or token is ever copied.
+ * An empty file opens successfully and yields an empty view.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    /**
+     * @brief Map a file
+     * @param filename Path to the file
+     */
+    explicit MappedFile(const std::string& filename);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Map a file, releasing any previous mapping
+     * @param filename Path to the file
+     * @return true if the file was opened and mapped
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief Release the mapping
+     */
+    void close();
+
+    /**
+     * @brief Tell the system that the bytes before an offset will not be read again
+     * @param offset End of the consumed range
+     * @details Lets a sequential reader keep its resident memory bounded on files larger
+     * than RAM. The bytes stay readable, they are simply paged in again if touched.
+     */
+    void discard(size_t offset);
+
+    bool isOpen() const { return opened; }
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(bytes, length); }
+
+private:
+    const char* bytes = nullptr;    ///< Start of the mapping (nullptr for empty files)
+    size_t length = 0;              ///< Mapped size in bytes
+    bool opened = false;            ///< Whether open() succeeded
+    size_t discarded = 0;           ///< Bytes already passed to discard()
+#if defined(_WIN32)
+    void* fileHandle = nullptr;     ///< HANDLE of the file
+    void* mappingHandle = nullptr;  ///< HANDLE of the file mapping
+#else
+    int descriptor = -1;            ///< File descriptor
+#endif
+};
@@ -0,0 +1,76 @@
+/**
+ * @file MaterialCache.h
+ * @author zhywyt (zhywyt@yeah.net)
+ * @brief Parsed MTL files shared by the loaders of many models
+ * @version 0.2
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#pragma once
+#include <ModelLoader.h>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Contents of one MTL file
+ */
+struct MaterialFile {
+    bool opened = false;                  ///< Whether the file could be read
+    std::vector<Material> materials;      ///< Definitions in file order, a name may appear twice
+};
+
+/**
+ * @brief Reads every MTL file once for any number of ModelLoader instances
+ * @details Scenes built from many OBJ files usually share a few material libraries. Loaders
+ * that use the same cache (ModelLoader::setMaterialCache) parse each library once; the
+ * others wait for that parse and copy the definitions into their own material table, so the
+ * MaterialIds of every model stay independent.
+ *
+ * The cache is thread safe. Files are keyed by their normalized absolute path and are not
+ * read again when they change on disk, call clear() (or ModelLoader::reloadMaterials) for that.
+ */
+class MaterialCache {
+public:
+    /**
+     * @brief Parses a file into its definitions
+     * @return false if the file cannot be opened
+     */
+    using Reader = std::function<bool(const std::string& path, std::vector<Material>& definitions)>;
+
+    /**
+     * @brief Get a file, reading it with read() if no loader has asked for it yet
+     * @param path MTL path, relative paths are resolved against the working directory
+     * @param read Called at most once per file, on the calling thread, while other callers
+     * for the same file wait
+     * @return Shared contents, never null
+     */
+    std::shared_ptr<const MaterialFile> acquire(const std::string& path, const Reader& read);
+
+    /**
+     * @brief Forget every file, the next acquire reads them again
+     */
+    void clear();
+
+    /**
+     * @brief Number of distinct files read
+     */
+    size_t size() const;
+
+    /**
+     * @brief Number of acquire calls answered without reading the file
+     */
+    size_t reuses() const;
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, std::shared_future<std::shared_ptr<const MaterialFile>>> files; ///< Normalized paths to their (pending) contents
+    size_t reuseCount = 0;
+};
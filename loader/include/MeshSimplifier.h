@@ -0,0 +1,95 @@
+/**
+ * @file MeshSimplifier.h
+ * @author zhywyt (zhywyt@yeah.net)
+ * @brief Quadric edge collapse simplification and LOD chains for indexed meshes
+ * @version 0.2
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#pragma once
+#include <ModelLoader.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Parameters of MeshSimplifier
+ */
+struct SimplifyOptions {
+    float maxError = 1.0f;                ///< Largest collapse error as a fraction of the bounding radius; levels that would exceed it keep more triangles
+    bool lockBorder = false;              ///< Keep open mesh borders in place (for meshes that must stay crack-free against neighbours)
+};
+
+/**
+ * @brief One level of detail: a triangle list over the vertices of the source mesh
+ */
+struct LodLevel {
+    std::vector<uint32_t> indices;        ///< Three vertex indices per triangle, into the source mesh
+    std::vector<Submesh> submeshes;       ///< Material runs, in the order of the source submeshes (empty runs dropped)
+    float error = 0.0f;                   ///< Largest geometric deviation from the source, in model units
+};
+
+/**
+ * @brief Levels of detail of a mesh, from the full mesh down to the coarsest level
+ */
+struct LodChain {
+    std::vector<LodLevel> levels;         ///< levels[0] is the source mesh, detail decreases with the index
+    float center[3] = {0.0f, 0.0f, 0.0f}; ///< Bounding sphere of the source vertices, in model units
+    float radius = 0.0f;
+
+    /**
+     * @brief The coarsest level whose error stays below a screen space tolerance
+     * @param pixelsPerUnit Size on screen of one model unit at the object's distance
+     * @param maxPixelError Largest acceptable deviation in pixels
+     * @return Level index, 0 if even the first simplified level is too coarse
+     */
+    size_t selectLevel(float pixelsPerUnit, float maxPixelError = 1.0f) const;
+
+    /**
+     * @brief Expand a level into per-triangle output, e.g. for the renderers
+     * @param mesh Mesh the chain was built from (either vertex layout)
+     * @param level Level index
+     * @return Triangles in the same form as ModelLoader::getTriangles
+     */
+    std::vector<Triangle> getTriangles(const IndexedMesh& mesh, size_t level) const;
+};
+
+/**
+ * @brief Mesh simplification by quadric error metric edge collapses (Garland & Heckbert)
+ * @details Every collapse moves a vertex onto a neighbouring vertex, so the simplified levels
+ * reuse the vertex buffer of the source and only differ in their index buffers.
+ *
+ * Vertices that share a position but not their texture coordinate or normal form a seam.
+ * Each vertex is classified on the welded (position only) topology as:
+ * - manifold: may collapse onto any neighbour;
+ * - border (on an open edge) and seam: may only slide along their border / seam, both sides
+ *   of a seam collapse together so UVs and normals never tear;
+ * - locked (corners, seams that meet, material boundaries, non-manifold vertices): never moves.
+ * Border and seam edges add a perpendicular plane to the quadrics, so they keep their shape.
+ * Collapses that would flip a triangle are rejected.
+ *
+ * Collapses are done in passes: every pass sorts all valid collapses by error and applies the
+ * cheapest ones that do not touch each other, until the triangle budget is met.
+ */
+class MeshSimplifier {
+public:
+    /**
+     * @brief Build a LOD chain with one level per ratio
+     * @param mesh Source mesh (either vertex layout)
+     * @param ratios Triangle budgets relative to the source, in decreasing order
+     * @param options Error limit and border handling
+     * @return levels[0] is the source, followed by one level per ratio
+     */
+    static LodChain buildLodChain(const IndexedMesh& mesh, const std::vector<float>& ratios = {0.5f, 0.25f, 0.125f},
+                                  const SimplifyOptions& options = {});
+
+    /**
+     * @brief Simplify to a single triangle budget
+     * @param mesh Source mesh
+     * @param ratio Triangle budget relative to the source
+     * @param options Error limit and border handling
+     */
+    static LodLevel simplify(const IndexedMesh& mesh, float ratio, const SimplifyOptions& options = {});
+};
@@ -0,0 +1,80 @@
+/**
+ * @file MeshletBuilder.h
+ * @author zhywyt (zhywyt@yeah.net)
+ * @brief Meshlet partitioning with bounding spheres and normal cones for cluster culling
+ * @version 0.2
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#pragma once
+#include <ModelLoader.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Parameters of MeshletBuilder::build
+ */
+struct MeshletOptions {
+    uint32_t maxVertices = 64;            ///< Vertices per meshlet, at most 256 (local indices are 8 bit)
+    uint32_t maxTriangles = 124;          ///< Triangles per meshlet, at most 255
+    float coneWeight = 0.5f;              ///< How much a narrow normal cone counts against sharing vertices, 0 to ignore
+};
+
+/**
+ * @brief A small cluster of triangles with its culling bounds
+ * @details The triangle corners are 8-bit indices into the meshlet's vertex list, which in turn
+ * holds indices into the vertices of the source IndexedMesh.
+ */
+struct Meshlet {
+    uint32_t vertexOffset;                ///< First entry in MeshletMesh::vertices
+    uint32_t triangleOffset;              ///< First entry in MeshletMesh::triangles (3 per triangle)
+    uint32_t vertexCount;                 ///< Number of vertices
+    uint32_t triangleCount;               ///< Number of triangles
+    MaterialId material;                  ///< Material of the submesh the triangles come from
+    float center[3];                      ///< Bounding sphere of the vertices
+    float radius;
+    float coneAxis[3];                    ///< Average facing direction of the triangles (unit length)
+    float coneCutoff;                     ///< sin of the cone's half angle, 1 if the triangles face too many ways to cull
+};
+
+/**
+ * @brief Meshlets of an IndexedMesh
+ */
+struct MeshletMesh {
+    std::vector<Meshlet> meshlets;        ///< Meshlets, grouped by submesh in submesh order
+    std::vector<uint32_t> vertices;       ///< Vertex indices into the source mesh, per meshlet
+    std::vector<uint8_t> triangles;       ///< Three local vertex indices per triangle, per meshlet
+};
+
+/**
+ * @brief Splits indexed meshes into meshlets for per-cluster culling
+ * @details Triangles are gathered greedily: a meshlet grows by the neighbouring triangle that adds
+ * the fewest new vertices and keeps the normal cone narrow, and starts a new meshlet when the vertex
+ * or triangle limit is reached or no neighbour is left. Meshlets never mix submeshes, so each one
+ * has a single material.
+ *
+ * Every meshlet carries a bounding sphere (frustum and occlusion tests) and a normal cone: when the
+ * viewer is inside the cone's back side, every triangle of the meshlet faces away
+ * (isBackfacing).
+ */
+class MeshletBuilder {
+public:
+    /**
+     * @brief Partition a mesh
+     * @param mesh Source mesh (either vertex layout)
+     * @param options Size limits
+     * @return Meshlets and their vertex and triangle lists
+     */
+    static MeshletMesh build(const IndexedMesh& mesh, const MeshletOptions& options = {});
+
+    /**
+     * @brief Whether all triangles of a meshlet face away from a viewpoint
+     * @param meshlet Meshlet with its bounds
+     * @param eye Viewpoint in the mesh's coordinate system
+     * @return true if the meshlet can be skipped for single sided rendering
+     */
+    static bool isBackfacing(const Meshlet& meshlet, const float eye[3]);
+};
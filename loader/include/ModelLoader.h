@@ -9,9 +9,19 @@
  * 
  */
 #pragma once
+#include <AlignedAllocator.h>
+#include <MappedFile.h>
+#include <MonotonicArena.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <map>
+#include <unordered_map>
 
 /**
  * @brief Represents a 3D vertex position
@@ -34,11 +44,31 @@ struct Normal {
     float x, y, z;
 };
 
+/**
+ * @brief Tangent space of a vertex, for normal mapping
+ * @details The bitangent is w * cross(normal, tangent), w is 1 or -1 depending on whether
+ * the texture is mirrored (the MikkTSpace convention).
+ */
+struct Tangent {
+    float x, y, z, w;
+};
+
+/**
+ * @brief Index of a material in ModelLoader::getMaterials
+ */
+using MaterialId = uint16_t;
+
+/**
+ * @brief MaterialId of faces without a usemtl statement
+ */
+constexpr MaterialId NO_MATERIAL = 0xFFFF;
+
 /**
  * @brief Material information from MTL files
  */
 struct Material {
     std::string name;                     ///< Material name
+    bool defined = false;                 ///< Whether an MTL file defined it (false if only named by usemtl)
     float ambient[3] = {0.2f, 0.2f, 0.2f};    ///< Ambient color (Ka)
     float diffuse[3] = {0.8f, 0.8f, 0.8f};    ///< Diffuse color (Kd)
     float specular[3] = {0.0f, 0.0f, 0.0f};   ///< Specular color (Ks)
@@ -79,40 +109,293 @@ struct Triangle {
     Normal n0, n1, n2;                   ///< Vertex normals (if available)
     bool hasTextures;                     ///< Whether texture coordinates are available
     bool hasNormals;                      ///< Whether vertex normals are available
-    std::string materialName;             ///< Name of the material used by this triangle
-    const Material* material;             ///< Pointer to the material (set after materials are loaded)
+    MaterialId materialId;                ///< Material used by this triangle, NO_MATERIAL if none
     
     /**
      * @brief Constructor
      */
-    Triangle() : hasTextures(false), hasNormals(false), material(nullptr) {}
+    Triangle() : hasTextures(false), hasNormals(false), materialId(NO_MATERIAL) {}
+    
+    /**
+     * @brief Look up the material of this triangle
+     * @param materials Material table the triangle was loaded with (ModelLoader::getMaterials)
+     * @return nullptr if the triangle has no material or no MTL file defined it
+     */
+    const Material* getMaterial(const std::vector<Material>& materials) const {
+        if (materialId == NO_MATERIAL || materialId >= materials.size() || !materials[materialId].defined) {
+            return nullptr;
+        }
+        return &materials[materialId];
+    }
     
     /**
      * @brief Check if this triangle has a valid material assigned
-     * @return true if material is not null
+     * @param materials Material table the triangle was loaded with
+     * @return true if the material exists and is defined
      */
-    bool hasMaterial() const {
-        return material != nullptr;
+    bool hasMaterial(const std::vector<Material>& materials) const {
+        return getMaterial(materials) != nullptr;
     }
     
     /**
      * @brief Check if this triangle has a diffuse texture
+     * @param materials Material table the triangle was loaded with
      * @return true if material exists and has a diffuse texture
      */
-    bool hasDiffuseTexture() const {
+    bool hasDiffuseTexture(const std::vector<Material>& materials) const {
+        const Material* material = getMaterial(materials);
         return material != nullptr && !material->diffuseTexture.empty();
     }
     
     /**
      * @brief Get the diffuse texture filename
+     * @param materials Material table the triangle was loaded with
      * @return Empty string if no texture, otherwise the texture filename
      */
-    const std::string& getDiffuseTexture() const {
+    const std::string& getDiffuseTexture(const std::vector<Material>& materials) const {
         static const std::string empty;
+        const Material* material = getMaterial(materials);
         return (material != nullptr) ? material->diffuseTexture : empty;
     }
 };
 
+/**
+ * @brief A unique vertex of an IndexedMesh
+ * @details Attributes a face corner does not reference are zero.
+ */
+struct MeshVertex {
+    Vertex position;                      ///< Vertex position
+    TextureCoord texCoord;                ///< Texture coordinate
+    Normal normal;                        ///< Vertex normal
+};
+
+/**
+ * @brief Vertex attributes of an IndexedMesh as separate 64-byte aligned streams
+ * @details Every component has its own array (structure of arrays), so SIMD code can load
+ * 4, 8 or 16 consecutive vertices of one component without gathering or swizzling. Each
+ * array is zero-padded to a multiple of PADDING elements, so vector loops over
+ * [0, paddedCount()) need no scalar tail.
+ */
+struct VertexStreams {
+    static constexpr size_t ALIGNMENT = 64;                       ///< Alignment of every array in bytes
+    static constexpr size_t PADDING = ALIGNMENT / sizeof(float);  ///< Array lengths are multiples of this
+
+    AlignedFloatArray positionX, positionY, positionZ;  ///< Vertex positions
+    AlignedFloatArray normalX, normalY, normalZ;        ///< Vertex normals
+    AlignedFloatArray texCoordU, texCoordV;             ///< Texture coordinates
+    size_t count = 0;                                   ///< Number of vertices, without padding
+
+    /**
+     * @brief Length of every array, count rounded up to PADDING
+     */
+    size_t paddedCount() const {
+        return (count + PADDING - 1) / PADDING * PADDING;
+    }
+
+    /**
+     * @brief Reserve space for a number of vertices
+     */
+    void reserve(size_t vertexCount) {
+        const size_t padded = (vertexCount + PADDING - 1) / PADDING * PADDING;
+        for (AlignedFloatArray* stream : all()) {
+            stream->reserve(padded);
+        }
+    }
+
+    /**
+     * @brief Append a vertex, the arrays are padded again by pad()
+     */
+    void push_back(const Vertex& position, const TextureCoord& texCoord, const Normal& normal) {
+        positionX.push_back(position.x);
+        positionY.push_back(position.y);
+        positionZ.push_back(position.z);
+        normalX.push_back(normal.x);
+        normalY.push_back(normal.y);
+        normalZ.push_back(normal.z);
+        texCoordU.push_back(texCoord.u);
+        texCoordV.push_back(texCoord.v);
+        ++count;
+    }
+
+    /**
+     * @brief Zero-fill every array up to paddedCount()
+     */
+    void pad() {
+        for (AlignedFloatArray* stream : all()) {
+            stream->resize(paddedCount(), 0.0f);
+        }
+    }
+
+    /**
+     * @brief Drop the zero padding so that push_back appends after the last vertex
+     */
+    void unpad() {
+        for (AlignedFloatArray* stream : all()) {
+            stream->resize(count);
+        }
+    }
+
+    /**
+     * @brief Remove all vertices
+     */
+    void clear() {
+        for (AlignedFloatArray* stream : all()) {
+            stream->clear();
+        }
+        count = 0;
+    }
+
+private:
+    std::array<AlignedFloatArray*, 8> all() {
+        return {&positionX, &positionY, &positionZ, &normalX, &normalY, &normalZ, &texCoordU, &texCoordV};
+    }
+};
+
+/**
+ * @brief A run of consecutive triangles sharing one material
+ */
+struct Submesh {
+    uint32_t firstIndex;                  ///< First entry in IndexedMesh::indices
+    uint32_t indexCount;                  ///< Number of indices (3 per triangle)
+    MaterialId material;                  ///< Material of the run, NO_MATERIAL if none
+};
+
+/**
+ * @brief Indexed triangle mesh with vertices shared between triangles
+ * @details Face corners with the same (v, vt, vn) triple map to one MeshVertex, so the
+ * mesh needs 12 bytes of indices per triangle plus the shared vertices, instead of a full
+ * Triangle. Triangles keep file order and are grouped into submeshes by material.
+ */
+struct IndexedMesh {
+    std::vector<MeshVertex> vertices;     ///< Unique vertices (VertexLayout::Interleaved)
+    VertexStreams streams;                ///< Unique vertices (VertexLayout::Streams)
+    std::vector<uint32_t> indices;        ///< Three vertex indices per triangle
+    std::vector<Submesh> submeshes;       ///< Material runs covering all indices
+    std::vector<Tangent> tangents;        ///< One per vertex in either layout if generated (TangentGenerator), empty otherwise
+    bool hasTexCoords = false;            ///< Whether any vertex references a texture coordinate
+    bool hasNormals = false;              ///< Whether any vertex references a normal
+
+    /**
+     * @brief Number of unique vertices in either layout
+     */
+    size_t vertexCount() const {
+        return vertices.empty() ? streams.count : vertices.size();
+    }
+
+    /**
+     * @brief A vertex in either layout
+     */
+    MeshVertex vertex(size_t i) const {
+        if (!vertices.empty()) {
+            return vertices[i];
+        }
+        return {{streams.positionX[i], streams.positionY[i], streams.positionZ[i]},
+                {streams.texCoordU[i], streams.texCoordV[i]},
+                {streams.normalX[i], streams.normalY[i], streams.normalZ[i]}};
+    }
+
+    /**
+     * @brief Remove all data
+     */
+    void clear() {
+        vertices.clear();
+        streams.clear();
+        indices.clear();
+        submeshes.clear();
+        tangents.clear();
+        hasTexCoords = false;
+        hasNormals = false;
+    }
+};
+
+/**
+ * @brief Non-owning view of VertexStreams
+ */
+struct VertexStreamsView {
+    const float* positionX = nullptr;     ///< Vertex positions
+    const float* positionY = nullptr;
+    const float* positionZ = nullptr;
+    const float* normalX = nullptr;       ///< Vertex normals
+    const float* normalY = nullptr;
+    const float* normalZ = nullptr;
+    const float* texCoordU = nullptr;     ///< Texture coordinates
+    const float* texCoordV = nullptr;
+    size_t count = 0;                     ///< Number of vertices
+    size_t paddedCount = 0;               ///< Length of every array
+};
+
+/**
+ * @brief Non-owning view of the geometry of an IndexedMesh
+ * @details Points either into ModelLoader's IndexedMesh or straight into a memory mapped
+ * .srmesh cache file. Only the arrays of the requested VertexLayout are set.
+ */
+struct IndexedMeshView {
+    const MeshVertex* vertices = nullptr; ///< Interleaved vertices (VertexLayout::Interleaved)
+    VertexStreamsView streams;            ///< Vertex streams (VertexLayout::Streams)
+    size_t vertexCount = 0;               ///< Number of unique vertices
+    const uint32_t* indices = nullptr;    ///< Three vertex indices per triangle
+    size_t indexCount = 0;                ///< Number of indices
+    const Submesh* submeshes = nullptr;   ///< Material runs covering all indices
+    size_t submeshCount = 0;              ///< Number of submeshes
+    const Tangent* tangents = nullptr;    ///< One tangent per vertex, nullptr if none were generated
+    bool hasTexCoords = false;            ///< Whether any vertex references a texture coordinate
+    bool hasNormals = false;              ///< Whether any vertex references a normal
+};
+
+/**
+ * @brief Memory layout of the IndexedMesh vertices
+ */
+enum class VertexLayout {
+    Interleaved,                          ///< One MeshVertex per vertex (IndexedMesh::vertices)
+    Streams                               ///< One aligned array per component (IndexedMesh::streams)
+};
+
+/**
+ * @brief Selects the outputs built by ModelLoader::loadModel
+ */
+struct LoadOptions {
+    bool triangles = true;                ///< Build the per-triangle output (getTriangles)
+    bool indexedMesh = false;             ///< Build the deduplicated output (getIndexedMesh)
+    VertexLayout vertexLayout = VertexLayout::Interleaved; ///< Vertex layout of the indexed mesh
+    bool useCache = false;                ///< Read / write a .srmesh cache next to the OBJ (indexed output only)
+    bool verifyCacheHash = false;         ///< Hash the sources even if their size and modification time match
+    bool optimizeMesh = false;            ///< Reorder the indexed mesh for the vertex cache, overdraw and vertex fetch (MeshOptimizer)
+    bool generateNormals = false;         ///< Compute normals for faces without vn from their smoothing groups (NormalGenerator)
+    float creaseAngle = 180.0f;           ///< Generated normals: degrees between faces beyond which an edge stays hard, 180 for groups only
+    bool generateTangents = false;        ///< Compute MikkTSpace tangents for the indexed mesh (TangentGenerator), needs normals and texture coordinates
+    bool singleBlockMesh = false;         ///< Move the indexed mesh into one arena block, read through getIndexedMeshView
+};
+
+/**
+ * @brief Vertex cache efficiency of an indexed mesh before and after MeshOptimizer
+ */
+struct MeshOptimizeStats {
+    float acmrBefore = 0.0f;              ///< Average cache miss ratio: transformed vertices per triangle
+    float acmrAfter = 0.0f;
+    float atvrBefore = 0.0f;              ///< Average transformed vertex ratio: transformed vertices per vertex (1 is ideal)
+    float atvrAfter = 0.0f;
+};
+
+/**
+ * @brief Memory taken by the per-chunk parse arrays of the last ModelLoader::loadModel
+ * @details The arrays are reserved from a line count before parsing, so the arena holds about
+ * arrayBytes; arrays that grew while parsing would leave every outgrown copy in the arena.
+ */
+struct ParseMemoryStats {
+    size_t arenaBytes = 0;                ///< Bytes handed out by the chunk arenas
+    size_t arrayBytes = 0;                ///< Bytes of the parsed elements (size times element size of every array)
+    size_t spareElements = 0;             ///< Capacity beyond size, summed over the arrays
+};
+
+/**
+ * @brief Receives the triangles of ModelLoader::streamModel batch by batch
+ * @param batch Triangles parsed since the previous call, in file order. The vector is
+ * reused for the next batch, so copy whatever has to outlive the call.
+ */
+using TriangleBatchCallback = std::function<void(const std::vector<Triangle>& batch)>;
+
+class MaterialCache;
+
 /**
  * @brief Enhanced 3D Model Loader supporting standard OBJ file features
  * @details This class provides comprehensive support for loading standard OBJ files including:
@@ -123,6 +406,7 @@ struct Triangle {
  * - Material library references (mtllib)
  * - Material usage (usemtl)
  * - Object groups (g, o)
+ * - Smoothing groups (s), used by LoadOptions::generateNormals
  * - Comments (#)
  */
 class ModelLoader {
@@ -156,6 +440,36 @@ public:
      */
     bool loadModel(const std::string& filename);
 
+    /**
+     * @brief Load 3D model from OBJ file, building the selected outputs
+     * @param filename Path to the OBJ file
+     * @param options Outputs to build; outputs that are not selected are left empty
+     * @details With LoadOptions::generateNormals, triangles that do not reference a normal at all
+     * three corners get generated ones: faces after "s off" / "s 0" are flat, the faces of every
+     * other smoothing group are smoothed together, and faces before the first s line count as one
+     * group. Generated normals are appended to getNormals() after the ones read from the file.
+     * @return true if the file has vertices and at least one triangle
+     */
+    bool loadModel(const std::string& filename, const LoadOptions& options);
+
+    /**
+     * @brief Parse an OBJ file front to back, handing triangles to a callback in batches
+     * @param filename Path to the OBJ file
+     * @param callback Called with every full batch and once with the remaining triangles
+     * @param batchSize Triangles per batch
+     * @details For files that do not fit in memory: triangles are never accumulated and the
+     * parsed part of the file is released from memory as parsing goes on, so memory use is
+     * bounded by one batch plus the v / vt / vn arrays (faces may reference any earlier
+     * element, so those are kept and are available through the getters afterwards).
+     * Material libraries are loaded when their mtllib line is reached. Triangles carry their
+     * Triangle::materialId, which stays valid; during a call getMaterials() holds every material
+     * defined so far, a later mtllib line may still define more.
+     * Parsing runs on the calling thread, normals are not generated.
+     * @return true if at least one triangle was delivered
+     */
+    bool streamModel(const std::string& filename, const TriangleBatchCallback& callback,
+                     size_t batchSize = 65536);
+
     /**
      * @brief Get all vertex positions
      * @return Constant reference to the vector of vertices
@@ -168,6 +482,45 @@ public:
      */
     const std::vector<Triangle>& getTriangles() const;
 
+    /**
+     * @brief Get the indexed mesh
+     * @return Constant reference to the mesh, empty unless LoadOptions::indexedMesh was set
+     * @note After a load from the .srmesh cache or with LoadOptions::singleBlockMesh the mesh is
+     * empty, the geometry is available through getIndexedMeshView
+     */
+    const IndexedMesh& getIndexedMesh() const;
+
+    /**
+     * @brief Get a view of the indexed geometry, wherever it is stored
+     * @return View into the IndexedMesh, into the mapped cache file after a cached load, or into
+     * the mesh block (LoadOptions::singleBlockMesh); valid until the next loadModel call or the
+     * destruction of the loader
+     */
+    IndexedMeshView getIndexedMeshView() const;
+
+    /**
+     * @brief Whether the last loadModel call was served from the .srmesh cache
+     */
+    bool isLoadedFromCache() const;
+
+    /**
+     * @brief Vertex cache statistics of the last load with LoadOptions::optimizeMesh
+     * @return ACMR and ATVR before and after optimization (also restored from the cache),
+     * all zero if the mesh was not optimized
+     */
+    const MeshOptimizeStats& getOptimizeStats() const;
+
+    /**
+     * @brief Memory of the per-chunk parse arrays of the last parsed load
+     * @return Arena and array bytes, all zero after a cached load or streamModel
+     */
+    const ParseMemoryStats& getParseMemoryStats() const;
+
+    /**
+     * @brief Path of the cache file for an OBJ file (the extension replaced by .srmesh)
+     */
+    static std::string getCachePath(const std::string& filename);
+
     /**
      * @brief Get all texture coordinates
      * @return Constant reference to the vector of texture coordinates
@@ -182,9 +535,33 @@ public:
 
     /**
      * @brief Get all materials
-     * @return Constant reference to the map of materials (name -> material)
+     * @return Constant reference to the material table, indexed by MaterialId
+     * @details A material gets its ID when its name first appears in a usemtl line (in file
+     * order), materials only defined in MTL files follow. Names that no MTL file defines
+     * keep a default entry with Material::defined set to false.
+     */
+    const std::vector<Material>& getMaterials() const;
+
+    /**
+     * @brief Find a material by name
+     * @return The material's ID, NO_MATERIAL if there is none
+     */
+    MaterialId findMaterial(const std::string& name) const;
+
+    /**
+     * @brief MTL files named by the last load, as opened (relative to the working directory)
+     * @details Includes files that could not be opened, so a material library created after
+     * the load can be detected.
      */
-    const std::map<std::string, Material>& getMaterials() const;
+    const std::vector<std::string>& getMaterialSources() const;
+
+    /**
+     * @brief Parse the MTL files of the last load again
+     * @return A new material table in which every existing material keeps its MaterialId, so
+     * triangles and submeshes can switch to it without being rebuilt. Materials no file defines
+     * any more revert to undefined defaults, new ones are appended. The loader is not changed.
+     */
+    std::vector<Material> reloadMaterials() const;
 
     /**
      * @brief Get the current object name
@@ -210,78 +587,261 @@ public:
                       size_t& textureCount, size_t& normalCount, 
                       size_t& materialCount) const;
 
+    /**
+     * @brief Set the number of threads used by loadModel
+     * @param count Thread count, 0 uses all hardware threads (default)
+     * @details Large files are split into newline-aligned chunks that are parsed in parallel.
+     * The result does not depend on the thread count.
+     */
+    void setThreadCount(unsigned int count);
+
+    /**
+     * @brief Share parsed MTL files with other loaders
+     * @param cache Cache used by every following load, nullptr (default) to read the files
+     * directly; it must outlive the loads that use it
+     * @details MaterialIds are still assigned per loader. reloadMaterials always reads the files.
+     */
+    void setMaterialCache(MaterialCache* cache);
+
+    /**
+     * @brief Return the memory kept for the next load to the heap
+     * @details Parse state lives in arenas that are reused by the next loadModel call, so loading
+     * many models in a row allocates (almost) nothing once the largest one has been seen. Call
+     * this after the last load to drop them. The block of LoadOptions::singleBlockMesh is released
+     * too, leaving getIndexedMeshView empty.
+     */
+    void releaseMemory();
+
 private:
+    /**
+     * @brief Smoothing group of the faces before the first s line
+     */
+    static constexpr int UNGROUPED = -2;
+
+    /**
+     * @brief One corner of a face as written in the file (0 for a missing index)
+     */
+    struct FaceCorner {
+        int vertex;
+        int texture;
+        int normal;
+    };
+
+    /**
+     * @brief A face recorded by a chunk, resolved into triangles once all chunks are parsed
+     */
+    struct Face {
+        int cornerCount;      ///< Number of corners, stored consecutively in Chunk::corners
+        int material;         ///< Index into Chunk::materialNames, -1 if set by an earlier chunk
+        int smoothingGroup;   ///< Group of the last s line (0 for off), -1 if set by an earlier chunk
+        size_t vertexCount;   ///< Chunk-local vertex count when the face was read
+        size_t textureCount;  ///< Chunk-local texture coordinate count when the face was read
+        size_t normalCount;   ///< Chunk-local normal count when the face was read
+    };
+
+    /**
+     * @brief Parse state of one newline-aligned piece of the file
+     * @details Chunks only see their own lines. Indices are kept as written and resolved
+     * against the prefix-summed element counts of the preceding chunks, and state that
+     * carries across lines (usemtl, s, o) is fixed up in file order after parsing.
+     * The per-line arrays are allocated from an arena that outlives the load.
+     */
+    struct Chunk {
+        explicit Chunk(std::pmr::memory_resource* arena = std::pmr::get_default_resource())
+            : vertices(arena), textureCoords(arena), normals(arena), corners(arena), faces(arena) {}
+
+        std::string_view text;                   ///< Lines of this chunk
+        std::pmr::vector<Vertex> vertices;       ///< Vertex positions read by this chunk
+        std::pmr::vector<TextureCoord> textureCoords; ///< Texture coordinates read by this chunk
+        std::pmr::vector<Normal> normals;        ///< Vertex normals read by this chunk
+        std::pmr::vector<FaceCorner> corners;    ///< Corners of all faces
+        std::pmr::vector<Face> faces;            ///< Faces in file order
+        std::vector<std::string> materialNames;  ///< Names given by usemtl lines
+        std::vector<std::string> materialLibraries; ///< Files named by mtllib lines
+        std::string objectName;                  ///< Last o name of this chunk
+        bool hasObjectName = false;              ///< Whether the chunk contains an o line
+        int currentMaterial = -1;                ///< Active entry of materialNames
+        int currentSmoothingGroup = -1;          ///< Group of the last s line, -1 if there is none
+        std::vector<MaterialId> materialIds;     ///< Interned IDs of materialNames
+        std::vector<std::string_view> tokens;    ///< Token buffer reused across lines
+        size_t vertexBase = 0;                   ///< Vertices read by earlier chunks
+        size_t textureBase = 0;                  ///< Texture coordinates read by earlier chunks
+        size_t normalBase = 0;                   ///< Normals read by earlier chunks
+        size_t triangleBase = 0;                 ///< Triangles emitted by earlier chunks
+        size_t triangleCount = 0;                ///< Triangles emitted by this chunk
+        MaterialId inheritedMaterial = NO_MATERIAL; ///< Material active when the chunk starts
+        int inheritedSmoothingGroup = UNGROUPED; ///< Smoothing group active when the chunk starts
+        size_t generatedBase = 0;                ///< Triangles with generated normals in earlier chunks
+        size_t generatedCount = 0;               ///< Triangles with generated normals in this chunk
+    };
+
     std::vector<Vertex> vertices;              ///< Vertex positions
     std::vector<TextureCoord> textureCoords;   ///< Texture coordinates
     std::vector<Normal> normals;               ///< Vertex normals
     std::vector<Triangle> triangles;           ///< Triangulated faces
-    std::map<std::string, Material> materials; ///< Materials by name
+    IndexedMesh indexedMesh;                   ///< Deduplicated indexed output
+    std::vector<Material> materials;           ///< Material table indexed by MaterialId
+    std::unordered_map<std::string, MaterialId> materialIds; ///< Material names to IDs
     std::string currentObjectName;             ///< Current object name
-    std::string currentMaterial;               ///< Current material name
     std::string basePath;                      ///< Base path for resolving relative file paths
+    std::vector<std::string_view> materialTokens; ///< Token buffer reused across MTL lines
+    unsigned int threadCount = 0;              ///< Parser threads, 0 for all hardware threads
+    MaterialCache* materialCache = nullptr;    ///< Shared parsed MTL files, not owned
+    std::vector<std::string> materialSources;  ///< MTL paths opened (or tried) by the last load
+    MappedFile cacheFile;                      ///< Mapped .srmesh file after a cached load
+    IndexedMeshView cacheView;                 ///< Geometry inside cacheFile
+    MeshOptimizeStats optimizeStats;           ///< Result of MeshOptimizer::optimize on the last load
+    ParseMemoryStats parseStats;               ///< Chunk arena use of the last parsed load
+    std::vector<uint32_t> generatedNormals;    ///< Entry of normals for every corner of a triangle with generated normals, during loadModel
+    std::vector<std::unique_ptr<MonotonicArena>> chunkArenas; ///< Parse state of each chunk, reset by every load
+    std::unique_ptr<MonotonicArena> scratchArena; ///< Temporary tables of a load (vertex deduplication)
+    std::unique_ptr<MonotonicArena> meshArena; ///< Storage of the indexed mesh with LoadOptions::singleBlockMesh
+    IndexedMeshView meshView;                  ///< Geometry inside meshArena, empty unless singleBlockMesh was set
+
+    /**
+     * @brief Arena i of chunkArenas, created on first use and reset for the load
+     */
+    MonotonicArena& chunkArena(size_t i);
+
+    /**
+     * @brief Forget the previous model and its statistics before loadModel or streamModel
+     * @param filename File about to be loaded, gives the base path
+     */
+    void resetState(const std::string& filename);
+
+    /**
+     * @brief Move indexedMesh into a single block of meshArena and point meshView at it
+     */
+    void moveMeshToBlock();
+
+    /**
+     * @brief Parse every line of a chunk
+     * @param chunk Chunk whose text is parsed into its local arrays
+     */
+    void parseChunk(Chunk& chunk);
+
+    /**
+     * @brief Count the triangles the faces of a chunk produce once indices are resolvable
+     * @param chunk Chunk with bases already set
+     * @return Number of triangles
+     */
+    size_t countChunkTriangles(const Chunk& chunk) const;
+
+    /**
+     * @brief Emit the triangles of a chunk into triangles[chunk.triangleBase ...]
+     * @param chunk Chunk with bases and inherited material already set
+     */
+    void emitChunkTriangles(const Chunk& chunk);
+
+    /**
+     * @brief Generate normals for the triangles without file normals (LoadOptions::generateNormals)
+     * @param chunks Chunks in file order with bases, counts and inherited state set
+     * @param options Crease angle
+     * @details Appends the normals to normals and fills generatedNormals in triangle order.
+     */
+    void generateMissingNormals(std::vector<Chunk>& chunks, const LoadOptions& options);
+
+    /**
+     * @brief Build indexedMesh from the faces of all chunks
+     * @param chunks Chunks in file order with bases and inherited materials set
+     * @param layout Layout of the unique vertices
+     */
+    void buildIndexedMesh(const std::vector<Chunk>& chunks, VertexLayout layout);
+
+    /**
+     * @brief Load the indexed mesh, materials and object name from a .srmesh cache
+     * @param filename Path to the OBJ file the cache belongs to
+     * @param options Load options, the vertex layout must match the cache
+     * @return false if there is no valid, up-to-date cache
+     */
+    bool readCache(const std::string& filename, const LoadOptions& options);
+
+    /**
+     * @brief Write the indexed mesh, materials and object name to a .srmesh cache
+     * @param filename Path to the OBJ file the cache belongs to
+     * @param options Options of the load, the vertex layout and optimization are recorded
+     * @return true if the cache file was written
+     */
+    bool writeCache(const std::string& filename, const LoadOptions& options) const;
 
     /**
      * @brief Parse a single line from the OBJ file
-     * @param line The line to parse
+     * @param line The line to parse (a view into the mapped file)
+     * @param chunk Chunk the line belongs to
      * @return true if parsing was successful
      */
-    bool parseLine(const std::string& line);
+    bool parseLine(std::string_view line, Chunk& chunk);
 
     /**
      * @brief Parse vertex position line (v x y z)
      * @param tokens Tokenized line components
+     * @param chunk Chunk the line belongs to
      * @return true if parsing was successful
      */
-    bool parseVertex(const std::vector<std::string>& tokens);
+    bool parseVertex(const std::vector<std::string_view>& tokens, Chunk& chunk);
 
     /**
      * @brief Parse texture coordinate line (vt u v)
      * @param tokens Tokenized line components
+     * @param chunk Chunk the line belongs to
      * @return true if parsing was successful
      */
-    bool parseTextureCoord(const std::vector<std::string>& tokens);
+    bool parseTextureCoord(const std::vector<std::string_view>& tokens, Chunk& chunk);
 
     /**
      * @brief Parse vertex normal line (vn x y z)
      * @param tokens Tokenized line components
+     * @param chunk Chunk the line belongs to
      * @return true if parsing was successful
      */
-    bool parseNormal(const std::vector<std::string>& tokens);
+    bool parseNormal(const std::vector<std::string_view>& tokens, Chunk& chunk);
 
     /**
      * @brief Parse face line (f v1/vt1/vn1 v2/vt2/vn2 v3/vt3/vn3)
      * @param tokens Tokenized line components
+     * @param chunk Chunk the line belongs to
      * @return true if parsing was successful
      */
-    bool parseFace(const std::vector<std::string>& tokens);
+    bool parseFace(const std::vector<std::string_view>& tokens, Chunk& chunk);
 
     /**
      * @brief Parse material library line (mtllib filename.mtl)
      * @param tokens Tokenized line components
+     * @param chunk Chunk the line belongs to
      * @return true if parsing was successful
      */
-    bool parseMaterialLibrary(const std::vector<std::string>& tokens);
+    bool parseMaterialLibrary(const std::vector<std::string_view>& tokens, Chunk& chunk);
 
     /**
      * @brief Parse material usage line (usemtl material_name)
      * @param tokens Tokenized line components
+     * @param chunk Chunk the line belongs to
      * @return true if parsing was successful
      */
-    bool parseUseMaterial(const std::vector<std::string>& tokens);
+    bool parseUseMaterial(const std::vector<std::string_view>& tokens, Chunk& chunk);
 
     /**
      * @brief Parse object name line (o object_name)
      * @param tokens Tokenized line components
+     * @param chunk Chunk the line belongs to
      * @return true if parsing was successful
      */
-    bool parseObjectName(const std::vector<std::string>& tokens);
+    bool parseObjectName(const std::vector<std::string_view>& tokens, Chunk& chunk);
+
+    /**
+     * @brief Parse smoothing group line (s group_number, s off)
+     * @param tokens Tokenized line components
+     * @param chunk Chunk the line belongs to
+     * @return true if parsing was successful
+     */
+    bool parseSmoothingGroup(const std::vector<std::string_view>& tokens, Chunk& chunk);
 
     /**
      * @brief Split a string by whitespace
      * @param str Input string
-     * @return Vector of tokens
+     * @param tokens Output views into str, cleared first so the buffer can be reused
      */
-    std::vector<std::string> tokenize(const std::string& str) const;
+    void tokenize(std::string_view str, std::vector<std::string_view>& tokens) const;
 
     /**
      * @brief Parse face vertex specification (v/vt/vn format)
@@ -291,7 +851,7 @@ private:
      * @param normalIndex Output normal index (1-based, 0 if not specified)
      * @return true if parsing was successful
      */
-    bool parseFaceVertex(const std::string& vertexSpec, int& vertexIndex, 
+    bool parseFaceVertex(std::string_view vertexSpec, int& vertexIndex, 
                         int& textureIndex, int& normalIndex) const;
 
     /**
@@ -302,18 +862,36 @@ private:
      */
     bool loadMaterialFile(const std::string& filename, const std::string& basePath);
 
+    /**
+     * @brief Parse an MTL file into its definitions, without touching the material table
+     * @param path Path to the MTL file
+     * @param definitions Receives the materials in file order
+     * @return false if the file cannot be opened
+     */
+    bool readMaterialFile(const std::string& path, std::vector<Material>& definitions);
+
     /**
      * @brief Parse a single line from MTL file
      * @param line The line to parse
      * @param currentMaterial Reference to current material being parsed
+     * @param definitions Receives currentMaterial when a newmtl line starts the next one
      * @return true if parsing was successful
      */
-    bool parseMaterialLine(const std::string& line, Material& currentMaterial);
+    bool parseMaterialLine(std::string_view line, Material& currentMaterial, std::vector<Material>& definitions);
+
+    /**
+     * @brief Get the ID of a material name, adding an undefined entry for a new name
+     * @return The ID, NO_MATERIAL if the table is full
+     */
+    MaterialId internMaterial(const std::string& name);
+
+    /**
+     * @brief Intern the usemtl names a chunk has not interned yet
+     */
+    void internChunkMaterials(Chunk& chunk);
 
     /**
-     * @brief Update material pointers in all triangles after materials are loaded
-     * @details This function should be called after all materials are loaded to set
-     * the material pointers in triangles based on their material names
+     * @brief Print a warning for every used material no MTL file defined
      */
-    void updateTriangleMaterialPointers();
+    void reportUndefinedMaterials() const;
 };
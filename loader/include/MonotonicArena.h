@@ -0,0 +1,89 @@
+/**
+ * @file MonotonicArena.h
+ * @author zhywyt (zhywyt@yeah.net)
+ * @brief Bump allocator for parse state that is freed all at once
+ * @version 0.2
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * @brief Memory resource handing out consecutive pieces of large blocks
+ * @details Allocation bumps a pointer and deallocation does nothing; memory comes back only
+ * through reset() or release(). Use it with std::pmr containers for data that lives exactly as
+ * long as one load.
+ *
+ * reset() keeps the memory for the next round. If the round needed more than one block, the
+ * blocks are replaced by a single one as large as all of them together, so repeating a workload
+ * of the same size allocates nothing from the heap and the heap sees one long-lived block
+ * instead of many short-lived ones.
+ */
+class MonotonicArena : public std::pmr::memory_resource {
+public:
+    /**
+     * @param initialBlockSize Bytes of the first block, later blocks double in size
+     */
+    explicit MonotonicArena(size_t initialBlockSize = 64 * 1024);
+    ~MonotonicArena() override;
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    /**
+     * @brief Invalidate every allocation and keep the memory for reuse
+     */
+    void reset();
+
+    /**
+     * @brief Invalidate every allocation and return all blocks to the heap
+     */
+    void release();
+
+    /**
+     * @brief Bytes handed out since the last reset, including alignment padding
+     */
+    size_t bytesUsed() const { return used; }
+
+    /**
+     * @brief Bytes of all blocks held
+     */
+    size_t capacity() const;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    /**
+     * @brief Alignment of every block, a cache line
+     */
+    static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;            ///< Blocks in allocation order, the last one is being filled
+    char* cursor = nullptr;               ///< Next free byte of the current block
+    char* limit = nullptr;                ///< End of the current block
+    size_t used = 0;                      ///< Bytes handed out since the last reset
+    size_t initialBlockSize;              ///< Size of the first block
+
+    /**
+     * @brief Continue in a new block with room for bytes at the given alignment
+     */
+    void addBlock(size_t bytes, size_t alignment);
+
+    /**
+     * @brief Return every block to the heap
+     */
+    void freeBlocks();
+};
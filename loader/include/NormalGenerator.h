@@ -0,0 +1,63 @@
+/**
+ * @file NormalGenerator.h
+ * @author zhywyt (zhywyt@yeah.net)
+ * @brief Smooth vertex normals from smoothing groups and a crease angle
+ * @version 0.2
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#pragma once
+#include <ModelLoader.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Parameters of NormalGenerator::generate
+ */
+struct NormalOptions {
+    float creaseAngle = 180.0f;           ///< Degrees between two faces beyond which their shared edge stays hard, 180 to smooth whole groups
+    unsigned int threadCount = 0;         ///< Threads, 0 for all hardware threads
+};
+
+/**
+ * @brief Normals of a triangle list, shared between the corners that are smoothed together
+ */
+struct GeneratedNormals {
+    std::vector<Normal> normals;          ///< Unit normals (zero for corners of isolated degenerate triangles)
+    std::vector<uint32_t> cornerNormals;  ///< Entry of normals for every triangle corner
+};
+
+/**
+ * @brief Computes vertex normals for triangles that have none
+ * @details The normal of a corner is the sum of the face normals around its position, each
+ * weighted by the face's area and by its angle at that position (so neither long thin triangles
+ * nor fans of many small ones pull the normal to their side). Only faces of the corner's
+ * smoothing group take part, and with a crease angle below 180 degrees only those whose face
+ * normal is within the angle of the corner's own face. Faces in group FLAT get their face normal.
+ *
+ * The work is split by position, not by triangle: every position gathers the corners around it
+ * from an adjacency table and writes only its own corners, so the threads never add into a shared
+ * vertex and no atomics or locks are needed. Corners of one position that end up with the same
+ * normal share one entry of GeneratedNormals::normals.
+ */
+class NormalGenerator {
+public:
+    static constexpr uint32_t FLAT = 0;   ///< Smoothing group of faces that are not smoothed (s off)
+
+    /**
+     * @brief Generate normals
+     * @param positions Vertex positions
+     * @param vertexCount Number of positions
+     * @param indices Three position indices per triangle
+     * @param indexCount Number of indices
+     * @param smoothingGroups Smoothing group of every triangle
+     * @param options Crease angle and thread count
+     * @return Normals and the normal of every corner
+     */
+    static GeneratedNormals generate(const Vertex* positions, size_t vertexCount, const uint32_t* indices,
+                                     size_t indexCount, const uint32_t* smoothingGroups,
+                                     const NormalOptions& options = {});
+};
@@ -0,0 +1,118 @@
+/**
+ * @file PlyLoader.h
+ * @author zhywyt (zhywyt@yeah.net)
+ * @brief PLY (Stanford polygon file) loader for large scans, binary and ASCII
+ * @version 0.2
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#pragma once
+#include <ModelLoader.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Encoding of the PLY body
+ */
+enum class PlyFormat {
+    Ascii,
+    BinaryLittleEndian,
+    BinaryBigEndian
+};
+
+/**
+ * @brief Scalar types of PLY properties
+ */
+enum class PlyType : uint8_t {
+    Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64
+};
+
+/**
+ * @brief A property declared in the header
+ */
+struct PlyProperty {
+    std::string name;
+    PlyType type = PlyType::Float32;      ///< Type of the value, or of the list items
+    bool isList = false;                  ///< Whether the property is a list (property list ...)
+    PlyType countType = PlyType::UInt8;   ///< Type of the list length
+};
+
+/**
+ * @brief An element declared in the header (vertex, face, or anything else)
+ */
+struct PlyElement {
+    std::string name;
+    size_t count = 0;                     ///< Number of rows
+    std::vector<PlyProperty> properties;
+};
+
+/**
+ * @brief Per-vertex colors as separate arrays, one byte per channel
+ */
+struct PlyColors {
+    std::vector<uint8_t> red, green, blue, alpha;  ///< alpha is 255 if the file has none
+
+    bool empty() const {
+        return red.empty();
+    }
+};
+
+/**
+ * @brief Loads point clouds and meshes from PLY files
+ * @details The vertex element fills the streams of an IndexedMesh (VertexLayout::Streams):
+ * x/y/z, nx/ny/nz and u/v (or s/t, texture_u/texture_v) go into their own float arrays, and
+ * red/green/blue/alpha into PlyColors. The face element's vertex_indices lists are
+ * triangulated as fans into IndexedMesh::indices; a file without faces is a point cloud.
+ *
+ * Binary bodies are memory mapped and never copied. When every row of an element has the same
+ * size (no list properties, or lists that all have the length of the first row, as in an all
+ * triangle mesh), row i starts at i times the row size and every attribute is converted column
+ * by column straight from the mapping into its array, split across threads. Other elements are
+ * walked row by row. ASCII bodies are split into newline aligned chunks that are parsed in
+ * parallel, like OBJ files.
+ *
+ * Faces with an index outside the vertex element are dropped.
+ */
+class PlyLoader {
+public:
+    /**
+     * @brief Load a PLY file
+     * @param filename Path to the file
+     * @return false if the file cannot be opened, the header is invalid or the body is truncated
+     */
+    bool load(const std::string& filename);
+
+    /**
+     * @brief Vertices in VertexLayout::Streams and triangle indices
+     */
+    const IndexedMesh& getMesh() const { return mesh; }
+
+    /**
+     * @brief Vertex colors, empty if the vertices have no red/green/blue
+     */
+    const PlyColors& getColors() const { return colors; }
+
+    /**
+     * @brief Elements and properties declared in the header
+     */
+    const std::vector<PlyElement>& getElements() const { return elements; }
+
+    PlyFormat getFormat() const { return format; }
+
+    /**
+     * @brief Set the number of threads used for conversion and ASCII parsing
+     * @param count Thread count, 0 for all hardware threads
+     */
+    void setThreadCount(unsigned int count) { threadCount = count; }
+
+private:
+    IndexedMesh mesh;
+    PlyColors colors;
+    std::vector<PlyElement> elements;
+    PlyFormat format = PlyFormat::Ascii;
+    unsigned int threadCount = 0;         ///< Threads, 0 for all hardware threads
+};
@@ -0,0 +1,44 @@
+/**
+ * @file TangentGenerator.h
+ * @author zhywyt (zhywyt@yeah.net)
+ * @brief MikkTSpace compatible tangent generation for indexed meshes
+ * @version 0.2
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#pragma once
+#include <ModelLoader.h>
+#include <cstddef>
+
+/**
+ * @brief Computes per-vertex tangents of an IndexedMesh the way MikkTSpace does
+ * @details Normal maps baked by the common tools (Blender, Substance, xNormal) assume the
+ * MikkTSpace tangent basis, so the tangents have to be reproduced exactly rather than
+ * approximated. For every triangle the texture space direction of increasing u is computed and
+ * normalized, and flipped on mirrored triangles. A vertex then sums, per group, the directions
+ * of its triangles projected into the plane of its normal and weighted by the triangle's angle at
+ * the vertex (also measured in that plane). A group is a fan of triangles around the vertex that
+ * are connected through shared edges and agree on being mirrored or not; w of the tangent
+ * records which.
+ *
+ * A vertex whose triangles form more than one group (a mirror seam running through it) is split,
+ * the copies are appended to the vertices and the indices of the affected triangles are updated.
+ * Triangles with degenerate texture coordinates take the mirroring of an edge neighbour; corners
+ * that belong to no group get MikkTSpace's default tangent (1, 0, 0). Polygons are triangulated
+ * before MikkTSpace sees them, so its quad specific orientation rule does not apply.
+ *
+ * The per-triangle directions and the per-vertex sums run in parallel; every vertex only reads
+ * its adjacent triangles and writes its own corners.
+ */
+class TangentGenerator {
+public:
+    /**
+     * @brief Fill mesh.tangents, splitting vertices where needed
+     * @param mesh Mesh with normals and texture coordinates, in either vertex layout
+     * @param threadCount Threads, 0 for all hardware threads
+     * @return false (and the mesh unchanged) if it has no normals or no texture coordinates
+     */
+    static bool generate(IndexedMesh& mesh, unsigned int threadCount = 0);
+};
@@ -0,0 +1,188 @@
+#include <FileWatcher.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Events that mean a file has new contents: closed after writing, renamed into place,
+ * or touched
+ */
+#if defined(__linux__)
+constexpr uint32_t WATCH_EVENTS = IN_CLOSE_WRITE | IN_MOVED_TO | IN_ATTRIB;
+#endif
+
+/**
+ * @brief Interval between timestamp checks while poll() waits
+ */
+constexpr int STAMP_INTERVAL_MS = 20;
+
+} // namespace
+
+FileWatcher::FileWatcher() {
+#if defined(__linux__)
+    descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+    clear();
+#if defined(__linux__)
+    if (descriptor >= 0) {
+        ::close(descriptor);
+    }
+#endif
+}
+
+std::string FileWatcher::normalize(const std::string& path) {
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(path, error);
+    if (error) {
+        absolute = path;
+    }
+    return absolute.lexically_normal().string();
+}
+
+bool FileWatcher::watch(const std::string& path) {
+    const std::string normalized = normalize(path);
+    if (files.count(normalized) != 0) {
+        return true;
+    }
+#if defined(__linux__)
+    if (descriptor >= 0) {
+        // Editors replace files by renaming, which a watch on the file itself would not survive
+        const std::string directory = std::filesystem::path(normalized).parent_path().string();
+        const int watchDescriptor = inotify_add_watch(descriptor, directory.c_str(), WATCH_EVENTS);
+        if (watchDescriptor < 0) {
+            return false;
+        }
+        directories[watchDescriptor] = directory;
+    }
+#endif
+    files[normalized] = path;
+    if (!isNative()) {
+        stamps[normalized] = stat(normalized);
+    }
+    return true;
+}
+
+void FileWatcher::clear() {
+#if defined(__linux__)
+    for (const auto& entry : directories) {
+        inotify_rm_watch(descriptor, entry.first);
+    }
+#endif
+    directories.clear();
+    files.clear();
+    stamps.clear();
+}
+
+std::vector<std::string> FileWatcher::poll(int timeoutMs) {
+    std::unordered_set<std::string> changed;
+    const auto start = std::chrono::steady_clock::now();
+    const auto elapsedMs = [&]() {
+        return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    std::chrono::steady_clock::now() - start).count());
+    };
+#if defined(__linux__)
+    if (descriptor >= 0) {
+        pollfd request = {descriptor, POLLIN, 0};
+        // Events for other files in the watched directories do not end the wait
+        while (changed.empty()) {
+            const int remaining = timeoutMs < 0 ? -1 : std::max(timeoutMs - elapsedMs(), 0);
+            if (::poll(&request, 1, remaining) <= 0) {
+                return {};
+            }
+            // Keep reading until the writer has been quiet for a while
+            readEvents(changed);
+            while (::poll(&request, 1, SETTLE_MS) > 0 && readEvents(changed)) {
+            }
+        }
+        std::vector<std::string> result;
+        for (const auto& normalized : changed) {
+            result.push_back(files[normalized]);
+        }
+        return result;
+    }
+#endif
+    compareStamps(changed);
+    while (changed.empty() && (timeoutMs < 0 || elapsedMs() < timeoutMs)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(STAMP_INTERVAL_MS));
+        compareStamps(changed);
+    }
+    if (!changed.empty()) {
+        // A file still being written changes again within the settle time
+        size_t count;
+        do {
+            count = changed.size();
+            std::this_thread::sleep_for(std::chrono::milliseconds(SETTLE_MS));
+            compareStamps(changed);
+        } while (changed.size() != count);
+    }
+    std::vector<std::string> result;
+    for (const auto& normalized : changed) {
+        result.push_back(files[normalized]);
+    }
+    return result;
+}
+
+FileWatcher::Stamp FileWatcher::stat(const std::string& path) {
+    Stamp stamp;
+    std::error_code error;
+    const auto modified = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return stamp;
+    }
+    stamp.modified = static_cast<int64_t>(modified.time_since_epoch().count());
+    stamp.size = static_cast<uint64_t>(std::filesystem::file_size(path, error));
+    stamp.exists = !error;
+    return stamp;
+}
+
+bool FileWatcher::readEvents(std::unordered_set<std::string>& changed) {
+#if defined(__linux__)
+    alignas(inotify_event) char buffer[16384];
+    bool any = false;
+    for (;;) {
+        const ssize_t length = ::read(descriptor, buffer, sizeof(buffer));
+        if (length <= 0) {
+            return any;
+        }
+        any = true;
+        for (const char* cursor = buffer; cursor < buffer + length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(cursor);
+            cursor += sizeof(inotify_event) + event->len;
+            const auto directory = directories.find(event->wd);
+            if (event->len == 0 || directory == directories.end()) {
+                continue;
+            }
+            const std::string path = (std::filesystem::path(directory->second) / event->name).string();
+            if (files.count(path) != 0) {
+                changed.insert(path);
+            }
+        }
+    }
+#else
+    (void)changed;
+    return false;
+#endif
+}
+
+void FileWatcher::compareStamps(std::unordered_set<std::string>& changed) {
+    for (auto& entry : stamps) {
+        const Stamp stamp = stat(entry.first);
+        if (!(stamp == entry.second)) {
+            entry.second = stamp;
+            changed.insert(entry.first);
+        }
+    }
+}
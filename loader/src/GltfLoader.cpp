@@ -0,0 +1,931 @@
+#include <GltfLoader.h>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string_view>
+#include <utility>
+
+// A .glb file is a 12 byte header followed by a JSON chunk and an optional BIN chunk:
+//
+//   uint32 magic "glTF", uint32 version (2), uint32 total length
+//   uint32 chunk length, uint32 chunk type "JSON", JSON text (space padded to 4 bytes)
+//   uint32 chunk length, uint32 chunk type "BIN\0", buffer 0 (zero padded to 4 bytes)
+//
+// Only the JSON is parsed into a small DOM; everything the accessors describe stays in the
+// mapping.
+
+namespace {
+
+constexpr uint32_t GLB_MAGIC = 0x46546C67u;       ///< "glTF"
+constexpr uint32_t GLB_VERSION = 2;
+constexpr uint32_t CHUNK_JSON = 0x4E4F534Au;      ///< "JSON"
+constexpr uint32_t CHUNK_BIN = 0x004E4942u;       ///< "BIN\0"
+constexpr size_t GLB_HEADER_SIZE = 12;
+constexpr size_t CHUNK_HEADER_SIZE = 8;
+constexpr int MAX_JSON_DEPTH = 256;
+constexpr uint32_t MODE_TRIANGLES = 4;
+constexpr double MAX_SIZE = 9007199254740992.0;   ///< 2^53, sizes up to it are exact doubles
+
+inline uint32_t readU32(const char* bytes) {
+    uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief A parsed JSON value
+ */
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> items;                              ///< Array elements
+    std::vector<std::pair<std::string, JsonValue>> members;    ///< Object members in file order
+
+    bool isArray() const { return type == Type::Array; }
+    bool isObject() const { return type == Type::Object; }
+    bool isNumber() const { return type == Type::Number; }
+    bool isString() const { return type == Type::String; }
+
+    /**
+     * @brief Member of an object, nullptr if absent or not an object
+     */
+    const JsonValue* find(std::string_view key) const {
+        for (const auto& member : members) {
+            if (member.first == key) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * @brief Recursive descent parser for RFC 8259 JSON
+ */
+class JsonParser {
+public:
+    explicit JsonParser(std::string_view text) : text(text) {}
+
+    bool parse(JsonValue& value) {
+        return parseValue(value, 0) && (skipSpace(), pos == text.size());
+    }
+
+private:
+    std::string_view text;
+    size_t pos = 0;
+
+    void skipSpace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+            ++pos;
+        }
+    }
+
+    bool consume(std::string_view literal) {
+        if (text.compare(pos, literal.size(), literal) != 0) {
+            return false;
+        }
+        pos += literal.size();
+        return true;
+    }
+
+    bool parseValue(JsonValue& value, int depth) {
+        skipSpace();
+        if (pos >= text.size() || depth > MAX_JSON_DEPTH) {
+            return false;
+        }
+        switch (text[pos]) {
+        case '{':
+            return parseObject(value, depth);
+        case '[':
+            return parseArray(value, depth);
+        case '"':
+            value.type = JsonValue::Type::String;
+            return parseString(value.string);
+        case 't':
+            value.type = JsonValue::Type::Bool;
+            value.boolean = true;
+            return consume("true");
+        case 'f':
+            value.type = JsonValue::Type::Bool;
+            value.boolean = false;
+            return consume("false");
+        case 'n':
+            value.type = JsonValue::Type::Null;
+            return consume("null");
+        default:
+            return parseNumber(value);
+        }
+    }
+
+    bool parseObject(JsonValue& value, int depth) {
+        value.type = JsonValue::Type::Object;
+        ++pos;
+        skipSpace();
+        if (pos < text.size() && text[pos] == '}') {
+            ++pos;
+            return true;
+        }
+        while (true) {
+            skipSpace();
+            std::string key;
+            if (pos >= text.size() || text[pos] != '"' || !parseString(key)) {
+                return false;
+            }
+            skipSpace();
+            if (pos >= text.size() || text[pos] != ':') {
+                return false;
+            }
+            ++pos;
+            value.members.emplace_back(std::move(key), JsonValue());
+            if (!parseValue(value.members.back().second, depth + 1)) {
+                return false;
+            }
+            skipSpace();
+            if (pos < text.size() && text[pos] == ',') {
+                ++pos;
+            } else if (pos < text.size() && text[pos] == '}') {
+                ++pos;
+                return true;
+            } else {
+                return false;
+            }
+        }
+    }
+
+    bool parseArray(JsonValue& value, int depth) {
+        value.type = JsonValue::Type::Array;
+        ++pos;
+        skipSpace();
+        if (pos < text.size() && text[pos] == ']') {
+            ++pos;
+            return true;
+        }
+        while (true) {
+            value.items.emplace_back();
+            if (!parseValue(value.items.back(), depth + 1)) {
+                return false;
+            }
+            skipSpace();
+            if (pos < text.size() && text[pos] == ',') {
+                ++pos;
+            } else if (pos < text.size() && text[pos] == ']') {
+                ++pos;
+                return true;
+            } else {
+                return false;
+            }
+        }
+    }
+
+    bool parseHex4(uint32_t& code) {
+        if (pos + 4 > text.size()) {
+            return false;
+        }
+        code = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char c = text[pos++];
+            code <<= 4;
+            if (c >= '0' && c <= '9') {
+                code |= static_cast<uint32_t>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                code |= static_cast<uint32_t>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                code |= static_cast<uint32_t>(c - 'A' + 10);
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    bool parseString(std::string& out) {
+        ++pos;
+        while (pos < text.size()) {
+            const char c = text[pos++];
+            if (c == '"') {
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                return false;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= text.size()) {
+                return false;
+            }
+            const char escape = text[pos++];
+            switch (escape) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                uint32_t code;
+                if (!parseHex4(code)) {
+                    return false;
+                }
+                // A high surrogate followed by an escaped low surrogate is one code point
+                if (code >= 0xD800 && code < 0xDC00 && text.compare(pos, 2, "\\u") == 0) {
+                    pos += 2;
+                    uint32_t low;
+                    if (!parseHex4(low) || low < 0xDC00 || low >= 0xE000) {
+                        return false;
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool parseNumber(JsonValue& value) {
+        value.type = JsonValue::Type::Number;
+        const char* first = text.data() + pos;
+        const auto result = std::from_chars(first, text.data() + text.size(), value.number);
+        if (result.ec != std::errc() || result.ptr == first) {
+            return false;
+        }
+        pos += static_cast<size_t>(result.ptr - first);
+        return true;
+    }
+};
+
+/**
+ * @brief A number member, fallback if absent or not a number
+ */
+double getNumber(const JsonValue& object, std::string_view key, double fallback) {
+    const JsonValue* value = object.find(key);
+    return value != nullptr && value->isNumber() ? value->number : fallback;
+}
+
+/**
+ * @brief A byte size, offset or count member (non-negative integer up to MAX_SIZE)
+ * @param size Receives the value, fallback if the member is absent
+ * @return false if the member is present but not such a number
+ */
+bool getSize(const JsonValue& object, std::string_view key, size_t fallback, size_t& size) {
+    const JsonValue* value = object.find(key);
+    if (value == nullptr) {
+        size = fallback;
+        return true;
+    }
+    if (!value->isNumber() || !(value->number >= 0.0 && value->number <= MAX_SIZE) ||
+        value->number != static_cast<double>(static_cast<uint64_t>(value->number))) {
+        return false;
+    }
+    size = static_cast<size_t>(value->number);
+    return true;
+}
+
+/**
+ * @brief An index member (non-negative integer), -1 if absent or invalid
+ */
+int getIndex(const JsonValue& object, std::string_view key) {
+    const double value = getNumber(object, key, -1.0);
+    return value >= 0.0 && value < 2147483647.0 && value == static_cast<double>(static_cast<int>(value))
+               ? static_cast<int>(value) : -1;
+}
+
+std::string getString(const JsonValue& object, std::string_view key) {
+    const JsonValue* value = object.find(key);
+    return value != nullptr && value->isString() ? value->string : std::string();
+}
+
+bool getBool(const JsonValue& object, std::string_view key, bool fallback) {
+    const JsonValue* value = object.find(key);
+    return value != nullptr && value->type == JsonValue::Type::Bool ? value->boolean : fallback;
+}
+
+/**
+ * @brief Read a fixed size number array member into out, left unchanged unless it has exactly count numbers
+ */
+void getFloats(const JsonValue& object, std::string_view key, float* out, size_t count) {
+    const JsonValue* value = object.find(key);
+    if (value == nullptr || !value->isArray() || value->items.size() != count) {
+        return;
+    }
+    for (const JsonValue& item : value->items) {
+        if (!item.isNumber()) {
+            return;
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<float>(value->items[i].number);
+    }
+}
+
+/**
+ * @brief Elements of an array member, an empty array if absent
+ */
+const std::vector<JsonValue>& getArray(const JsonValue& object, std::string_view key) {
+    static const std::vector<JsonValue> empty;
+    const JsonValue* value = object.find(key);
+    return value != nullptr && value->isArray() ? value->items : empty;
+}
+
+uint32_t componentCountOf(const std::string& type) {
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4") return 4;
+    if (type == "MAT2") return 4;
+    if (type == "MAT3") return 9;
+    if (type == "MAT4") return 16;
+    return 0;
+}
+
+size_t componentSizeOf(GltfComponentType type) {
+    switch (type) {
+    case GltfComponentType::Int8:
+    case GltfComponentType::UInt8:
+        return 1;
+    case GltfComponentType::Int16:
+    case GltfComponentType::UInt16:
+        return 2;
+    case GltfComponentType::UInt32:
+    case GltfComponentType::Float:
+        return 4;
+    }
+    return 0;
+}
+
+/**
+ * @brief Column major a * b
+ */
+void multiply(const float* a, const float* b, float* out) {
+    float result[16];
+    for (int column = 0; column < 4; ++column) {
+        for (int row = 0; row < 4; ++row) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; ++k) {
+                sum += a[k * 4 + row] * b[column * 4 + k];
+            }
+            result[column * 4 + row] = sum;
+        }
+    }
+    std::memcpy(out, result, sizeof(result));
+}
+
+/**
+ * @brief Column major translation * rotation * scale, rotation as a unit quaternion (x, y, z, w)
+ */
+void composeTrs(const float* t, const float* q, const float* s, float* out) {
+    const float x = q[0], y = q[1], z = q[2], w = q[3];
+    const float rotation[9] = {
+        1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + z * w), 2.0f * (x * z - y * w),
+        2.0f * (x * y - z * w), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + x * w),
+        2.0f * (x * z + y * w), 2.0f * (y * z - x * w), 1.0f - 2.0f * (x * x + y * y)};
+    for (int column = 0; column < 3; ++column) {
+        for (int row = 0; row < 3; ++row) {
+            out[column * 4 + row] = rotation[column * 3 + row] * s[column];
+        }
+        out[column * 4 + 3] = 0.0f;
+    }
+    out[12] = t[0];
+    out[13] = t[1];
+    out[14] = t[2];
+    out[15] = 1.0f;
+}
+
+/**
+ * @brief Component c of element i as a float, integer components normalized if the accessor says so
+ */
+float readComponent(const GltfAccessor& accessor, size_t i, uint32_t c) {
+    const size_t size = componentSizeOf(accessor.componentType);
+    const char* bytes = accessor.bytes + i * accessor.stride + c * size;
+    switch (accessor.componentType) {
+    case GltfComponentType::Float: {
+        float value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+    case GltfComponentType::UInt8: {
+        const uint8_t value = static_cast<uint8_t>(*bytes);
+        return accessor.normalized ? value / 255.0f : value;
+    }
+    case GltfComponentType::Int8: {
+        const int8_t value = static_cast<int8_t>(*bytes);
+        return accessor.normalized ? std::max(value / 127.0f, -1.0f) : value;
+    }
+    case GltfComponentType::UInt16: {
+        uint16_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return accessor.normalized ? value / 65535.0f : value;
+    }
+    case GltfComponentType::Int16: {
+        int16_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return accessor.normalized ? std::max(value / 32767.0f, -1.0f) : value;
+    }
+    case GltfComponentType::UInt32: {
+        uint32_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return static_cast<float>(value);
+    }
+    }
+    return 0.0f;
+}
+
+/**
+ * @brief Whether an accessor holds float elements of a number of components
+ */
+bool isFloatAccessor(const std::vector<GltfAccessor>& accessors, int index, uint32_t componentCount) {
+    return index >= 0 && accessors[index].bytes != nullptr &&
+           accessors[index].componentType == GltfComponentType::Float &&
+           accessors[index].componentCount == componentCount;
+}
+
+/**
+ * @brief A contiguous byte range inside a buffer (glTF bufferView)
+ */
+struct BufferView {
+    const char* bytes = nullptr;
+    size_t length = 0;
+    size_t stride = 0;        ///< 0 for tightly packed elements
+};
+
+} // namespace
+
+size_t GltfAccessor::elementSize() const {
+    return componentSizeOf(componentType) * componentCount;
+}
+
+uint32_t GltfAccessor::index(size_t i) const {
+    const char* element = bytes + i * stride;
+    switch (componentType) {
+    case GltfComponentType::UInt8:
+        return static_cast<uint8_t>(*element);
+    case GltfComponentType::UInt16: {
+        uint16_t value;
+        std::memcpy(&value, element, sizeof(value));
+        return value;
+    }
+    case GltfComponentType::UInt32: {
+        uint32_t value;
+        std::memcpy(&value, element, sizeof(value));
+        return value;
+    }
+    default:
+        return 0;
+    }
+}
+
+bool GltfLoader::load(const std::string& filename) {
+    file.close();
+    externalBuffers.clear();
+    buffers.clear();
+    accessors.clear();
+    meshes.clear();
+    materials.clear();
+    images.clear();
+    nodes.clear();
+    instances.clear();
+    basePath = std::filesystem::path(filename).parent_path().string();
+
+    if (!file.open(filename)) {
+        std::cerr << "Error: Cannot open glTF file " << filename << std::endl;
+        return false;
+    }
+
+    // Binary glTF: the JSON chunk and buffer 0 inside the file; otherwise the whole file is JSON
+    std::string_view json = file.view();
+    const char* binBytes = nullptr;
+    size_t binLength = 0;
+    if (file.size() >= GLB_HEADER_SIZE && readU32(file.data()) == GLB_MAGIC) {
+        const char* data = file.data();
+        const size_t length = std::min<size_t>(readU32(data + 8), file.size());
+        if (readU32(data + 4) != GLB_VERSION || length < GLB_HEADER_SIZE + CHUNK_HEADER_SIZE ||
+            readU32(data + 16) != CHUNK_JSON || readU32(data + 12) > length - GLB_HEADER_SIZE - CHUNK_HEADER_SIZE) {
+            std::cerr << "Error: Invalid GLB header in " << filename << std::endl;
+            return false;
+        }
+        const size_t jsonLength = readU32(data + 12);
+        json = std::string_view(data + GLB_HEADER_SIZE + CHUNK_HEADER_SIZE, jsonLength);
+        const size_t binChunk = GLB_HEADER_SIZE + CHUNK_HEADER_SIZE + (jsonLength + 3) / 4 * 4;
+        if (binChunk + CHUNK_HEADER_SIZE <= length && readU32(data + binChunk + 4) == CHUNK_BIN) {
+            binBytes = data + binChunk + CHUNK_HEADER_SIZE;
+            binLength = std::min<size_t>(readU32(data + binChunk), length - binChunk - CHUNK_HEADER_SIZE);
+        }
+    }
+
+    JsonValue root;
+    if (!JsonParser(json).parse(root) || !root.isObject()) {
+        std::cerr << "Error: Invalid glTF JSON in " << filename << std::endl;
+        return false;
+    }
+    const JsonValue* asset = root.find("asset");
+    if (asset == nullptr || getString(*asset, "version").compare(0, 2, "2.") != 0) {
+        std::cerr << "Error: " << filename << " is not glTF 2.0" << std::endl;
+        return false;
+    }
+
+    // Buffers: the BIN chunk or mapped files. Data URIs are not supported and stay empty, so
+    // accessors into them are empty too
+    for (const JsonValue& buffer : getArray(root, "buffers")) {
+        size_t byteLength = 0;
+        if (!getSize(buffer, "byteLength", 0, byteLength)) {
+            std::cerr << "Error: Invalid buffer byteLength in " << filename << std::endl;
+            return false;
+        }
+        const std::string uri = getString(buffer, "uri");
+        std::pair<const char*, size_t> bytes(nullptr, 0);
+        if (uri.empty()) {
+            if (buffers.empty() && binBytes != nullptr && binLength >= byteLength) {
+                bytes = {binBytes, byteLength};
+            }
+        } else if (uri.compare(0, 5, "data:") == 0) {
+            std::cerr << "Warning: Embedded data URI buffers are not supported" << std::endl;
+        } else {
+            MappedFile mapped;
+            if (mapped.open((std::filesystem::path(basePath) / uri).string()) && mapped.size() >= byteLength) {
+                bytes = {mapped.data(), byteLength};
+                externalBuffers.push_back(std::move(mapped));
+            } else {
+                std::cerr << "Warning: Cannot map glTF buffer " << uri << std::endl;
+            }
+        }
+        buffers.push_back(bytes);
+    }
+
+    std::vector<BufferView> bufferViews;
+    for (const JsonValue& view : getArray(root, "bufferViews")) {
+        BufferView result;
+        const int buffer = getIndex(view, "buffer");
+        size_t offset = 0;
+        size_t length = 0;
+        size_t stride = 0;
+        if (!getSize(view, "byteOffset", 0, offset) || !getSize(view, "byteLength", 0, length) ||
+            !getSize(view, "byteStride", 0, stride)) {
+            std::cerr << "Error: Invalid bufferView in " << filename << std::endl;
+            return false;
+        }
+        if (buffer >= 0 && static_cast<size_t>(buffer) < buffers.size() && buffers[buffer].first != nullptr &&
+            offset <= buffers[buffer].second && length <= buffers[buffer].second - offset) {
+            result.bytes = buffers[buffer].first + offset;
+            result.length = length;
+            result.stride = stride;
+        }
+        bufferViews.push_back(result);
+    }
+
+    // Accessors point into their buffer view once every element is known to lie inside it
+    for (const JsonValue& accessor : getArray(root, "accessors")) {
+        GltfAccessor result;
+        result.componentType = static_cast<GltfComponentType>(std::max(getIndex(accessor, "componentType"), 0));
+        result.componentCount = componentCountOf(getString(accessor, "type"));
+        result.normalized = getBool(accessor, "normalized", false);
+        const size_t elementSize = result.elementSize();
+        const int view = getIndex(accessor, "bufferView");
+        size_t offset = 0;
+        if (!getSize(accessor, "count", 0, result.count) || !getSize(accessor, "byteOffset", 0, offset)) {
+            std::cerr << "Error: Invalid accessor count or byteOffset in " << filename << std::endl;
+            return false;
+        }
+        if (elementSize == 0) {
+            std::cerr << "Error: Invalid accessor type in " << filename << std::endl;
+            return false;
+        }
+        if (view >= 0 && static_cast<size_t>(view) < bufferViews.size() && bufferViews[view].bytes != nullptr &&
+            accessor.find("sparse") == nullptr) {
+            const BufferView& source = bufferViews[view];
+            result.stride = source.stride != 0 ? source.stride : elementSize;
+            // Divide instead of multiplying, a large count or stride must not wrap around
+            if (result.stride >= elementSize && offset <= source.length &&
+                (result.count == 0 || (elementSize <= source.length - offset &&
+                                       result.count <= (source.length - offset - elementSize) / result.stride + 1))) {
+                result.bytes = source.bytes + offset;
+            }
+        }
+        if (result.bytes == nullptr) {
+            result.count = 0;
+        }
+        float bounds[16];
+        std::fill(bounds, bounds + 16, 0.0f);
+        getFloats(accessor, "min", bounds, result.componentCount);
+        std::copy(bounds, bounds + 3, result.min);
+        getFloats(accessor, "max", bounds, result.componentCount);
+        std::copy(bounds, bounds + 3, result.max);
+        accessors.push_back(result);
+    }
+
+    for (const JsonValue& image : getArray(root, "images")) {
+        GltfImage result;
+        result.name = getString(image, "name");
+        result.uri = getString(image, "uri");
+        result.mimeType = getString(image, "mimeType");
+        const int view = getIndex(image, "bufferView");
+        if (view >= 0 && static_cast<size_t>(view) < bufferViews.size()) {
+            result.bytes = bufferViews[view].bytes;
+            result.size = bufferViews[view].bytes != nullptr ? bufferViews[view].length : 0;
+        }
+        images.push_back(std::move(result));
+    }
+
+    // Materials reference textures, which only add a sampler to an image
+    std::vector<int> textureImages;
+    for (const JsonValue& texture : getArray(root, "textures")) {
+        const int source = getIndex(texture, "source");
+        textureImages.push_back(source >= 0 && static_cast<size_t>(source) < images.size() ? source : -1);
+    }
+    auto readTexture = [&](const JsonValue& owner, std::string_view key, GltfTextureRef& out) -> const JsonValue* {
+        const JsonValue* info = owner.find(key);
+        if (info == nullptr || !info->isObject()) {
+            return nullptr;
+        }
+        const int texture = getIndex(*info, "index");
+        if (texture >= 0 && static_cast<size_t>(texture) < textureImages.size()) {
+            out.image = textureImages[texture];
+        }
+        out.texCoord = static_cast<uint32_t>(std::max(getIndex(*info, "texCoord"), 0));
+        return info;
+    };
+    for (const JsonValue& material : getArray(root, "materials")) {
+        GltfMaterial result;
+        result.name = getString(material, "name");
+        if (const JsonValue* pbr = material.find("pbrMetallicRoughness")) {
+            getFloats(*pbr, "baseColorFactor", result.baseColorFactor, 4);
+            result.metallicFactor = static_cast<float>(getNumber(*pbr, "metallicFactor", 1.0));
+            result.roughnessFactor = static_cast<float>(getNumber(*pbr, "roughnessFactor", 1.0));
+            readTexture(*pbr, "baseColorTexture", result.baseColorTexture);
+            readTexture(*pbr, "metallicRoughnessTexture", result.metallicRoughnessTexture);
+        }
+        if (const JsonValue* info = readTexture(material, "normalTexture", result.normalTexture)) {
+            result.normalScale = static_cast<float>(getNumber(*info, "scale", 1.0));
+        }
+        if (const JsonValue* info = readTexture(material, "occlusionTexture", result.occlusionTexture)) {
+            result.occlusionStrength = static_cast<float>(getNumber(*info, "strength", 1.0));
+        }
+        readTexture(material, "emissiveTexture", result.emissiveTexture);
+        getFloats(material, "emissiveFactor", result.emissiveFactor, 3);
+        const std::string alphaMode = getString(material, "alphaMode");
+        result.alphaMode = alphaMode == "MASK" ? GltfAlphaMode::Mask
+                         : alphaMode == "BLEND" ? GltfAlphaMode::Blend : GltfAlphaMode::Opaque;
+        result.alphaCutoff = static_cast<float>(getNumber(material, "alphaCutoff", 0.5));
+        result.doubleSided = getBool(material, "doubleSided", false);
+        materials.push_back(std::move(result));
+    }
+
+    auto accessorIndex = [&](const JsonValue& owner, std::string_view key) {
+        const int index = getIndex(owner, key);
+        return index >= 0 && static_cast<size_t>(index) < accessors.size() ? index : -1;
+    };
+    for (const JsonValue& mesh : getArray(root, "meshes")) {
+        GltfMesh result;
+        result.name = getString(mesh, "name");
+        for (const JsonValue& primitive : getArray(mesh, "primitives")) {
+            GltfPrimitive draw;
+            if (const JsonValue* attributes = primitive.find("attributes")) {
+                draw.position = accessorIndex(*attributes, "POSITION");
+                draw.normal = accessorIndex(*attributes, "NORMAL");
+                draw.texCoord = accessorIndex(*attributes, "TEXCOORD_0");
+                draw.tangent = accessorIndex(*attributes, "TANGENT");
+            }
+            draw.indices = accessorIndex(primitive, "indices");
+            const int material = getIndex(primitive, "material");
+            draw.material = static_cast<size_t>(material) < materials.size() ? material : -1;
+            // An invalid mode becomes ~0u, which no renderer draws
+            draw.mode = primitive.find("mode") == nullptr ? MODE_TRIANGLES
+                                                          : static_cast<uint32_t>(getIndex(primitive, "mode"));
+            result.primitives.push_back(draw);
+        }
+        meshes.push_back(std::move(result));
+    }
+
+    // Nodes: local transforms and the hierarchy, which has to be a forest
+    const std::vector<JsonValue>& nodeArray = getArray(root, "nodes");
+    nodes.resize(nodeArray.size());
+    for (size_t i = 0; i < nodeArray.size(); ++i) {
+        const JsonValue& node = nodeArray[i];
+        GltfNode& result = nodes[i];
+        result.name = getString(node, "name");
+        const int mesh = getIndex(node, "mesh");
+        result.mesh = static_cast<size_t>(mesh) < meshes.size() ? mesh : -1;
+        if (node.find("matrix") != nullptr) {
+            getFloats(node, "matrix", result.localMatrix, 16);
+        } else {
+            float translation[3] = {0.0f, 0.0f, 0.0f};
+            float rotation[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+            float scale[3] = {1.0f, 1.0f, 1.0f};
+            getFloats(node, "translation", translation, 3);
+            getFloats(node, "rotation", rotation, 4);
+            getFloats(node, "scale", scale, 3);
+            composeTrs(translation, rotation, scale, result.localMatrix);
+        }
+        for (const JsonValue& child : getArray(node, "children")) {
+            const int index = child.isNumber() ? static_cast<int>(child.number) : -1;
+            if (index < 0 || static_cast<size_t>(index) >= nodeArray.size() || static_cast<size_t>(index) == i) {
+                std::cerr << "Error: Invalid child of node " << i << " in " << filename << std::endl;
+                return false;
+            }
+            result.children.push_back(index);
+        }
+    }
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        for (int child : nodes[i].children) {
+            if (nodes[child].parent != -1) {
+                std::cerr << "Error: Node " << child << " has more than one parent in " << filename << std::endl;
+                return false;
+            }
+            nodes[child].parent = static_cast<int>(i);
+        }
+    }
+
+    // World matrices, parents before children (iterative, hierarchies can be deep)
+    std::vector<int> stack;
+    size_t visited = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].parent == -1) {
+            stack.push_back(static_cast<int>(i));
+        }
+    }
+    while (!stack.empty()) {
+        GltfNode& node = nodes[stack.back()];
+        stack.pop_back();
+        ++visited;
+        if (node.parent == -1) {
+            std::memcpy(node.worldMatrix, node.localMatrix, sizeof(node.worldMatrix));
+        } else {
+            multiply(nodes[node.parent].worldMatrix, node.localMatrix, node.worldMatrix);
+        }
+        stack.insert(stack.end(), node.children.rbegin(), node.children.rend());
+    }
+    if (visited != nodes.size()) {
+        std::cerr << "Error: Node hierarchy of " << filename << " contains a cycle" << std::endl;
+        return false;
+    }
+
+    // Instances: every node with a mesh below the roots of the default scene, in depth first order.
+    // Without scenes all root nodes are drawn
+    const std::vector<JsonValue>& scenes = getArray(root, "scenes");
+    const int scene = std::max(getIndex(root, "scene"), 0);
+    if (static_cast<size_t>(scene) < scenes.size()) {
+        const std::vector<JsonValue>& roots = getArray(scenes[scene], "nodes");
+        for (auto it = roots.rbegin(); it != roots.rend(); ++it) {
+            const int index = it->isNumber() ? static_cast<int>(it->number) : -1;
+            if (index >= 0 && static_cast<size_t>(index) < nodes.size() && nodes[index].parent == -1) {
+                stack.push_back(index);
+            }
+        }
+    } else {
+        for (size_t i = nodes.size(); i-- > 0;) {
+            if (nodes[i].parent == -1) {
+                stack.push_back(static_cast<int>(i));
+            }
+        }
+    }
+    while (!stack.empty()) {
+        const int index = stack.back();
+        stack.pop_back();
+        const GltfNode& node = nodes[index];
+        if (node.mesh >= 0) {
+            GltfInstance instance;
+            instance.node = index;
+            instance.mesh = node.mesh;
+            std::memcpy(instance.worldMatrix, node.worldMatrix, sizeof(instance.worldMatrix));
+            instances.push_back(instance);
+        }
+        stack.insert(stack.end(), node.children.rbegin(), node.children.rend());
+    }
+
+    return true;
+}
+
+IndexedMesh GltfLoader::buildIndexedMesh(int mesh, VertexLayout layout) const {
+    IndexedMesh result;
+    if (mesh < 0 || static_cast<size_t>(mesh) >= meshes.size()) {
+        return result;
+    }
+    const std::vector<GltfPrimitive>& primitives = meshes[mesh].primitives;
+    auto drawn = [&](const GltfPrimitive& primitive) {
+        return primitive.mode == MODE_TRIANGLES && isFloatAccessor(accessors, primitive.position, 3);
+    };
+    // Tangents are only kept if every primitive has them
+    bool allTangents = false;
+    for (const GltfPrimitive& primitive : primitives) {
+        if (drawn(primitive)) {
+            allTangents = isFloatAccessor(accessors, primitive.tangent, 4);
+            if (!allTangents) {
+                break;
+            }
+        }
+    }
+
+    for (const GltfPrimitive& primitive : primitives) {
+        if (!drawn(primitive)) {
+            continue;
+        }
+        const StridedView<Vertex> positions = accessors[primitive.position].as<Vertex>();
+        const StridedView<Normal> normals = isFloatAccessor(accessors, primitive.normal, 3)
+                                                ? accessors[primitive.normal].as<Normal>() : StridedView<Normal>();
+        const bool hasTexCoords = primitive.texCoord >= 0 && accessors[primitive.texCoord].bytes != nullptr &&
+                                  accessors[primitive.texCoord].componentCount == 2;
+        const size_t base = result.vertices.size();
+        const size_t count = positions.size();
+        result.vertices.resize(base + count);
+        for (size_t i = 0; i < count; ++i) {
+            MeshVertex& vertex = result.vertices[base + i];
+            vertex.position = positions[i];
+            vertex.normal = i < normals.size() ? normals[i] : Normal{0.0f, 0.0f, 0.0f};
+            vertex.texCoord = {0.0f, 0.0f};
+            if (hasTexCoords && i < accessors[primitive.texCoord].count) {
+                // glTF puts v = 0 at the top of the image, OBJ at the bottom
+                vertex.texCoord.u = readComponent(accessors[primitive.texCoord], i, 0);
+                vertex.texCoord.v = 1.0f - readComponent(accessors[primitive.texCoord], i, 1);
+            }
+        }
+        if (allTangents) {
+            const StridedView<Tangent> tangents = accessors[primitive.tangent].as<Tangent>();
+            for (size_t i = 0; i < count; ++i) {
+                Tangent tangent = i < tangents.size() ? tangents[i] : Tangent{1.0f, 0.0f, 0.0f, 1.0f};
+                // Flipping v mirrors texture space, so the bitangent changes side
+                tangent.w = -tangent.w;
+                result.tangents.push_back(tangent);
+            }
+        }
+        result.hasNormals = result.hasNormals || !normals.empty();
+        result.hasTexCoords = result.hasTexCoords || hasTexCoords;
+
+        Submesh submesh;
+        submesh.firstIndex = static_cast<uint32_t>(result.indices.size());
+        submesh.material = primitive.material >= 0 ? static_cast<MaterialId>(primitive.material) : NO_MATERIAL;
+        const GltfAccessor* indices = primitive.indices >= 0 ? &accessors[primitive.indices] : nullptr;
+        const size_t indexCount = indices != nullptr ? indices->count : count;
+        for (size_t i = 0; i + 3 <= indexCount; i += 3) {
+            uint32_t triangle[3];
+            bool valid = true;
+            for (size_t k = 0; k < 3; ++k) {
+                triangle[k] = indices != nullptr ? indices->index(i + k) : static_cast<uint32_t>(i + k);
+                valid = valid && triangle[k] < count;
+            }
+            if (valid) {
+                for (uint32_t index : triangle) {
+                    result.indices.push_back(static_cast<uint32_t>(base + index));
+                }
+            }
+        }
+        submesh.indexCount = static_cast<uint32_t>(result.indices.size()) - submesh.firstIndex;
+        if (submesh.indexCount > 0) {
+            result.submeshes.push_back(submesh);
+        }
+    }
+
+    if (layout == VertexLayout::Streams) {
+        result.streams.reserve(result.vertices.size());
+        for (const MeshVertex& vertex : result.vertices) {
+            result.streams.push_back(vertex.position, vertex.texCoord, vertex.normal);
+        }
+        result.streams.pad();
+        result.vertices = {};
+    }
+    return result;
+}
+
+std::vector<Material> GltfLoader::getMaterialTable() const {
+    std::vector<Material> table;
+    table.reserve(materials.size());
+    for (const GltfMaterial& material : materials) {
+        Material converted;
+        converted.name = material.name;
+        converted.defined = true;
+        std::copy(material.baseColorFactor, material.baseColorFactor + 3, converted.diffuse);
+        if (material.baseColorTexture.image >= 0) {
+            converted.diffuseTexture = images[material.baseColorTexture.image].uri;
+        }
+        table.push_back(std::move(converted));
+    }
+    return table;
+}
@@ -0,0 +1,55 @@
+#include <MaterialCache.h>
+#include <filesystem>
+#include <system_error>
+
+std::shared_ptr<const MaterialFile> MaterialCache::acquire(const std::string& path, const Reader& read) {
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(path, error);
+    if (error) {
+        absolute = path;
+    }
+    const std::string key = absolute.lexically_normal().string();
+
+    std::promise<std::shared_ptr<const MaterialFile>> promise;
+    std::shared_future<std::shared_ptr<const MaterialFile>> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = files.find(key);
+        if (it != files.end()) {
+            ++reuseCount;
+            pending = it->second;
+        } else {
+            files.emplace(key, promise.get_future().share());
+        }
+    }
+    if (pending.valid()) {
+        // Another loader reads (or has read) the file
+        return pending.get();
+    }
+
+    auto file = std::make_shared<MaterialFile>();
+    try {
+        file->opened = read(path, file->materials);
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+    promise.set_value(file);
+    return file;
+}
+
+void MaterialCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    files.clear();
+    reuseCount = 0;
+}
+
+size_t MaterialCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return files.size();
+}
+
+size_t MaterialCache::reuses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return reuseCount;
+}
@@ -0,0 +1,469 @@
+#include <ModelLoader.h>
+#include <MappedFile.h>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <type_traits>
+
+// .srmesh layout (little endian, native float and integer formats):
+//
+//   CacheHeader
+//   CacheSection[sectionCount]
+//   sections, each starting at a multiple of SECTION_ALIGNMENT
+//
+// The geometry sections are raw MeshVertex / float / uint32_t / Submesh arrays that are
+// used in place from the mapping. The small sections (sources, names, materials) are
+// serialized with length-prefixed strings and copied out on load.
+
+namespace {
+
+constexpr char CACHE_MAGIC[8] = {'S', 'R', 'M', 'E', 'S', 'H', '\0', '\x1a'};
+constexpr uint32_t CACHE_VERSION = 4;
+constexpr uint32_t CACHE_ENDIAN_TAG = 0x01020304u;
+constexpr size_t SECTION_ALIGNMENT = 64;
+
+constexpr uint32_t FLAG_TEX_COORDS = 1u << 0;
+constexpr uint32_t FLAG_NORMALS = 1u << 1;
+constexpr uint32_t FLAG_OPTIMIZED = 1u << 2;
+constexpr uint32_t FLAG_GENERATED_NORMALS = 1u << 3;
+constexpr uint32_t FLAG_TANGENTS = 1u << 4;
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    uint32_t layout;          ///< VertexLayout of the vertex sections
+    uint32_t flags;           ///< FLAG_TEX_COORDS | FLAG_NORMALS | FLAG_OPTIMIZED | FLAG_GENERATED_NORMALS | FLAG_TANGENTS
+    uint64_t vertexCount;
+    uint64_t indexCount;
+    uint64_t submeshCount;
+    uint32_t sectionCount;
+    float creaseAngle;        ///< LoadOptions::creaseAngle, only set with FLAG_GENERATED_NORMALS
+};
+
+struct CacheSection {
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+};
+
+enum SectionType : uint32_t {
+    SECTION_SOURCES = 1,      ///< OBJ and MTL files the cache was built from
+    SECTION_NAMES,            ///< Object name
+    SECTION_MATERIALS,        ///< Material table in MaterialId order
+    SECTION_VERTICES,         ///< MeshVertex[vertexCount]
+    SECTION_POSITION_X,       ///< float[paddedCount] per stream, in VertexStreams order
+    SECTION_POSITION_Y,
+    SECTION_POSITION_Z,
+    SECTION_NORMAL_X,
+    SECTION_NORMAL_Y,
+    SECTION_NORMAL_Z,
+    SECTION_TEX_COORD_U,
+    SECTION_TEX_COORD_V,
+    SECTION_INDICES,          ///< uint32_t[indexCount]
+    SECTION_SUBMESHES,        ///< Submesh[submeshCount]
+    SECTION_OPTIMIZE_STATS,   ///< MeshOptimizeStats, only in optimized caches
+    SECTION_TANGENTS,         ///< Tangent[vertexCount], only if tangents were generated
+    SECTION_TYPE_END
+};
+
+static_assert(std::is_trivially_copyable<MeshVertex>::value, "MeshVertex is stored as raw bytes");
+static_assert(std::is_trivially_copyable<Submesh>::value, "Submesh is stored as raw bytes");
+static_assert(std::is_trivially_copyable<MeshOptimizeStats>::value, "MeshOptimizeStats is stored as raw bytes");
+static_assert(std::is_trivially_copyable<Tangent>::value, "Tangent is stored as raw bytes");
+
+/**
+ * @brief Identity of a file the cache depends on
+ */
+struct SourceRecord {
+    std::string path;
+    bool exists = false;
+    uint64_t size = 0;
+    int64_t modified = 0;     ///< Modification time in file clock ticks
+    uint64_t hash = 0;        ///< Content hash, see hashBytes
+};
+
+/**
+ * @brief 64-bit hash of a byte range, eight bytes per step
+ */
+uint64_t hashBytes(const char* data, size_t size) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    for (; i < size; ++i) {
+        h = (h ^ static_cast<unsigned char>(data[i])) * 0xC4CEB9FE1A85EC53ull;
+    }
+    return h ^ (h >> 29);
+}
+
+/**
+ * @brief Size and modification time of a file, exists is false if it cannot be read
+ */
+SourceRecord statSource(const std::string& path) {
+    SourceRecord record;
+    record.path = path;
+    std::error_code error;
+    const auto size = std::filesystem::file_size(path, error);
+    if (error) {
+        return record;
+    }
+    const auto modified = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return record;
+    }
+    record.exists = true;
+    record.size = static_cast<uint64_t>(size);
+    record.modified = static_cast<int64_t>(modified.time_since_epoch().count());
+    return record;
+}
+
+/**
+ * @brief Content hash of a file, 0 if it cannot be mapped
+ */
+uint64_t hashFile(const std::string& path) {
+    MappedFile file(path);
+    return file.isOpen() ? hashBytes(file.data(), file.size()) : 0;
+}
+
+/**
+ * @brief Appends plain values and length-prefixed strings to a byte buffer
+ */
+class ByteWriter {
+public:
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "raw values only");
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    void writeString(const std::string& value) {
+        write(static_cast<uint32_t>(value.size()));
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+    const std::vector<char>& data() const { return buffer; }
+
+private:
+    std::vector<char> buffer;
+};
+
+/**
+ * @brief Reads what ByteWriter wrote, failing instead of reading past the end
+ */
+class ByteReader {
+public:
+    ByteReader(const char* data, size_t size) : cursor(data), end(data + size) {}
+
+    template <typename T>
+    bool read(T& value) {
+        if (static_cast<size_t>(end - cursor) < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, cursor, sizeof(T));
+        cursor += sizeof(T);
+        return true;
+    }
+
+    bool readString(std::string& value) {
+        uint32_t length;
+        if (!read(length) || static_cast<size_t>(end - cursor) < length) {
+            return false;
+        }
+        value.assign(cursor, length);
+        cursor += length;
+        return true;
+    }
+
+private:
+    const char* cursor;
+    const char* end;
+};
+
+} // namespace
+
+std::string ModelLoader::getCachePath(const std::string& filename) {
+    return std::filesystem::path(filename).replace_extension(".srmesh").string();
+}
+
+bool ModelLoader::writeCache(const std::string& filename, const LoadOptions& options) const {
+    const VertexLayout layout = options.vertexLayout;
+    // Small sections
+    ByteWriter sources;
+    std::vector<std::string> paths = {filename};
+    paths.insert(paths.end(), materialSources.begin(), materialSources.end());
+    sources.write(static_cast<uint32_t>(paths.size()));
+    for (const auto& path : paths) {
+        SourceRecord record = statSource(path);
+        if (record.exists) {
+            record.hash = hashFile(path);
+        }
+        sources.writeString(record.path);
+        sources.write(static_cast<uint8_t>(record.exists));
+        sources.write(record.size);
+        sources.write(record.modified);
+        sources.write(record.hash);
+    }
+
+    ByteWriter names;
+    names.writeString(currentObjectName);
+
+    ByteWriter materialBytes;
+    materialBytes.write(static_cast<uint32_t>(materials.size()));
+    for (const auto& material : materials) {
+        materialBytes.writeString(material.name);
+        materialBytes.write(static_cast<uint8_t>(material.defined));
+        materialBytes.write(material.ambient);
+        materialBytes.write(material.diffuse);
+        materialBytes.write(material.specular);
+        materialBytes.write(material.shininess);
+        materialBytes.writeString(material.diffuseTexture);
+    }
+
+    // Section table
+    struct Payload {
+        uint32_t type;
+        const void* data;
+        size_t size;
+    };
+    std::vector<Payload> payloads = {
+        {SECTION_SOURCES, sources.data().data(), sources.data().size()},
+        {SECTION_NAMES, names.data().data(), names.data().size()},
+        {SECTION_MATERIALS, materialBytes.data().data(), materialBytes.data().size()},
+    };
+    const VertexStreams& streams = indexedMesh.streams;
+    if (layout == VertexLayout::Streams) {
+        const AlignedFloatArray* arrays[] = {&streams.positionX, &streams.positionY, &streams.positionZ,
+                                             &streams.normalX, &streams.normalY, &streams.normalZ,
+                                             &streams.texCoordU, &streams.texCoordV};
+        for (uint32_t i = 0; i < 8; ++i) {
+            payloads.push_back({SECTION_POSITION_X + i, arrays[i]->data(), arrays[i]->size() * sizeof(float)});
+        }
+    } else {
+        payloads.push_back({SECTION_VERTICES, indexedMesh.vertices.data(), indexedMesh.vertices.size() * sizeof(MeshVertex)});
+    }
+    payloads.push_back({SECTION_INDICES, indexedMesh.indices.data(), indexedMesh.indices.size() * sizeof(uint32_t)});
+    payloads.push_back({SECTION_SUBMESHES, indexedMesh.submeshes.data(), indexedMesh.submeshes.size() * sizeof(Submesh)});
+    if (options.optimizeMesh) {
+        payloads.push_back({SECTION_OPTIMIZE_STATS, &optimizeStats, sizeof(MeshOptimizeStats)});
+    }
+    if (!indexedMesh.tangents.empty()) {
+        payloads.push_back({SECTION_TANGENTS, indexedMesh.tangents.data(), indexedMesh.tangents.size() * sizeof(Tangent)});
+    }
+
+    CacheHeader header = {};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.endianTag = CACHE_ENDIAN_TAG;
+    header.layout = static_cast<uint32_t>(layout);
+    header.flags = (indexedMesh.hasTexCoords ? FLAG_TEX_COORDS : 0) | (indexedMesh.hasNormals ? FLAG_NORMALS : 0) |
+                   (options.optimizeMesh ? FLAG_OPTIMIZED : 0) |
+                   (options.generateNormals ? FLAG_GENERATED_NORMALS : 0) |
+                   (options.generateTangents ? FLAG_TANGENTS : 0);
+    header.creaseAngle = options.generateNormals ? options.creaseAngle : 0.0f;
+    header.vertexCount = indexedMesh.vertexCount();
+    header.indexCount = indexedMesh.indices.size();
+    header.submeshCount = indexedMesh.submeshes.size();
+    header.sectionCount = static_cast<uint32_t>(payloads.size());
+
+    std::vector<CacheSection> sections;
+    uint64_t offset = sizeof(CacheHeader) + payloads.size() * sizeof(CacheSection);
+    for (const auto& payload : payloads) {
+        offset = (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+        sections.push_back({payload.type, 0, offset, payload.size});
+        offset += payload.size;
+    }
+
+    // Written under a temporary name so that a reader never maps a half written cache
+    const std::string cachePath = getCachePath(filename);
+    const std::string temporaryPath = cachePath + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(CacheSection));
+        uint64_t position = sizeof(CacheHeader) + sections.size() * sizeof(CacheSection);
+        const char zeros[SECTION_ALIGNMENT] = {};
+        for (size_t i = 0; i < payloads.size(); ++i) {
+            out.write(zeros, static_cast<std::streamsize>(sections[i].offset - position));
+            out.write(static_cast<const char*>(payloads[i].data), static_cast<std::streamsize>(payloads[i].size));
+            position = sections[i].offset + payloads[i].size;
+        }
+        if (!out) {
+            out.close();
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    if (error) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ModelLoader::readCache(const std::string& filename, const LoadOptions& options) {
+    MappedFile file(getCachePath(filename));
+    if (!file.isOpen() || file.size() < sizeof(CacheHeader)) {
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION ||
+        header.endianTag != CACHE_ENDIAN_TAG || header.layout != static_cast<uint32_t>(options.vertexLayout) ||
+        ((header.flags & FLAG_OPTIMIZED) != 0) != options.optimizeMesh ||
+        ((header.flags & FLAG_GENERATED_NORMALS) != 0) != options.generateNormals ||
+        ((header.flags & FLAG_TANGENTS) != 0) != options.generateTangents ||
+        (options.generateNormals && header.creaseAngle != options.creaseAngle)) {
+        return false;
+    }
+    const uint64_t tableEnd = sizeof(CacheHeader) + static_cast<uint64_t>(header.sectionCount) * sizeof(CacheSection);
+    if (tableEnd > file.size()) {
+        return false;
+    }
+
+    // Locate and bounds check the sections
+    const char* sections[SECTION_TYPE_END] = {};
+    uint64_t sizes[SECTION_TYPE_END] = {};
+    for (uint32_t i = 0; i < header.sectionCount; ++i) {
+        CacheSection section;
+        std::memcpy(&section, file.data() + sizeof(CacheHeader) + i * sizeof(CacheSection), sizeof(section));
+        if (section.type == 0 || section.type >= SECTION_TYPE_END || section.offset % SECTION_ALIGNMENT != 0 ||
+            section.offset > file.size() || section.size > file.size() - section.offset) {
+            return false;
+        }
+        sections[section.type] = file.data() + section.offset;
+        sizes[section.type] = section.size;
+    }
+
+    // Every source must be unchanged: size and modification time are enough unless they
+    // disagree on time only or a content check is requested, then the content hash decides
+    ByteReader sources(sections[SECTION_SOURCES], sizes[SECTION_SOURCES]);
+    uint32_t sourceCount;
+    if (sections[SECTION_SOURCES] == nullptr || !sources.read(sourceCount) || sourceCount == 0) {
+        return false;
+    }
+    std::vector<std::string> cachedSources;
+    for (uint32_t i = 0; i < sourceCount; ++i) {
+        SourceRecord cached;
+        uint8_t exists;
+        if (!sources.readString(cached.path) || !sources.read(exists) || !sources.read(cached.size) ||
+            !sources.read(cached.modified) || !sources.read(cached.hash)) {
+            return false;
+        }
+        if (i == 0 && cached.path != filename) {
+            return false;
+        }
+        if (i > 0) {
+            cachedSources.push_back(cached.path);
+        }
+        const SourceRecord current = statSource(cached.path);
+        if (current.exists != (exists != 0)) {
+            return false;
+        }
+        if (!current.exists) {
+            continue;
+        }
+        if (current.size != cached.size) {
+            return false;
+        }
+        if ((options.verifyCacheHash || current.modified != cached.modified) && hashFile(cached.path) != cached.hash) {
+            return false;
+        }
+    }
+
+    // Geometry is used in place
+    IndexedMeshView view;
+    view.vertexCount = header.vertexCount;
+    view.indexCount = header.indexCount;
+    view.submeshCount = header.submeshCount;
+    view.hasTexCoords = (header.flags & FLAG_TEX_COORDS) != 0;
+    view.hasNormals = (header.flags & FLAG_NORMALS) != 0;
+    if (sizes[SECTION_INDICES] != view.indexCount * sizeof(uint32_t) ||
+        sizes[SECTION_SUBMESHES] != view.submeshCount * sizeof(Submesh)) {
+        return false;
+    }
+    view.indices = reinterpret_cast<const uint32_t*>(sections[SECTION_INDICES]);
+    view.submeshes = reinterpret_cast<const Submesh*>(sections[SECTION_SUBMESHES]);
+    if (options.vertexLayout == VertexLayout::Streams) {
+        const size_t padded = (view.vertexCount + VertexStreams::PADDING - 1) / VertexStreams::PADDING * VertexStreams::PADDING;
+        const float* arrays[8];
+        for (uint32_t i = 0; i < 8; ++i) {
+            if (sizes[SECTION_POSITION_X + i] != padded * sizeof(float)) {
+                return false;
+            }
+            arrays[i] = reinterpret_cast<const float*>(sections[SECTION_POSITION_X + i]);
+        }
+        view.streams = {arrays[0], arrays[1], arrays[2], arrays[3], arrays[4], arrays[5], arrays[6], arrays[7],
+                        view.vertexCount, padded};
+    } else {
+        if (sizes[SECTION_VERTICES] != view.vertexCount * sizeof(MeshVertex)) {
+            return false;
+        }
+        view.vertices = reinterpret_cast<const MeshVertex*>(sections[SECTION_VERTICES]);
+    }
+    if (sections[SECTION_TANGENTS] != nullptr) {
+        if (sizes[SECTION_TANGENTS] != view.vertexCount * sizeof(Tangent)) {
+            return false;
+        }
+        view.tangents = reinterpret_cast<const Tangent*>(sections[SECTION_TANGENTS]);
+    }
+
+    MeshOptimizeStats cachedStats;
+    if (options.optimizeMesh) {
+        if (sizes[SECTION_OPTIMIZE_STATS] != sizeof(MeshOptimizeStats)) {
+            return false;
+        }
+        std::memcpy(&cachedStats, sections[SECTION_OPTIMIZE_STATS], sizeof(cachedStats));
+    }
+
+    // Names and materials are small and copied out
+    ByteReader names(sections[SECTION_NAMES], sizes[SECTION_NAMES]);
+    std::string objectName;
+    if (!names.readString(objectName)) {
+        return false;
+    }
+
+    ByteReader materialBytes(sections[SECTION_MATERIALS], sizes[SECTION_MATERIALS]);
+    uint32_t materialCount;
+    if (!materialBytes.read(materialCount) || materialCount > NO_MATERIAL) {
+        return false;
+    }
+    std::vector<Material> cachedMaterials(materialCount);
+    for (auto& material : cachedMaterials) {
+        uint8_t defined;
+        if (!materialBytes.readString(material.name) || !materialBytes.read(defined) ||
+            !materialBytes.read(material.ambient) || !materialBytes.read(material.diffuse) ||
+            !materialBytes.read(material.specular) || !materialBytes.read(material.shininess) ||
+            !materialBytes.readString(material.diffuseTexture)) {
+            return false;
+        }
+        material.defined = defined != 0;
+    }
+
+    materials = std::move(cachedMaterials);
+    for (size_t i = 0; i < materials.size(); ++i) {
+        materialIds.emplace(materials[i].name, static_cast<MaterialId>(i));
+    }
+    currentObjectName = std::move(objectName);
+    materialSources = std::move(cachedSources);
+    optimizeStats = cachedStats;
+    indexedMesh.hasTexCoords = view.hasTexCoords;
+    indexedMesh.hasNormals = view.hasNormals;
+    cacheView = view;
+    cacheFile = std::move(file);
+    return true;
+}
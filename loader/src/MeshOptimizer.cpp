@@ -0,0 +1,404 @@
+#include <MeshOptimizer.h>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+/**
+ * @brief Triangles around every vertex, stored as compressed rows
+ */
+struct TriangleAdjacency {
+    std::vector<uint32_t> offsets;        ///< First entry of each vertex in triangles, vertexCount + 1 entries
+    std::vector<uint32_t> counts;         ///< Triangles per vertex
+    std::vector<uint32_t> triangles;      ///< Triangle numbers grouped by vertex
+
+    void build(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+        counts.assign(vertexCount, 0);
+        for (size_t i = 0; i < indexCount; ++i) {
+            ++counts[indices[i]];
+        }
+        offsets.resize(vertexCount + 1);
+        offsets[0] = 0;
+        for (size_t v = 0; v < vertexCount; ++v) {
+            offsets[v + 1] = offsets[v] + counts[v];
+        }
+        triangles.resize(indexCount);
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indexCount; ++i) {
+            triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+};
+
+/**
+ * @brief FIFO post-transform cache simulated with timestamps
+ * @details A vertex is in the cache if fewer than cacheSize misses happened since it was
+ * loaded, which is exactly a FIFO of cacheSize entries without moving any entries.
+ */
+class CacheSimulator {
+public:
+    CacheSimulator(size_t vertexCount, uint32_t cacheSize)
+        : timestamps(vertexCount, 0), size(cacheSize), time(cacheSize + 1) {}
+
+    /**
+     * @brief Reference a vertex
+     * @return true on a miss
+     */
+    bool access(uint32_t vertex) {
+        if (time - timestamps[vertex] > size) {
+            timestamps[vertex] = time++;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Misses since the vertex was loaded, greater than the cache size if it is not cached
+     */
+    uint32_t age(uint32_t vertex) const {
+        return time - timestamps[vertex];
+    }
+
+    /**
+     * @brief Empty the cache
+     */
+    void flush() {
+        time += size + 1;
+    }
+
+private:
+    std::vector<uint32_t> timestamps;
+    uint32_t size;
+    uint32_t time;
+};
+
+/**
+ * @brief Reorder an array so that element i moves to remap[i]
+ */
+template <typename Array>
+void permute(Array& array, const std::vector<uint32_t>& remap, Array& scratch) {
+    scratch.assign(array.begin(), array.end());
+    for (size_t i = 0; i < remap.size(); ++i) {
+        array[remap[i]] = scratch[i];
+    }
+}
+
+} // namespace
+
+float MeshOptimizer::computeACMR(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+    if (indexCount < 3) {
+        return 0.0f;
+    }
+    CacheSimulator cache(vertexCount, cacheSize);
+    size_t misses = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        misses += cache.access(indices[i]);
+    }
+    return static_cast<float>(misses) / static_cast<float>(indexCount / 3);
+}
+
+void MeshOptimizer::optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize,
+                                        std::vector<uint32_t>* clusters) {
+    const size_t triangleCount = indexCount / 3;
+    if (clusters != nullptr) {
+        clusters->clear();
+    }
+    if (triangleCount == 0) {
+        return;
+    }
+
+    TriangleAdjacency adjacency;
+    adjacency.build(indices, indexCount, vertexCount);
+    std::vector<uint32_t>& live = adjacency.counts;  // Triangles not emitted yet, per vertex
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnd;                    // Recently used vertices, most recent last
+    deadEnd.reserve(indexCount);
+    std::vector<uint32_t> output(indexCount);
+    CacheSimulator cache(vertexCount, cacheSize);
+
+    uint32_t current = 0;
+    while (current < vertexCount && live[current] == 0) {
+        ++current;
+    }
+    uint32_t inputCursor = current;
+    size_t outputTriangle = 0;
+    if (clusters != nullptr) {
+        clusters->push_back(0);
+    }
+
+    while (current != INVALID_INDEX && current < vertexCount) {
+        // Emit the whole fan around the current vertex
+        const size_t candidatesBegin = deadEnd.size();
+        for (uint32_t k = adjacency.offsets[current]; k < adjacency.offsets[current + 1]; ++k) {
+            const uint32_t triangle = adjacency.triangles[k];
+            if (emitted[triangle]) {
+                continue;
+            }
+            emitted[triangle] = true;
+            for (int corner = 0; corner < 3; ++corner) {
+                const uint32_t vertex = indices[triangle * 3 + corner];
+                output[outputTriangle * 3 + corner] = vertex;
+                deadEnd.push_back(vertex);
+                --live[vertex];
+                cache.access(vertex);
+            }
+            ++outputTriangle;
+        }
+
+        // Next fan: the fan's vertex that stays longest in the cache while its remaining
+        // triangles are emitted (each one may push up to two new vertices)
+        uint32_t next = INVALID_INDEX;
+        int64_t bestPriority = -1;
+        for (size_t i = candidatesBegin; i < deadEnd.size(); ++i) {
+            const uint32_t vertex = deadEnd[i];
+            if (live[vertex] == 0) {
+                continue;
+            }
+            int64_t priority = 0;
+            const uint32_t age = cache.age(vertex);
+            if (age + 2 * live[vertex] <= cacheSize) {
+                priority = age;
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = vertex;
+            }
+        }
+
+        if (next == INVALID_INDEX) {
+            // Dead end: go back to a recently used vertex, then to the input order
+            while (!deadEnd.empty() && next == INVALID_INDEX) {
+                const uint32_t vertex = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[vertex] > 0) {
+                    next = vertex;
+                }
+            }
+            while (next == INVALID_INDEX && inputCursor < vertexCount) {
+                if (live[inputCursor] > 0) {
+                    next = inputCursor;
+                }
+                ++inputCursor;
+            }
+            if (clusters != nullptr && next != INVALID_INDEX) {
+                clusters->push_back(static_cast<uint32_t>(outputTriangle));
+            }
+        }
+        current = next;
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+void MeshOptimizer::optimizeOverdraw(uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount,
+                                     const std::vector<uint32_t>& clusters, uint32_t cacheSize, float threshold) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || clusters.empty()) {
+        return;
+    }
+
+    // Cut every hard cluster further wherever the running ACMR drops to within threshold of
+    // the cluster's own ACMR, cutting there costs little cache efficiency
+    std::vector<uint32_t> softClusters;
+    CacheSimulator cache(vertexCount, cacheSize);
+    for (size_t c = 0; c < clusters.size(); ++c) {
+        const uint32_t begin = clusters[c];
+        const uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : static_cast<uint32_t>(triangleCount);
+        if (begin >= end) {
+            continue;
+        }
+        cache.flush();
+        size_t clusterMisses = 0;
+        for (uint32_t t = begin; t < end; ++t) {
+            for (int corner = 0; corner < 3; ++corner) {
+                clusterMisses += cache.access(indices[t * 3 + corner]);
+            }
+        }
+        const float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+        cache.flush();
+        softClusters.push_back(begin);
+        size_t runMisses = 0, runTriangles = 0;
+        for (uint32_t t = begin; t < end; ++t) {
+            for (int corner = 0; corner < 3; ++corner) {
+                runMisses += cache.access(indices[t * 3 + corner]);
+            }
+            ++runTriangles;
+            if (t + 1 < end && static_cast<float>(runMisses) <= clusterThreshold * static_cast<float>(runTriangles)) {
+                softClusters.push_back(t + 1);
+                cache.flush();
+                runMisses = runTriangles = 0;
+            }
+        }
+    }
+
+    // Area weighted centroid and normal of every cluster, and of the whole range
+    const size_t clusterCount = softClusters.size();
+    std::vector<float> centroids(clusterCount * 3, 0.0f);
+    std::vector<float> sortKeys(clusterCount, 0.0f);
+    std::vector<float> clusterNormals(clusterCount * 3, 0.0f);
+    double meshCentroid[3] = {0.0, 0.0, 0.0};
+    double meshArea = 0.0;
+    for (size_t c = 0; c < clusterCount; ++c) {
+        const uint32_t begin = softClusters[c];
+        const uint32_t end = c + 1 < clusterCount ? softClusters[c + 1] : static_cast<uint32_t>(triangleCount);
+        float area = 0.0f;
+        float centroid[3] = {0.0f, 0.0f, 0.0f};
+        float normal[3] = {0.0f, 0.0f, 0.0f};
+        for (uint32_t t = begin; t < end; ++t) {
+            const float* a = positions + indices[t * 3] * 3;
+            const float* b = positions + indices[t * 3 + 1] * 3;
+            const float* p = positions + indices[t * 3 + 2] * 3;
+            const float e0[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            const float e1[3] = {p[0] - a[0], p[1] - a[1], p[2] - a[2]};
+            const float n[3] = {e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0]};
+            const float doubleArea = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (int k = 0; k < 3; ++k) {
+                centroid[k] += (a[k] + b[k] + p[k]) * (doubleArea / 3.0f);
+                normal[k] += n[k];
+            }
+            area += doubleArea;
+        }
+        const float inverseArea = area > 0.0f ? 1.0f / area : 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            centroids[c * 3 + k] = centroid[k] * inverseArea;
+            clusterNormals[c * 3 + k] = normal[k];
+            meshCentroid[k] += centroid[k];
+        }
+        meshArea += area;
+    }
+    for (double& coordinate : meshCentroid) {
+        coordinate = meshArea > 0.0 ? coordinate / meshArea : 0.0;
+    }
+
+    // Clusters facing away from the centre are likely in front of the others from any view
+    for (size_t c = 0; c < clusterCount; ++c) {
+        const float* n = &clusterNormals[c * 3];
+        const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length <= 0.0f) {
+            continue;
+        }
+        float dot = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            dot += (centroids[c * 3 + k] - static_cast<float>(meshCentroid[k])) * n[k];
+        }
+        sortKeys[c] = dot / length;
+    }
+    std::vector<uint32_t> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        order[c] = static_cast<uint32_t>(c);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(indexCount);
+    for (uint32_t c : order) {
+        const uint32_t begin = softClusters[c];
+        const uint32_t end = c + 1 < clusterCount ? softClusters[c + 1] : static_cast<uint32_t>(triangleCount);
+        output.insert(output.end(), indices + begin * 3, indices + end * 3);
+    }
+    std::copy(output.begin(), output.end(), indices);
+}
+
+void MeshOptimizer::optimizeVertexFetch(IndexedMesh& mesh) {
+    const size_t vertexCount = mesh.vertexCount();
+    std::vector<uint32_t> remap(vertexCount, INVALID_INDEX);
+    uint32_t next = 0;
+    for (uint32_t& index : mesh.indices) {
+        if (remap[index] == INVALID_INDEX) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+    // Vertices no triangle uses keep their relative order at the end
+    for (uint32_t& target : remap) {
+        if (target == INVALID_INDEX) {
+            target = next++;
+        }
+    }
+
+    if (!mesh.vertices.empty()) {
+        std::vector<MeshVertex> scratch;
+        permute(mesh.vertices, remap, scratch);
+    } else {
+        AlignedFloatArray scratch;
+        AlignedFloatArray* streams[] = {&mesh.streams.positionX, &mesh.streams.positionY, &mesh.streams.positionZ,
+                                        &mesh.streams.normalX, &mesh.streams.normalY, &mesh.streams.normalZ,
+                                        &mesh.streams.texCoordU, &mesh.streams.texCoordV};
+        for (AlignedFloatArray* stream : streams) {
+            permute(*stream, remap, scratch);
+        }
+    }
+    if (!mesh.tangents.empty()) {
+        std::vector<Tangent> scratch;
+        permute(mesh.tangents, remap, scratch);
+    }
+}
+
+MeshOptimizeStats MeshOptimizer::optimize(IndexedMesh& mesh, const MeshOptimizeOptions& options) {
+    MeshOptimizeStats stats;
+    const size_t vertexCount = mesh.vertexCount();
+    const size_t indexCount = mesh.indices.size();
+    if (vertexCount == 0 || indexCount < 3) {
+        return stats;
+    }
+    const float trianglesPerVertex = static_cast<float>(indexCount / 3) / static_cast<float>(vertexCount);
+    stats.acmrBefore = computeACMR(mesh.indices.data(), indexCount, vertexCount, options.cacheSize);
+    stats.atvrBefore = stats.acmrBefore * trianglesPerVertex;
+
+    // Submeshes are optimized separately, with their vertices renumbered locally so that the
+    // per-vertex work arrays only cover the submesh
+    std::vector<uint32_t> globalToLocal(vertexCount, INVALID_INDEX);
+    std::vector<uint32_t> localToGlobal;
+    std::vector<uint32_t> localIndices;
+    std::vector<float> localPositions;
+    std::vector<uint32_t> clusters;
+    const bool overdraw = options.overdrawThreshold > 0.0f;
+    for (const Submesh& submesh : mesh.submeshes) {
+        uint32_t* range = mesh.indices.data() + submesh.firstIndex;
+        const size_t count = submesh.indexCount / 3 * 3;
+        if (count == 0) {
+            continue;
+        }
+        localToGlobal.clear();
+        localIndices.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t& local = globalToLocal[range[i]];
+            if (local == INVALID_INDEX) {
+                local = static_cast<uint32_t>(localToGlobal.size());
+                localToGlobal.push_back(range[i]);
+            }
+            localIndices[i] = local;
+        }
+
+        optimizeVertexCache(localIndices.data(), count, localToGlobal.size(), options.cacheSize,
+                            overdraw ? &clusters : nullptr);
+        if (overdraw) {
+            localPositions.resize(localToGlobal.size() * 3);
+            for (size_t v = 0; v < localToGlobal.size(); ++v) {
+                const Vertex position = mesh.vertex(localToGlobal[v]).position;
+                localPositions[v * 3] = position.x;
+                localPositions[v * 3 + 1] = position.y;
+                localPositions[v * 3 + 2] = position.z;
+            }
+            optimizeOverdraw(localIndices.data(), count, localPositions.data(), localToGlobal.size(), clusters,
+                             options.cacheSize, options.overdrawThreshold);
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            range[i] = localToGlobal[localIndices[i]];
+        }
+        for (uint32_t vertex : localToGlobal) {
+            globalToLocal[vertex] = INVALID_INDEX;
+        }
+    }
+
+    if (options.optimizeVertexFetch) {
+        optimizeVertexFetch(mesh);
+    }
+    stats.acmrAfter = computeACMR(mesh.indices.data(), indexCount, vertexCount, options.cacheSize);
+    stats.atvrAfter = stats.acmrAfter * trianglesPerVertex;
+    return stats;
+}
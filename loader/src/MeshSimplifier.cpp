@@ -0,0 +1,645 @@
+#include <MeshSimplifier.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <tuple>
+
+namespace {
+
+constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+constexpr float BORDER_WEIGHT = 10.0f;    // Border edges resist much more than the surface
+constexpr float SEAM_WEIGHT = 1.0f;
+
+/**
+ * @brief How a vertex may move, see MeshSimplifier
+ */
+enum class VertexKind : uint8_t {
+    Manifold,
+    Border,
+    Seam,
+    Locked
+};
+
+struct Vec3 {
+    float x, y, z;
+};
+
+inline Vec3 operator-(const Vec3& a, const Vec3& b) {
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+inline Vec3 cross(const Vec3& a, const Vec3& b) {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+inline float dot(const Vec3& a, const Vec3& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline float normalize(Vec3& v) {
+    float length = std::sqrt(dot(v, v));
+    if (length > 0.0f) {
+        v = {v.x / length, v.y / length, v.z / length};
+    }
+    return length;
+}
+
+/**
+ * @brief Sum of weighted squared distances to planes, as a symmetric 4x4 matrix
+ * @details Stored in double: the error of a collapse on a dense mesh is many orders of
+ * magnitude below the terms it is computed from.
+ */
+struct Quadric {
+    double a00 = 0, a11 = 0, a22 = 0, a10 = 0, a20 = 0, a21 = 0;
+    double b0 = 0, b1 = 0, b2 = 0, c = 0;
+    double weight = 0;
+
+    /**
+     * @brief Add the plane dot(normal, p) + d = 0 (normal of unit length)
+     */
+    void addPlane(const Vec3& n, double d, double w) {
+        a00 += w * n.x * n.x;
+        a11 += w * n.y * n.y;
+        a22 += w * n.z * n.z;
+        a10 += w * n.y * n.x;
+        a20 += w * n.z * n.x;
+        a21 += w * n.z * n.y;
+        b0 += w * n.x * d;
+        b1 += w * n.y * d;
+        b2 += w * n.z * d;
+        c += w * d * d;
+        weight += w;
+    }
+
+    void add(const Quadric& q) {
+        a00 += q.a00; a11 += q.a11; a22 += q.a22;
+        a10 += q.a10; a20 += q.a20; a21 += q.a21;
+        b0 += q.b0; b1 += q.b1; b2 += q.b2;
+        c += q.c;
+        weight += q.weight;
+    }
+
+    /**
+     * @brief Mean squared distance of p to the planes
+     */
+    float error(const Vec3& p) const {
+        double rx = a00 * p.x + a10 * p.y + a20 * p.z + b0;
+        double ry = a10 * p.x + a11 * p.y + a21 * p.z + b1;
+        double rz = a20 * p.x + a21 * p.y + a22 * p.z + b2;
+        double r = rx * p.x + ry * p.y + rz * p.z + b0 * p.x + b1 * p.y + b2 * p.z + c;
+        return weight > 0.0 ? static_cast<float>(std::fabs(r) / weight) : 0.0f;
+    }
+};
+
+/**
+ * @brief Triangles around every vertex, stored as compressed rows
+ */
+struct VertexTriangles {
+    std::vector<uint32_t> offsets;        ///< First entry of each vertex in triangles, vertexCount + 1 entries
+    std::vector<uint32_t> triangles;      ///< Triangle numbers grouped by vertex
+
+    void build(const std::vector<uint32_t>& indices, size_t vertexCount) {
+        offsets.assign(vertexCount + 1, 0);
+        for (uint32_t v : indices) {
+            ++offsets[v + 1];
+        }
+        for (size_t v = 0; v < vertexCount; ++v) {
+            offsets[v + 1] += offsets[v];
+        }
+        triangles.resize(indices.size());
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+};
+
+struct Collapse {
+    uint32_t from;
+    uint32_t to;
+    float error;
+};
+
+/**
+ * @brief Approximate, stable sort of collapses by error in linear time
+ * @details Errors are non-negative, so their float bits order like the values; the exponent
+ * and the top mantissa bits form the bucket, errors in one bucket are within 12.5%.
+ */
+void sortByError(std::vector<Collapse>& collapses) {
+    constexpr int BUCKET_BITS = 11;
+    auto bucket = [](float error) {
+        uint32_t bits;
+        std::memcpy(&bits, &error, sizeof(bits));
+        return (bits & 0x7FFFFFFFu) >> (31 - BUCKET_BITS);
+    };
+    std::vector<uint32_t> offsets((1u << BUCKET_BITS) + 1, 0);
+    for (const Collapse& collapse : collapses) {
+        ++offsets[bucket(collapse.error) + 1];
+    }
+    for (size_t b = 1; b < offsets.size(); ++b) {
+        offsets[b] += offsets[b - 1];
+    }
+    std::vector<Collapse> sorted(collapses.size());
+    for (const Collapse& collapse : collapses) {
+        sorted[offsets[bucket(collapse.error)]++] = collapse;
+    }
+    collapses.swap(sorted);
+}
+
+/**
+ * @brief Simplification state shared by all levels of a chain
+ */
+class Simplifier {
+public:
+    Simplifier(const IndexedMesh& mesh, const SimplifyOptions& options);
+
+    /**
+     * @brief Collapse edges until at most targetTriangles remain or the error limit is reached
+     */
+    void simplify(size_t targetTriangles);
+
+    /**
+     * @brief The current triangles as a level of the chain
+     */
+    LodLevel snapshot() const;
+
+    const Vec3& center() const { return origin; }
+    float radius() const { return scale; }
+
+private:
+    void remapPositions();
+    void classifyVertices();
+    void computeQuadrics();
+    bool canCollapse(uint32_t from, uint32_t to) const;
+    bool flipsTriangle(uint32_t from, uint32_t to) const;
+    size_t collapsePass(size_t triangleGoal);
+
+    const IndexedMesh& source;
+    bool lockBorder;
+    float errorLimit;                     // Squared, in normalized units
+    float maxError = 0.0f;                // Largest collapse error so far, squared
+    Vec3 origin = {0.0f, 0.0f, 0.0f};
+    float scale = 0.0f;
+
+    std::vector<Vec3> positions;          // Normalized to the unit sphere around the bounds
+    std::vector<uint32_t> indices;        // Current triangles
+    std::vector<uint32_t> triangleSubmesh; // Source submesh of each current triangle
+    std::vector<uint32_t> remap;          // First vertex with the same position
+    std::vector<uint32_t> wedge;          // Next vertex with the same position, cyclic
+    std::vector<VertexKind> kinds;
+    std::vector<uint32_t> loop;           // Target of the single open outgoing edge of border and seam vertices
+    std::vector<uint32_t> loopBack;       // Source of the single open incoming edge
+    std::vector<Quadric> quadrics;        // Indexed by remap
+
+    VertexTriangles adjacency;            // Rebuilt every pass
+    std::vector<uint32_t> collapseRemap;
+    std::vector<bool> collapseLocked;     // Indexed by remap
+};
+
+Simplifier::Simplifier(const IndexedMesh& mesh, const SimplifyOptions& options)
+    : source(mesh), lockBorder(options.lockBorder), errorLimit(options.maxError * options.maxError) {
+    const size_t vertexCount = mesh.vertexCount();
+    positions.resize(vertexCount);
+    Vec3 lower = {FLT_MAX, FLT_MAX, FLT_MAX};
+    Vec3 upper = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const Vertex p = mesh.vertex(i).position;
+        positions[i] = {p.x, p.y, p.z};
+        lower = {std::min(lower.x, p.x), std::min(lower.y, p.y), std::min(lower.z, p.z)};
+        upper = {std::max(upper.x, p.x), std::max(upper.y, p.y), std::max(upper.z, p.z)};
+    }
+    if (vertexCount > 0) {
+        origin = {(lower.x + upper.x) * 0.5f, (lower.y + upper.y) * 0.5f, (lower.z + upper.z) * 0.5f};
+    }
+    for (const Vec3& p : positions) {
+        Vec3 d = p - origin;
+        scale = std::max(scale, dot(d, d));
+    }
+    scale = std::sqrt(scale);
+    // Quadrics of large coordinates lose most of their float precision, so errors are
+    // computed in a unit sphere and scaled back in snapshot
+    const float inverse = scale > 0.0f ? 1.0f / scale : 0.0f;
+    for (Vec3& p : positions) {
+        Vec3 d = p - origin;
+        p = {d.x * inverse, d.y * inverse, d.z * inverse};
+    }
+
+    indices = mesh.indices;
+    triangleSubmesh.resize(indices.size() / 3);
+    for (size_t s = 0; s < mesh.submeshes.size(); ++s) {
+        const Submesh& submesh = mesh.submeshes[s];
+        std::fill(triangleSubmesh.begin() + submesh.firstIndex / 3,
+                  triangleSubmesh.begin() + (submesh.firstIndex + submesh.indexCount) / 3, static_cast<uint32_t>(s));
+    }
+
+    remapPositions();
+    classifyVertices();
+    computeQuadrics();
+    collapseRemap.resize(vertexCount);
+    collapseLocked.resize(vertexCount);
+}
+
+void Simplifier::remapPositions() {
+    const size_t vertexCount = positions.size();
+    std::vector<uint32_t> order(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    auto key = [this](uint32_t v) {
+        const Vec3& p = positions[v];
+        return std::make_tuple(p.x, p.y, p.z);
+    };
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return key(a) < key(b) || (key(a) == key(b) && a < b);
+    });
+
+    remap.resize(vertexCount);
+    wedge.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount;) {
+        size_t end = i + 1;
+        while (end < vertexCount && key(order[end]) == key(order[i])) {
+            ++end;
+        }
+        for (size_t j = i; j < end; ++j) {
+            remap[order[j]] = order[i];
+            wedge[order[j]] = order[j + 1 < end ? j + 1 : i];
+        }
+        i = end;
+    }
+}
+
+void Simplifier::classifyVertices() {
+    const size_t vertexCount = positions.size();
+    adjacency.build(indices, vertexCount);
+
+    // An edge is open if no triangle of the same submesh uses it in the other direction;
+    // "attribute" edges compare vertices, "position" edges compare remap
+    auto hasEdge = [this](uint32_t from, uint32_t to, uint32_t submesh, bool byPosition) {
+        uint32_t v = from;
+        do {
+            for (uint32_t k = adjacency.offsets[v]; k < adjacency.offsets[v + 1]; ++k) {
+                uint32_t t = adjacency.triangles[k];
+                if (triangleSubmesh[t] != submesh) {
+                    continue;
+                }
+                const uint32_t* corners = &indices[t * 3];
+                uint32_t c = corners[0] == v ? 0 : (corners[1] == v ? 1 : 2);
+                uint32_t next = corners[(c + 1) % 3];
+                if (byPosition ? remap[next] == remap[to] : next == to) {
+                    return true;
+                }
+            }
+            v = byPosition ? wedge[v] : from;
+        } while (v != from);
+        return false;
+    };
+
+    // INVALID_INDEX: no open edge, the vertex itself: more than one
+    auto record = [](std::vector<uint32_t>& slot, uint32_t vertex, uint32_t other) {
+        slot[vertex] = slot[vertex] == INVALID_INDEX ? other : vertex;
+    };
+    std::vector<uint32_t> positionOut(vertexCount, INVALID_INDEX);
+    std::vector<uint32_t> positionIn(vertexCount, INVALID_INDEX);
+    loop.assign(vertexCount, INVALID_INDEX);
+    loopBack.assign(vertexCount, INVALID_INDEX);
+    for (size_t t = 0; t < indices.size() / 3; ++t) {
+        for (int e = 0; e < 3; ++e) {
+            uint32_t from = indices[t * 3 + e];
+            uint32_t to = indices[t * 3 + (e + 1) % 3];
+            if (hasEdge(to, from, triangleSubmesh[t], false)) {
+                continue;
+            }
+            record(loop, from, to);
+            record(loopBack, to, from);
+            if (!hasEdge(to, from, triangleSubmesh[t], true)) {
+                record(positionOut, from, to);
+                record(positionIn, to, from);
+            }
+        }
+    }
+
+    auto single = [](uint32_t open, uint32_t vertex) {
+        return open != INVALID_INDEX && open != vertex;
+    };
+    kinds.assign(vertexCount, VertexKind::Locked);
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+        if (remap[v] != v) {
+            continue;
+        }
+        VertexKind kind = VertexKind::Locked;
+        if (wedge[v] == v) {
+            if (loop[v] == INVALID_INDEX && loopBack[v] == INVALID_INDEX) {
+                kind = VertexKind::Manifold;
+            } else if (single(positionOut[v], v) && single(positionIn[v], v) &&
+                       loop[v] == positionOut[v] && loopBack[v] == positionIn[v]) {
+                kind = lockBorder ? VertexKind::Locked : VertexKind::Border;
+            }
+        } else if (wedge[wedge[v]] == v) {
+            // Two wedges whose open edges close each other: a UV or normal seam through the surface
+            uint32_t w = wedge[v];
+            if (positionOut[v] == INVALID_INDEX && positionIn[v] == INVALID_INDEX &&
+                positionOut[w] == INVALID_INDEX && positionIn[w] == INVALID_INDEX &&
+                single(loop[v], v) && single(loopBack[v], v) && single(loop[w], w) && single(loopBack[w], w) &&
+                remap[loop[v]] == remap[loopBack[w]] && remap[loopBack[v]] == remap[loop[w]] &&
+                remap[loop[v]] != remap[loopBack[v]]) {
+                kind = VertexKind::Seam;
+            }
+        }
+        uint32_t w = v;
+        do {
+            kinds[w] = kind;
+            w = wedge[w];
+        } while (w != v);
+    }
+}
+
+void Simplifier::computeQuadrics() {
+    quadrics.assign(positions.size(), Quadric());
+    for (size_t t = 0; t < indices.size() / 3; ++t) {
+        const uint32_t* corners = &indices[t * 3];
+        const Vec3& p0 = positions[corners[0]];
+        Vec3 normal = cross(positions[corners[1]] - p0, positions[corners[2]] - p0);
+        float area = normalize(normal);
+        Quadric q;
+        q.addPlane(normal, -dot(normal, p0), area);
+        for (int c = 0; c < 3; ++c) {
+            quadrics[remap[corners[c]]].add(q);
+        }
+
+        // Border and seam edges also keep their distance to a plane through the edge,
+        // perpendicular to the triangle, so they cannot be pulled inwards
+        for (int e = 0; e < 3; ++e) {
+            uint32_t i0 = corners[e];
+            uint32_t i1 = corners[(e + 1) % 3];
+            VertexKind k0 = kinds[i0];
+            VertexKind k1 = kinds[i1];
+            bool open0 = k0 == VertexKind::Border || k0 == VertexKind::Seam;
+            bool open1 = k1 == VertexKind::Border || k1 == VertexKind::Seam;
+            if ((!open0 && !open1) || (open0 && loop[i0] != i1) || (open1 && loopBack[i1] != i0)) {
+                continue;
+            }
+            // Seam edges are found from both sides
+            if (k0 != VertexKind::Border && k1 != VertexKind::Border && remap[i1] > remap[i0]) {
+                continue;
+            }
+            Vec3 edge = positions[i1] - positions[i0];
+            float length = normalize(edge);
+            Vec3 perpendicular = cross(edge, normal);
+            normalize(perpendicular);
+            float weight = (k0 == VertexKind::Border || k1 == VertexKind::Border) ? BORDER_WEIGHT : SEAM_WEIGHT;
+            Quadric edgeQuadric;
+            edgeQuadric.addPlane(perpendicular, -dot(perpendicular, positions[i0]), length * length * weight);
+            quadrics[remap[i0]].add(edgeQuadric);
+            quadrics[remap[i1]].add(edgeQuadric);
+        }
+    }
+}
+
+bool Simplifier::canCollapse(uint32_t from, uint32_t to) const {
+    VertexKind kind = kinds[from];
+    VertexKind target = kinds[to];
+    switch (kind) {
+    case VertexKind::Manifold:
+        return true;
+    case VertexKind::Border:
+        return (target == VertexKind::Border || target == VertexKind::Locked) &&
+               (loop[from] == to || loopBack[from] == to);
+    case VertexKind::Seam:
+        return (target == VertexKind::Seam || target == VertexKind::Locked) &&
+               (loop[from] == to || loopBack[from] == to);
+    default:
+        return false;
+    }
+}
+
+bool Simplifier::flipsTriangle(uint32_t from, uint32_t to) const {
+    const Vec3& target = positions[to];
+    uint32_t v = from;
+    do {
+        for (uint32_t k = adjacency.offsets[v]; k < adjacency.offsets[v + 1]; ++k) {
+            const uint32_t* corners = &indices[adjacency.triangles[k] * 3];
+            uint32_t c = corners[0] == v ? 0 : (corners[1] == v ? 1 : 2);
+            uint32_t a = collapseRemap[corners[(c + 1) % 3]];
+            uint32_t b = collapseRemap[corners[(c + 2) % 3]];
+            // Triangles on the collapsed edge disappear
+            if (remap[a] == remap[to] || remap[b] == remap[to]) {
+                continue;
+            }
+            const Vec3& pv = positions[v];
+            Vec3 before = cross(positions[a] - pv, positions[b] - pv);
+            Vec3 after = cross(positions[a] - target, positions[b] - target);
+            if (dot(before, after) <= 0.0f) {
+                return true;
+            }
+        }
+        v = wedge[v];
+    } while (v != from);
+    return false;
+}
+
+size_t Simplifier::collapsePass(size_t triangleGoal) {
+    const size_t triangleCount = indices.size() / 3;
+    adjacency.build(indices, positions.size());
+
+    // The cheaper direction of every edge that may collapse
+    std::vector<Collapse> collapses;
+    collapses.reserve(triangleCount * 3);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        for (int e = 0; e < 3; ++e) {
+            uint32_t i0 = indices[t * 3 + e];
+            uint32_t i1 = indices[t * 3 + (e + 1) % 3];
+            bool forward = canCollapse(i0, i1);
+            bool backward = canCollapse(i1, i0);
+            // Interior edges appear in two triangles, keep one
+            if (forward && backward && kinds[i0] == kinds[i1] && remap[i0] > remap[i1]) {
+                continue;
+            }
+            float forwardError = forward ? quadrics[remap[i0]].error(positions[i1]) : FLT_MAX;
+            float backwardError = backward ? quadrics[remap[i1]].error(positions[i0]) : FLT_MAX;
+            if (forward && forwardError <= backwardError) {
+                collapses.push_back({i0, i1, forwardError});
+            } else if (backward) {
+                collapses.push_back({i1, i0, backwardError});
+            }
+        }
+    }
+    if (collapses.empty()) {
+        return 0;
+    }
+    sortByError(collapses);
+
+    // Most collapses remove two triangles; past the goal, stop at errors well above the
+    // cheapest ones so that one pass does not spend all the budget on the first edges it meets
+    size_t edgeGoal = triangleGoal / 2;
+    float limit = errorLimit;
+    if (edgeGoal < collapses.size()) {
+        limit = std::min(limit, collapses[edgeGoal].error * 1.5f);
+    }
+
+    for (size_t v = 0; v < collapseRemap.size(); ++v) {
+        collapseRemap[v] = static_cast<uint32_t>(v);
+    }
+    std::fill(collapseLocked.begin(), collapseLocked.end(), false);
+
+    const size_t minimumProgress = std::max<size_t>(triangleGoal / 8, 1);
+    size_t removed = 0;
+    for (const Collapse& collapse : collapses) {
+        if (removed >= triangleGoal || collapse.error > errorLimit) {
+            break;
+        }
+        if (collapse.error > limit) {
+            // The cheap collapses may be mostly blocked by flips, then the pass moves on to
+            // the next error band instead of making almost no progress
+            if (removed >= minimumProgress) {
+                break;
+            }
+            limit = collapse.error * 1.5f;
+        }
+        uint32_t i0 = collapse.from;
+        uint32_t i1 = collapse.to;
+        uint32_t r0 = remap[i0];
+        uint32_t r1 = remap[i1];
+        if (collapseLocked[r0] || collapseLocked[r1] || flipsTriangle(i0, i1)) {
+            continue;
+        }
+
+        if (kinds[i0] == VertexKind::Seam) {
+            // The other side of the seam moves to the matching wedge of the target
+            uint32_t s0 = wedge[i0];
+            uint32_t s1 = loop[i0] == i1 ? loopBack[s0] : loop[s0];
+            if (s1 == INVALID_INDEX || remap[s1] != r1) {
+                continue;
+            }
+            collapseRemap[s0] = s1;
+        }
+        collapseRemap[i0] = i1;
+        collapseLocked[r0] = true;
+        collapseLocked[r1] = true;
+        quadrics[r1].add(quadrics[r0]);
+        maxError = std::max(maxError, collapse.error);
+        removed += kinds[i0] == VertexKind::Border ? 1 : 2;
+    }
+    if (removed == 0) {
+        return 0;
+    }
+
+    // Loops that pointed at a collapsed vertex skip it
+    for (std::vector<uint32_t>* edges : {&loop, &loopBack}) {
+        std::vector<uint32_t>& next = *edges;
+        for (size_t v = 0; v < next.size(); ++v) {
+            if (next[v] != INVALID_INDEX) {
+                uint32_t target = collapseRemap[next[v]];
+                next[v] = target == v ? next[next[v]] : target;
+            }
+        }
+    }
+
+    // Apply the collapses and drop the triangles that became degenerate, keeping the order
+    size_t kept = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        uint32_t a = collapseRemap[indices[t * 3 + 0]];
+        uint32_t b = collapseRemap[indices[t * 3 + 1]];
+        uint32_t c = collapseRemap[indices[t * 3 + 2]];
+        if (remap[a] == remap[b] || remap[b] == remap[c] || remap[c] == remap[a]) {
+            continue;
+        }
+        indices[kept * 3 + 0] = a;
+        indices[kept * 3 + 1] = b;
+        indices[kept * 3 + 2] = c;
+        triangleSubmesh[kept] = triangleSubmesh[t];
+        ++kept;
+    }
+    indices.resize(kept * 3);
+    triangleSubmesh.resize(kept);
+    return triangleCount - kept;
+}
+
+void Simplifier::simplify(size_t targetTriangles) {
+    while (indices.size() / 3 > targetTriangles) {
+        if (collapsePass(indices.size() / 3 - targetTriangles) == 0) {
+            break;
+        }
+    }
+}
+
+LodLevel Simplifier::snapshot() const {
+    LodLevel level;
+    level.indices = indices;
+    for (size_t t = 0; t < triangleSubmesh.size(); ++t) {
+        uint32_t s = triangleSubmesh[t];
+        if (t == 0 || s != triangleSubmesh[t - 1]) {
+            level.submeshes.push_back({static_cast<uint32_t>(t * 3), 0, source.submeshes[s].material});
+        }
+        level.submeshes.back().indexCount += 3;
+    }
+    level.error = std::sqrt(maxError) * scale;
+    return level;
+}
+
+} // namespace
+
+size_t LodChain::selectLevel(float pixelsPerUnit, float maxPixelError) const {
+    for (size_t i = levels.size(); i > 1; --i) {
+        if (levels[i - 1].error * pixelsPerUnit <= maxPixelError) {
+            return i - 1;
+        }
+    }
+    return 0;
+}
+
+std::vector<Triangle> LodChain::getTriangles(const IndexedMesh& mesh, size_t level) const {
+    std::vector<Triangle> triangles;
+    if (level >= levels.size()) {
+        return triangles;
+    }
+    const LodLevel& lod = levels[level];
+    triangles.reserve(lod.indices.size() / 3);
+    for (const Submesh& submesh : lod.submeshes) {
+        Triangle triangle;
+        triangle.hasTextures = mesh.hasTexCoords;
+        triangle.hasNormals = mesh.hasNormals;
+        triangle.materialId = submesh.material;
+        for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; i += 3) {
+            MeshVertex v0 = mesh.vertex(lod.indices[i + 0]);
+            MeshVertex v1 = mesh.vertex(lod.indices[i + 1]);
+            MeshVertex v2 = mesh.vertex(lod.indices[i + 2]);
+            triangle.v0 = v0.position;
+            triangle.v1 = v1.position;
+            triangle.v2 = v2.position;
+            triangle.t0 = v0.texCoord;
+            triangle.t1 = v1.texCoord;
+            triangle.t2 = v2.texCoord;
+            triangle.n0 = v0.normal;
+            triangle.n1 = v1.normal;
+            triangle.n2 = v2.normal;
+            triangles.push_back(triangle);
+        }
+    }
+    return triangles;
+}
+
+LodLevel MeshSimplifier::simplify(const IndexedMesh& mesh, float ratio, const SimplifyOptions& options) {
+    Simplifier simplifier(mesh, options);
+    simplifier.simplify(static_cast<size_t>(static_cast<double>(mesh.indices.size() / 3) * ratio));
+    return simplifier.snapshot();
+}
+
+LodChain MeshSimplifier::buildLodChain(const IndexedMesh& mesh, const std::vector<float>& ratios,
+                                       const SimplifyOptions& options) {
+    LodChain chain;
+    Simplifier simplifier(mesh, options);
+    chain.center[0] = simplifier.center().x;
+    chain.center[1] = simplifier.center().y;
+    chain.center[2] = simplifier.center().z;
+    chain.radius = simplifier.radius();
+
+    // Every level continues from the previous one, so the errors never decrease
+    chain.levels.push_back(simplifier.snapshot());
+    const size_t triangleCount = mesh.indices.size() / 3;
+    for (float ratio : ratios) {
+        simplifier.simplify(static_cast<size_t>(static_cast<double>(triangleCount) * ratio));
+        chain.levels.push_back(simplifier.snapshot());
+    }
+    return chain;
+}
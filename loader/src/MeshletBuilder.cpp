@@ -0,0 +1,322 @@
+#include <MeshletBuilder.h>
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+constexpr float LIVE_WEIGHT = 0.05f;      // Score per remaining triangle around the corners
+
+/**
+ * @brief Unemitted triangles around every vertex, stored as compressed rows
+ * @details Emitted triangles are swapped out of the rows, so the neighbour search of a growing
+ * meshlet only sees triangles that may still join it.
+ */
+struct LiveAdjacency {
+    std::vector<uint32_t> offsets;        ///< First entry of each vertex in triangles
+    std::vector<uint32_t> counts;         ///< Unemitted triangles per vertex
+    std::vector<uint32_t> triangles;      ///< Triangle numbers grouped by vertex
+
+    void build(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+        counts.assign(vertexCount, 0);
+        for (size_t i = 0; i < indexCount; ++i) {
+            ++counts[indices[i]];
+        }
+        offsets.resize(vertexCount + 1);
+        offsets[0] = 0;
+        for (size_t v = 0; v < vertexCount; ++v) {
+            offsets[v + 1] = offsets[v] + counts[v];
+        }
+        triangles.resize(indexCount);
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indexCount; ++i) {
+            triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    void remove(uint32_t vertex, uint32_t triangle) {
+        uint32_t* row = &triangles[offsets[vertex]];
+        uint32_t& count = counts[vertex];
+        for (uint32_t k = 0; k < count; ++k) {
+            if (row[k] == triangle) {
+                row[k] = row[--count];
+                return;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Smallest sphere found by Ritter's method: start from the most distant pair of axis
+ * extremes and grow until every point is inside
+ */
+void boundingSphere(const std::vector<std::array<float, 3>>& points, float center[3], float& radius) {
+    size_t extremes[6] = {0, 0, 0, 0, 0, 0};
+    for (size_t i = 0; i < points.size(); ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (points[i][axis] < points[extremes[axis * 2]][axis]) {
+                extremes[axis * 2] = i;
+            }
+            if (points[i][axis] > points[extremes[axis * 2 + 1]][axis]) {
+                extremes[axis * 2 + 1] = i;
+            }
+        }
+    }
+    auto distance2 = [](const std::array<float, 3>& a, const std::array<float, 3>& b) {
+        float dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+        return dx * dx + dy * dy + dz * dz;
+    };
+    int widest = 0;
+    for (int axis = 1; axis < 3; ++axis) {
+        if (distance2(points[extremes[axis * 2]], points[extremes[axis * 2 + 1]]) >
+            distance2(points[extremes[widest * 2]], points[extremes[widest * 2 + 1]])) {
+            widest = axis;
+        }
+    }
+    const std::array<float, 3>& a = points[extremes[widest * 2]];
+    const std::array<float, 3>& b = points[extremes[widest * 2 + 1]];
+    for (int k = 0; k < 3; ++k) {
+        center[k] = (a[k] + b[k]) * 0.5f;
+    }
+    radius = std::sqrt(distance2(a, b)) * 0.5f;
+
+    for (const std::array<float, 3>& p : points) {
+        float d2 = distance2(p, {center[0], center[1], center[2]});
+        if (d2 > radius * radius) {
+            float d = std::sqrt(d2);
+            float grown = (radius + d) * 0.5f;
+            float shift = (grown - radius) / d;
+            for (int k = 0; k < 3; ++k) {
+                center[k] += (p[k] - center[k]) * shift;
+            }
+            radius = grown;
+        }
+    }
+    // Rounding of the last updates must not leave a point outside
+    radius *= 1.0f + FLT_EPSILON * 4.0f;
+}
+
+/**
+ * @brief Builds one meshlet at a time
+ */
+class MeshletWriter {
+public:
+    MeshletWriter(const IndexedMesh& mesh, MeshletMesh& output)
+        : mesh(mesh), output(output), localIndex(mesh.vertexCount(), INVALID_INDEX) {}
+
+    /**
+     * @brief Number of corners of the triangle not in the current meshlet yet
+     */
+    uint32_t newVertices(const uint32_t* corners) const {
+        return (localIndex[corners[0]] == INVALID_INDEX) + (localIndex[corners[1]] == INVALID_INDEX) +
+               (localIndex[corners[2]] == INVALID_INDEX);
+    }
+
+    uint32_t vertexCount() const { return static_cast<uint32_t>(vertices.size()); }
+    uint32_t triangleCount() const { return static_cast<uint32_t>(triangles.size() / 3); }
+    const std::vector<uint32_t>& getVertices() const { return vertices; }
+
+    void add(const uint32_t* corners, const float normal[3]) {
+        for (int k = 0; k < 3; ++k) {
+            uint32_t& local = localIndex[corners[k]];
+            if (local == INVALID_INDEX) {
+                local = static_cast<uint32_t>(vertices.size());
+                vertices.push_back(corners[k]);
+            }
+            triangles.push_back(static_cast<uint8_t>(local));
+        }
+        for (int k = 0; k < 3; ++k) {
+            normalSum[k] += normal[k];
+        }
+    }
+
+    /**
+     * @brief Unit average normal of the triangles so far
+     */
+    void averageNormal(float axis[3]) const {
+        float length = std::sqrt(normalSum[0] * normalSum[0] + normalSum[1] * normalSum[1] +
+                                 normalSum[2] * normalSum[2]);
+        for (int k = 0; k < 3; ++k) {
+            axis[k] = length > 0.0f ? normalSum[k] / length : 0.0f;
+        }
+    }
+
+    /**
+     * @brief Append the meshlet with its bounds and start an empty one
+     */
+    void finish(MaterialId material) {
+        if (triangles.empty()) {
+            return;
+        }
+        Meshlet meshlet;
+        meshlet.vertexOffset = static_cast<uint32_t>(output.vertices.size());
+        meshlet.triangleOffset = static_cast<uint32_t>(output.triangles.size());
+        meshlet.vertexCount = vertexCount();
+        meshlet.triangleCount = triangleCount();
+        meshlet.material = material;
+
+        points.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const Vertex position = mesh.vertex(vertices[i]).position;
+            points[i] = {position.x, position.y, position.z};
+        }
+        boundingSphere(points, meshlet.center, meshlet.radius);
+
+        // The cone contains every face normal; the cutoff is the sine of its half angle, so that
+        // isBackfacing can compare it against the angle under which the bounding sphere is seen
+        averageNormal(meshlet.coneAxis);
+        float minimumDot = 1.0f;
+        for (size_t t = 0; t < triangles.size(); t += 3) {
+            float normal[3];
+            if (faceNormal(points[triangles[t]], points[triangles[t + 1]], points[triangles[t + 2]], normal)) {
+                minimumDot = std::min(minimumDot, normal[0] * meshlet.coneAxis[0] + normal[1] * meshlet.coneAxis[1] +
+                                                      normal[2] * meshlet.coneAxis[2]);
+            }
+        }
+        meshlet.coneCutoff = minimumDot <= 0.0f ? 1.0f : std::sqrt(1.0f - minimumDot * minimumDot);
+
+        output.meshlets.push_back(meshlet);
+        output.vertices.insert(output.vertices.end(), vertices.begin(), vertices.end());
+        output.triangles.insert(output.triangles.end(), triangles.begin(), triangles.end());
+        for (uint32_t vertex : vertices) {
+            localIndex[vertex] = INVALID_INDEX;
+        }
+        vertices.clear();
+        triangles.clear();
+        normalSum[0] = normalSum[1] = normalSum[2] = 0.0f;
+    }
+
+    /**
+     * @brief Unit normal of a triangle
+     * @return false for degenerate triangles
+     */
+    static bool faceNormal(const std::array<float, 3>& a, const std::array<float, 3>& b,
+                           const std::array<float, 3>& c, float normal[3]) {
+        float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        float e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+        float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length == 0.0f) {
+            return false;
+        }
+        for (int k = 0; k < 3; ++k) {
+            normal[k] /= length;
+        }
+        return true;
+    }
+
+private:
+    const IndexedMesh& mesh;
+    MeshletMesh& output;
+    std::vector<uint32_t> localIndex;     // Index in the current meshlet of every source vertex
+    std::vector<uint32_t> vertices;
+    std::vector<uint8_t> triangles;
+    std::vector<std::array<float, 3>> points;
+    float normalSum[3] = {0.0f, 0.0f, 0.0f};
+};
+
+} // namespace
+
+MeshletMesh MeshletBuilder::build(const IndexedMesh& mesh, const MeshletOptions& options) {
+    MeshletMesh output;
+    const size_t vertexCount = mesh.vertexCount();
+    const size_t indexCount = mesh.indices.size() / 3 * 3;
+    const uint32_t maxVertices = std::min<uint32_t>(std::max<uint32_t>(options.maxVertices, 3), 256);
+    const uint32_t maxTriangles = std::min<uint32_t>(std::max<uint32_t>(options.maxTriangles, 1), 255);
+    if (vertexCount == 0 || indexCount == 0) {
+        return output;
+    }
+    const uint32_t* indices = mesh.indices.data();
+    output.meshlets.reserve(indexCount / 3 / maxTriangles + mesh.submeshes.size());
+    output.triangles.reserve(indexCount);
+
+    std::vector<std::array<float, 3>> normals(indexCount / 3);
+    std::array<float, 3> corners[3];
+    for (size_t t = 0; t < indexCount / 3; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            const Vertex position = mesh.vertex(indices[t * 3 + k]).position;
+            corners[k] = {position.x, position.y, position.z};
+        }
+        if (!MeshletWriter::faceNormal(corners[0], corners[1], corners[2], normals[t].data())) {
+            normals[t] = {0.0f, 0.0f, 0.0f};
+        }
+    }
+
+    LiveAdjacency adjacency;
+    adjacency.build(indices, indexCount, vertexCount);
+    std::vector<bool> emitted(indexCount / 3, false);
+    MeshletWriter writer(mesh, output);
+
+    for (const Submesh& submesh : mesh.submeshes) {
+        const uint32_t first = submesh.firstIndex / 3;
+        const uint32_t last = std::min<uint32_t>((submesh.firstIndex + submesh.indexCount) / 3,
+                                                 static_cast<uint32_t>(indexCount / 3));
+        uint32_t cursor = first;
+        while (true) {
+            // The neighbour that adds the fewest vertices, ties broken towards the cone axis and
+            // towards corners with few triangles left, which would otherwise end up in small islands
+            uint32_t best = INVALID_INDEX;
+            float bestScore = FLT_MAX;
+            float axis[3];
+            writer.averageNormal(axis);
+            for (uint32_t vertex : writer.getVertices()) {
+                const uint32_t* row = &adjacency.triangles[adjacency.offsets[vertex]];
+                for (uint32_t k = 0; k < adjacency.counts[vertex]; ++k) {
+                    uint32_t t = row[k];
+                    if (t < first || t >= last) {
+                        continue;
+                    }
+                    uint32_t extra = writer.newVertices(indices + t * 3);
+                    if (writer.vertexCount() + extra > maxVertices) {
+                        continue;
+                    }
+                    const std::array<float, 3>& n = normals[t];
+                    float spread = 1.0f - (n[0] * axis[0] + n[1] * axis[1] + n[2] * axis[2]);
+                    uint32_t live = adjacency.counts[indices[t * 3]] + adjacency.counts[indices[t * 3 + 1]] +
+                                    adjacency.counts[indices[t * 3 + 2]];
+                    float score = static_cast<float>(extra) + options.coneWeight * spread + LIVE_WEIGHT * live;
+                    if (score < bestScore) {
+                        bestScore = score;
+                        best = t;
+                    }
+                }
+            }
+
+            // No neighbour fits: continue from the first triangle not emitted yet, in a new meshlet
+            if (best == INVALID_INDEX) {
+                while (cursor < last && emitted[cursor]) {
+                    ++cursor;
+                }
+                if (cursor == last) {
+                    break;
+                }
+                best = cursor;
+                writer.finish(submesh.material);
+            }
+
+            writer.add(indices + best * 3, normals[best].data());
+            emitted[best] = true;
+            for (int k = 0; k < 3; ++k) {
+                adjacency.remove(indices[best * 3 + k], best);
+            }
+            if (writer.triangleCount() == maxTriangles) {
+                writer.finish(submesh.material);
+            }
+        }
+        writer.finish(submesh.material);
+    }
+    return output;
+}
+
+bool MeshletBuilder::isBackfacing(const Meshlet& meshlet, const float eye[3]) {
+    // Every face normal is within the cone; the meshlet faces away if the viewer sees the bounding
+    // sphere from behind the cone's back side
+    float view[3] = {meshlet.center[0] - eye[0], meshlet.center[1] - eye[1], meshlet.center[2] - eye[2]};
+    float distance = std::sqrt(view[0] * view[0] + view[1] * view[1] + view[2] * view[2]);
+    float along = view[0] * meshlet.coneAxis[0] + view[1] * meshlet.coneAxis[1] + view[2] * meshlet.coneAxis[2];
+    return along >= meshlet.coneCutoff * distance + meshlet.radius;
+}
@@ -1,16 +1,256 @@
 #include <ModelLoader.h>
-#include <fstream>
-#include <sstream>
+#include <MappedFile.h>
+#include <MaterialCache.h>
+#include <MeshOptimizer.h>
+#include <NormalGenerator.h>
+#include <TangentGenerator.h>
+#include "NumberParsing.h"
+#include "ParallelRanges.h"
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 #include <filesystem>
+#include <memory_resource>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 
-bool ModelLoader::loadModel(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        return false;
+namespace {
+
+/**
+ * @brief Smallest chunk handed to a parser thread, smaller files are parsed on one thread
+ */
+constexpr size_t MIN_CHUNK_BYTES = size_t(1) << 20;
+
+/**
+ * @brief Resolve an OBJ index against the number of elements defined so far
+ * @param index 1-based index, or negative to count back from the last element
+ * @param count Elements defined before the face
+ * @return 0-based index, -1 if the index is 0 or out of range
+ */
+inline long long resolveIndex(int index, size_t count) {
+    const long long resolved = index > 0 ? static_cast<long long>(index) - 1
+                                         : static_cast<long long>(count) + index;
+    if (index == 0 || resolved < 0 || resolved >= static_cast<long long>(count)) {
+        return -1;
+    }
+    return resolved;
+}
+
+/**
+ * @brief Walk the fan triangles of every recorded face of a chunk
+ * @details A face stops at its first triangle with an unresolvable vertex, the triangles
+ * before it are kept. func receives the face, its three corners and their vertex indices.
+ */
+template <typename ChunkType, typename Func>
+void forEachChunkTriangle(const ChunkType& chunk, Func&& func) {
+    size_t corner = 0;
+    for (const auto& face : chunk.faces) {
+        const size_t vertexCount = chunk.vertexBase + face.vertexCount;
+        const auto* corners = chunk.corners.data() + corner;
+        corner += face.cornerCount;
+
+        const long long v0 = resolveIndex(corners[0].vertex, vertexCount);
+        for (int i = 1; i + 1 < face.cornerCount; ++i) {
+            const long long v1 = resolveIndex(corners[i].vertex, vertexCount);
+            const long long v2 = resolveIndex(corners[i + 1].vertex, vertexCount);
+            if (v0 < 0 || v1 < 0 || v2 < 0) {
+                break;
+            }
+            func(face, corners[0], corners[i], corners[i + 1], v0, v1, v2);
+        }
+    }
+}
+
+/**
+ * @brief Resolved (v, vt, vn) triple of a face corner, -1 for a missing attribute
+ */
+struct CornerKey {
+    long long vertex;
+    long long texture;
+    long long normal;
+
+    bool operator==(const CornerKey& other) const {
+        return vertex == other.vertex && texture == other.texture && normal == other.normal;
+    }
+};
+
+/**
+ * @brief Number of elements each line type of an OBJ text adds
+ */
+struct LineCounts {
+    size_t vertices = 0;
+    size_t textureCoords = 0;
+    size_t normals = 0;
+    size_t faces = 0;
+    size_t corners = 0;                   ///< Corners of all faces (tokens after "f")
+};
+
+/**
+ * @brief Histogram of the line types of an OBJ text, to reserve the parse arrays exactly
+ * @details Lines are found with memchr and classified by their first token the way parseLine
+ * does, only face lines are scanned further to count their corners. Lines that later fail to
+ * parse are counted too, so the counts are an upper bound that is exact for valid files.
+ */
+LineCounts countLines(std::string_view text) {
+    LineCounts counts;
+    const char* cursor = text.data();
+    const char* end = cursor + text.size();
+    while (cursor < end) {
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        const char* lineEnd = newline != nullptr ? newline : end;
+        while (cursor < lineEnd && isSpace(*cursor)) {
+            ++cursor;
+        }
+        const size_t length = lineEnd - cursor;
+        if (length >= 2 && cursor[0] == 'v') {
+            if (isSpace(cursor[1])) {
+                ++counts.vertices;
+            } else if (length >= 3 && isSpace(cursor[2])) {
+                counts.textureCoords += cursor[1] == 't' ? 1 : 0;
+                counts.normals += cursor[1] == 'n' ? 1 : 0;
+            }
+        } else if (length >= 2 && cursor[0] == 'f' && isSpace(cursor[1])) {
+            size_t tokens = 0;
+            for (const char* c = cursor + 1; c < lineEnd; ++c) {
+                tokens += !isSpace(*c) && isSpace(c[-1]) ? 1 : 0;
+            }
+            if (tokens >= 3) {
+                ++counts.faces;
+                counts.corners += tokens;
+            }
+        }
+        cursor = lineEnd + 1;
+    }
+    return counts;
+}
+
+/**
+ * @brief Open addressing map from CornerKey to a vertex ID
+ * @details Keys are stored densely by ID and the table only holds IDs, which keeps it far
+ * smaller and faster than a node based std::unordered_map for millions of vertices.
+ */
+class CornerMap {
+public:
+    CornerMap(size_t expected, std::pmr::memory_resource* arena) : slots(arena), keys(arena) {
+        size_t capacity = 16;
+        while (capacity < expected * 2) {
+            capacity *= 2;
+        }
+        slots.assign(capacity, EMPTY);
+        keys.reserve(expected);
+    }
+
+    /**
+     * @brief Find the ID of a key, adding it with the next free ID if absent
+     * @param inserted Set to true if the key was added
+     */
+    uint32_t findOrInsert(const CornerKey& key, bool& inserted) {
+        size_t slot = hash(key) & (slots.size() - 1);
+        while (slots[slot] != EMPTY) {
+            if (keys[slots[slot]] == key) {
+                inserted = false;
+                return slots[slot];
+            }
+            slot = (slot + 1) & (slots.size() - 1);
+        }
+        const uint32_t id = static_cast<uint32_t>(keys.size());
+        slots[slot] = id;
+        keys.push_back(key);
+        inserted = true;
+        if (keys.size() * 2 > slots.size()) {
+            grow();
+        }
+        return id;
+    }
+
+    /**
+     * @brief Keys in ID order
+     */
+    const std::pmr::vector<CornerKey>& uniqueKeys() const {
+        return keys;
+    }
+
+private:
+    static constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+    std::pmr::vector<uint32_t> slots;
+    std::pmr::vector<CornerKey> keys;
+
+    static size_t hash(const CornerKey& key) {
+        uint64_t h = static_cast<uint64_t>(key.vertex) * 0x9E3779B97F4A7C15ull;
+        h ^= static_cast<uint64_t>(key.texture) * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+        h ^= static_cast<uint64_t>(key.normal) * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+
+    void grow() {
+        slots.assign(slots.size() * 2, EMPTY);
+        for (uint32_t id = 0; id < keys.size(); ++id) {
+            size_t slot = hash(keys[id]) & (slots.size() - 1);
+            while (slots[slot] != EMPTY) {
+                slot = (slot + 1) & (slots.size() - 1);
+            }
+            slots[slot] = id;
+        }
+    }
+};
+
+/**
+ * @brief Whether all three corners of a triangle reference a normal read from the file
+ */
+template <typename ChunkType, typename FaceType, typename CornerType>
+bool hasFileNormals(const ChunkType& chunk, const FaceType& face,
+                    const CornerType& c0, const CornerType& c1, const CornerType& c2) {
+    const size_t normalCount = chunk.normalBase + face.normalCount;
+    return resolveIndex(c0.normal, normalCount) >= 0 && resolveIndex(c1.normal, normalCount) >= 0 &&
+           resolveIndex(c2.normal, normalCount) >= 0;
+}
+
+/**
+ * @brief Fill a triangle from three face corners (as written in the file) and their resolved vertex indices
+ * @details Texture coordinates and normals are used only if all three corners resolve.
+ */
+template <typename ChunkType, typename FaceType, typename CornerType>
+void fillTriangle(Triangle& triangle, const ChunkType& chunk, const FaceType& face,
+                  const CornerType& c0, const CornerType& c1, const CornerType& c2,
+                  long long v0, long long v1, long long v2, const Vertex* vertices, const TextureCoord* textureCoords,
+                  const Normal* normals) {
+    triangle.v0 = vertices[v0];
+    triangle.v1 = vertices[v1];
+    triangle.v2 = vertices[v2];
+    
+    // Handle texture coordinates if available
+    const size_t textureCount = chunk.textureBase + face.textureCount;
+    const long long t0 = resolveIndex(c0.texture, textureCount);
+    const long long t1 = resolveIndex(c1.texture, textureCount);
+    const long long t2 = resolveIndex(c2.texture, textureCount);
+    triangle.hasTextures = t0 >= 0 && t1 >= 0 && t2 >= 0;
+    if (triangle.hasTextures) {
+        triangle.t0 = textureCoords[t0];
+        triangle.t1 = textureCoords[t1];
+        triangle.t2 = textureCoords[t2];
+    }
+    
+    // Handle normals if available
+    const size_t normalCount = chunk.normalBase + face.normalCount;
+    const long long n0 = resolveIndex(c0.normal, normalCount);
+    const long long n1 = resolveIndex(c1.normal, normalCount);
+    const long long n2 = resolveIndex(c2.normal, normalCount);
+    triangle.hasNormals = n0 >= 0 && n1 >= 0 && n2 >= 0;
+    if (triangle.hasNormals) {
+        triangle.n0 = normals[n0];
+        triangle.n1 = normals[n1];
+        triangle.n2 = normals[n2];
     }
     
+    // Set the material name active at this face
+    triangle.materialId = face.material >= 0 ? chunk.materialIds[face.material] : chunk.inheritedMaterial;
+}
+
+} // namespace
+
+void ModelLoader::resetState(const std::string& filename) {
     // Extract base path from the filename
     std::filesystem::path filePath(filename);
     basePath = filePath.parent_path().string();
@@ -20,279 +260,631 @@ bool ModelLoader::loadModel(const std::string& filename) {
     textureCoords.clear();
     normals.clear();
     triangles.clear();
+    indexedMesh.clear();
     materials.clear();
+    materialIds.clear();
     currentObjectName.clear();
-    currentMaterial.clear();
+    materialSources.clear();
+    cacheFile.close();
+    cacheView = IndexedMeshView();
+    meshView = IndexedMeshView();
+    if (meshArena) {
+        meshArena->reset();
+    }
+    optimizeStats = MeshOptimizeStats();
+    parseStats = ParseMemoryStats();
+    generatedNormals.clear();
+}
+
+bool ModelLoader::loadModel(const std::string& filename) {
+    return loadModel(filename, LoadOptions());
+}
+
+bool ModelLoader::loadModel(const std::string& filename, const LoadOptions& options) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        return false;
+    }
+    
+    resetState(filename);
     
-    std::string line;
-    while (std::getline(file, line)) {
-        if (!parseLine(line)) {
+    // The cache only holds the indexed output
+    const bool cacheable = options.useCache && options.indexedMesh && !options.triangles;
+    if (cacheable && readCache(filename, options)) {
+        return true;
+    }
+    
+    // Split the mapping into newline-aligned chunks, one per thread
+    unsigned int threads = threadCount != 0 ? threadCount : std::thread::hardware_concurrency();
+    threads = std::max(threads, 1u);
+    const size_t chunkCount = std::clamp<size_t>(file.size() / MIN_CHUNK_BYTES, 1, threads);
+    if (!scratchArena) {
+        scratchArena = std::make_unique<MonotonicArena>();
+    }
+    scratchArena->reset();
+    std::vector<Chunk> chunks;
+    chunks.reserve(chunkCount);
+    for (size_t i = 0; i < chunkCount; ++i) {
+        chunks.emplace_back(&chunkArena(i));
+    }
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+    const char* cursor = begin;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const char* chunkEnd = end;
+        if (i + 1 < chunkCount) {
+            chunkEnd = std::max(begin + file.size() / chunkCount * (i + 1), cursor);
+            const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', end - chunkEnd));
+            chunkEnd = newline != nullptr ? newline + 1 : end;
+        }
+        chunks[i].text = std::string_view(cursor, chunkEnd - cursor);
+        cursor = chunkEnd;
+    }
+    
+    runParallel(chunkCount, [&](size_t i) { parseChunk(chunks[i]); });
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const Chunk& chunk = chunks[i];
+        parseStats.arenaBytes += chunkArenas[i]->bytesUsed();
+        parseStats.arrayBytes += chunk.vertices.size() * sizeof(Vertex) + chunk.textureCoords.size() * sizeof(TextureCoord) +
+                                 chunk.normals.size() * sizeof(Normal) + chunk.corners.size() * sizeof(FaceCorner) +
+                                 chunk.faces.size() * sizeof(Face);
+        parseStats.spareElements += chunk.vertices.capacity() - chunk.vertices.size() +
+                                    chunk.textureCoords.capacity() - chunk.textureCoords.size() +
+                                    chunk.normals.capacity() - chunk.normals.size() +
+                                    chunk.corners.capacity() - chunk.corners.size() +
+                                    chunk.faces.capacity() - chunk.faces.size();
+    }
+    
+    // Prefix sums of the element counts, and the usemtl / s / o state carried across chunks.
+    // Material names are interned in file order
+    size_t vertexTotal = 0, textureTotal = 0, normalTotal = 0;
+    MaterialId activeMaterial = NO_MATERIAL;
+    int activeSmoothingGroup = UNGROUPED;
+    for (auto& chunk : chunks) {
+        chunk.vertexBase = vertexTotal;
+        chunk.textureBase = textureTotal;
+        chunk.normalBase = normalTotal;
+        vertexTotal += chunk.vertices.size();
+        textureTotal += chunk.textureCoords.size();
+        normalTotal += chunk.normals.size();
+        
+        internChunkMaterials(chunk);
+        chunk.inheritedMaterial = activeMaterial;
+        if (chunk.currentMaterial >= 0) {
+            activeMaterial = chunk.materialIds[chunk.currentMaterial];
+        }
+        chunk.inheritedSmoothingGroup = activeSmoothingGroup;
+        if (chunk.currentSmoothingGroup >= 0) {
+            activeSmoothingGroup = chunk.currentSmoothingGroup;
+        }
+        if (chunk.hasObjectName) {
+            currentObjectName = chunk.objectName;
+        }
+    }
+    vertices.resize(vertexTotal);
+    textureCoords.resize(textureTotal);
+    normals.resize(normalTotal);
+    runParallel(chunkCount, [&](size_t i) {
+        Chunk& chunk = chunks[i];
+        std::copy(chunk.vertices.begin(), chunk.vertices.end(), vertices.begin() + chunk.vertexBase);
+        std::copy(chunk.textureCoords.begin(), chunk.textureCoords.end(), textureCoords.begin() + chunk.textureBase);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + chunk.normalBase);
+        chunk.triangleCount = countChunkTriangles(chunk);
+    });
+    
+    // Material libraries are loaded in file order, later definitions replace earlier ones.
+    // The table is complete before any triangle points into it
+    for (const auto& chunk : chunks) {
+        for (const auto& library : chunk.materialLibraries) {
+            loadMaterialFile(library, basePath);
+        }
+    }
+    reportUndefinedMaterials();
+    
+    // Every chunk writes its triangles into its own range
+    size_t triangleTotal = 0;
+    for (auto& chunk : chunks) {
+        chunk.triangleBase = triangleTotal;
+        triangleTotal += chunk.triangleCount;
+    }
+    if (options.generateNormals) {
+        generateMissingNormals(chunks, options);
+    }
+    if (options.triangles) {
+        triangles.resize(triangleTotal);
+        runParallel(chunkCount, [&](size_t i) { emitChunkTriangles(chunks[i]); });
+    }
+    if (options.indexedMesh) {
+        indexedMesh.indices.reserve(triangleTotal * 3);
+        buildIndexedMesh(chunks, options.vertexLayout);
+        if (options.generateTangents) {
+            TangentGenerator::generate(indexedMesh, threadCount);
+        }
+        if (options.optimizeMesh) {
+            optimizeStats = MeshOptimizer::optimize(indexedMesh);
+        }
+    }
+    generatedNormals = {};
+    file.close();
+    
+    const bool loaded = !vertices.empty() && triangleTotal > 0;
+    if (cacheable && loaded) {
+        // A cache that cannot be written (e.g. read-only directory) only costs the next parse
+        writeCache(filename, options);
+    }
+    if (options.indexedMesh && options.singleBlockMesh && loaded) {
+        moveMeshToBlock();
+    }
+    return loaded;
+}
+
+bool ModelLoader::streamModel(const std::string& filename, const TriangleBatchCallback& callback,
+                              size_t batchSize) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        return false;
+    }
+    
+    resetState(filename);
+    
+    // The whole file is one chunk whose faces are turned into triangles right away
+    Chunk chunk;
+    std::vector<Triangle> batch;
+    batch.reserve(std::max<size_t>(batchSize, 1));
+    size_t delivered = 0;
+    auto deliver = [&]() {
+        callback(batch);
+        delivered += batch.size();
+        batch.clear();
+    };
+    
+    constexpr size_t DISCARD_STEP = size_t(32) << 20;
+    size_t nextDiscard = DISCARD_STEP;
+    const char* begin = file.data();
+    const char* cursor = begin;
+    const char* end = begin + file.size();
+    while (cursor < end) {
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        const char* lineEnd = newline != nullptr ? newline : end;
+        parseLine(std::string_view(cursor, lineEnd - cursor), chunk);
+        cursor = lineEnd + 1;
+        
+        for (const auto& library : chunk.materialLibraries) {
+            loadMaterialFile(library, basePath);
+        }
+        chunk.materialLibraries.clear();
+        internChunkMaterials(chunk);
+        
+        if (!chunk.faces.empty()) {
+            forEachChunkTriangle(chunk, [&](const Face& face, const FaceCorner& c0, const FaceCorner& c1,
+                                            const FaceCorner& c2, long long v0, long long v1, long long v2) {
+                Triangle& triangle = batch.emplace_back();
+                fillTriangle(triangle, chunk, face, c0, c1, c2, v0, v1, v2,
+                             chunk.vertices.data(), chunk.textureCoords.data(), chunk.normals.data());
+                
+                if (batch.size() >= batchSize) {
+                    deliver();
+                }
+            });
+            chunk.faces.clear();
+            chunk.corners.clear();
+        }
+        
+        // Parsed text is not needed again
+        if (static_cast<size_t>(cursor - begin) >= nextDiscard) {
+            file.discard(cursor - begin);
+            nextDiscard += DISCARD_STEP;
+        }
+    }
+    if (!batch.empty()) {
+        deliver();
+    }
+    reportUndefinedMaterials();
+    
+    vertices.assign(chunk.vertices.begin(), chunk.vertices.end());
+    textureCoords.assign(chunk.textureCoords.begin(), chunk.textureCoords.end());
+    normals.assign(chunk.normals.begin(), chunk.normals.end());
+    if (chunk.hasObjectName) {
+        currentObjectName = chunk.objectName;
+    }
+    return !vertices.empty() && delivered > 0;
+}
+
+void ModelLoader::setThreadCount(unsigned int count) {
+    threadCount = count;
+}
+
+void ModelLoader::setMaterialCache(MaterialCache* cache) {
+    materialCache = cache;
+}
+
+void ModelLoader::releaseMemory() {
+    chunkArenas.clear();
+    scratchArena.reset();
+    meshView = IndexedMeshView();
+    meshArena.reset();
+}
+
+MonotonicArena& ModelLoader::chunkArena(size_t i) {
+    while (chunkArenas.size() <= i) {
+        chunkArenas.push_back(std::make_unique<MonotonicArena>());
+    }
+    chunkArenas[i]->reset();
+    return *chunkArenas[i];
+}
+
+void ModelLoader::parseChunk(Chunk& chunk) {
+    // Size the arrays once: growing them in the arena would leave every outgrown copy behind
+    const LineCounts counts = countLines(chunk.text);
+    chunk.vertices.reserve(counts.vertices);
+    chunk.textureCoords.reserve(counts.textureCoords);
+    chunk.normals.reserve(counts.normals);
+    chunk.faces.reserve(counts.faces);
+    chunk.corners.reserve(counts.corners);
+    
+    // Walk the mapped bytes line by line, lines are views into the mapping
+    const char* cursor = chunk.text.data();
+    const char* end = cursor + chunk.text.size();
+    while (cursor < end) {
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        const char* lineEnd = newline != nullptr ? newline : end;
+        if (!parseLine(std::string_view(cursor, lineEnd - cursor), chunk)) {
             // Continue parsing even if individual lines fail
             // This provides better error tolerance
         }
+        cursor = lineEnd + 1;
     }
-    file.close();
+}
+
+size_t ModelLoader::countChunkTriangles(const Chunk& chunk) const {
+    size_t count = 0;
+    forEachChunkTriangle(chunk, [&](const Face&, const FaceCorner&, const FaceCorner&, const FaceCorner&,
+                                    long long, long long, long long) { ++count; });
+    return count;
+}
+
+void ModelLoader::emitChunkTriangles(const Chunk& chunk) {
+    Triangle* triangle = triangles.data() + chunk.triangleBase;
+    const uint32_t* generated = generatedNormals.empty() ? nullptr : generatedNormals.data() + chunk.generatedBase * 3;
+    forEachChunkTriangle(chunk, [&](const Face& face, const FaceCorner& c0, const FaceCorner& c1,
+                                    const FaceCorner& c2, long long v0, long long v1, long long v2) {
+        fillTriangle(*triangle, chunk, face, c0, c1, c2, v0, v1, v2, vertices.data(), textureCoords.data(),
+                     normals.data());
+        if (generated != nullptr && !triangle->hasNormals) {
+            triangle->n0 = normals[generated[0]];
+            triangle->n1 = normals[generated[1]];
+            triangle->n2 = normals[generated[2]];
+            triangle->hasNormals = true;
+            generated += 3;
+        }
+        ++triangle;
+    });
+}
+
+void ModelLoader::generateMissingNormals(std::vector<Chunk>& chunks, const LoadOptions& options) {
+    // Count, then collect the triangles without file normals, every chunk into its own range
+    runParallel(chunks.size(), [&](size_t i) {
+        Chunk& chunk = chunks[i];
+        chunk.generatedCount = 0;
+        forEachChunkTriangle(chunk, [&](const Face& face, const FaceCorner& c0, const FaceCorner& c1,
+                                        const FaceCorner& c2, long long, long long, long long) {
+            if (!hasFileNormals(chunk, face, c0, c1, c2)) {
+                ++chunk.generatedCount;
+            }
+        });
+    });
+    size_t generatedTotal = 0;
+    for (auto& chunk : chunks) {
+        chunk.generatedBase = generatedTotal;
+        generatedTotal += chunk.generatedCount;
+    }
+    if (generatedTotal == 0) {
+        return;
+    }
+    
+    std::pmr::vector<uint32_t> indices(generatedTotal * 3, scratchArena.get());
+    std::pmr::vector<uint32_t> groups(generatedTotal, scratchArena.get());
+    runParallel(chunks.size(), [&](size_t i) {
+        const Chunk& chunk = chunks[i];
+        size_t triangle = chunk.generatedBase;
+        forEachChunkTriangle(chunk, [&](const Face& face, const FaceCorner& c0, const FaceCorner& c1,
+                                        const FaceCorner& c2, long long v0, long long v1, long long v2) {
+            if (hasFileNormals(chunk, face, c0, c1, c2)) {
+                return;
+            }
+            indices[triangle * 3] = static_cast<uint32_t>(v0);
+            indices[triangle * 3 + 1] = static_cast<uint32_t>(v1);
+            indices[triangle * 3 + 2] = static_cast<uint32_t>(v2);
+            // File groups are never negative, so the faces before the first s line get a group of their own
+            const int group = face.smoothingGroup >= 0 ? face.smoothingGroup : chunk.inheritedSmoothingGroup;
+            groups[triangle] = group == UNGROUPED ? 0xFFFFFFFFu : static_cast<uint32_t>(group);
+            ++triangle;
+        });
+    });
     
-    // Update material pointers in triangles after all materials are loaded
-    updateTriangleMaterialPointers();
+    NormalOptions normalOptions;
+    normalOptions.creaseAngle = options.creaseAngle;
+    normalOptions.threadCount = threadCount;
+    GeneratedNormals generated = NormalGenerator::generate(vertices.data(), vertices.size(), indices.data(),
+                                                           indices.size(), groups.data(), normalOptions);
+    
+    // Generated normals follow the file's, so both are addressed through normals
+    const uint32_t fileNormalCount = static_cast<uint32_t>(normals.size());
+    normals.insert(normals.end(), generated.normals.begin(), generated.normals.end());
+    generatedNormals = std::move(generated.cornerNormals);
+    for (uint32_t& normal : generatedNormals) {
+        normal += fileNormalCount;
+    }
+}
+
+void ModelLoader::buildIndexedMesh(const std::vector<Chunk>& chunks, VertexLayout layout) {
+    // Most meshes have about as many unique corners as positions
+    CornerMap unique(vertices.size(), scratchArena.get());
+    for (const auto& chunk : chunks) {
+        const uint32_t* generated = generatedNormals.empty() ? nullptr : generatedNormals.data() + chunk.generatedBase * 3;
+        forEachChunkTriangle(chunk, [&](const Face& face, const FaceCorner& c0, const FaceCorner& c1,
+                                        const FaceCorner& c2, long long v0, long long v1, long long v2) {
+            // Consecutive triangles with the same material form one submesh
+            const MaterialId id = face.material >= 0 ? chunk.materialIds[face.material] : chunk.inheritedMaterial;
+            if (indexedMesh.submeshes.empty() || indexedMesh.submeshes.back().material != id) {
+                indexedMesh.submeshes.push_back({static_cast<uint32_t>(indexedMesh.indices.size()), 0, id});
+            }
+            indexedMesh.submeshes.back().indexCount += 3;
+            
+            const size_t textureCount = chunk.textureBase + face.textureCount;
+            const size_t normalCount = chunk.normalBase + face.normalCount;
+            const FaceCorner* corners[3] = {&c0, &c1, &c2};
+            const long long positions[3] = {v0, v1, v2};
+            long long cornerNormals[3];
+            for (int k = 0; k < 3; ++k) {
+                cornerNormals[k] = resolveIndex(corners[k]->normal, normalCount);
+            }
+            if (generated != nullptr && !hasFileNormals(chunk, face, c0, c1, c2)) {
+                for (int k = 0; k < 3; ++k) {
+                    cornerNormals[k] = generated[k];
+                }
+                generated += 3;
+            }
+            for (int k = 0; k < 3; ++k) {
+                const CornerKey key = {positions[k], resolveIndex(corners[k]->texture, textureCount), cornerNormals[k]};
+                bool inserted;
+                indexedMesh.indices.push_back(unique.findOrInsert(key, inserted));
+            }
+        });
+    }
     
-    return !vertices.empty() && !triangles.empty();
+    // The unique vertices are known now, so the vertex array is allocated once at its final size
+    const std::pmr::vector<CornerKey>& keys = unique.uniqueKeys();
+    const bool streams = layout == VertexLayout::Streams;
+    if (streams) {
+        indexedMesh.streams.reserve(keys.size());
+    } else {
+        indexedMesh.vertices.reserve(keys.size());
+    }
+    for (const CornerKey& key : keys) {
+        MeshVertex vertex = {vertices[key.vertex], {0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}};
+        if (key.texture >= 0) {
+            vertex.texCoord = textureCoords[key.texture];
+            indexedMesh.hasTexCoords = true;
+        }
+        if (key.normal >= 0) {
+            vertex.normal = normals[key.normal];
+            indexedMesh.hasNormals = true;
+        }
+        if (streams) {
+            indexedMesh.streams.push_back(vertex.position, vertex.texCoord, vertex.normal);
+        } else {
+            indexedMesh.vertices.push_back(vertex);
+        }
+    }
+    if (streams) {
+        indexedMesh.streams.pad();
+    }
 }
 
-bool ModelLoader::parseLine(const std::string& line) {
+bool ModelLoader::parseLine(std::string_view line, Chunk& chunk) {
     // Skip empty lines and comments
     if (line.empty() || line[0] == '#') {
         return true;
     }
     
-    auto tokens = tokenize(line);
+    std::vector<std::string_view>& tokens = chunk.tokens;
+    tokenize(line, tokens);
     if (tokens.empty()) {
         return true;
     }
     
-    const std::string& prefix = tokens[0];
+    const std::string_view prefix = tokens[0];
     
     if (prefix == "v") {
-        return parseVertex(tokens);
+        return parseVertex(tokens, chunk);
     } else if (prefix == "vt") {
-        return parseTextureCoord(tokens);
+        return parseTextureCoord(tokens, chunk);
     } else if (prefix == "vn") {
-        return parseNormal(tokens);
+        return parseNormal(tokens, chunk);
     } else if (prefix == "f") {
-        return parseFace(tokens);
+        return parseFace(tokens, chunk);
     } else if (prefix == "mtllib") {
-        return parseMaterialLibrary(tokens);
+        return parseMaterialLibrary(tokens, chunk);
     } else if (prefix == "usemtl") {
-        return parseUseMaterial(tokens);
+        return parseUseMaterial(tokens, chunk);
     } else if (prefix == "o") {
-        return parseObjectName(tokens);
+        return parseObjectName(tokens, chunk);
     } else if (prefix == "g") {
         // Group names - currently ignored but can be extended
         return true;
     } else if (prefix == "s") {
-        // Smoothing groups - currently ignored but can be extended
-        return true;
+        return parseSmoothingGroup(tokens, chunk);
     }
     
     // Unknown line type - ignore but don't fail
     return true;
 }
 
-bool ModelLoader::parseVertex(const std::vector<std::string>& tokens) {
+bool ModelLoader::parseVertex(const std::vector<std::string_view>& tokens, Chunk& chunk) {
     if (tokens.size() < 4) {
         return false;
     }
     
-    try {
-        float x = std::stof(tokens[1]);
-        float y = std::stof(tokens[2]);
-        float z = std::stof(tokens[3]);
-        vertices.push_back({x, y, z});
-        return true;
-    } catch (const std::exception&) {
+    float x, y, z;
+    if (!parseFloat(tokens[1], x) || !parseFloat(tokens[2], y) || !parseFloat(tokens[3], z)) {
         return false;
     }
+    chunk.vertices.push_back({x, y, z});
+    return true;
 }
 
-bool ModelLoader::parseTextureCoord(const std::vector<std::string>& tokens) {
+bool ModelLoader::parseTextureCoord(const std::vector<std::string_view>& tokens, Chunk& chunk) {
     if (tokens.size() < 3) {
         return false;
     }
     
-    try {
-        float u = std::stof(tokens[1]);
-        float v = std::stof(tokens[2]);
-        textureCoords.push_back({u, v});
-        return true;
-    } catch (const std::exception&) {
+    float u, v;
+    if (!parseFloat(tokens[1], u) || !parseFloat(tokens[2], v)) {
         return false;
     }
+    chunk.textureCoords.push_back({u, v});
+    return true;
 }
 
-bool ModelLoader::parseNormal(const std::vector<std::string>& tokens) {
+bool ModelLoader::parseNormal(const std::vector<std::string_view>& tokens, Chunk& chunk) {
     if (tokens.size() < 4) {
         return false;
     }
     
-    try {
-        float x = std::stof(tokens[1]);
-        float y = std::stof(tokens[2]);
-        float z = std::stof(tokens[3]);
-        normals.push_back({x, y, z});
-        return true;
-    } catch (const std::exception&) {
+    float x, y, z;
+    if (!parseFloat(tokens[1], x) || !parseFloat(tokens[2], y) || !parseFloat(tokens[3], z)) {
         return false;
     }
+    chunk.normals.push_back({x, y, z});
+    return true;
 }
 
-bool ModelLoader::parseFace(const std::vector<std::string>& tokens) {
+bool ModelLoader::parseFace(const std::vector<std::string_view>& tokens, Chunk& chunk) {
     if (tokens.size() < 4) {
         return false;
     }
     
-    std::vector<int> vertexIndices;
-    std::vector<int> textureIndices;
-    std::vector<int> normalIndices;
-    
-    // Parse each vertex specification
+    // Parse each vertex specification, indices are resolved once all chunks are parsed
+    const size_t firstCorner = chunk.corners.size();
     for (size_t i = 1; i < tokens.size(); ++i) {
-        int vIdx = 0, tIdx = 0, nIdx = 0;
-        if (!parseFaceVertex(tokens[i], vIdx, tIdx, nIdx)) {
+        FaceCorner corner;
+        if (!parseFaceVertex(tokens[i], corner.vertex, corner.texture, corner.normal)) {
+            chunk.corners.resize(firstCorner);
             return false;
         }
-        
-        vertexIndices.push_back(vIdx);
-        textureIndices.push_back(tIdx);
-        normalIndices.push_back(nIdx);
+        chunk.corners.push_back(corner);
     }
     
-    // Triangulate the face (fan triangulation)
-    for (size_t i = 1; i + 1 < vertexIndices.size(); ++i) {
-        Triangle triangle;
-        
-        // Get vertex positions (convert 1-based to 0-based indexing)
-        int v0 = vertexIndices[0] - 1;
-        int v1 = vertexIndices[i] - 1;
-        int v2 = vertexIndices[i + 1] - 1;
-        
-        if (v0 < 0 || v0 >= static_cast<int>(vertices.size()) ||
-            v1 < 0 || v1 >= static_cast<int>(vertices.size()) ||
-            v2 < 0 || v2 >= static_cast<int>(vertices.size())) {
-            return false;
-        }
-        
-        triangle.v0 = vertices[v0];
-        triangle.v1 = vertices[v1];
-        triangle.v2 = vertices[v2];
-        
-        // Handle texture coordinates if available
-        triangle.hasTextures = false;
-        if (textureIndices[0] > 0 && textureIndices[i] > 0 && textureIndices[i + 1] > 0) {
-            int t0 = textureIndices[0] - 1;
-            int t1 = textureIndices[i] - 1;
-            int t2 = textureIndices[i + 1] - 1;
-            
-            if (t0 >= 0 && t0 < static_cast<int>(textureCoords.size()) &&
-                t1 >= 0 && t1 < static_cast<int>(textureCoords.size()) &&
-                t2 >= 0 && t2 < static_cast<int>(textureCoords.size())) {
-                triangle.t0 = textureCoords[t0];
-                triangle.t1 = textureCoords[t1];
-                triangle.t2 = textureCoords[t2];
-                triangle.hasTextures = true;
-            }
-        }
-        
-        // Handle normals if available
-        triangle.hasNormals = false;
-        if (normalIndices[0] > 0 && normalIndices[i] > 0 && normalIndices[i + 1] > 0) {
-            int n0 = normalIndices[0] - 1;
-            int n1 = normalIndices[i] - 1;
-            int n2 = normalIndices[i + 1] - 1;
-            
-            if (n0 >= 0 && n0 < static_cast<int>(normals.size()) &&
-                n1 >= 0 && n1 < static_cast<int>(normals.size()) &&
-                n2 >= 0 && n2 < static_cast<int>(normals.size())) {
-                triangle.n0 = normals[n0];
-                triangle.n1 = normals[n1];
-                triangle.n2 = normals[n2];
-                triangle.hasNormals = true;
-            }
-        }
-        
-        // Set the current material name for this triangle
-        triangle.materialName = currentMaterial;
-        
-        triangles.push_back(triangle);
+    Face face;
+    face.cornerCount = static_cast<int>(tokens.size() - 1);
+    face.material = chunk.currentMaterial;
+    face.smoothingGroup = chunk.currentSmoothingGroup;
+    face.vertexCount = chunk.vertices.size();
+    face.textureCount = chunk.textureCoords.size();
+    face.normalCount = chunk.normals.size();
+    chunk.faces.push_back(face);
+    return true;
+}
+
+bool ModelLoader::parseMaterialLibrary(const std::vector<std::string_view>& tokens, Chunk& chunk) {
+    if (tokens.size() < 2) {
+        return false;
     }
     
+    // Get the MTL filename, the library is loaded after all chunks are parsed
+    chunk.materialLibraries.emplace_back(tokens[1]);
     return true;
 }
 
-bool ModelLoader::parseMaterialLibrary(const std::vector<std::string>& tokens) {
+bool ModelLoader::parseUseMaterial(const std::vector<std::string_view>& tokens, Chunk& chunk) {
     if (tokens.size() < 2) {
         return false;
     }
     
-    // Get the MTL filename
-    std::string mtlFilename = tokens[1];
-    
-    return loadMaterialFile(mtlFilename, basePath);
+    if (chunk.currentMaterial < 0 || chunk.materialNames[chunk.currentMaterial] != tokens[1]) {
+        chunk.materialNames.emplace_back(tokens[1]);
+        chunk.currentMaterial = static_cast<int>(chunk.materialNames.size()) - 1;
+    }
+    return true;
 }
 
-bool ModelLoader::parseUseMaterial(const std::vector<std::string>& tokens) {
+bool ModelLoader::parseObjectName(const std::vector<std::string_view>& tokens, Chunk& chunk) {
     if (tokens.size() < 2) {
         return false;
     }
     
-    currentMaterial = tokens[1];
+    chunk.objectName = tokens[1];
+    chunk.hasObjectName = true;
     return true;
 }
 
-bool ModelLoader::parseObjectName(const std::vector<std::string>& tokens) {
+bool ModelLoader::parseSmoothingGroup(const std::vector<std::string_view>& tokens, Chunk& chunk) {
     if (tokens.size() < 2) {
         return false;
     }
     
-    currentObjectName = tokens[1];
+    // "s off" and "s 0" both turn smoothing off
+    int group = 0;
+    if (tokens[1] != "off" && (!parseInt(tokens[1], group) || group < 0)) {
+        return false;
+    }
+    chunk.currentSmoothingGroup = group;
     return true;
 }
 
-std::vector<std::string> ModelLoader::tokenize(const std::string& str) const {
-    std::vector<std::string> tokens;
-    std::istringstream iss(str);
-    std::string token;
-    
-    while (iss >> token) {
-        tokens.push_back(token);
+void ModelLoader::tokenize(std::string_view str, std::vector<std::string_view>& tokens) const {
+    tokens.clear();
+    size_t i = 0;
+    while (i < str.size()) {
+        while (i < str.size() && isSpace(str[i])) {
+            ++i;
+        }
+        const size_t begin = i;
+        while (i < str.size() && !isSpace(str[i])) {
+            ++i;
+        }
+        if (i > begin) {
+            tokens.push_back(str.substr(begin, i - begin));
+        }
     }
-    
-    return tokens;
 }
 
-bool ModelLoader::parseFaceVertex(const std::string& vertexSpec, int& vertexIndex, 
+bool ModelLoader::parseFaceVertex(std::string_view vertexSpec, int& vertexIndex, 
                                  int& textureIndex, int& normalIndex) const {
     vertexIndex = textureIndex = normalIndex = 0;
     
-    // Split by '/' character
-    std::vector<std::string> parts;
-    std::string current;
-    
-    for (char c : vertexSpec) {
-        if (c == '/') {
-            parts.push_back(current);
-            current.clear();
-        } else {
-            current += c;
+    // Split by '/' character: vertex, texture and normal parts
+    const size_t firstSlash = vertexSpec.find('/');
+    const std::string_view vertexPart = vertexSpec.substr(0, firstSlash);
+    std::string_view texturePart;
+    std::string_view normalPart;
+    if (firstSlash != std::string_view::npos) {
+        const size_t secondSlash = vertexSpec.find('/', firstSlash + 1);
+        texturePart = vertexSpec.substr(firstSlash + 1, secondSlash - (firstSlash + 1));
+        if (secondSlash != std::string_view::npos) {
+            // Anything after a third slash is ignored
+            normalPart = vertexSpec.substr(secondSlash + 1);
+            normalPart = normalPart.substr(0, normalPart.find('/'));
         }
     }
-    parts.push_back(current);
     
-    if (parts.empty()) {
+    // Parse vertex index (required)
+    if (vertexPart.empty() || !parseInt(vertexPart, vertexIndex)) {
         return false;
     }
     
-    try {
-        // Parse vertex index (required)
-        if (!parts[0].empty()) {
-            vertexIndex = std::stoi(parts[0]);
-        } else {
-            return false;
-        }
-        
-        // Parse texture index (optional)
-        if (parts.size() > 1 && !parts[1].empty()) {
-            textureIndex = std::stoi(parts[1]);
-        }
-        
-        // Parse normal index (optional)
-        if (parts.size() > 2 && !parts[2].empty()) {
-            normalIndex = std::stoi(parts[2]);
-        }
-        
-        return true;
-    } catch (const std::exception&) {
+    // Parse texture index (optional)
+    if (!texturePart.empty() && !parseInt(texturePart, textureIndex)) {
+        return false;
+    }
+    
+    // Parse normal index (optional)
+    if (!normalPart.empty() && !parseInt(normalPart, normalIndex)) {
         return false;
     }
+    
+    return true;
 }
 
 const std::vector<Vertex>& ModelLoader::getVertices() const {
@@ -303,6 +895,92 @@ const std::vector<Triangle>& ModelLoader::getTriangles() const {
     return triangles;
 }
 
+const IndexedMesh& ModelLoader::getIndexedMesh() const {
+    return indexedMesh;
+}
+
+IndexedMeshView ModelLoader::getIndexedMeshView() const {
+    if (cacheFile.isOpen()) {
+        return cacheView;
+    }
+    if (meshView.indices != nullptr) {
+        return meshView;
+    }
+    
+    IndexedMeshView view;
+    view.vertices = indexedMesh.vertices.empty() ? nullptr : indexedMesh.vertices.data();
+    const VertexStreams& streams = indexedMesh.streams;
+    if (streams.count > 0) {
+        view.streams = {streams.positionX.data(), streams.positionY.data(), streams.positionZ.data(),
+                        streams.normalX.data(), streams.normalY.data(), streams.normalZ.data(),
+                        streams.texCoordU.data(), streams.texCoordV.data(),
+                        streams.count, streams.paddedCount()};
+    }
+    view.vertexCount = indexedMesh.vertexCount();
+    view.indices = indexedMesh.indices.data();
+    view.indexCount = indexedMesh.indices.size();
+    view.submeshes = indexedMesh.submeshes.data();
+    view.submeshCount = indexedMesh.submeshes.size();
+    view.tangents = indexedMesh.tangents.empty() ? nullptr : indexedMesh.tangents.data();
+    view.hasTexCoords = indexedMesh.hasTexCoords;
+    view.hasNormals = indexedMesh.hasNormals;
+    return view;
+}
+
+void ModelLoader::moveMeshToBlock() {
+    // One exactly sized allocation holding every array, each starting on a cache line
+    constexpr size_t ALIGNMENT = 64;
+    const auto aligned = [](size_t bytes) { return (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1); };
+    const VertexStreams& streams = indexedMesh.streams;
+    const auto bytes = [&](const auto& array) { return aligned(array.size() * sizeof(array[0])); };
+    const size_t total = bytes(indexedMesh.vertices) + bytes(streams.positionX) + bytes(streams.positionY) +
+                         bytes(streams.positionZ) + bytes(streams.normalX) + bytes(streams.normalY) +
+                         bytes(streams.normalZ) + bytes(streams.texCoordU) + bytes(streams.texCoordV) +
+                         bytes(indexedMesh.indices) + bytes(indexedMesh.submeshes) + bytes(indexedMesh.tangents);
+    if (!meshArena) {
+        meshArena = std::make_unique<MonotonicArena>(total);
+    }
+    char* cursor = static_cast<char*>(meshArena->allocate(total, ALIGNMENT));
+    const auto place = [&](const auto& array) {
+        using T = typename std::decay_t<decltype(array)>::value_type;
+        if (array.empty()) {
+            return static_cast<const T*>(nullptr);
+        }
+        std::memcpy(cursor, array.data(), array.size() * sizeof(T));
+        const T* placed = reinterpret_cast<const T*>(cursor);
+        cursor += aligned(array.size() * sizeof(T));
+        return placed;
+    };
+    
+    meshView = IndexedMeshView();
+    meshView.vertices = place(indexedMesh.vertices);
+    meshView.streams = {place(streams.positionX), place(streams.positionY), place(streams.positionZ),
+                        place(streams.normalX), place(streams.normalY), place(streams.normalZ),
+                        place(streams.texCoordU), place(streams.texCoordV),
+                        streams.count, streams.paddedCount()};
+    meshView.vertexCount = indexedMesh.vertexCount();
+    meshView.indices = place(indexedMesh.indices);
+    meshView.indexCount = indexedMesh.indices.size();
+    meshView.submeshes = place(indexedMesh.submeshes);
+    meshView.submeshCount = indexedMesh.submeshes.size();
+    meshView.tangents = place(indexedMesh.tangents);
+    meshView.hasTexCoords = indexedMesh.hasTexCoords;
+    meshView.hasNormals = indexedMesh.hasNormals;
+    indexedMesh = IndexedMesh();
+}
+
+bool ModelLoader::isLoadedFromCache() const {
+    return cacheFile.isOpen();
+}
+
+const MeshOptimizeStats& ModelLoader::getOptimizeStats() const {
+    return optimizeStats;
+}
+
+const ParseMemoryStats& ModelLoader::getParseMemoryStats() const {
+    return parseStats;
+}
+
 const std::vector<TextureCoord>& ModelLoader::getTextureCoords() const {
     return textureCoords;
 }
@@ -311,10 +989,15 @@ const std::vector<Normal>& ModelLoader::getNormals() const {
     return normals;
 }
 
-const std::map<std::string, Material>& ModelLoader::getMaterials() const {
+const std::vector<Material>& ModelLoader::getMaterials() const {
     return materials;
 }
 
+MaterialId ModelLoader::findMaterial(const std::string& name) const {
+    auto it = materialIds.find(name);
+    return it != materialIds.end() ? it->second : NO_MATERIAL;
+}
+
 const std::string& ModelLoader::getCurrentObjectName() const {
     return currentObjectName;
 }
@@ -323,6 +1006,26 @@ const std::string& ModelLoader::getBasePath() const {
     return basePath;
 }
 
+const std::vector<std::string>& ModelLoader::getMaterialSources() const {
+    return materialSources;
+}
+
+std::vector<Material> ModelLoader::reloadMaterials() const {
+    // Start from the known names only, so the IDs stay and stale definitions are dropped
+    ModelLoader reader;
+    reader.materialIds = materialIds;
+    reader.materials.reserve(materials.size());
+    for (const auto& material : materials) {
+        Material entry;
+        entry.name = material.name;
+        reader.materials.push_back(entry);
+    }
+    for (const auto& source : materialSources) {
+        reader.loadMaterialFile(source, "");
+    }
+    return std::move(reader.materials);
+}
+
 void ModelLoader::getStatistics(size_t& vertexCount, size_t& triangleCount, 
                                size_t& textureCount, size_t& normalCount, 
                                size_t& materialCount) const {
@@ -330,7 +1033,8 @@ void ModelLoader::getStatistics(size_t& vertexCount, size_t& triangleCount,
     triangleCount = triangles.size();
     textureCount = textureCoords.size();
     normalCount = normals.size();
-    materialCount = materials.size();
+    materialCount = static_cast<size_t>(std::count_if(materials.begin(), materials.end(),
+                                                      [](const Material& material) { return material.defined; }));
 }
 
 bool ModelLoader::loadMaterialFile(const std::string& filename, const std::string& basePath) {
@@ -342,43 +1046,72 @@ bool ModelLoader::loadMaterialFile(const std::string& filename, const std::strin
         fullPath = std::filesystem::path(basePath) / filename;
     }
     
-    std::ifstream file(fullPath);
-    if (!file.is_open()) {
+    // Remembered as a dependency of the .srmesh cache, even if it does not exist
+    materialSources.push_back(fullPath.string());
+    std::shared_ptr<const MaterialFile> file;
+    if (materialCache != nullptr) {
+        file = materialCache->acquire(fullPath.string(), [this](const std::string& path, std::vector<Material>& definitions) {
+            return readMaterialFile(path, definitions);
+        });
+    } else {
+        auto parsed = std::make_shared<MaterialFile>();
+        parsed->opened = readMaterialFile(fullPath.string(), parsed->materials);
+        file = std::move(parsed);
+    }
+    
+    // Definitions are interned in file order, a later one replaces an earlier one of the same name
+    for (const auto& definition : file->materials) {
+        const MaterialId id = internMaterial(definition.name);
+        if (id != NO_MATERIAL) {
+            materials[id] = definition;
+        }
+    }
+    return file->opened;
+}
+
+bool ModelLoader::readMaterialFile(const std::string& path, std::vector<Material>& definitions) {
+    MappedFile file(path);
+    if (!file.isOpen()) {
         // Try alternative paths or report error
-        std::cerr << "Warning: Cannot open material file: " << fullPath << std::endl;
+        std::cerr << "Warning: Cannot open material file: " << std::filesystem::path(path) << std::endl;
         return false;
     }
     
     Material currentMaterial;
-    std::string line;
-    
-    while (std::getline(file, line)) {
-        if (!parseMaterialLine(line, currentMaterial)) {
+    const char* cursor = file.data();
+    const char* end = cursor + file.size();
+    while (cursor < end) {
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        const char* lineEnd = newline != nullptr ? newline : end;
+        if (!parseMaterialLine(std::string_view(cursor, lineEnd - cursor), currentMaterial, definitions)) {
             // Continue parsing even if individual lines fail
         }
+        cursor = lineEnd + 1;
     }
     
     // Add the last material if it has a name
     if (!currentMaterial.name.empty()) {
-        materials[currentMaterial.name] = currentMaterial;
+        definitions.push_back(currentMaterial);
     }
     
     file.close();
     return true;
 }
 
-bool ModelLoader::parseMaterialLine(const std::string& line, Material& currentMaterial) {
+bool ModelLoader::parseMaterialLine(std::string_view line, Material& currentMaterial,
+                                    std::vector<Material>& definitions) {
     // Skip empty lines and comments
     if (line.empty() || line[0] == '#') {
         return true;
     }
     
-    auto tokens = tokenize(line);
+    std::vector<std::string_view>& tokens = materialTokens;
+    tokenize(line, tokens);
     if (tokens.empty()) {
         return true;
     }
     
-    const std::string& prefix = tokens[0];
+    const std::string_view prefix = tokens[0];
     
     if (prefix == "newmtl") {
         // Start new material
@@ -388,12 +1121,13 @@ bool ModelLoader::parseMaterialLine(const std::string& line, Material& currentMa
         
         // Save previous material if it exists
         if (!currentMaterial.name.empty()) {
-            materials[currentMaterial.name] = currentMaterial;
+            definitions.push_back(currentMaterial);
         }
         
         // Initialize new material
         currentMaterial = Material();
-        currentMaterial.name = tokens[1];
+        currentMaterial.name = std::string(tokens[1]);
+        currentMaterial.defined = true;
         return true;
     }
     
@@ -405,53 +1139,36 @@ bool ModelLoader::parseMaterialLine(const std::string& line, Material& currentMa
     if (prefix == "Ka") {
         // Ambient color
         if (tokens.size() >= 4) {
-            try {
-                currentMaterial.ambient[0] = std::stof(tokens[1]);
-                currentMaterial.ambient[1] = std::stof(tokens[2]);
-                currentMaterial.ambient[2] = std::stof(tokens[3]);
-                return true;
-            } catch (const std::exception&) {
-                return false;
-            }
+            // Channels parsed before a failing one are kept, as with std::stof throwing
+            return parseFloat(tokens[1], currentMaterial.ambient[0]) &&
+                   parseFloat(tokens[2], currentMaterial.ambient[1]) &&
+                   parseFloat(tokens[3], currentMaterial.ambient[2]);
         }
     } else if (prefix == "Kd") {
         // Diffuse color
         if (tokens.size() >= 4) {
-            try {
-                currentMaterial.diffuse[0] = std::stof(tokens[1]);
-                currentMaterial.diffuse[1] = std::stof(tokens[2]);
-                currentMaterial.diffuse[2] = std::stof(tokens[3]);
-                return true;
-            } catch (const std::exception&) {
-                return false;
-            }
+            // Channels parsed before a failing one are kept, as with std::stof throwing
+            return parseFloat(tokens[1], currentMaterial.diffuse[0]) &&
+                   parseFloat(tokens[2], currentMaterial.diffuse[1]) &&
+                   parseFloat(tokens[3], currentMaterial.diffuse[2]);
         }
     } else if (prefix == "Ks") {
         // Specular color
         if (tokens.size() >= 4) {
-            try {
-                currentMaterial.specular[0] = std::stof(tokens[1]);
-                currentMaterial.specular[1] = std::stof(tokens[2]);
-                currentMaterial.specular[2] = std::stof(tokens[3]);
-                return true;
-            } catch (const std::exception&) {
-                return false;
-            }
+            // Channels parsed before a failing one are kept, as with std::stof throwing
+            return parseFloat(tokens[1], currentMaterial.specular[0]) &&
+                   parseFloat(tokens[2], currentMaterial.specular[1]) &&
+                   parseFloat(tokens[3], currentMaterial.specular[2]);
         }
     } else if (prefix == "Ns") {
         // Specular exponent (shininess)
         if (tokens.size() >= 2) {
-            try {
-                currentMaterial.shininess = std::stof(tokens[1]);
-                return true;
-            } catch (const std::exception&) {
-                return false;
-            }
+            return parseFloat(tokens[1], currentMaterial.shininess);
         }
     } else if (prefix == "map_Kd") {
         // Diffuse texture map
         if (tokens.size() >= 2) {
-            currentMaterial.diffuseTexture = tokens[1];
+            currentMaterial.diffuseTexture = std::string(tokens[1]);
             return true;
         }
     }
@@ -460,20 +1177,34 @@ bool ModelLoader::parseMaterialLine(const std::string& line, Material& currentMa
     return true;
 }
 
-void ModelLoader::updateTriangleMaterialPointers() {
-    for (auto& triangle : triangles) {
-        if (!triangle.materialName.empty()) {
-            auto it = materials.find(triangle.materialName);
-            if (it != materials.end()) {
-                triangle.material = &(it->second);
-            } else {
-                // Material not found, set to nullptr
-                triangle.material = nullptr;
-                std::cerr << "Warning: Material '" << triangle.materialName << "' not found" << std::endl;
-            }
-        } else {
-            // No material assigned
-            triangle.material = nullptr;
+MaterialId ModelLoader::internMaterial(const std::string& name) {
+    auto it = materialIds.find(name);
+    if (it != materialIds.end()) {
+        return it->second;
+    }
+    if (materials.size() >= NO_MATERIAL) {
+        std::cerr << "Warning: Too many materials, '" << name << "' is ignored" << std::endl;
+        return NO_MATERIAL;
+    }
+    
+    const MaterialId id = static_cast<MaterialId>(materials.size());
+    Material material;
+    material.name = name;
+    materials.push_back(material);
+    materialIds.emplace(name, id);
+    return id;
+}
+
+void ModelLoader::internChunkMaterials(Chunk& chunk) {
+    for (size_t i = chunk.materialIds.size(); i < chunk.materialNames.size(); ++i) {
+        chunk.materialIds.push_back(internMaterial(chunk.materialNames[i]));
+    }
+}
+
+void ModelLoader::reportUndefinedMaterials() const {
+    for (const auto& material : materials) {
+        if (!material.defined) {
+            std::cerr << "Warning: Material '" << material.name << "' not found" << std::endl;
         }
     }
 }
@@ -0,0 +1,76 @@
+#include <MonotonicArena.h>
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+MonotonicArena::MonotonicArena(size_t initialBlockSize)
+    : initialBlockSize(std::max<size_t>(initialBlockSize, BLOCK_ALIGNMENT)) {
+}
+
+MonotonicArena::~MonotonicArena() {
+    freeBlocks();
+}
+
+void MonotonicArena::reset() {
+    if (blocks.size() > 1) {
+        // Next time the whole round fits into one block
+        const size_t total = capacity();
+        freeBlocks();
+        blocks.push_back({static_cast<char*>(::operator new(total, std::align_val_t(BLOCK_ALIGNMENT))), total});
+    }
+    cursor = blocks.empty() ? nullptr : blocks[0].data;
+    limit = blocks.empty() ? nullptr : blocks[0].data + blocks[0].size;
+    used = 0;
+}
+
+void MonotonicArena::release() {
+    freeBlocks();
+    cursor = nullptr;
+    limit = nullptr;
+    used = 0;
+}
+
+size_t MonotonicArena::capacity() const {
+    size_t total = 0;
+    for (const auto& block : blocks) {
+        total += block.size;
+    }
+    return total;
+}
+
+void* MonotonicArena::do_allocate(size_t bytes, size_t alignment) {
+    uintptr_t address = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    if (cursor == nullptr || address + bytes > reinterpret_cast<uintptr_t>(limit)) {
+        addBlock(bytes, alignment);
+        address = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    }
+    char* pointer = reinterpret_cast<char*>(address);
+    used += pointer + bytes - cursor;
+    cursor = pointer + bytes;
+    return pointer;
+}
+
+void MonotonicArena::do_deallocate(void*, size_t, size_t) {
+    // Memory is reclaimed by reset() and release() only
+}
+
+bool MonotonicArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void MonotonicArena::addBlock(size_t bytes, size_t alignment) {
+    // Blocks double so a growing vector needs a logarithmic number of them
+    size_t size = blocks.empty() ? initialBlockSize : blocks.back().size * 2;
+    size = std::max(size, bytes + std::max(alignment, BLOCK_ALIGNMENT));
+    char* data = static_cast<char*>(::operator new(size, std::align_val_t(BLOCK_ALIGNMENT)));
+    blocks.push_back({data, size});
+    cursor = data;
+    limit = data + size;
+}
+
+void MonotonicArena::freeBlocks() {
+    for (const auto& block : blocks) {
+        ::operator delete(block.data, std::align_val_t(BLOCK_ALIGNMENT));
+    }
+    blocks.clear();
+}
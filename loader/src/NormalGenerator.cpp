@@ -0,0 +1,171 @@
+#include <NormalGenerator.h>
+#include "ParallelRanges.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+inline Normal subtract(const Vertex& a, const Vertex& b) {
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+inline Normal cross(const Normal& a, const Normal& b) {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+inline float dot(const Normal& a, const Normal& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline float length(const Normal& a) {
+    return std::sqrt(dot(a, a));
+}
+
+/**
+ * @brief Unit length copy of a vector, zero for a zero vector
+ */
+inline Normal normalize(const Normal& a) {
+    const float len = length(a);
+    if (len <= 0.0f) {
+        return {0.0f, 0.0f, 0.0f};
+    }
+    return {a.x / len, a.y / len, a.z / len};
+}
+
+inline bool equal(const Normal& a, const Normal& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+} // namespace
+
+GeneratedNormals NormalGenerator::generate(const Vertex* positions, size_t vertexCount, const uint32_t* indices,
+                                           size_t indexCount, const uint32_t* smoothingGroups,
+                                           const NormalOptions& options) {
+    GeneratedNormals result;
+    const size_t triangleCount = indexCount / 3;
+    result.cornerNormals.resize(triangleCount * 3);
+    const unsigned int threads = resolveThreadCount(options.threadCount);
+    // From 180 degrees on every pair of faces passes the crease test and only groups separate normals
+    const bool useCrease = options.creaseAngle < 180.0f;
+    const float creaseCos = std::cos(std::max(options.creaseAngle, 0.0f) * 3.14159265358979f / 180.0f);
+
+    // Unit face normals, and the weight of every corner: face area times the angle at the corner
+    std::vector<Normal> faceNormals(triangleCount);
+    std::vector<float> cornerWeights(triangleCount * 3);
+    parallelRanges(triangleCount, threads, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            const Vertex* p[3] = {&positions[indices[t * 3]], &positions[indices[t * 3 + 1]],
+                                  &positions[indices[t * 3 + 2]]};
+            const Normal faceCross = cross(subtract(*p[1], *p[0]), subtract(*p[2], *p[0]));
+            const float area = 0.5f * length(faceCross);
+            faceNormals[t] = normalize(faceCross);
+            for (int k = 0; k < 3; ++k) {
+                const Normal e1 = subtract(*p[(k + 1) % 3], *p[k]);
+                const Normal e2 = subtract(*p[(k + 2) % 3], *p[k]);
+                const float lengths = length(e1) * length(e2);
+                const float angle = lengths > 0.0f ? std::acos(std::clamp(dot(e1, e2) / lengths, -1.0f, 1.0f)) : 0.0f;
+                cornerWeights[t * 3 + k] = area * angle;
+            }
+        }
+    });
+
+    // Corners grouped by position, in corner order
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        ++offsets[indices[i] + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<uint32_t> corners(triangleCount * 3);
+    {
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; ++i) {
+            corners[cursor[indices[i]]++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    // Gather: every position sums the faces around it and writes only its own corners.
+    // cornerNormals holds a number local to the position until the prefix sum below
+    std::vector<Normal> cornerValues(triangleCount * 3);
+    std::vector<uint32_t> uniqueCounts(vertexCount + 1, 0);
+    parallelRanges(vertexCount, threads, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            uint32_t* first = corners.data() + offsets[v];
+            uint32_t* last = corners.data() + offsets[v + 1];
+            std::sort(first, last, [&](uint32_t a, uint32_t b) {
+                const uint32_t groupA = smoothingGroups[a / 3];
+                const uint32_t groupB = smoothingGroups[b / 3];
+                return groupA != groupB ? groupA < groupB : a < b;
+            });
+            uint32_t unique = 0;
+            for (uint32_t* run = first; run != last;) {
+                const uint32_t group = smoothingGroups[*run / 3];
+                uint32_t* runEnd = run;
+                while (runEnd != last && smoothingGroups[*runEnd / 3] == group) {
+                    ++runEnd;
+                }
+                Normal groupNormal = {0.0f, 0.0f, 0.0f};
+                if (group != FLAT && !useCrease) {
+                    for (const uint32_t* c = run; c != runEnd; ++c) {
+                        const Normal& face = faceNormals[*c / 3];
+                        const float weight = cornerWeights[*c];
+                        groupNormal = {groupNormal.x + face.x * weight, groupNormal.y + face.y * weight,
+                                       groupNormal.z + face.z * weight};
+                    }
+                    groupNormal = normalize(groupNormal);
+                }
+                for (const uint32_t* c = run; c != runEnd; ++c) {
+                    const Normal& own = faceNormals[*c / 3];
+                    Normal normal = own;
+                    if (group != FLAT && !useCrease) {
+                        normal = groupNormal;
+                    } else if (group != FLAT) {
+                        // Only the faces within the crease angle of the corner's own face
+                        Normal sum = {0.0f, 0.0f, 0.0f};
+                        for (const uint32_t* other = run; other != runEnd; ++other) {
+                            const Normal& face = faceNormals[*other / 3];
+                            if (dot(own, face) >= creaseCos) {
+                                const float weight = cornerWeights[*other];
+                                sum = {sum.x + face.x * weight, sum.y + face.y * weight, sum.z + face.z * weight};
+                            }
+                        }
+                        normal = normalize(sum);
+                    }
+                    // Corners of the group with the same normal share it
+                    cornerValues[*c] = normal;
+                    uint32_t id = unique;
+                    for (const uint32_t* previous = run; previous != c; ++previous) {
+                        if (equal(cornerValues[*previous], normal)) {
+                            id = result.cornerNormals[*previous];
+                            break;
+                        }
+                    }
+                    if (id == unique) {
+                        ++unique;
+                    }
+                    result.cornerNormals[*c] = id;
+                }
+                run = runEnd;
+            }
+            uniqueCounts[v + 1] = unique;
+        }
+    });
+    for (size_t v = 0; v < vertexCount; ++v) {
+        uniqueCounts[v + 1] += uniqueCounts[v];
+    }
+
+    // Turn the local numbers into entries of the normal array
+    result.normals.resize(uniqueCounts[vertexCount]);
+    parallelRanges(vertexCount, threads, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                const uint32_t c = corners[i];
+                const uint32_t id = uniqueCounts[v] + result.cornerNormals[c];
+                result.cornerNormals[c] = id;
+                result.normals[id] = cornerValues[c];
+            }
+        }
+    });
+    return result;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file NumberParsing.h
+ * @author zhywyt (zhywyt@yeah.net)
+ * @brief Allocation-free number parsing with std::stof / std::stoi semantics (internal to the loader)
+ * @version 0.2
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#pragma once
+#include <charconv>
+#include <cmath>
+#include <exception>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Whitespace as classified by std::isspace in the "C" locale
+ */
+inline bool isSpace(char c) {
+    // ' ' is the only whitespace above '\r', everything else is a single range
+    const unsigned char u = static_cast<unsigned char>(c);
+    return u == ' ' || (u >= '\t' && u <= '\r');
+}
+
+/**
+ * @brief First character at or after first that is not whitespace
+ */
+inline const char* skipSpaces(const char* first, const char* last) {
+    while (first != last && isSpace(*first)) {
+        ++first;
+    }
+    return first;
+}
+
+/**
+ * @brief Skip a leading '+', which std::from_chars rejects but std::stof/std::stoi accept
+ * @return false if the sign is followed by another sign ("+-1" is invalid for std::stof too)
+ */
+inline bool skipPlusSign(const char*& first, const char* last) {
+    if (first != last && *first == '+') {
+        ++first;
+        if (first != last && (*first == '+' || *first == '-')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Slow path with the exact semantics of std::stof
+ */
+inline bool parseFloatFallback(std::string_view token, float& value) {
+    try {
+        value = std::stof(std::string(token));
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+/**
+ * @brief Parse a float the way std::stof does, without allocating
+ * @details Leading whitespace is skipped and the longest valid prefix is converted,
+ * trailing characters are ignored.
+ * Out of range values (overflow, or underflow to zero / subnormal) fail like std::stof
+ * throwing std::out_of_range. Hexadecimal floats and subnormal results are rare enough
+ * to be handed to std::stof itself.
+ */
+inline bool parseFloat(std::string_view token, float& value) {
+    const char* first = skipSpaces(token.data(), token.data() + token.size());
+    const char* last = token.data() + token.size();
+    if (!skipPlusSign(first, last)) {
+        return false;
+    }
+    const char* digits = (first != last && *first == '-') ? first + 1 : first;
+    if (last - digits >= 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) {
+        return parseFloatFallback(token, value);
+    }
+
+    // value is only written on success, like an assignment from std::stof
+    float parsed;
+    const auto result = std::from_chars(first, last, parsed);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    if (parsed == 0.0f) {
+        // A true zero has no non-zero digit before the exponent, anything else underflowed
+        for (const char* c = digits; c != result.ptr && *c != 'e' && *c != 'E'; ++c) {
+            if (*c >= '1' && *c <= '9') {
+                return false;
+            }
+        }
+    } else if (std::fpclassify(parsed) == FP_SUBNORMAL) {
+        return parseFloatFallback(token, value);
+    }
+    value = parsed;
+    return true;
+}
+
+/**
+ * @brief Parse a base-10 integer the way std::stoi does, without allocating
+ * @details Leading whitespace and a '+' sign are accepted, trailing characters are ignored.
+ */
+inline bool parseInt(std::string_view token, int& value) {
+    const char* first = skipSpaces(token.data(), token.data() + token.size());
+    const char* last = token.data() + token.size();
+    if (!skipPlusSign(first, last)) {
+        return false;
+    }
+    return std::from_chars(first, last, value).ec == std::errc();
+}
@@ -0,0 +1,71 @@
+/**
+ * @file ParallelRanges.h
+ * @author zhywyt (zhywyt@yeah.net)
+ * @brief Splitting a loop over contiguous ranges across threads (internal to the loader)
+ * @version 0.2
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Smallest range handed to a thread, smaller inputs are processed on one thread
+ */
+constexpr size_t MIN_PARALLEL_RANGE = 16384;
+
+/**
+ * @brief Thread count for a thread count option, 0 meaning all hardware threads
+ */
+inline unsigned int resolveThreadCount(unsigned int threadCount) {
+    const unsigned int threads = threadCount != 0 ? threadCount : std::thread::hardware_concurrency();
+    return std::max(threads, 1u);
+}
+
+/**
+ * @brief Run task(begin, end) over [0, count), split into one contiguous range per thread
+ */
+template <typename Task>
+void parallelRanges(size_t count, unsigned int threads, Task&& task) {
+    const size_t ranges = std::clamp<size_t>(count / MIN_PARALLEL_RANGE, 1, threads);
+    if (ranges == 1) {
+        task(size_t(0), count);
+        return;
+    }
+    std::vector<std::thread> pool;
+    pool.reserve(ranges - 1);
+    for (size_t i = 1; i < ranges; ++i) {
+        pool.emplace_back([&task, i, ranges, count]() { task(count * i / ranges, count * (i + 1) / ranges); });
+    }
+    task(size_t(0), count / ranges);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Run task(0) ... task(count - 1), one thread per task
+ */
+template <typename Task>
+void runParallel(size_t count, Task&& task) {
+    if (count <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+    std::vector<std::thread> pool;
+    pool.reserve(count - 1);
+    for (size_t i = 1; i < count; ++i) {
+        pool.emplace_back([&task, i]() { task(i); });
+    }
+    task(0);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
@@ -0,0 +1,643 @@
+#include <PlyLoader.h>
+#include <MappedFile.h>
+#include "ParallelRanges.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <type_traits>
+
+namespace {
+
+/**
+ * @brief Smallest chunk of an ASCII body handed to a parser thread
+ */
+constexpr size_t MIN_CHUNK_BYTES = size_t(1) << 20;
+constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+/**
+ * @brief Vertex attribute a property is converted into
+ */
+enum Target {
+    TARGET_NONE = -1,
+    POSITION_X, POSITION_Y, POSITION_Z,
+    NORMAL_X, NORMAL_Y, NORMAL_Z,
+    TEXCOORD_U, TEXCOORD_V,
+    FLOAT_TARGETS,                        ///< Targets below are colors
+    COLOR_RED = FLOAT_TARGETS, COLOR_GREEN, COLOR_BLUE, COLOR_ALPHA,
+    TARGET_COUNT
+};
+
+Target targetOf(const std::string& name) {
+    if (name == "x") return POSITION_X;
+    if (name == "y") return POSITION_Y;
+    if (name == "z") return POSITION_Z;
+    if (name == "nx") return NORMAL_X;
+    if (name == "ny") return NORMAL_Y;
+    if (name == "nz") return NORMAL_Z;
+    if (name == "u" || name == "s" || name == "texture_u" || name == "texture_s") return TEXCOORD_U;
+    if (name == "v" || name == "t" || name == "texture_v" || name == "texture_t") return TEXCOORD_V;
+    if (name == "red" || name == "diffuse_red") return COLOR_RED;
+    if (name == "green" || name == "diffuse_green") return COLOR_GREEN;
+    if (name == "blue" || name == "diffuse_blue") return COLOR_BLUE;
+    if (name == "alpha" || name == "diffuse_alpha") return COLOR_ALPHA;
+    return TARGET_NONE;
+}
+
+bool parseType(std::string_view name, PlyType& type) {
+    if (name == "char" || name == "int8") type = PlyType::Int8;
+    else if (name == "uchar" || name == "uint8") type = PlyType::UInt8;
+    else if (name == "short" || name == "int16") type = PlyType::Int16;
+    else if (name == "ushort" || name == "uint16") type = PlyType::UInt16;
+    else if (name == "int" || name == "int32") type = PlyType::Int32;
+    else if (name == "uint" || name == "uint32") type = PlyType::UInt32;
+    else if (name == "float" || name == "float32") type = PlyType::Float32;
+    else if (name == "double" || name == "float64") type = PlyType::Float64;
+    else return false;
+    return true;
+}
+
+size_t typeSize(PlyType type) {
+    switch (type) {
+    case PlyType::Int8: case PlyType::UInt8: return 1;
+    case PlyType::Int16: case PlyType::UInt16: return 2;
+    case PlyType::Int32: case PlyType::UInt32: case PlyType::Float32: return 4;
+    case PlyType::Float64: return 8;
+    }
+    return 0;
+}
+
+/**
+ * @brief A T stored at p, byte swapped for big endian files
+ */
+template <typename T>
+inline T loadScalar(const char* p, bool swap) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, p, sizeof(T));
+    if (swap) {
+        std::reverse(bytes, bytes + sizeof(T));
+    }
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+/**
+ * @brief Call f with a value of the C++ type of a PLY type (only the type matters)
+ */
+template <typename F>
+void dispatch(PlyType type, F&& f) {
+    switch (type) {
+    case PlyType::Int8: f(int8_t()); break;
+    case PlyType::UInt8: f(uint8_t()); break;
+    case PlyType::Int16: f(int16_t()); break;
+    case PlyType::UInt16: f(uint16_t()); break;
+    case PlyType::Int32: f(int32_t()); break;
+    case PlyType::UInt32: f(uint32_t()); break;
+    case PlyType::Float32: f(float()); break;
+    case PlyType::Float64: f(double()); break;
+    }
+}
+
+double loadValue(const char* p, PlyType type, bool swap) {
+    double value = 0.0;
+    dispatch(type, [&](auto tag) { value = static_cast<double>(loadScalar<decltype(tag)>(p, swap)); });
+    return value;
+}
+
+/**
+ * @brief A color channel as a byte: floating point colors are in [0, 1], integer ones in [0, 255]
+ */
+template <typename T>
+inline uint8_t toColor(T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<uint8_t>(std::clamp(value * T(255) + T(0.5), T(0), T(255)));
+    } else {
+        return static_cast<uint8_t>(std::clamp<long long>(value, 0, 255));
+    }
+}
+
+/**
+ * @brief List index as a vertex index, INVALID_INDEX if negative, fractional or too large
+ */
+inline uint32_t toIndex(double value, size_t vertexCount) {
+    if (value < 0.0 || value >= static_cast<double>(vertexCount) || value != static_cast<double>(static_cast<uint64_t>(value))) {
+        return INVALID_INDEX;
+    }
+    return static_cast<uint32_t>(value);
+}
+
+/**
+ * @brief Fan triangulation of one polygon into out, nothing if an index is invalid or it has fewer than 3 corners
+ */
+inline void appendPolygon(const uint32_t* polygon, size_t count, std::vector<uint32_t>& out) {
+    if (count < 3 || std::find(polygon, polygon + count, INVALID_INDEX) != polygon + count) {
+        return;
+    }
+    for (size_t k = 2; k < count; ++k) {
+        out.push_back(polygon[0]);
+        out.push_back(polygon[k - 1]);
+        out.push_back(polygon[k]);
+    }
+}
+
+/**
+ * @brief Destination arrays of the vertex attributes, nullptr for attributes the file lacks
+ */
+struct VertexTargets {
+    float* floats[FLOAT_TARGETS] = {};
+    uint8_t* colors[TARGET_COUNT - FLOAT_TARGETS] = {};
+
+    /**
+     * @brief Store a value read as type
+     */
+    void set(int target, size_t row, double value, PlyType type) {
+        if (target < FLOAT_TARGETS) {
+            floats[target][row] = static_cast<float>(value);
+        } else if (colors[target - FLOAT_TARGETS] != nullptr) {
+            const bool floating = type == PlyType::Float32 || type == PlyType::Float64;
+            colors[target - FLOAT_TARGETS][row] = floating ? toColor(value) : toColor(static_cast<long long>(value));
+        }
+    }
+};
+
+/**
+ * @brief Newline aligned piece of an ASCII body
+ */
+struct AsciiChunk {
+    std::string_view text;
+    size_t firstRow = 0;                  ///< Global row number of the first non-blank line
+    size_t rowCount = 0;                  ///< Non-blank lines
+    std::vector<uint32_t> indices;        ///< Triangles of the face rows
+    size_t indexBase = 0;                 ///< Indices of earlier chunks
+    bool failed = false;
+};
+
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+ * @brief Read the next number of a line
+ */
+inline bool nextNumber(const char*& cursor, const char* end, double& value) {
+    while (cursor != end && isBlank(*cursor)) {
+        ++cursor;
+    }
+    if (cursor != end && *cursor == '+') {
+        ++cursor;
+    }
+    const auto result = std::from_chars(cursor, end, value);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    cursor = result.ptr;
+    return true;
+}
+
+/**
+ * @brief Whether a line has anything but whitespace
+ */
+inline bool hasContent(const char* first, const char* last) {
+    return std::any_of(first, last, [](char c) { return !isBlank(c); });
+}
+
+} // namespace
+
+bool PlyLoader::load(const std::string& filename) {
+    mesh.clear();
+    colors = {};
+    elements.clear();
+    format = PlyFormat::Ascii;
+
+    MappedFile file;
+    if (!file.open(filename)) {
+        std::cerr << "Error: Cannot open PLY file " << filename << std::endl;
+        return false;
+    }
+
+    // Header: one declaration per line up to end_header
+    const std::string_view text = file.view();
+    size_t pos = 0;
+    std::vector<std::string_view> tokens;
+    auto nextLine = [&]() -> bool {
+        if (pos >= text.size()) {
+            return false;
+        }
+        size_t newline = text.find('\n', pos);
+        if (newline == std::string_view::npos) {
+            newline = text.size();
+        }
+        std::string_view line = text.substr(pos, newline - pos);
+        pos = std::min(newline + 1, text.size());
+        tokens.clear();
+        size_t start = 0;
+        while (start < line.size()) {
+            while (start < line.size() && (isBlank(line[start]) || line[start] == '\n')) {
+                ++start;
+            }
+            size_t stop = start;
+            while (stop < line.size() && !isBlank(line[stop])) {
+                ++stop;
+            }
+            if (stop > start) {
+                tokens.push_back(line.substr(start, stop - start));
+            }
+            start = stop;
+        }
+        return true;
+    };
+    auto fail = [&](const char* message) {
+        std::cerr << "Error: " << message << " in " << filename << std::endl;
+        mesh.clear();
+        colors = {};
+        return false;
+    };
+
+    if (!nextLine() || tokens.size() != 1 || tokens[0] != "ply") {
+        return fail("Missing ply signature");
+    }
+    bool ended = false;
+    bool hasFormat = false;
+    while (!ended && nextLine()) {
+        if (tokens.empty() || tokens[0] == "comment" || tokens[0] == "obj_info") {
+            continue;
+        }
+        if (tokens[0] == "end_header") {
+            ended = true;
+        } else if (tokens[0] == "format" && tokens.size() == 3) {
+            if (tokens[1] == "ascii") format = PlyFormat::Ascii;
+            else if (tokens[1] == "binary_little_endian") format = PlyFormat::BinaryLittleEndian;
+            else if (tokens[1] == "binary_big_endian") format = PlyFormat::BinaryBigEndian;
+            else return fail("Unknown PLY format");
+            hasFormat = true;
+        } else if (tokens[0] == "element" && tokens.size() == 3) {
+            PlyElement element;
+            element.name = std::string(tokens[1]);
+            if (std::from_chars(tokens[2].data(), tokens[2].data() + tokens[2].size(), element.count).ec != std::errc()) {
+                return fail("Invalid element count");
+            }
+            elements.push_back(std::move(element));
+        } else if (tokens[0] == "property" && !elements.empty()) {
+            PlyProperty property;
+            bool valid = false;
+            if (tokens.size() == 5 && tokens[1] == "list") {
+                property.isList = true;
+                property.name = std::string(tokens[4]);
+                valid = parseType(tokens[2], property.countType) && parseType(tokens[3], property.type) &&
+                        property.countType != PlyType::Float32 && property.countType != PlyType::Float64;
+            } else if (tokens.size() == 3) {
+                property.name = std::string(tokens[2]);
+                valid = parseType(tokens[1], property.type);
+            }
+            if (!valid) {
+                return fail("Invalid property declaration");
+            }
+            elements.back().properties.push_back(std::move(property));
+        } else {
+            return fail("Invalid header line");
+        }
+    }
+    if (!ended || !hasFormat) {
+        return fail("Incomplete PLY header");
+    }
+
+    // The vertex element fills the streams, the vertex_indices list of the face element the indices
+    const PlyElement* vertexElement = nullptr;
+    const PlyElement* faceElement = nullptr;
+    size_t faceList = 0;
+    for (const PlyElement& element : elements) {
+        if (element.name == "vertex" && vertexElement == nullptr) {
+            vertexElement = &element;
+        } else if (element.name == "face" && faceElement == nullptr) {
+            for (size_t i = 0; i < element.properties.size(); ++i) {
+                const PlyProperty& property = element.properties[i];
+                if (property.isList && (property.name == "vertex_indices" || property.name == "vertex_index")) {
+                    faceElement = &element;
+                    faceList = i;
+                    break;
+                }
+            }
+        }
+    }
+    const size_t vertexCount = vertexElement != nullptr ? vertexElement->count : 0;
+    if (vertexCount > INVALID_INDEX) {
+        return fail("Too many vertices");
+    }
+
+    // Properties of the vertex element that have a destination
+    std::vector<int> targets(vertexElement != nullptr ? vertexElement->properties.size() : 0, TARGET_NONE);
+    bool present[TARGET_COUNT] = {};
+    for (size_t i = 0; i < targets.size(); ++i) {
+        if (!vertexElement->properties[i].isList) {
+            targets[i] = targetOf(vertexElement->properties[i].name);
+            if (targets[i] != TARGET_NONE) {
+                present[targets[i]] = true;
+            }
+        }
+    }
+    mesh.streams.count = vertexCount;
+    mesh.streams.pad();
+    VertexStreams& streams = mesh.streams;
+    VertexTargets destination;
+    float* floatArrays[FLOAT_TARGETS] = {streams.positionX.data(), streams.positionY.data(), streams.positionZ.data(),
+                                         streams.normalX.data(), streams.normalY.data(), streams.normalZ.data(),
+                                         streams.texCoordU.data(), streams.texCoordV.data()};
+    std::copy(floatArrays, floatArrays + FLOAT_TARGETS, destination.floats);
+    if (present[COLOR_RED] || present[COLOR_GREEN] || present[COLOR_BLUE]) {
+        colors.red.assign(vertexCount, 0);
+        colors.green.assign(vertexCount, 0);
+        colors.blue.assign(vertexCount, 0);
+        colors.alpha.assign(vertexCount, 255);
+        uint8_t* colorArrays[TARGET_COUNT - FLOAT_TARGETS] = {colors.red.data(), colors.green.data(),
+                                                              colors.blue.data(), colors.alpha.data()};
+        std::copy(colorArrays, colorArrays + (TARGET_COUNT - FLOAT_TARGETS), destination.colors);
+    }
+
+    const unsigned int threads = resolveThreadCount(threadCount);
+    const char* body = text.data() + pos;
+    const char* end = text.data() + text.size();
+
+    if (format != PlyFormat::Ascii) {
+        const bool swap = format == PlyFormat::BinaryBigEndian;
+        const char* cursor = body;
+        for (const PlyElement& element : elements) {
+            const size_t propertyCount = element.properties.size();
+
+            // Row layout from the first row: offsets of the properties and lengths of the lists
+            std::vector<size_t> offsets(propertyCount);
+            std::vector<size_t> listLengths(propertyCount, 0);
+            size_t rowSize = 0;
+            bool uniform = true;
+            const bool hasList = std::any_of(element.properties.begin(), element.properties.end(),
+                                             [](const PlyProperty& property) { return property.isList; });
+            if (element.count > 0) {
+                for (size_t i = 0; i < propertyCount; ++i) {
+                    const PlyProperty& property = element.properties[i];
+                    offsets[i] = rowSize;
+                    if (!property.isList) {
+                        rowSize += typeSize(property.type);
+                        continue;
+                    }
+                    if (static_cast<size_t>(end - cursor) < rowSize + typeSize(property.countType)) {
+                        return fail("Truncated PLY body");
+                    }
+                    listLengths[i] = static_cast<size_t>(loadValue(cursor + rowSize, property.countType, swap));
+                    rowSize += typeSize(property.countType) + listLengths[i] * typeSize(property.type);
+                }
+                // Every row has that layout if every list has the length of the first row's (by induction
+                // over the rows), checked in parallel
+                if (rowSize == 0 || static_cast<size_t>(end - cursor) / rowSize < element.count) {
+                    uniform = false;
+                } else if (hasList) {
+                    std::atomic<bool> same(true);
+                    parallelRanges(element.count, threads, [&](size_t begin, size_t stop) {
+                        for (size_t i = 0; i < propertyCount; ++i) {
+                            if (!element.properties[i].isList) {
+                                continue;
+                            }
+                            dispatch(element.properties[i].countType, [&](auto tag) {
+                                using T = decltype(tag);
+                                const T expected = static_cast<T>(listLengths[i]);
+                                const char* counts = cursor + offsets[i];
+                                for (size_t row = begin; row < stop; ++row) {
+                                    if (loadScalar<T>(counts + row * rowSize, swap) != expected) {
+                                        same.store(false, std::memory_order_relaxed);
+                                        return;
+                                    }
+                                }
+                            });
+                        }
+                    });
+                    uniform = same.load();
+                }
+            }
+
+            if (uniform) {
+                // Fixed row size: convert column by column straight from the mapping
+                if (&element == vertexElement) {
+                    for (size_t i = 0; i < propertyCount; ++i) {
+                        const int target = targets[i];
+                        if (target == TARGET_NONE || (target >= FLOAT_TARGETS && colors.empty())) {
+                            continue;
+                        }
+                        const char* column = cursor + offsets[i];
+                        parallelRanges(element.count, threads, [&](size_t begin, size_t stop) {
+                            dispatch(element.properties[i].type, [&](auto tag) {
+                                using T = decltype(tag);
+                                if (target < FLOAT_TARGETS) {
+                                    float* out = destination.floats[target];
+                                    for (size_t row = begin; row < stop; ++row) {
+                                        out[row] = static_cast<float>(loadScalar<T>(column + row * rowSize, swap));
+                                    }
+                                } else {
+                                    uint8_t* out = destination.colors[target - FLOAT_TARGETS];
+                                    for (size_t row = begin; row < stop; ++row) {
+                                        out[row] = toColor(loadScalar<T>(column + row * rowSize, swap));
+                                    }
+                                }
+                            });
+                        });
+                    }
+                } else if (&element == faceElement && listLengths[faceList] >= 3) {
+                    const PlyProperty& list = element.properties[faceList];
+                    const size_t corners = listLengths[faceList];
+                    const size_t perRow = (corners - 2) * 3;
+                    const char* items = cursor + offsets[faceList] + typeSize(list.countType);
+                    const size_t itemSize = typeSize(list.type);
+                    mesh.indices.resize(element.count * perRow);
+                    std::atomic<bool> dropped(false);
+                    parallelRanges(element.count, threads, [&](size_t begin, size_t stop) {
+                        dispatch(list.type, [&](auto tag) {
+                            using T = decltype(tag);
+                            std::vector<uint32_t> polygon(corners);
+                            for (size_t row = begin; row < stop; ++row) {
+                                const char* item = items + row * rowSize;
+                                bool valid = true;
+                                for (size_t k = 0; k < corners; ++k) {
+                                    polygon[k] = toIndex(static_cast<double>(loadScalar<T>(item + k * itemSize, swap)),
+                                                         vertexCount);
+                                    valid = valid && polygon[k] != INVALID_INDEX;
+                                }
+                                uint32_t* out = mesh.indices.data() + row * perRow;
+                                if (!valid) {
+                                    dropped.store(true, std::memory_order_relaxed);
+                                    std::fill_n(out, perRow, INVALID_INDEX);
+                                    continue;
+                                }
+                                for (size_t k = 2; k < corners; ++k) {
+                                    *out++ = polygon[0];
+                                    *out++ = polygon[k - 1];
+                                    *out++ = polygon[k];
+                                }
+                            }
+                        });
+                    });
+                    if (dropped.load()) {
+                        // Squeeze out the triangles of faces with invalid indices
+                        size_t kept = 0;
+                        for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+                            if (mesh.indices[i] != INVALID_INDEX) {
+                                std::copy_n(mesh.indices.begin() + i, 3, mesh.indices.begin() + kept);
+                                kept += 3;
+                            }
+                        }
+                        mesh.indices.resize(kept);
+                    }
+                }
+                cursor += element.count * rowSize;
+                continue;
+            }
+
+            // Rows of different sizes: walk them one by one
+            std::vector<uint32_t> polygon;
+            for (size_t row = 0; row < element.count; ++row) {
+                for (size_t i = 0; i < propertyCount; ++i) {
+                    const PlyProperty& property = element.properties[i];
+                    size_t length = 1;
+                    if (property.isList) {
+                        if (static_cast<size_t>(end - cursor) < typeSize(property.countType)) {
+                            return fail("Truncated PLY body");
+                        }
+                        length = static_cast<size_t>(loadValue(cursor, property.countType, swap));
+                        cursor += typeSize(property.countType);
+                    }
+                    const size_t size = typeSize(property.type);
+                    if (static_cast<size_t>(end - cursor) / size < length) {
+                        return fail("Truncated PLY body");
+                    }
+                    if (&element == vertexElement && targets[i] != TARGET_NONE) {
+                        destination.set(targets[i], row, loadValue(cursor, property.type, swap), property.type);
+                    } else if (&element == faceElement && i == faceList) {
+                        polygon.resize(length);
+                        for (size_t k = 0; k < length; ++k) {
+                            polygon[k] = toIndex(loadValue(cursor + k * size, property.type, swap), vertexCount);
+                        }
+                        appendPolygon(polygon.data(), length, mesh.indices);
+                    }
+                    cursor += length * size;
+                }
+            }
+        }
+    } else {
+        // ASCII: one row per non-blank line, elements one after another. Newline aligned chunks
+        // count their rows, then parse them knowing the global row number of their first line
+        const size_t bodySize = static_cast<size_t>(end - body);
+        const size_t chunkCount = std::clamp<size_t>(bodySize / MIN_CHUNK_BYTES, 1, threads);
+        std::vector<AsciiChunk> chunks(chunkCount);
+        const char* cursor = body;
+        for (size_t i = 0; i < chunkCount; ++i) {
+            const char* chunkEnd = end;
+            if (i + 1 < chunkCount) {
+                chunkEnd = std::max(body + bodySize / chunkCount * (i + 1), cursor);
+                const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', end - chunkEnd));
+                chunkEnd = newline != nullptr ? newline + 1 : end;
+            }
+            chunks[i].text = std::string_view(cursor, chunkEnd - cursor);
+            cursor = chunkEnd;
+        }
+        auto forEachLine = [](const AsciiChunk& chunk, auto&& visit) {
+            const char* line = chunk.text.data();
+            const char* stop = line + chunk.text.size();
+            while (line < stop) {
+                const char* newline = static_cast<const char*>(std::memchr(line, '\n', stop - line));
+                const char* lineEnd = newline != nullptr ? newline : stop;
+                if (hasContent(line, lineEnd) && !visit(line, lineEnd)) {
+                    return;
+                }
+                line = lineEnd + 1;
+            }
+        };
+        runParallel(chunkCount, [&](size_t i) {
+            forEachLine(chunks[i], [&](const char*, const char*) {
+                ++chunks[i].rowCount;
+                return true;
+            });
+        });
+        size_t rowTotal = 0;
+        for (AsciiChunk& chunk : chunks) {
+            chunk.firstRow = rowTotal;
+            rowTotal += chunk.rowCount;
+        }
+        std::vector<size_t> elementStarts(elements.size() + 1, 0);
+        for (size_t e = 0; e < elements.size(); ++e) {
+            elementStarts[e + 1] = elementStarts[e] + elements[e].count;
+        }
+        if (rowTotal < elementStarts.back()) {
+            return fail("Truncated PLY body");
+        }
+
+        runParallel(chunkCount, [&](size_t c) {
+            AsciiChunk& chunk = chunks[c];
+            size_t row = chunk.firstRow;
+            size_t e = std::upper_bound(elementStarts.begin(), elementStarts.end(), row) - elementStarts.begin() - 1;
+            std::vector<uint32_t> polygon;
+            forEachLine(chunk, [&](const char* line, const char* lineEnd) {
+                while (e < elements.size() && row >= elementStarts[e + 1]) {
+                    ++e;
+                }
+                if (e >= elements.size()) {
+                    return false;
+                }
+                const PlyElement& element = elements[e];
+                const size_t local = row - elementStarts[e];
+                ++row;
+                if (&element != vertexElement && &element != faceElement) {
+                    return true;
+                }
+                double value;
+                for (size_t i = 0; i < element.properties.size(); ++i) {
+                    const PlyProperty& property = element.properties[i];
+                    size_t length = 1;
+                    if (property.isList) {
+                        if (!nextNumber(line, lineEnd, value) || value < 0.0) {
+                            chunk.failed = true;
+                            return false;
+                        }
+                        length = static_cast<size_t>(value);
+                    }
+                    const bool isFaceList = &element == faceElement && i == faceList;
+                    if (isFaceList) {
+                        polygon.resize(length);
+                    }
+                    for (size_t k = 0; k < length; ++k) {
+                        if (!nextNumber(line, lineEnd, value)) {
+                            chunk.failed = true;
+                            return false;
+                        }
+                        if (isFaceList) {
+                            polygon[k] = toIndex(value, vertexCount);
+                        } else if (&element == vertexElement && targets[i] != TARGET_NONE) {
+                            destination.set(targets[i], local, value, property.type);
+                        }
+                    }
+                    if (isFaceList) {
+                        appendPolygon(polygon.data(), length, chunk.indices);
+                    }
+                }
+                return true;
+            });
+        });
+        size_t indexTotal = 0;
+        for (AsciiChunk& chunk : chunks) {
+            if (chunk.failed) {
+                return fail("Invalid number in PLY body");
+            }
+            chunk.indexBase = indexTotal;
+            indexTotal += chunk.indices.size();
+        }
+        mesh.indices.resize(indexTotal);
+        runParallel(chunkCount, [&](size_t i) {
+            std::copy(chunks[i].indices.begin(), chunks[i].indices.end(), mesh.indices.begin() + chunks[i].indexBase);
+        });
+    }
+
+    mesh.hasNormals = present[NORMAL_X] && present[NORMAL_Y] && present[NORMAL_Z];
+    mesh.hasTexCoords = present[TEXCOORD_U] && present[TEXCOORD_V];
+    if (!mesh.indices.empty()) {
+        mesh.submeshes.push_back({0, static_cast<uint32_t>(mesh.indices.size()), NO_MATERIAL});
+    }
+    return true;
+}
@@ -0,0 +1,272 @@
+#include <TangentGenerator.h>
+#include "ParallelRanges.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+constexpr uint8_t ORIENT_PRESERVING = 1;  ///< The texture space of the triangle is not mirrored
+constexpr uint8_t GROUP_WITH_ANY = 2;     ///< Degenerate texture space, the triangle joins its neighbours' groups
+constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+inline bool notZero(float value) {
+    return std::fabs(value) > FLT_MIN;
+}
+
+inline bool notZero(const Normal& v) {
+    return notZero(v.x) || notZero(v.y) || notZero(v.z);
+}
+
+inline Normal subtract(const Vertex& a, const Vertex& b) {
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+inline Normal scale(const Normal& v, float s) {
+    return {v.x * s, v.y * s, v.z * s};
+}
+
+inline Normal add(const Normal& a, const Normal& b) {
+    return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+inline float dot(const Normal& a, const Normal& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline float length(const Normal& v) {
+    return std::sqrt(dot(v, v));
+}
+
+/**
+ * @brief v without its component along the unit vector n, normalized unless it is zero
+ */
+inline Normal projectToPlane(const Normal& v, const Normal& n) {
+    const Normal projected = add(v, scale(n, -dot(n, v)));
+    return notZero(projected) ? scale(projected, 1.0f / length(projected)) : projected;
+}
+
+inline bool equal(const Tangent& a, const Tangent& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+}
+
+} // namespace
+
+bool TangentGenerator::generate(IndexedMesh& mesh, unsigned int threadCount) {
+    const size_t vertexCount = mesh.vertexCount();
+    const size_t triangleCount = mesh.indices.size() / 3;
+    if (!mesh.hasNormals || !mesh.hasTexCoords || triangleCount == 0) {
+        return false;
+    }
+    const unsigned int threads = resolveThreadCount(threadCount);
+    const uint32_t* indices = mesh.indices.data();
+
+    // Direction of increasing u on every triangle, normalized and flipped on mirrored ones
+    std::vector<Normal> directions(triangleCount);
+    std::vector<uint8_t> flags(triangleCount);
+    parallelRanges(triangleCount, threads, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            const MeshVertex v0 = mesh.vertex(indices[t * 3]);
+            const MeshVertex v1 = mesh.vertex(indices[t * 3 + 1]);
+            const MeshVertex v2 = mesh.vertex(indices[t * 3 + 2]);
+            const Normal d1 = subtract(v1.position, v0.position);
+            const Normal d2 = subtract(v2.position, v0.position);
+            const float t21x = v1.texCoord.u - v0.texCoord.u;
+            const float t21y = v1.texCoord.v - v0.texCoord.v;
+            const float t31x = v2.texCoord.u - v0.texCoord.u;
+            const float t31y = v2.texCoord.v - v0.texCoord.v;
+            const float signedArea = t21x * t31y - t21y * t31x;
+            const Normal os = add(scale(d1, t31y), scale(d2, -t21y));
+            const Normal ot = add(scale(d1, -t31x), scale(d2, t21x));
+
+            uint8_t flag = GROUP_WITH_ANY | (signedArea > 0.0f ? ORIENT_PRESERVING : 0);
+            Normal direction = {0.0f, 0.0f, 0.0f};
+            if (notZero(signedArea)) {
+                const float lengthS = length(os);
+                const float lengthT = length(ot);
+                if (notZero(lengthS)) {
+                    direction = scale(os, ((flag & ORIENT_PRESERVING) ? 1.0f : -1.0f) / lengthS);
+                }
+                if (notZero(lengthS / std::fabs(signedArea)) && notZero(lengthT / std::fabs(signedArea))) {
+                    flag &= static_cast<uint8_t>(~GROUP_WITH_ANY);
+                }
+            }
+            directions[t] = direction;
+            flags[t] = flag;
+        }
+    });
+
+    // Corners grouped by vertex, in corner order
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        ++offsets[indices[i] + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<uint32_t> corners(triangleCount * 3);
+    {
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; ++i) {
+            corners[cursor[indices[i]]++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    // Edge neighbours in MikkTSpace are consistently wound: an edge a -> b of one triangle
+    // meets b -> a of the other
+    auto sharesEdge = [&](uint32_t cornerA, uint32_t cornerB) {
+        const uint32_t a = cornerA / 3 * 3;
+        const uint32_t b = cornerB / 3 * 3;
+        const uint32_t nextA = indices[a + (cornerA + 1) % 3];
+        const uint32_t prevA = indices[a + (cornerA + 2) % 3];
+        const uint32_t nextB = indices[b + (cornerB + 1) % 3];
+        const uint32_t prevB = indices[b + (cornerB + 2) % 3];
+        return nextA == prevB || prevA == nextB;
+    };
+
+    // Triangles with a degenerate texture space take the mirroring of their lowest numbered
+    // regular edge neighbour, which is the group MikkTSpace's fan walk reaches them from first
+    std::vector<uint8_t> orientations(triangleCount);
+    parallelRanges(triangleCount, threads, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            orientations[t] = flags[t] & ORIENT_PRESERVING;
+            if (!(flags[t] & GROUP_WITH_ANY)) {
+                continue;
+            }
+            uint32_t neighbour = INVALID_INDEX;
+            for (uint32_t k = 0; k < 3; ++k) {
+                const uint32_t corner = static_cast<uint32_t>(t * 3 + k);
+                const uint32_t vertex = indices[corner];
+                for (uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; ++i) {
+                    const uint32_t other = corners[i] / 3;
+                    if (other != t && other < neighbour && !(flags[other] & GROUP_WITH_ANY) &&
+                        sharesEdge(corner, corners[i])) {
+                        neighbour = other;
+                    }
+                }
+            }
+            if (neighbour != INVALID_INDEX) {
+                orientations[t] = flags[neighbour] & ORIENT_PRESERVING;
+            }
+        }
+    });
+
+    // Every vertex splits its corners into groups (union-find over shared edges between
+    // triangles of the same mirroring) and sums each group. cornerIds holds a number local to
+    // the vertex until the prefix sum below
+    std::vector<Tangent> cornerTangents(triangleCount * 3);
+    std::vector<uint32_t> cornerIds(triangleCount * 3);
+    std::vector<uint32_t> extraCounts(vertexCount + 1, 0);
+    parallelRanges(vertexCount, threads, [&](size_t begin, size_t end) {
+        std::vector<uint32_t> parent;
+        std::vector<Normal> sums;
+        std::vector<uint8_t> seeded;
+        auto find = [&](uint32_t i) {
+            while (parent[i] != i) {
+                parent[i] = parent[parent[i]];
+                i = parent[i];
+            }
+            return i;
+        };
+        for (size_t v = begin; v < end; ++v) {
+            const uint32_t* list = corners.data() + offsets[v];
+            const uint32_t count = offsets[v + 1] - offsets[v];
+            if (count == 0) {
+                continue;
+            }
+            parent.resize(count);
+            std::iota(parent.begin(), parent.end(), 0u);
+            for (uint32_t i = 0; i < count; ++i) {
+                for (uint32_t j = i + 1; j < count; ++j) {
+                    if (orientations[list[i] / 3] == orientations[list[j] / 3] && sharesEdge(list[i], list[j])) {
+                        parent[find(j)] = find(i);
+                    }
+                }
+            }
+
+            // Directions projected into the plane of the vertex normal, weighted by the corner angle in that plane
+            const MeshVertex vertex = mesh.vertex(v);
+            const Normal& n = vertex.normal;
+            sums.assign(count, {0.0f, 0.0f, 0.0f});
+            seeded.assign(count, 0);
+            for (uint32_t i = 0; i < count; ++i) {
+                const uint32_t corner = list[i];
+                const uint32_t t = corner / 3;
+                const Vertex next = mesh.vertex(indices[t * 3 + (corner + 1) % 3]).position;
+                const Vertex prev = mesh.vertex(indices[t * 3 + (corner + 2) % 3]).position;
+                const Normal e1 = projectToPlane(subtract(prev, vertex.position), n);
+                const Normal e2 = projectToPlane(subtract(next, vertex.position), n);
+                const float angle = std::acos(std::clamp(dot(e1, e2), -1.0f, 1.0f));
+                const uint32_t root = find(i);
+                sums[root] = add(sums[root], scale(projectToPlane(directions[t], n), angle));
+                seeded[root] |= !(flags[t] & GROUP_WITH_ANY);
+            }
+
+            uint32_t unique = 0;
+            for (uint32_t i = 0; i < count; ++i) {
+                const uint32_t corner = list[i];
+                const uint32_t root = find(i);
+                Normal direction = {1.0f, 0.0f, 0.0f};
+                if (seeded[root]) {
+                    direction = notZero(sums[root]) ? scale(sums[root], 1.0f / length(sums[root])) : sums[root];
+                }
+                const Tangent tangent = {direction.x, direction.y, direction.z,
+                                         orientations[corner / 3] ? 1.0f : -1.0f};
+                cornerTangents[corner] = tangent;
+                uint32_t id = unique;
+                for (uint32_t j = 0; j < i; ++j) {
+                    if (equal(cornerTangents[list[j]], tangent)) {
+                        id = cornerIds[list[j]];
+                        break;
+                    }
+                }
+                if (id == unique) {
+                    ++unique;
+                }
+                cornerIds[corner] = id;
+            }
+            extraCounts[v + 1] = unique - 1;
+        }
+    });
+    for (size_t v = 0; v < vertexCount; ++v) {
+        extraCounts[v + 1] += extraCounts[v];
+    }
+    const size_t extraTotal = extraCounts[vertexCount];
+
+    // The first tangent of a vertex stays on it, the others go to copies appended after the vertices
+    std::vector<Tangent> tangents(vertexCount + extraTotal, Tangent{1.0f, 0.0f, 0.0f, 1.0f});
+    std::vector<uint32_t> sources(extraTotal);
+    parallelRanges(vertexCount, threads, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                const uint32_t corner = corners[i];
+                const uint32_t local = cornerIds[corner];
+                uint32_t id = static_cast<uint32_t>(v);
+                if (local > 0) {
+                    id = static_cast<uint32_t>(vertexCount + extraCounts[v] + local - 1);
+                    sources[id - vertexCount] = static_cast<uint32_t>(v);
+                }
+                mesh.indices[corner] = id;
+                tangents[id] = cornerTangents[corner];
+            }
+        }
+    });
+    if (!mesh.vertices.empty()) {
+        mesh.vertices.resize(vertexCount + extraTotal);
+        for (size_t i = 0; i < extraTotal; ++i) {
+            mesh.vertices[vertexCount + i] = mesh.vertices[sources[i]];
+        }
+    } else if (extraTotal > 0) {
+        mesh.streams.unpad();
+        for (size_t i = 0; i < extraTotal; ++i) {
+            const MeshVertex copy = mesh.vertex(sources[i]);
+            mesh.streams.push_back(copy.position, copy.texCoord, copy.normal);
+        }
+        mesh.streams.pad();
+    }
+    mesh.tangents = std::move(tangents);
+    return true;
+}
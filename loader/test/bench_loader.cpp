@@ -0,0 +1,532 @@
+/**
+ * @file bench_loader.cpp
+ * @author zhywyt (zhywyt@yeah.net)
+ * @brief Loader benchmark on generated OBJ/MTL files of increasing size
+ * @details Generates synthetic OBJ files (10K to 10M faces) in several face formats, loads each
+ * one with ModelLoader and reports throughput (MB/s, triangles/s), peak RSS and heap
+ * allocations per face. Results can be written as JSON to track regressions over time.
+ * 
+ * Usage: loader_bench [--faces 10000,100000,1000000] [--formats v,vt,vn,vtvn,quads,ngons,materials]
+ *                     [--threads N] [--repeat N] [--indexed] [--single-block] [--reuse]
+ *                     [--dir DIR] [--keep] [--json FILE]
+ * 
+ * --reuse loads everything with one ModelLoader, whose parse arenas are kept between loads, and
+ * --single-block sets LoadOptions::singleBlockMesh for the indexed output.
+ * 
+ * Build in Release for meaningful numbers.
+ * @version 0.2
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include <ModelLoader.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <initializer_list>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#include <malloc.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+// Every heap allocation of the process goes through these, so the benchmark can count the
+// allocations a load makes
+
+namespace {
+std::atomic<size_t> allocationCount{0};
+std::atomic<size_t> allocatedBytes{0};
+
+void* allocate(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size != 0 ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    const std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+#if defined(_WIN32)
+    void* pointer = _aligned_malloc(size != 0 ? size : 1, align);
+#else
+    void* pointer = nullptr;
+    if (posix_memalign(&pointer, align, size != 0 ? size : 1) != 0) {
+        pointer = nullptr;
+    }
+#endif
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void releaseAligned(void* pointer) noexcept {
+#if defined(_WIN32)
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+} // namespace
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { releaseAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { releaseAligned(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { releaseAligned(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { releaseAligned(pointer); }
+
+namespace {
+
+/**
+ * @brief Face formats of the generated files
+ */
+struct FormatSpec {
+    const char* name;
+    bool texCoords;                       ///< Faces reference vt
+    bool normals;                         ///< Faces reference vn
+    int corners;                          ///< Corners per face: 3, 4 or 6
+    int materials;                        ///< Materials switched between with usemtl, 0 for none
+};
+
+const FormatSpec FORMATS[] = {
+    {"v", false, false, 3, 0},            // f 1 2 3
+    {"vt", true, false, 3, 0},            // f 1/1 2/2 3/3
+    {"vn", false, true, 3, 0},            // f 1//1 2//2 3//3
+    {"vtvn", true, true, 3, 0},           // f 1/1/1 2/2/2 3/3/3
+    {"quads", true, true, 4, 0},          // f with 4 corners
+    {"ngons", true, true, 6, 0},          // f with 6 corners (two grid cells)
+    {"materials", true, true, 3, 256},    // usemtl every 64 faces, 256 materials in the MTL
+};
+
+/**
+ * @brief Faces between two usemtl lines of the materials format
+ */
+constexpr size_t FACES_PER_MATERIAL = 64;
+
+/**
+ * @brief Buffered writer for large text files
+ */
+class TextWriter {
+public:
+    explicit TextWriter(const std::string& filename) : file(std::fopen(filename.c_str(), "wb")) {
+        buffer.reserve(CAPACITY + 256);
+    }
+
+    ~TextWriter() {
+        flush();
+        if (file != nullptr) {
+            std::fclose(file);
+        }
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    TextWriter& operator<<(const char* text) {
+        buffer += text;
+        return check();
+    }
+
+    TextWriter& operator<<(char c) {
+        buffer += c;
+        return check();
+    }
+
+    TextWriter& operator<<(size_t value) {
+        char digits[24];
+        const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, result.ptr);
+        return check();
+    }
+
+    TextWriter& operator<<(float value) {
+        char digits[32];
+        const int length = std::snprintf(digits, sizeof(digits), "%.6f", value);
+        buffer.append(digits, static_cast<size_t>(length));
+        return check();
+    }
+
+private:
+    static constexpr size_t CAPACITY = size_t(1) << 20;
+    std::FILE* file;
+    std::string buffer;
+
+    TextWriter& check() {
+        if (buffer.size() >= CAPACITY) {
+            flush();
+        }
+        return *this;
+    }
+
+    void flush() {
+        if (file != nullptr && !buffer.empty()) {
+            std::fwrite(buffer.data(), 1, buffer.size(), file);
+        }
+        buffer.clear();
+    }
+};
+
+/**
+ * @brief Write a grid mesh with a number of faces in a format, and its MTL for the materials format
+ * @return Bytes written (OBJ plus MTL)
+ */
+size_t generateObj(const std::string& filename, const FormatSpec& format, size_t faceCount) {
+    // Triangles take half a cell, quads a cell, 6-gons two cells
+    const size_t cellsPerFace = format.corners == 6 ? 2 : 1;
+    const size_t facesPerCell = format.corners == 3 ? 2 : 1;
+    const size_t cells = (faceCount * cellsPerFace + facesPerCell - 1) / facesPerCell;
+    size_t width = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(cells))));
+    width += width % cellsPerFace;        // 6-gons never wrap around a row
+    const size_t height = (cells + width - 1) / width;
+    const size_t columns = width + 1;
+
+    const std::string mtlName = std::filesystem::path(filename).stem().string() + ".mtl";
+    if (format.materials > 0) {
+        TextWriter mtl((std::filesystem::path(filename).parent_path() / mtlName).string());
+        for (int m = 0; m < format.materials; ++m) {
+            const float shade = static_cast<float>(m) / static_cast<float>(format.materials);
+            mtl << "newmtl material_" << static_cast<size_t>(m) << "\nKa 0.2 0.2 0.2\nKd " << shade << ' ' << 0.5f << ' '
+                << 1.0f - shade << "\nKs 0.1 0.1 0.1\nNs 32\n\n";
+        }
+    }
+
+    {
+        TextWriter obj(filename);
+        if (!obj.isOpen()) {
+            return 0;
+        }
+        obj << "# synthetic " << format.name << " grid, " << faceCount << " faces\n";
+        if (format.materials > 0) {
+            obj << "mtllib " << mtlName.c_str() << '\n';
+        }
+        obj << "o grid\n";
+        for (size_t y = 0; y <= height; ++y) {
+            for (size_t x = 0; x <= width; ++x) {
+                const float fx = static_cast<float>(x) / static_cast<float>(width);
+                const float fy = static_cast<float>(y) / static_cast<float>(height);
+                obj << "v " << fx << ' ' << 0.1f * std::sin(fx * 20.0f) * std::cos(fy * 20.0f) << ' ' << fy << '\n';
+                if (format.texCoords) {
+                    obj << "vt " << fx << ' ' << fy << '\n';
+                }
+                if (format.normals) {
+                    obj << "vn " << 0.0f << ' ' << 1.0f << ' ' << 0.0f << '\n';
+                }
+            }
+        }
+
+        auto corner = [&](size_t x, size_t y) {
+            const size_t index = y * columns + x + 1;
+            obj << ' ' << index;
+            if (format.texCoords || format.normals) {
+                obj << '/';
+                if (format.texCoords) {
+                    obj << index;
+                }
+                if (format.normals) {
+                    obj << '/' << index;
+                }
+            }
+        };
+        auto face = [&](std::initializer_list<std::array<size_t, 2>> cells) {
+            obj << 'f';
+            for (const auto& cell : cells) {
+                corner(cell[0], cell[1]);
+            }
+            obj << '\n';
+        };
+        size_t written = 0;
+        for (size_t y = 0; y < height && written < faceCount; ++y) {
+            for (size_t x = 0; x < width && written < faceCount; x += cellsPerFace) {
+                if (format.materials > 0 && written % FACES_PER_MATERIAL == 0) {
+                    obj << "usemtl material_" << (written / FACES_PER_MATERIAL) % static_cast<size_t>(format.materials) << '\n';
+                }
+                if (format.corners == 3) {
+                    face({{x, y}, {x + 1, y}, {x + 1, y + 1}});
+                    if (++written < faceCount) {
+                        face({{x, y}, {x + 1, y + 1}, {x, y + 1}});
+                        ++written;
+                    }
+                } else if (format.corners == 4) {
+                    face({{x, y}, {x + 1, y}, {x + 1, y + 1}, {x, y + 1}});
+                    ++written;
+                } else {
+                    face({{x, y}, {x + 1, y}, {x + 2, y}, {x + 2, y + 1}, {x + 1, y + 1}, {x, y + 1}});
+                    ++written;
+                }
+            }
+        }
+    }
+
+    std::error_code error;
+    size_t bytes = std::filesystem::file_size(filename, error);
+    if (format.materials > 0) {
+        bytes += std::filesystem::file_size(std::filesystem::path(filename).parent_path() / mtlName, error);
+    }
+    return bytes;
+}
+
+/**
+ * @brief Resident set size in KB
+ */
+size_t currentRssKB() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    return GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) ? pmc.WorkingSetSize / 1024 : 0;
+#elif defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    long size = 0, rss = 0;
+    statm >> size >> rss;
+    return static_cast<size_t>(rss) * static_cast<size_t>(sysconf(_SC_PAGESIZE) / 1024);
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Start a new peak RSS measurement, where the platform allows resetting the peak
+ * @details Linux resets the high-water mark through /proc/self/clear_refs; elsewhere the peak
+ * covers the whole process, so only runs that grow beyond earlier ones are measured exactly.
+ */
+void resetPeakRss() {
+#if defined(__linux__)
+    std::ofstream clear("/proc/self/clear_refs");
+    clear << "5";
+#endif
+}
+
+/**
+ * @brief Peak resident set size in KB since resetPeakRss
+ */
+size_t peakRssKB() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    return GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) ? pmc.PeakWorkingSetSize / 1024 : 0;
+#elif defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return static_cast<size_t>(std::strtoull(line.c_str() + 6, nullptr, 10));
+        }
+    }
+    return 0;
+#elif defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) / 1024;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Measurements of one file
+ */
+struct BenchResult {
+    std::string format;
+    size_t faces = 0;
+    size_t triangles = 0;
+    size_t bytes = 0;
+    double seconds = 0.0;                 ///< Fastest of the repeats
+    size_t peakRssKB = 0;                 ///< Peak RSS of the loads above the RSS before them
+    size_t allocations = 0;               ///< Heap allocations of one load
+    size_t allocatedBytes = 0;            ///< Heap bytes requested by one load
+};
+
+std::vector<size_t> parseSizes(const std::string& list) {
+    std::vector<size_t> sizes;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        sizes.push_back(static_cast<size_t>(std::strtoull(item.c_str(), nullptr, 10)));
+    }
+    return sizes;
+}
+
+std::vector<const FormatSpec*> parseFormats(const std::string& list) {
+    std::vector<const FormatSpec*> formats;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        for (const FormatSpec& format : FORMATS) {
+            if (item == format.name) {
+                formats.push_back(&format);
+            }
+        }
+    }
+    return formats;
+}
+
+void writeJson(const std::string& filename, const std::vector<BenchResult>& results, unsigned int threads,
+               bool indexed) {
+    std::ofstream out(filename);
+    out << "{\n  \"timestamp\": " << static_cast<long long>(std::time(nullptr)) << ",\n  \"threads\": " << threads
+        << ",\n  \"output\": \"" << (indexed ? "indexed" : "triangles") << "\",\n  \"results\": [\n";
+    out << std::fixed;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        const double megabytes = static_cast<double>(r.bytes) / (1024.0 * 1024.0);
+        out << "    {\"format\": \"" << r.format << "\", \"faces\": " << r.faces << ", \"triangles\": " << r.triangles
+            << ", \"bytes\": " << r.bytes << ", \"seconds\": " << std::setprecision(6) << r.seconds
+            << ", \"mb_per_s\": " << std::setprecision(2) << megabytes / r.seconds
+            << ", \"triangles_per_s\": " << std::setprecision(0) << static_cast<double>(r.triangles) / r.seconds
+            << ", \"peak_rss_kb\": " << r.peakRssKB << ", \"allocations\": " << r.allocations
+            << ", \"allocations_per_face\": " << std::setprecision(4)
+            << static_cast<double>(r.allocations) / static_cast<double>(std::max<size_t>(r.faces, 1))
+            << ", \"allocated_bytes\": " << r.allocatedBytes << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = {10000, 100000, 1000000};
+    std::vector<const FormatSpec*> formats;
+    for (const FormatSpec& format : FORMATS) {
+        formats.push_back(&format);
+    }
+    unsigned int threads = 0;
+    int repeat = 3;
+    bool indexed = false;
+    bool singleBlock = false;
+    bool reuse = false;
+    bool keep = false;
+    std::string directory = (std::filesystem::temp_directory_path() / "loader_bench").string();
+    std::string jsonFile;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--faces" && hasValue) {
+            sizes = parseSizes(argv[++i]);
+        } else if (arg == "--formats" && hasValue) {
+            formats = parseFormats(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            threads = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--repeat" && hasValue) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--dir" && hasValue) {
+            directory = argv[++i];
+        } else if (arg == "--json" && hasValue) {
+            jsonFile = argv[++i];
+        } else if (arg == "--indexed") {
+            indexed = true;
+        } else if (arg == "--single-block") {
+            singleBlock = true;
+        } else if (arg == "--reuse") {
+            reuse = true;
+        } else if (arg == "--keep") {
+            keep = true;
+        } else {
+            std::cerr << "用法: " << argv[0] << " [--faces 10000,100000,1000000] [--formats "
+                      << "v,vt,vn,vtvn,quads,ngons,materials] [--threads N] [--repeat N] [--indexed] "
+                      << "[--single-block] [--reuse] [--dir DIR] [--keep] [--json FILE]" << std::endl;
+            return 1;
+        }
+    }
+    std::filesystem::create_directories(directory);
+
+    LoadOptions options;
+    options.triangles = !indexed;
+    options.indexedMesh = indexed;
+    options.singleBlockMesh = singleBlock;
+    ModelLoader sharedLoader;
+    sharedLoader.setThreadCount(threads);
+
+    std::vector<BenchResult> results;
+    // Column names in ASCII so that setw lines them up
+    std::cout << std::left << std::setw(10) << "format" << std::right << std::setw(10) << "faces" << std::setw(12)
+              << "triangles" << std::setw(10) << "MB" << std::setw(10) << "ms" << std::setw(10) << "MB/s" << std::setw(12)
+              << "Mtri/s" << std::setw(12) << "peak MB" << std::setw(12) << "alloc/face" << std::endl;
+    for (size_t faces : sizes) {
+        for (const FormatSpec* format : formats) {
+            const std::string filename =
+                (std::filesystem::path(directory) / (std::string(format->name) + "_" + std::to_string(faces) + ".obj")).string();
+            BenchResult result;
+            result.format = format->name;
+            result.faces = faces;
+            result.bytes = generateObj(filename, *format, faces);
+            if (result.bytes == 0) {
+                std::cerr << "无法写入 " << filename << std::endl;
+                return 1;
+            }
+
+            // Without --reuse every repeat uses a fresh loader, so each load allocates its output from scratch
+            resetPeakRss();
+            const size_t rssBefore = currentRssKB();
+            for (int run = 0; run < repeat; ++run) {
+                ModelLoader freshLoader;
+                freshLoader.setThreadCount(threads);
+                ModelLoader& loader = reuse ? sharedLoader : freshLoader;
+                const size_t allocationsBefore = allocationCount.load();
+                const size_t bytesBefore = allocatedBytes.load();
+                const auto start = std::chrono::steady_clock::now();
+                const bool loaded = loader.loadModel(filename, options);
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (!loaded) {
+                    std::cerr << "加载失败: " << filename << std::endl;
+                    return 1;
+                }
+                result.allocations = allocationCount.load() - allocationsBefore;
+                result.allocatedBytes = allocatedBytes.load() - bytesBefore;
+                result.triangles = indexed ? loader.getIndexedMeshView().indexCount / 3 : loader.getTriangles().size();
+                result.seconds = run == 0 ? seconds : std::min(result.seconds, seconds);
+            }
+            const size_t peak = peakRssKB();
+            result.peakRssKB = peak > rssBefore ? peak - rssBefore : 0;
+            if (!keep) {
+                std::error_code error;
+                std::filesystem::remove(filename, error);
+                std::filesystem::remove(std::filesystem::path(filename).replace_extension(".mtl"), error);
+            }
+
+            const double megabytes = static_cast<double>(result.bytes) / (1024.0 * 1024.0);
+            std::cout << std::left << std::setw(10) << result.format << std::right << std::setw(10) << result.faces
+                      << std::setw(12) << result.triangles << std::fixed << std::setprecision(1) << std::setw(10)
+                      << megabytes << std::setw(10) << result.seconds * 1000.0 << std::setw(10) << megabytes / result.seconds
+                      << std::setprecision(2) << std::setw(12) << result.triangles / result.seconds / 1e6
+                      << std::setprecision(1) << std::setw(12) << result.peakRssKB / 1024.0 << std::setprecision(5)
+                      << std::setw(12) << static_cast<double>(result.allocations) / static_cast<double>(faces)
+                      << std::endl;
+            results.push_back(result);
+        }
+    }
+
+    if (!jsonFile.empty()) {
+        writeJson(jsonFile, results, threads, indexed);
+        std::cout << "结果已写入 " << jsonFile << std::endl;
+    }
+    return 0;
+}
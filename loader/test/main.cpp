@@ -14,7 +14,24 @@
 
 #include <iostream>
 #include <ModelLoader.h>
+#include <MeshSimplifier.h>
+#include <MeshletBuilder.h>
+#include <TangentGenerator.h>
+#include <GltfLoader.h>
+#include <PlyLoader.h>
+#include <FileWatcher.h>
+#include <MaterialCache.h>
+#include "NumberParsing.h"
 #include <iomanip>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
 
 #if defined(_WIN32)
 #include <windows.h>
@@ -121,17 +138,17 @@ void printSampleData(const ModelLoader& loader) {
         }
         
         // Show material information for the first triangle
-        if (t.hasMaterial()) {
-            std::cout << "第一个三角形材质: " << t.materialName << std::endl;
-            std::cout << "  环境光: (" << t.material->ambient[0] << ", " << t.material->ambient[1] << ", " << t.material->ambient[2] << ")" << std::endl;
-            std::cout << "  漫反射: (" << t.material->diffuse[0] << ", " << t.material->diffuse[1] << ", " << t.material->diffuse[2] << ")" << std::endl;
-            std::cout << "  镜面反射: (" << t.material->specular[0] << ", " << t.material->specular[1] << ", " << t.material->specular[2] << ")" << std::endl;
-            std::cout << "  光泽度: " << t.material->shininess << std::endl;
-            if (t.hasDiffuseTexture()) {
-                std::cout << "  漫反射纹理: " << t.getDiffuseTexture() << std::endl;
+        if (const Material* material = t.getMaterial(materials)) {
+            std::cout << "第一个三角形材质: " << material->name << std::endl;
+            std::cout << "  环境光: (" << material->ambient[0] << ", " << material->ambient[1] << ", " << material->ambient[2] << ")" << std::endl;
+            std::cout << "  漫反射: (" << material->diffuse[0] << ", " << material->diffuse[1] << ", " << material->diffuse[2] << ")" << std::endl;
+            std::cout << "  镜面反射: (" << material->specular[0] << ", " << material->specular[1] << ", " << material->specular[2] << ")" << std::endl;
+            std::cout << "  光泽度: " << material->shininess << std::endl;
+            if (t.hasDiffuseTexture(materials)) {
+                std::cout << "  漫反射纹理: " << t.getDiffuseTexture(materials) << std::endl;
             }
-        } else if (!t.materialName.empty()) {
-            std::cout << "第一个三角形材质: " << t.materialName << " (未找到)" << std::endl;
+        } else if (t.materialId != NO_MATERIAL) {
+            std::cout << "第一个三角形材质: " << materials[t.materialId].name << " (未找到)" << std::endl;
         }
     }
     
@@ -185,10 +202,12 @@ bool testEnhancedFeatures(const std::string& filename) {
         const auto& materials = loader.getMaterials();
         const auto& triangles = loader.getTriangles();
         
-        if (!materials.empty()) {
+        if (mCount > 0) {
             std::cout << "\n--- 材质详细信息 ---" << std::endl;
-            for (const auto& matPair : materials) {
-                const auto& mat = matPair.second;
+            for (const auto& mat : materials) {
+                if (!mat.defined) {
+                    continue;
+                }
                 std::cout << "材质名称: " << mat.name << std::endl;
                 std::cout << "  环境光: (" << mat.ambient[0] << ", " << mat.ambient[1] << ", " << mat.ambient[2] << ")" << std::endl;
                 std::cout << "  漫反射: (" << mat.diffuse[0] << ", " << mat.diffuse[1] << ", " << mat.diffuse[2] << ")" << std::endl;
@@ -206,9 +225,9 @@ bool testEnhancedFeatures(const std::string& filename) {
         int trianglesWithMaterials = 0;
         int trianglesWithTextures = 0;
         for (const auto& triangle : triangles) {
-            if (triangle.hasMaterial()) {
+            if (triangle.hasMaterial(materials)) {
                 trianglesWithMaterials++;
-                if (triangle.hasDiffuseTexture()) {
+                if (triangle.hasDiffuseTexture(materials)) {
                     trianglesWithTextures++;
                 }
             }
@@ -225,6 +244,1200 @@ bool testEnhancedFeatures(const std::string& filename) {
     return result;
 }
 
+/**
+ * @brief Test the indexed mesh output against the per-triangle output
+ * @param filename Path to OBJ file to test
+ * @return true if both outputs describe the same triangles
+ */
+bool testIndexedMesh(const std::string& filename) {
+    ModelLoader loader;
+    LoadOptions options;
+    options.indexedMesh = true;
+    
+    std::cout << "\n=== 索引网格测试 (" << filename << ") ===" << std::endl;
+    if (!loader.loadModel(filename, options)) {
+        std::cout << "加载结果: 失败" << std::endl;
+        return false;
+    }
+    
+    const auto& mesh = loader.getIndexedMesh();
+    const auto& triangles = loader.getTriangles();
+    std::cout << "唯一顶点数: " << mesh.vertices.size() << std::endl;
+    std::cout << "索引数: " << mesh.indices.size() << std::endl;
+    std::cout << "子网格数: " << mesh.submeshes.size() << std::endl;
+    
+    bool same = mesh.indices.size() == triangles.size() * 3;
+    for (size_t i = 0; same && i < triangles.size(); ++i) {
+        const Vertex* corners[3] = {&triangles[i].v0, &triangles[i].v1, &triangles[i].v2};
+        for (int k = 0; k < 3; ++k) {
+            const Vertex& position = mesh.vertices[mesh.indices[i * 3 + k]].position;
+            same = same && position.x == corners[k]->x && position.y == corners[k]->y && position.z == corners[k]->z;
+        }
+    }
+    
+    size_t covered = 0;
+    for (const auto& submesh : mesh.submeshes) {
+        for (uint32_t i = submesh.firstIndex; same && i < submesh.firstIndex + submesh.indexCount; i += 3) {
+            same = triangles[i / 3].materialId == submesh.material;
+        }
+        covered += submesh.indexCount;
+    }
+    same = same && covered == mesh.indices.size();
+    
+    // The stream layout holds the same vertices in aligned, padded per-component arrays
+    ModelLoader streamLoader;
+    options.triangles = false;
+    options.vertexLayout = VertexLayout::Streams;
+    streamLoader.loadModel(filename, options);
+    const auto& streams = streamLoader.getIndexedMesh().streams;
+    same = same && streams.count == mesh.vertices.size() && streams.positionX.size() % VertexStreams::PADDING == 0 &&
+           reinterpret_cast<uintptr_t>(streams.positionX.data()) % VertexStreams::ALIGNMENT == 0;
+    for (size_t i = 0; same && i < streams.count; ++i) {
+        const MeshVertex& vertex = mesh.vertices[i];
+        same = streams.positionX[i] == vertex.position.x && streams.positionY[i] == vertex.position.y &&
+               streams.positionZ[i] == vertex.position.z && streams.normalX[i] == vertex.normal.x &&
+               streams.normalY[i] == vertex.normal.y && streams.normalZ[i] == vertex.normal.z &&
+               streams.texCoordU[i] == vertex.texCoord.u && streams.texCoordV[i] == vertex.texCoord.v;
+    }
+    
+    std::cout << "✓ 索引网格与三角形一致: " << (same ? "通过" : "失败") << std::endl;
+    return same;
+}
+
+/**
+ * @brief Test that MeshOptimizer only reorders triangles within their submesh
+ * @param filename Path to OBJ file to test
+ * @return true if the optimized mesh draws the same triangles with no worse ACMR
+ */
+bool testMeshOptimizer(const std::string& filename) {
+    ModelLoader plainLoader;
+    ModelLoader optimizedLoader;
+    LoadOptions options;
+    options.triangles = false;
+    options.indexedMesh = true;
+    
+    std::cout << "\n=== 网格优化测试 (" << filename << ") ===" << std::endl;
+    if (!plainLoader.loadModel(filename, options)) {
+        std::cout << "加载结果: 失败" << std::endl;
+        return false;
+    }
+    options.optimizeMesh = true;
+    optimizedLoader.loadModel(filename, options);
+    
+    const IndexedMesh& plain = plainLoader.getIndexedMesh();
+    const IndexedMesh& optimized = optimizedLoader.getIndexedMesh();
+    const MeshOptimizeStats& stats = optimizedLoader.getOptimizeStats();
+    std::cout << "ACMR: " << stats.acmrBefore << " -> " << stats.acmrAfter << std::endl;
+    std::cout << "ATVR: " << stats.atvrBefore << " -> " << stats.atvrAfter << std::endl;
+    
+    // Each submesh must hold the same triangles, compared by corner positions
+    auto submeshTriangles = [](const IndexedMesh& mesh, const Submesh& submesh) {
+        std::vector<std::array<float, 9>> result;
+        for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; i += 3) {
+            std::array<float, 9> corners;
+            for (int k = 0; k < 3; ++k) {
+                const Vertex& position = mesh.vertices[mesh.indices[i + k]].position;
+                corners[k * 3] = position.x;
+                corners[k * 3 + 1] = position.y;
+                corners[k * 3 + 2] = position.z;
+            }
+            result.push_back(corners);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+    bool same = optimized.vertices.size() == plain.vertices.size() &&
+                optimized.submeshes.size() == plain.submeshes.size() && stats.acmrAfter <= stats.acmrBefore;
+    for (size_t i = 0; same && i < plain.submeshes.size(); ++i) {
+        same = optimized.submeshes[i].firstIndex == plain.submeshes[i].firstIndex &&
+               optimized.submeshes[i].indexCount == plain.submeshes[i].indexCount &&
+               submeshTriangles(optimized, optimized.submeshes[i]) == submeshTriangles(plain, plain.submeshes[i]);
+    }
+    
+    std::cout << "✓ 优化后三角形不变: " << (same ? "通过" : "失败") << std::endl;
+    return same;
+}
+
+/**
+ * @brief A size x size quad height field over the unit square, with texture coordinates
+ */
+IndexedMesh makeHeightField(uint32_t size) {
+    IndexedMesh mesh;
+    mesh.hasTexCoords = true;
+    for (uint32_t y = 0; y <= size; ++y) {
+        for (uint32_t x = 0; x <= size; ++x) {
+            float u = static_cast<float>(x) / size;
+            float v = static_cast<float>(y) / size;
+            MeshVertex vertex = {};
+            vertex.position = {u, v, 0.1f * std::sin(u * 3.0f) * std::cos(v * 2.0f)};
+            vertex.texCoord = {u, v};
+            mesh.vertices.push_back(vertex);
+        }
+    }
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            uint32_t v0 = y * (size + 1) + x;
+            uint32_t v1 = v0 + 1;
+            uint32_t v2 = v0 + size + 1;
+            uint32_t v3 = v2 + 1;
+            mesh.indices.insert(mesh.indices.end(), {v0, v1, v3, v0, v3, v2});
+        }
+    }
+    mesh.submeshes.push_back({0, static_cast<uint32_t>(mesh.indices.size()), NO_MATERIAL});
+    return mesh;
+}
+
+/**
+ * @brief Test the LOD chain of a curved grid
+ * @return true if every level is smaller, at least as wrong as the previous one and keeps the corners
+ */
+bool testMeshSimplifier() {
+    // The corners are the only locked vertices
+    const uint32_t size = 64;
+    IndexedMesh mesh = makeHeightField(size);
+
+    std::cout << "\n=== LOD 生成测试 ===" << std::endl;
+    LodChain chain = MeshSimplifier::buildLodChain(mesh);
+    bool valid = chain.levels.size() == 4 && chain.levels[0].indices == mesh.indices;
+    const std::array<uint32_t, 4> corners = {0, size, size * (size + 1), (size + 1) * (size + 1) - 1};
+    for (size_t i = 1; valid && i < chain.levels.size(); ++i) {
+        const LodLevel& level = chain.levels[i];
+        std::cout << "层次 " << i << ": " << level.indices.size() / 3 << " 个三角形, 误差 " << level.error << std::endl;
+        valid = level.indices.size() < chain.levels[i - 1].indices.size() &&
+                level.error >= chain.levels[i - 1].error && level.submeshes.size() == 1 &&
+                level.submeshes[0].indexCount == level.indices.size();
+        for (uint32_t index : level.indices) {
+            valid = valid && index < mesh.vertexCount();
+        }
+        for (uint32_t corner : corners) {
+            valid = valid && std::find(level.indices.begin(), level.indices.end(), corner) != level.indices.end();
+        }
+    }
+    valid = valid && chain.selectLevel(0.0f) == chain.levels.size() - 1 && chain.selectLevel(1e9f) == 0 &&
+            chain.getTriangles(mesh, 1).size() == chain.levels[1].indices.size() / 3;
+    
+    std::cout << "✓ LOD 链: " << (valid ? "通过" : "失败") << std::endl;
+    return valid;
+}
+
+/**
+ * @brief Test the meshlets of a curved grid
+ * @return true if every triangle is in exactly one meshlet and the bounds hold
+ */
+bool testMeshletBuilder() {
+    IndexedMesh mesh = makeHeightField(64);
+    MeshletOptions options;
+    MeshletMesh meshlets = MeshletBuilder::build(mesh, options);
+    
+    std::cout << "\n=== Meshlet 测试 ===" << std::endl;
+    std::cout << "Meshlet 数: " << meshlets.meshlets.size() << std::endl;
+    std::vector<std::array<uint32_t, 3>> triangles;
+    bool valid = true;
+    for (const Meshlet& meshlet : meshlets.meshlets) {
+        valid = valid && meshlet.vertexCount <= options.maxVertices && meshlet.triangleCount <= options.maxTriangles;
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+            const Vertex p = mesh.vertex(meshlets.vertices[meshlet.vertexOffset + i]).position;
+            float dx = p.x - meshlet.center[0], dy = p.y - meshlet.center[1], dz = p.z - meshlet.center[2];
+            valid = valid && std::sqrt(dx * dx + dy * dy + dz * dz) <= meshlet.radius;
+        }
+        for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+            std::array<uint32_t, 3> corners;
+            for (int k = 0; k < 3; ++k) {
+                corners[k] = meshlets.vertices[meshlet.vertexOffset + meshlets.triangles[meshlet.triangleOffset + t * 3 + k]];
+            }
+            triangles.push_back(corners);
+        }
+        // The height field faces +z: seen from far below every meshlet faces away, from above none does
+        const float below[3] = {0.5f, 0.5f, -100.0f};
+        const float above[3] = {0.5f, 0.5f, 100.0f};
+        valid = valid && MeshletBuilder::isBackfacing(meshlet, below) && !MeshletBuilder::isBackfacing(meshlet, above);
+    }
+    std::vector<std::array<uint32_t, 3>> expected;
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        expected.push_back({mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2]});
+    }
+    std::sort(triangles.begin(), triangles.end());
+    std::sort(expected.begin(), expected.end());
+    valid = valid && triangles == expected;
+    
+    std::cout << "✓ Meshlet 覆盖与包围: " << (valid ? "通过" : "失败") << std::endl;
+    return valid;
+}
+
+/**
+ * @brief Test normal generation on a cube with one smoothed and one flat half
+ * @param filename Path to smooth_cube.obj
+ * @return true if smoothed corners average their faces, flat ones keep the face normal and a
+ * small crease angle keeps the cube's edges hard
+ */
+bool testNormalGeneration(const std::string& filename) {
+    std::cout << "\n=== 法线生成测试 (" << filename << ") ===" << std::endl;
+    auto faceNormal = [](const Triangle& t) {
+        float ax = t.v1.x - t.v0.x, ay = t.v1.y - t.v0.y, az = t.v1.z - t.v0.z;
+        float bx = t.v2.x - t.v0.x, by = t.v2.y - t.v0.y, bz = t.v2.z - t.v0.z;
+        Normal n = {ay * bz - az * by, az * bx - ax * bz, ax * by - ay * bx};
+        float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+        return Normal{n.x / length, n.y / length, n.z / length};
+    };
+    auto near = [](const Normal& a, const Normal& b) {
+        return std::abs(a.x - b.x) < 1e-5f && std::abs(a.y - b.y) < 1e-5f && std::abs(a.z - b.z) < 1e-5f;
+    };
+    
+    bool valid = true;
+    for (float creaseAngle : {180.0f, 60.0f}) {
+        ModelLoader loader;
+        LoadOptions options;
+        options.indexedMesh = true;
+        options.generateNormals = true;
+        options.creaseAngle = creaseAngle;
+        if (!loader.loadModel(filename, options)) {
+            std::cout << "加载结果: 失败" << std::endl;
+            return false;
+        }
+        const auto& triangles = loader.getTriangles();
+        valid = valid && triangles.size() == 12 && loader.getIndexedMesh().hasNormals;
+        
+        // Without a crease angle a smoothed corner averages the smoothed faces at its position,
+        // each face counts once however it is split into triangles (angle weighting)
+        for (size_t i = 0; valid && i < triangles.size(); ++i) {
+            const Triangle& triangle = triangles[i];
+            const Vertex* positions[3] = {&triangle.v0, &triangle.v1, &triangle.v2};
+            const Normal* normals[3] = {&triangle.n0, &triangle.n1, &triangle.n2};
+            for (int k = 0; k < 3; ++k) {
+                Normal expected = faceNormal(triangle);
+                if (i < 6 && creaseAngle >= 180.0f) {
+                    Normal sum = {0.0f, 0.0f, 0.0f};
+                    for (size_t quad = 0; quad < 3; ++quad) {
+                        const Triangle& first = triangles[quad * 2];
+                        const Triangle& second = triangles[quad * 2 + 1];
+                        const Vertex corners[4] = {first.v0, first.v1, first.v2, second.v2};
+                        if (std::any_of(corners, corners + 4, [&](const Vertex& v) {
+                                return v.x == positions[k]->x && v.y == positions[k]->y && v.z == positions[k]->z;
+                            })) {
+                            Normal face = faceNormal(first);
+                            sum = {sum.x + face.x, sum.y + face.y, sum.z + face.z};
+                        }
+                    }
+                    float length = std::sqrt(sum.x * sum.x + sum.y * sum.y + sum.z * sum.z);
+                    expected = {sum.x / length, sum.y / length, sum.z / length};
+                }
+                valid = valid && triangle.hasNormals && near(*normals[k], expected);
+            }
+        }
+        
+        // Smoothed positions share one vertex (7 + 3 flat quads), a hard cube has 24
+        const size_t vertexCount = loader.getIndexedMesh().vertexCount();
+        std::cout << "折边角 " << static_cast<int>(creaseAngle) << ": " << vertexCount << " 个唯一顶点, "
+                  << loader.getNormals().size() << " 条法线" << std::endl;
+        valid = valid && vertexCount == (creaseAngle >= 180.0f ? 19u : 24u);
+    }
+    
+    std::cout << "✓ 平滑组与折边角: " << (valid ? "通过" : "失败") << std::endl;
+    return valid;
+}
+
+/**
+ * @brief Test tangents on a flat grid whose texture is mirrored at x = 0.5
+ * @param filename OBJ file with normals and texture coordinates, loaded with tangents
+ * @return true if each half gets its own unsplit tangent frame, the seam vertices are split and
+ * the loaded tangents are unit length and perpendicular to the normals
+ */
+bool testTangentGeneration(const std::string& filename) {
+    std::cout << "\n=== 切线生成测试 ===" << std::endl;
+    const uint32_t size = 16;
+    IndexedMesh mesh = makeHeightField(size);
+    mesh.hasNormals = true;
+    for (MeshVertex& vertex : mesh.vertices) {
+        vertex.position.z = 0.0f;
+        vertex.normal = {0.0f, 0.0f, 1.0f};
+        vertex.texCoord.u = std::abs(vertex.position.x - 0.5f) * 2.0f;
+    }
+    const IndexedMesh original = mesh;
+    bool valid = TangentGenerator::generate(mesh) && mesh.tangents.size() == mesh.vertices.size() &&
+                 mesh.vertices.size() == original.vertices.size() + size + 1;
+    
+    // Increasing u points away from the seam: the left half is mirrored (w = -1)
+    for (size_t i = 0; valid && i < mesh.indices.size(); ++i) {
+        const MeshVertex& before = original.vertices[original.indices[i]];
+        const MeshVertex& after = mesh.vertices[mesh.indices[i]];
+        valid = before.position.x == after.position.x && before.position.y == after.position.y &&
+                before.texCoord.u == after.texCoord.u;
+        const uint32_t* triangle = &original.indices[i / 3 * 3];
+        const float centerX = (original.vertices[triangle[0]].position.x + original.vertices[triangle[1]].position.x +
+                               original.vertices[triangle[2]].position.x) / 3.0f;
+        const float side = centerX < 0.5f ? -1.0f : 1.0f;
+        const Tangent& tangent = mesh.tangents[mesh.indices[i]];
+        valid = valid && std::abs(tangent.x - side) < 1e-5f && std::abs(tangent.y) < 1e-5f &&
+                std::abs(tangent.z) < 1e-5f && tangent.w == side;
+    }
+    std::cout << "镜像接缝拆分后顶点数: " << original.vertices.size() << " -> " << mesh.vertices.size() << std::endl;
+    
+    ModelLoader loader;
+    LoadOptions options;
+    options.indexedMesh = true;
+    options.generateTangents = true;
+    valid = valid && loader.loadModel(filename, options);
+    const IndexedMesh& loaded = loader.getIndexedMesh();
+    valid = valid && loaded.tangents.size() == loaded.vertexCount() && loader.getIndexedMeshView().tangents != nullptr;
+    for (size_t i = 0; valid && i < loaded.tangents.size(); ++i) {
+        const Tangent& t = loaded.tangents[i];
+        const Normal& n = loaded.vertices[i].normal;
+        valid = std::abs(t.x * t.x + t.y * t.y + t.z * t.z - 1.0f) < 1e-4f &&
+                std::abs(t.x * n.x + t.y * n.y + t.z * n.z) < 1e-4f && std::abs(t.w) == 1.0f;
+    }
+    
+    std::cout << "✓ 切线与镜像: " << (valid ? "通过" : "失败") << std::endl;
+    return valid;
+}
+
+/**
+ * @brief Test the glTF loader on a GLB written here: one mesh drawn by two nodes under a common parent
+ * @return true if the accessors read the binary chunk in place, the instances get the composed
+ * world matrices and the PBR material and embedded image are found
+ */
+bool testGltfLoader() {
+    std::cout << "\n=== glTF 加载测试 ===" << std::endl;
+    // Binary chunk: interleaved position + uv (stride 20), packed normals, uint16 indices, image
+    std::vector<char> bin(144, 0);
+    const float positions[4][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+    const float uvs[4][2] = {{0, 1}, {1, 1}, {1, 0}, {0, 0}};
+    const float normals[4][3] = {{0, 0, 1}, {0, 0, 1}, {0, 0, 1}, {0, 0, 1}};
+    const uint16_t indices[6] = {0, 1, 2, 0, 2, 3};
+    for (int i = 0; i < 4; ++i) {
+        std::memcpy(&bin[i * 20], positions[i], 12);
+        std::memcpy(&bin[i * 20 + 12], uvs[i], 8);
+    }
+    std::memcpy(&bin[80], normals, 48);
+    std::memcpy(&bin[128], indices, 12);
+    std::memcpy(&bin[140], "\x89PNG", 4);
+    std::string json = R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"nodes":[0]}],)"
+        R"("nodes":[{"name":"root","translation":[1,0,0],"children":[1,2]},{"name":"a","mesh":0,"translation":[0,2,0]},)"
+        R"({"name":"b","mesh":0,"rotation":[0,0,0.70710678,0.70710678],"scale":[2,2,2]}],)"
+        R"("meshes":[{"name":"quad","primitives":[{"attributes":{"POSITION":0,"TEXCOORD_0":1,"NORMAL":2},"indices":3,"material":0}]}],)"
+        R"("materials":[{"name":"pbr","pbrMetallicRoughness":{"baseColorFactor":[0.5,0.25,1,1],"metallicFactor":0,)"
+        R"("roughnessFactor":0.5,"baseColorTexture":{"index":0}},"normalTexture":{"index":1,"scale":0.8},)"
+        R"("alphaMode":"MASK","doubleSided":true}],)"
+        R"("textures":[{"source":0},{"source":1}],"images":[{"uri":"albedo.png"},{"bufferView":3,"mimeType":"image/png"}],)"
+        R"("accessors":[{"bufferView":0,"componentType":5126,"count":4,"type":"VEC3","min":[0,0,0],"max":[1,1,0]},)"
+        R"({"bufferView":0,"byteOffset":12,"componentType":5126,"count":4,"type":"VEC2"},)"
+        R"({"bufferView":1,"componentType":5126,"count":4,"type":"VEC3"},)"
+        R"({"bufferView":2,"componentType":5123,"count":6,"type":"SCALAR"}],)"
+        R"("bufferViews":[{"buffer":0,"byteOffset":0,"byteLength":80,"byteStride":20},{"buffer":0,"byteOffset":80,"byteLength":48},)"
+        R"({"buffer":0,"byteOffset":128,"byteLength":12},{"buffer":0,"byteOffset":140,"byteLength":4}],)"
+        R"("buffers":[{"byteLength":144}]})";
+    auto writeU32 = [](std::ofstream& out, uint32_t value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    const std::string filename = "gltf_test_scene.glb";
+    auto writeGlb = [&](std::string text) {
+        text.resize((text.size() + 3) / 4 * 4, ' ');
+        std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+        writeU32(out, 0x46546C67u);
+        writeU32(out, 2);
+        writeU32(out, static_cast<uint32_t>(12 + 8 + text.size() + 8 + bin.size()));
+        writeU32(out, static_cast<uint32_t>(text.size()));
+        writeU32(out, 0x4E4F534Au);
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        writeU32(out, static_cast<uint32_t>(bin.size()));
+        writeU32(out, 0x004E4942u);
+        out.write(bin.data(), static_cast<std::streamsize>(bin.size()));
+    };
+    writeGlb(json);
+    
+    GltfLoader loader;
+    bool valid = loader.load(filename);
+    const auto& accessors = loader.getAccessors();
+    valid = valid && accessors.size() == 4 && loader.getMeshes().size() == 1;
+    if (valid) {
+        // Interleaved positions are strided, the packed normals are a plain array into the file
+        const StridedView<Vertex> positionView = accessors[0].as<Vertex>();
+        const StridedView<Normal> normalView = accessors[2].as<Normal>();
+        valid = positionView.size() == 4 && !positionView.contiguous() && positionView[2].x == 1.0f &&
+                positionView[2].y == 1.0f && normalView.data() != nullptr && normalView.data()[3].z == 1.0f &&
+                accessors[1].as<TextureCoord>()[3].u == 0.0f && accessors[3].index(5) == 3 &&
+                accessors[0].max[1] == 1.0f && accessors[3].as<Vertex>().empty();
+    }
+    
+    // Both nodes draw mesh 0: a at root + (0, 2, 0), b rotated 90 degrees about z and scaled by 2
+    const auto& instances = loader.getInstances();
+    auto near = [](float a, float b) { return std::abs(a - b) < 1e-5f; };
+    valid = valid && loader.getNodes().size() == 3 && loader.getNodes()[2].parent == 0 && instances.size() == 2 &&
+            instances[0].mesh == 0 && instances[1].mesh == 0;
+    if (valid) {
+        const float* a = instances[0].worldMatrix;
+        const float* b = instances[1].worldMatrix;
+        valid = near(a[12], 1.0f) && near(a[13], 2.0f) && near(a[0], 1.0f) &&
+                near(b[12], 1.0f) && near(b[13], 0.0f) && near(b[0], 0.0f) && near(b[1], 2.0f) && near(b[4], -2.0f);
+    }
+    
+    const auto& materials = loader.getMaterials();
+    const auto& images = loader.getImages();
+    valid = valid && materials.size() == 1 && images.size() == 2;
+    if (valid) {
+        const GltfMaterial& material = materials[0];
+        valid = material.baseColorFactor[1] == 0.25f && material.metallicFactor == 0.0f &&
+                material.roughnessFactor == 0.5f && material.baseColorTexture.image == 0 &&
+                material.normalTexture.image == 1 && near(material.normalScale, 0.8f) &&
+                material.alphaMode == GltfAlphaMode::Mask && material.doubleSided &&
+                images[1].size == 4 && std::memcmp(images[1].bytes, "\x89PNG", 4) == 0 &&
+                loader.getMaterialTable()[0].diffuseTexture == "albedo.png";
+    }
+    
+    // The IndexedMesh uses the OBJ texture convention (v = 0 at the bottom)
+    const IndexedMesh mesh = loader.buildIndexedMesh(0);
+    valid = valid && mesh.vertices.size() == 4 && mesh.indices.size() == 6 && mesh.submeshes.size() == 1 &&
+            mesh.submeshes[0].material == 0 && mesh.hasNormals && mesh.hasTexCoords &&
+            mesh.vertices[3].texCoord.v == 1.0f && mesh.indices[5] == 3;
+    std::cout << "实例: " << instances.size() << ", 网格: " << loader.getMeshes().size()
+              << ", 材质: " << materials.size() << std::endl;
+    
+    // Negative, fractional or huge sizes are rejected
+    auto replaced = [](std::string text, const std::string& from, const std::string& to) {
+        text.replace(text.find(from), from.size(), to);
+        return text;
+    };
+    const std::pair<std::string, std::string> malformed[] = {
+        {R"("byteOffset":12,)", R"("byteOffset":-8,)"},
+        {R"("count":6,)", R"("count":6.5,)"},
+        {R"("byteLength":144})", R"("byteLength":1e300})"},
+        {R"("byteOffset":80,"byteLength":48)", R"("byteOffset":80,"byteLength":-48)"}
+    };
+    bool rejected = true;
+    for (const auto& [from, to] : malformed) {
+        writeGlb(replaced(json, from, to));
+        rejected = rejected && !loader.load(filename);
+    }
+    // (count - 1) * stride wraps around to 0 here; the accessors must come out empty, not point past the file
+    writeGlb(replaced(replaced(json, R"("byteStride":20)", R"("byteStride":4503599627370496)"),
+                      R"("count":4,)", R"("count":4097,)"));
+    rejected = rejected && loader.load(filename) && loader.getAccessors().size() == 4 &&
+               loader.getAccessors()[0].count == 0 && loader.getAccessors()[0].as<Vertex>().empty() &&
+               loader.getAccessors()[1].count == 0 && loader.getAccessors()[2].count == 4;
+    std::cout << "✓ 非法的大小和越界的 accessor: " << (rejected ? "通过" : "失败") << std::endl;
+    valid = valid && rejected;
+    
+    // A truncated file is rejected
+    {
+        std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+        writeU32(out, 0x46546C67u);
+        writeU32(out, 2);
+        writeU32(out, 1000);
+        writeU32(out, 500);
+        writeU32(out, 0x4E4F534Au);
+    }
+    valid = valid && !loader.load(filename);
+    std::remove(filename.c_str());
+    
+    std::cout << "✓ GLB 实例与 PBR 材质: " << (valid ? "通过" : "失败") << std::endl;
+    return valid;
+}
+
+/**
+ * @brief Test the PLY loader on a grid written as ASCII, binary little endian and big endian
+ * @return true if all encodings and thread counts give the same streams and indices, and mixed
+ * polygon sizes, colors and invalid faces are handled
+ */
+bool testPlyLoader() {
+    std::cout << "\n=== PLY 加载测试 ===" << std::endl;
+    // A quad grid big enough for the ASCII body to be parsed in several chunks
+    const uint32_t size = 300;
+    std::vector<float> grid;
+    std::vector<uint32_t> quads;
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            grid.insert(grid.end(), {x * 0.5f, y * 0.25f, static_cast<float>((x * 7 + y * 3) % 11)});
+            if (x + 1 < size && y + 1 < size) {
+                quads.insert(quads.end(), {y * size + x, y * size + x + 1, (y + 1) * size + x + 1, (y + 1) * size + x});
+            }
+        }
+    }
+    const size_t vertexCount = grid.size() / 3;
+    const size_t faceCount = quads.size() / 4;
+    auto header = [&](std::ofstream& out, const char* format) {
+        out << "ply\nformat " << format << " 1.0\ncomment grid\nelement vertex " << vertexCount
+            << "\nproperty float x\nproperty float y\nproperty float z\nelement face " << faceCount
+            << "\nproperty list uchar int vertex_indices\nend_header\n";
+    };
+    auto writeBinary = [&](const std::string& filename, bool bigEndian) {
+        std::ofstream out(filename, std::ios::binary);
+        header(out, bigEndian ? "binary_big_endian" : "binary_little_endian");
+        auto put = [&](const void* value, size_t bytes) {
+            char buffer[4];
+            std::memcpy(buffer, value, bytes);
+            if (bigEndian) {
+                std::reverse(buffer, buffer + bytes);
+            }
+            out.write(buffer, static_cast<std::streamsize>(bytes));
+        };
+        for (float value : grid) {
+            put(&value, 4);
+        }
+        for (size_t f = 0; f < faceCount; ++f) {
+            const uint8_t corners = 4;
+            put(&corners, 1);
+            for (size_t k = 0; k < 4; ++k) {
+                put(&quads[f * 4 + k], 4);
+            }
+        }
+    };
+    {
+        std::ofstream out("ply_test_ascii.ply");
+        header(out, "ascii");
+        for (size_t v = 0; v < vertexCount; ++v) {
+            out << grid[v * 3] << ' ' << grid[v * 3 + 1] << ' ' << grid[v * 3 + 2] << '\n';
+        }
+        for (size_t f = 0; f < faceCount; ++f) {
+            out << "4 " << quads[f * 4] << ' ' << quads[f * 4 + 1] << ' ' << quads[f * 4 + 2] << ' ' << quads[f * 4 + 3] << '\n';
+        }
+    }
+    writeBinary("ply_test_le.ply", false);
+    writeBinary("ply_test_be.ply", true);
+    
+    bool valid = true;
+    auto check = [&](const std::string& filename, unsigned int threads) {
+        PlyLoader loader;
+        loader.setThreadCount(threads);
+        if (!loader.load(filename)) {
+            return false;
+        }
+        const IndexedMesh& mesh = loader.getMesh();
+        bool same = mesh.streams.count == vertexCount && mesh.indices.size() == faceCount * 6 &&
+                    mesh.submeshes.size() == 1 && !mesh.hasNormals && loader.getColors().empty();
+        for (size_t v = 0; same && v < vertexCount; ++v) {
+            same = mesh.streams.positionX[v] == grid[v * 3] && mesh.streams.positionY[v] == grid[v * 3 + 1] &&
+                   mesh.streams.positionZ[v] == grid[v * 3 + 2];
+        }
+        for (size_t f = 0; same && f < faceCount; ++f) {
+            const uint32_t* quad = &quads[f * 4];
+            const uint32_t* triangles = &mesh.indices[f * 6];
+            same = triangles[0] == quad[0] && triangles[1] == quad[1] && triangles[2] == quad[2] &&
+                   triangles[3] == quad[0] && triangles[4] == quad[2] && triangles[5] == quad[3];
+        }
+        return same;
+    };
+    valid = check("ply_test_ascii.ply", 1) && check("ply_test_ascii.ply", 4) && check("ply_test_le.ply", 4) &&
+            check("ply_test_be.ply", 1);
+    
+    // Mixed polygon sizes (rows of different sizes), uchar colors, and a face with an invalid index
+    {
+        std::ofstream out("ply_test_mixed.ply", std::ios::binary);
+        out << "ply\nformat binary_little_endian 1.0\nelement vertex 4\nproperty float x\nproperty float y\n"
+               "property float z\nproperty uchar red\nproperty uchar green\nproperty uchar blue\n"
+               "element face 3\nproperty list uchar uint vertex_indices\nend_header\n";
+        for (uint32_t v = 0; v < 4; ++v) {
+            const float position[3] = {static_cast<float>(v & 1), static_cast<float>(v >> 1), 0.0f};
+            const uint8_t color[3] = {static_cast<uint8_t>(v * 80), 10, 200};
+            out.write(reinterpret_cast<const char*>(position), sizeof(position));
+            out.write(reinterpret_cast<const char*>(color), sizeof(color));
+        }
+        const uint8_t triangle = 3, quad = 4;
+        const uint32_t first[3] = {0, 1, 3}, second[4] = {0, 1, 3, 2}, broken[3] = {0, 1, 9};
+        out.write(reinterpret_cast<const char*>(&triangle), 1);
+        out.write(reinterpret_cast<const char*>(first), sizeof(first));
+        out.write(reinterpret_cast<const char*>(&quad), 1);
+        out.write(reinterpret_cast<const char*>(second), sizeof(second));
+        out.write(reinterpret_cast<const char*>(&triangle), 1);
+        out.write(reinterpret_cast<const char*>(broken), sizeof(broken));
+    }
+    PlyLoader mixed;
+    valid = valid && mixed.load("ply_test_mixed.ply") && mixed.getMesh().indices.size() == 9 &&
+            mixed.getMesh().indices[8] == 2 && mixed.getColors().red[3] == 240 &&
+            mixed.getColors().blue[0] == 200 && mixed.getColors().alpha[1] == 255 &&
+            mixed.getMesh().streams.positionY[2] == 1.0f;
+    
+    // A body shorter than the header promises is rejected
+    {
+        std::ofstream out("ply_test_mixed.ply", std::ios::binary | std::ios::trunc);
+        out << "ply\nformat binary_little_endian 1.0\nelement vertex 100\nproperty float x\nend_header\n";
+    }
+    valid = valid && !mixed.load("ply_test_mixed.ply");
+    for (const char* filename : {"ply_test_ascii.ply", "ply_test_le.ply", "ply_test_be.ply", "ply_test_mixed.ply"}) {
+        std::remove(filename);
+    }
+    
+    std::cout << "✓ ASCII/二进制与多线程一致: " << (valid ? "通过" : "失败") << std::endl;
+    return valid;
+}
+
+/**
+ * @brief Test loading into arenas: repeated loads and the single block mesh
+ * @param filename Path to OBJ file to test
+ * @return true if the block holds the same mesh as IndexedMesh after every load
+ */
+bool testArenaLoading(const std::string& filename) {
+    ModelLoader reference;
+    LoadOptions options;
+    options.indexedMesh = true;
+    options.triangles = false;
+    options.generateTangents = true;
+    
+    std::cout << "\n=== Arena 加载测试 (" << filename << ") ===" << std::endl;
+    if (!reference.loadModel(filename, options)) {
+        std::cout << "加载结果: 失败" << std::endl;
+        return false;
+    }
+    const IndexedMesh& mesh = reference.getIndexedMesh();
+    
+    // The same loader reuses its arenas for every load
+    ModelLoader loader;
+    options.singleBlockMesh = true;
+    bool same = true;
+    for (int round = 0; same && round < 3; ++round) {
+        same = loader.loadModel(filename, options) && loader.getIndexedMesh().indices.empty();
+        const IndexedMeshView view = loader.getIndexedMeshView();
+        same = same && view.vertexCount == mesh.vertices.size() && view.indexCount == mesh.indices.size() &&
+               view.submeshCount == mesh.submeshes.size() && view.tangents != nullptr &&
+               view.hasTexCoords == mesh.hasTexCoords && view.hasNormals == mesh.hasNormals;
+        same = same && reinterpret_cast<uintptr_t>(view.vertices) % 64 == 0 &&
+               reinterpret_cast<uintptr_t>(view.indices) % 64 == 0;
+        same = same && std::memcmp(view.vertices, mesh.vertices.data(), mesh.vertices.size() * sizeof(MeshVertex)) == 0 &&
+               std::memcmp(view.indices, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t)) == 0 &&
+               std::memcmp(view.tangents, mesh.tangents.data(), mesh.tangents.size() * sizeof(Tangent)) == 0;
+        for (size_t i = 0; same && i < view.submeshCount; ++i) {
+            same = view.submeshes[i].firstIndex == mesh.submeshes[i].firstIndex &&
+                   view.submeshes[i].indexCount == mesh.submeshes[i].indexCount &&
+                   view.submeshes[i].material == mesh.submeshes[i].material;
+        }
+    }
+    std::cout << "✓ 重复加载单块网格一致: " << (same ? "通过" : "失败") << std::endl;
+    
+    // Streams are copied with their padding
+    options.vertexLayout = VertexLayout::Streams;
+    options.generateTangents = false;
+    bool streams = loader.loadModel(filename, options);
+    const IndexedMeshView view = loader.getIndexedMeshView();
+    streams = streams && view.vertices == nullptr && view.streams.count == mesh.vertices.size() &&
+              view.streams.paddedCount % VertexStreams::PADDING == 0 &&
+              reinterpret_cast<uintptr_t>(view.streams.positionX) % VertexStreams::ALIGNMENT == 0;
+    for (size_t i = 0; streams && i < view.streams.count; ++i) {
+        const MeshVertex& vertex = mesh.vertices[i];
+        streams = view.streams.positionX[i] == vertex.position.x && view.streams.positionZ[i] == vertex.position.z &&
+                  view.streams.normalY[i] == vertex.normal.y && view.streams.texCoordV[i] == vertex.texCoord.v;
+    }
+    std::cout << "✓ 流布局单块网格: " << (streams ? "通过" : "失败") << std::endl;
+    
+    loader.releaseMemory();
+    const bool released = loader.getIndexedMeshView().indexCount == 0;
+    std::cout << "✓ 释放内存后视图为空: " << (released ? "通过" : "失败") << std::endl;
+    return same && streams && released;
+}
+
+/**
+ * @brief Test the file watcher on a material file and reloading only the materials
+ * @return true if the rewritten MTL is reported and reloadMaterials keeps the material ids
+ */
+bool testFileWatcher() {
+    std::cout << "\n=== 文件监视与材质重载测试 ===" << std::endl;
+    auto writeMaterials = [](float red) {
+        std::ofstream out("watch_test.mtl");
+        out << "newmtl first\nKd " << red << " 0 0\n\nnewmtl second\nKd 0 1 0\nmap_Kd second.png\n";
+    };
+    {
+        std::ofstream out("watch_test.obj");
+        out << "mtllib watch_test.mtl\nv 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\n"
+            << "usemtl second\nf 1 2 3\nusemtl first\nf 2 4 3\n";
+    }
+    writeMaterials(1.0f);
+    
+    ModelLoader loader;
+    bool valid = loader.loadModel("watch_test.obj") && loader.getMaterialSources().size() == 1;
+    FileWatcher watcher;
+    for (const std::string& source : loader.getMaterialSources()) {
+        valid = valid && watcher.watch(source);
+    }
+    valid = valid && watcher.watch("watch_test.obj");
+    valid = valid && watcher.poll(0).empty();
+    
+    writeMaterials(0.5f);
+    const std::vector<std::string> changed = watcher.poll(1000);
+    const bool reported = changed.size() == 1 &&
+                          FileWatcher::normalize(changed[0]) == FileWatcher::normalize(loader.getMaterialSources()[0]);
+    std::cout << "✓ 报告修改的 MTL (" << (watcher.isNative() ? "inotify" : "时间戳") << "): "
+              << (reported ? "通过" : "失败") << std::endl;
+    
+    // The new table keeps the ids of the loaded geometry, only the values change
+    const std::vector<Material>& before = loader.getMaterials();
+    const std::vector<Material> after = loader.reloadMaterials();
+    bool reloaded = after.size() == before.size();
+    for (size_t i = 0; reloaded && i < after.size(); ++i) {
+        reloaded = after[i].name == before[i].name && after[i].diffuseTexture == before[i].diffuseTexture;
+        if (after[i].name == "first") {
+            reloaded = reloaded && after[i].diffuse[0] == 0.5f && before[i].diffuse[0] == 1.0f;
+        }
+    }
+    std::cout << "✓ 材质重载保持 ID: " << (reloaded ? "通过" : "失败") << std::endl;
+    
+    std::remove("watch_test.obj");
+    std::remove("watch_test.mtl");
+    return valid && reported && reloaded;
+}
+
+/**
+ * @brief Test sharing parsed MTL files between loaders on different threads
+ * @return true if the library is read once and both models get the tables of an uncached load
+ */
+bool testMaterialCache() {
+    std::cout << "\n=== 共享材质缓存测试 ===" << std::endl;
+    {
+        std::ofstream out("cache_test.mtl");
+        out << "newmtl red\nKd 1 0 0\nmap_Kd red.png\n\nnewmtl green\nKd 0 1 0\n\nnewmtl red\nKd 0.5 0 0\n";
+    }
+    // The models use the materials in different orders, so their MaterialIds differ
+    const char* names[2] = {"cache_test_a.obj", "cache_test_b.obj"};
+    const char* order[2][2] = {{"red", "green"}, {"green", "red"}};
+    for (int m = 0; m < 2; ++m) {
+        std::ofstream out(names[m]);
+        out << "v 0 0 0\nv 1 0 0\nv 0 1 0\nusemtl " << order[m][0] << "\nf 1 2 3\nmtllib cache_test.mtl\n"
+            << "usemtl " << order[m][1] << "\nf 1 3 2\n";
+    }
+    
+    MaterialCache cache;
+    ModelLoader cached[2];
+    bool loaded[2] = {false, false};
+    std::vector<std::thread> threads;
+    for (int m = 0; m < 2; ++m) {
+        threads.emplace_back([&, m]() {
+            cached[m].setMaterialCache(&cache);
+            loaded[m] = cached[m].loadModel(names[m]);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const bool shared = loaded[0] && loaded[1] && cache.size() == 1 && cache.reuses() == 1;
+    std::cout << "✓ MTL 只解析一次: " << (shared ? "通过" : "失败") << std::endl;
+    
+    bool same = true;
+    for (int m = 0; same && m < 2; ++m) {
+        ModelLoader reference;
+        same = reference.loadModel(names[m]) && reference.getMaterials().size() == cached[m].getMaterials().size();
+        for (size_t i = 0; same && i < reference.getMaterials().size(); ++i) {
+            const Material& expected = reference.getMaterials()[i];
+            const Material& actual = cached[m].getMaterials()[i];
+            same = expected.name == actual.name && expected.defined == actual.defined &&
+                   std::memcmp(expected.diffuse, actual.diffuse, sizeof(expected.diffuse)) == 0 &&
+                   expected.diffuseTexture == actual.diffuseTexture;
+        }
+        const auto& triangles = cached[m].getTriangles();
+        const auto& materials = cached[m].getMaterials();
+        same = same && triangles.size() == 2 && triangles[0].hasMaterial(materials) && triangles[1].hasMaterial(materials) &&
+               triangles[0].getMaterial(materials)->name == order[m][0] &&
+               triangles[1].getMaterial(materials)->name == order[m][1];
+    }
+    // The later definition of red wins, as without the cache
+    same = same && cached[0].getMaterials()[cached[0].findMaterial("red")].diffuse[0] == 0.5f;
+    std::cout << "✓ 与不使用缓存的材质表一致: " << (same ? "通过" : "失败") << std::endl;
+    
+    for (const char* filename : {"cache_test.mtl", "cache_test_a.obj", "cache_test_b.obj"}) {
+        std::remove(filename);
+    }
+    return shared && same;
+}
+
+/**
+ * @brief Test that the parse reserves its per-chunk arrays from the line counts
+ * @return true if the chunk arrays have no spare capacity and the chunk arenas hold little more than them
+ */
+bool testPresizing() {
+    std::cout << "\n=== 预分配测试 ===" << std::endl;
+    // A quad grid with v/vt/vn, a comment and blank lines, so faces and corners differ
+    const int size = 400;
+    {
+        std::ofstream out("presize_test.obj");
+        out << "# grid\n\n";
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                out << "v " << x << ' ' << y << " 0\n";
+                out << "  vt " << x / float(size) << ' ' << y / float(size) << "\n";
+                out << "vn 0 0 1\r\n";
+            }
+        }
+        for (int y = 0; y + 1 < size; ++y) {
+            for (int x = 0; x + 1 < size; ++x) {
+                const int a = y * size + x + 1, b = a + 1, c = a + size + 1, d = a + size;
+                out << "f " << a << '/' << a << '/' << a << ' ' << b << '/' << b << '/' << b << ' '
+                    << c << '/' << c << '/' << c << ' ' << d << '/' << d << '/' << d << "\n";
+            }
+        }
+    }
+    const size_t vertexCount = size_t(size) * size;
+    const size_t triangleCount = size_t(size - 1) * (size - 1) * 2;
+    
+    ModelLoader loader;
+    LoadOptions options;
+    options.indexedMesh = true;
+    size_t memBefore = getMemoryUsageKB();
+    bool loaded = loader.loadModel("presize_test.obj", options);
+    size_t memAfter = getMemoryUsageKB();
+    std::cout << "[内存监控] 当前 RSS 加载前: " << memBefore << " KB, 加载后: " << memAfter << " KB" << std::endl;
+    
+    const IndexedMesh& mesh = loader.getIndexedMesh();
+    const bool counted = loaded && loader.getVertices().size() == vertexCount &&
+                         loader.getTextureCoords().size() == vertexCount && loader.getNormals().size() == vertexCount &&
+                         loader.getTriangles().size() == triangleCount && mesh.vertices.size() == vertexCount &&
+                         mesh.indices.size() == triangleCount * 3;
+    std::cout << "✓ 元素数量: " << (counted ? "通过" : "失败") << std::endl;
+    
+    // Arrays grown by doubling would leave every outgrown copy in the chunk arena
+    const ParseMemoryStats& parse = loader.getParseMemoryStats();
+    std::cout << "[内存监控] 解析区: " << parse.arenaBytes / 1024 << " KB, 解析数组: " << parse.arrayBytes / 1024
+              << " KB, 多余元素: " << parse.spareElements << std::endl;
+    const bool exact = parse.arrayBytes > 0 && parse.spareElements == 0 &&
+                       parse.arenaBytes <= parse.arrayBytes + parse.arrayBytes / 20 + 4096 &&
+                       mesh.vertices.capacity() == mesh.vertices.size();
+    std::cout << "✓ 解析数组没有多余容量: " << (exact ? "通过" : "失败") << std::endl;
+    
+    std::remove("presize_test.obj");
+    return counted && exact;
+}
+
+/**
+ * @brief Test the .srmesh cache: loads served from it and every change that must invalidate it
+ * @return true if the cache is used only while the OBJ, its MTL and the load options are unchanged
+ */
+bool testMeshCache() {
+    std::cout << "\n=== 网格缓存测试 ===" << std::endl;
+    auto writeModel = [](int extraFaces) {
+        std::ofstream out("mesh_cache_test.obj");
+        out << "mtllib mesh_cache_test.mtl\nv 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\nvn 0 0 1\n"
+            << "usemtl red\nf 1/1/1 2/2/1 3/3/1\nusemtl blue\nf 1/1/1 3/3/1 4/4/1\n";
+        for (int i = 0; i < extraFaces; ++i) {
+            out << "f 4/4/1 3/3/1 2/2/1\n";
+        }
+    };
+    auto writeMaterials = [](const char* red) {
+        std::ofstream out("mesh_cache_test.mtl");
+        out << "newmtl red\nKd " << red << " 0 0\nnewmtl blue\nKd 0 0 1\n";
+    };
+    writeModel(0);
+    writeMaterials("1");
+    std::remove("mesh_cache_test.srmesh");
+    
+    LoadOptions options;
+    options.indexedMesh = true;
+    options.triangles = false;
+    ModelLoader reference;
+    bool valid = reference.loadModel("mesh_cache_test.obj", options);
+    const IndexedMesh& mesh = reference.getIndexedMesh();
+    
+    // 1 if the load was served from the cache (IndexedMesh stays empty), 0 if it parsed, -1 on failure
+    options.useCache = true;
+    auto load = [](ModelLoader& loader, const LoadOptions& loadOptions) {
+        if (!loader.loadModel("mesh_cache_test.obj", loadOptions)) {
+            return -1;
+        }
+        return loader.getIndexedMesh().indices.empty() && loader.getIndexedMeshView().indexCount > 0 ? 1 : 0;
+    };
+    
+    ModelLoader first;
+    ModelLoader second;
+    valid = valid && load(first, options) == 0 && std::ifstream("mesh_cache_test.srmesh").good() &&
+            load(second, options) == 1;
+    const IndexedMeshView view = second.getIndexedMeshView();
+    valid = valid && view.vertexCount == mesh.vertices.size() && view.indexCount == mesh.indices.size() &&
+            view.submeshCount == mesh.submeshes.size() && view.hasTexCoords && view.hasNormals &&
+            std::memcmp(view.vertices, mesh.vertices.data(), mesh.vertices.size() * sizeof(MeshVertex)) == 0 &&
+            std::memcmp(view.indices, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t)) == 0;
+    for (size_t i = 0; valid && i < view.submeshCount; ++i) {
+        valid = view.submeshes[i].firstIndex == mesh.submeshes[i].firstIndex &&
+                view.submeshes[i].indexCount == mesh.submeshes[i].indexCount &&
+                second.getMaterials()[view.submeshes[i].material].name ==
+                    reference.getMaterials()[mesh.submeshes[i].material].name;
+    }
+    std::cout << "✓ 第二次加载使用缓存且与解析结果一致: " << (valid ? "通过" : "失败") << std::endl;
+    
+    // A newer modification time alone is settled by the content hash
+    std::filesystem::last_write_time("mesh_cache_test.obj",
+                                     std::filesystem::last_write_time("mesh_cache_test.obj") + std::chrono::seconds(5));
+    ModelLoader touched;
+    const bool hashed = load(touched, options) == 1;
+    std::cout << "✓ 只修改时间时内容哈希相同仍使用缓存: " << (hashed ? "通过" : "失败") << std::endl;
+    
+    // Every edit forces a parse, which writes a new cache for the next load
+    bool edits = true;
+    ModelLoader loaders[6];
+    writeModel(1);
+    edits = edits && load(loaders[0], options) == 0 && loaders[0].getIndexedMesh().indices.size() == mesh.indices.size() + 3 &&
+            load(loaders[1], options) == 1;
+    writeMaterials("0.25");
+    edits = edits && load(loaders[2], options) == 0 &&
+            loaders[2].getMaterials()[loaders[2].findMaterial("red")].diffuse[0] == 0.25f &&
+            load(loaders[3], options) == 1;
+    std::remove("mesh_cache_test.mtl");
+    edits = edits && load(loaders[4], options) == 0 && load(loaders[5], options) == 1;
+    std::cout << "✓ 修改 OBJ、修改或删除 MTL 后重新解析: " << (edits ? "通过" : "失败") << std::endl;
+    
+    // A cache written with other options is not used, and the parse replaces it
+    bool rejected = true;
+    for (int variant = 0; variant < 3; ++variant) {
+        LoadOptions other = options;
+        if (variant == 0) {
+            other.vertexLayout = VertexLayout::Streams;
+        } else if (variant == 1) {
+            other.optimizeMesh = true;
+        } else {
+            other.generateNormals = true;
+        }
+        ModelLoader withOther;
+        ModelLoader withBase;
+        ModelLoader again;
+        rejected = rejected && load(withOther, other) == 0 && load(withBase, options) == 0 && load(again, options) == 1;
+    }
+    std::cout << "✓ 布局、优化或法线生成选项不同时拒绝缓存: " << (rejected ? "通过" : "失败") << std::endl;
+    
+    for (const char* filename : {"mesh_cache_test.obj", "mesh_cache_test.mtl", "mesh_cache_test.srmesh"}) {
+        std::remove(filename);
+    }
+    const bool removed = !std::ifstream("mesh_cache_test.srmesh").good();
+    return valid && hashed && edits && rejected && removed;
+}
+
+/**
+ * @brief Table-driven test of the allocation-free number parsers against std::stof / std::stoi
+ * @details Every token must succeed or fail exactly when the standard function does and give
+ * the same value; a failed parse leaves the output untouched.
+ * @return true if parseFloat and parseInt agree with the standard functions on every token
+ */
+bool testNumberParsing() {
+    std::cout << "\n=== 数字解析测试 ===" << std::endl;
+    const std::vector<std::string> floats = {
+        "0", "-0", "1", "-1", "+1", "1.5", "-2.25", ".5", "-.5", "5.", "00012.5", "3.14159265358979",
+        "1e3", "1E-3", "-2.5e+2", "+6.02e23", "1e", "1e+", "1.5e3x", "1,5", "1.5abc",
+        "inf", "-inf", "+inf", "INF", "Infinity", "infinit", "nan", "-nan", "+nan", "NaN", "nan(123)",
+        " 1.5", "\t-2", "\n+3e1", "  .25", "   ", " + 1", "",
+        "+", "-", ".", "+-1", "-+1", "++1", "--1", "e5", "abc",
+        "0x1p3", "-0x1.8p1", "+0X10",
+        "3.4028235e38", "-3.4028235e38", "3.5e38", "1e39", "-1e39", "1e400",
+        "1.17549435e-38", "1e-38", "-1e-40", "1e-46", "1e-50", "0e999", "0.000e-999", "-0.0e10"
+    };
+    const std::vector<std::string> ints = {
+        "0", "-0", "7", "-7", "+7", "007", "2147483647", "-2147483648", "2147483648", "-2147483649",
+        "99999999999", "+2147483647", "12abc", "1.9", "1e3", "0x10",
+        " 7", "\t-7", "\n+7", "   ", " + 7", "", "+", "-", "+-1", "-+1", "++1", "abc"
+    };
+    
+    const float untouchedFloat = 123.0f;
+    int floatMismatches = 0;
+    for (const auto& token : floats) {
+        bool expectedOk = true;
+        float expected = 0.0f;
+        try {
+            expected = std::stof(token);
+        } catch (const std::exception&) {
+            expectedOk = false;
+        }
+        float value = untouchedFloat;
+        const bool ok = parseFloat(token, value);
+        const bool same = ok == expectedOk &&
+                          (ok ? (std::isnan(expected) ? std::isnan(value) : value == expected) &&
+                                    std::signbit(value) == std::signbit(expected)
+                              : value == untouchedFloat);
+        if (!same) {
+            std::cout << "  parseFloat(\"" << token << "\"): " << (ok ? "成功 " : "失败 ") << value
+                      << "，std::stof: " << (expectedOk ? "成功 " : "失败 ") << expected << std::endl;
+            ++floatMismatches;
+        }
+    }
+    std::cout << "✓ parseFloat 与 std::stof 一致 (" << floats.size() << " 项): "
+              << (floatMismatches == 0 ? "通过" : "失败") << std::endl;
+    
+    const int untouchedInt = 123;
+    int intMismatches = 0;
+    for (const auto& token : ints) {
+        bool expectedOk = true;
+        int expected = 0;
+        try {
+            expected = std::stoi(token);
+        } catch (const std::exception&) {
+            expectedOk = false;
+        }
+        int value = untouchedInt;
+        const bool ok = parseInt(token, value);
+        if (ok != expectedOk || (ok ? value != expected : value != untouchedInt)) {
+            std::cout << "  parseInt(\"" << token << "\"): " << (ok ? "成功 " : "失败 ") << value
+                      << "，std::stoi: " << (expectedOk ? "成功 " : "失败 ") << expected << std::endl;
+            ++intMismatches;
+        }
+    }
+    std::cout << "✓ parseInt 与 std::stoi 一致 (" << ints.size() << " 项): "
+              << (intMismatches == 0 ? "通过" : "失败") << std::endl;
+    
+    return floatMismatches == 0 && intMismatches == 0;
+}
+
+/**
+ * @brief Test that the chunked parser gives the same result on one thread and on many
+ * @details The file is large enough to be split into one chunk per thread and uses negative
+ * (relative) indices, usemtl and s lines, whose state has to carry across chunk borders.
+ * @return true if triangles, material IDs and the indexed mesh do not depend on the thread count
+ */
+bool testParallelParsing() {
+    std::cout << "\n=== 多线程解析一致性测试 ===" << std::endl;
+    const int groups = 96000;
+    const char* names[3] = {"red", "green", "blue"};
+    {
+        std::ofstream out("parallel_test.obj");
+        for (int g = 0; g < groups; ++g) {
+            if (g % 97 == 0) {
+                out << "usemtl " << names[(g / 97) % 3] << "\n";
+            }
+            if (g % 53 == 0) {
+                out << ((g / 53) % 2 == 0 ? "s 1\n" : "s off\n");
+            }
+            out << "v " << g << " 0 " << g % 7 << "\nv " << g << " 1 0.5\nv " << g + 1 << " 0 " << -g % 5 << "\n";
+            out << "vt 0 0\nvt 1 0\nvt 0 " << g % 3 << "\nvn 0 0 1\n";
+            if (g % 2 == 0) {
+                out << "f -3/-3/-1 -2/-2/-1 -1/-1/-1\n";
+            } else {
+                out << "f -1/-1 -2/-2 -3/-3\n";
+            }
+            if (g % 4 == 3) {
+                // Absolute indices pointing back into earlier chunks
+                out << "f " << g + 1 << ' ' << g / 2 + 1 << ' ' << 3 * g + 1 << "\n";
+            }
+        }
+    }
+    const auto fileBytes = std::filesystem::file_size("parallel_test.obj");
+    std::cout << "文件大小: " << fileBytes / 1024 << " KB" << std::endl;
+    
+    LoadOptions options;
+    options.indexedMesh = true;
+    options.generateNormals = true;
+    ModelLoader single;
+    ModelLoader parallel;
+    single.setThreadCount(1);
+    parallel.setThreadCount(8);
+    bool valid = fileBytes > 8 * (size_t(1) << 20) && single.loadModel("parallel_test.obj", options) &&
+                 parallel.loadModel("parallel_test.obj", options);
+    
+    // Negative indices refer to the elements just before the face
+    const auto& triangles = single.getTriangles();
+    valid = valid && triangles.size() == size_t(groups) + groups / 4 &&
+            triangles[0].v0.x == 0.0f && triangles[0].v1.y == 1.0f && triangles[0].v2.x == 1.0f &&
+            triangles[0].hasTextures && triangles[0].hasNormals &&
+            triangles[1].v0.x == 2.0f && triangles[1].v0.z == -1.0f && triangles[1].v2.y == 0.0f &&
+            triangles[2].v0.z == 2.0f && triangles[2].v2.x == 3.0f && triangles[2].v2.z == -2.0f &&
+            triangles[2].t2.v == 2.0f;
+    std::cout << "✓ 负数（相对）索引: " << (valid ? "通过" : "失败") << std::endl;
+    
+    const auto& others = parallel.getTriangles();
+    bool same = valid && others.size() == triangles.size() &&
+                single.getMaterials().size() == parallel.getMaterials().size();
+    for (size_t i = 0; same && i < triangles.size(); ++i) {
+        const Triangle& a = triangles[i];
+        const Triangle& b = others[i];
+        // Texture coordinates are left unset on triangles without them
+        same = std::memcmp(&a.v0, &b.v0, sizeof(Vertex)) == 0 && std::memcmp(&a.v1, &b.v1, sizeof(Vertex)) == 0 &&
+               std::memcmp(&a.v2, &b.v2, sizeof(Vertex)) == 0 &&
+               (!a.hasTextures || std::memcmp(&a.t2, &b.t2, sizeof(TextureCoord)) == 0) &&
+               std::memcmp(&a.n0, &b.n0, sizeof(Normal)) == 0 && std::memcmp(&a.n2, &b.n2, sizeof(Normal)) == 0 &&
+               a.hasTextures == b.hasTextures && a.hasNormals == b.hasNormals && a.materialId == b.materialId;
+    }
+    for (size_t i = 0; same && i < single.getMaterials().size(); ++i) {
+        same = single.getMaterials()[i].name == parallel.getMaterials()[i].name;
+    }
+    const IndexedMesh& meshA = single.getIndexedMesh();
+    const IndexedMesh& meshB = parallel.getIndexedMesh();
+    same = same && meshA.vertices.size() == meshB.vertices.size() && meshA.indices == meshB.indices &&
+           meshA.submeshes.size() == meshB.submeshes.size() &&
+           std::memcmp(meshA.vertices.data(), meshB.vertices.data(), meshA.vertices.size() * sizeof(MeshVertex)) == 0;
+    std::cout << "✓ 1 线程与 8 线程结果一致: " << (same ? "通过" : "失败") << std::endl;
+    
+    std::remove("parallel_test.obj");
+    return valid && same;
+}
+
+/**
+ * @brief Test that streaming in small batches delivers the triangles of loadModel
+ * @param filename Path to OBJ file to test
+ * @return true if the streamed triangles match
+ */
+bool testStreaming(const std::string& filename) {
+    ModelLoader loader;
+    ModelLoader streamer;
+    
+    std::cout << "\n=== 流式加载测试 (" << filename << ") ===" << std::endl;
+    if (!loader.loadModel(filename)) {
+        std::cout << "加载结果: 失败" << std::endl;
+        return false;
+    }
+    
+    const auto& triangles = loader.getTriangles();
+    // IDs are assigned in the order names are first seen, so compare materials by name
+    auto materialName = [](const ModelLoader& owner, MaterialId id) {
+        return id != NO_MATERIAL ? owner.getMaterials()[id].name : std::string();
+    };
+    // Statistics of an earlier load must not survive a stream
+    LoadOptions optimized;
+    optimized.indexedMesh = true;
+    optimized.optimizeMesh = true;
+    bool reset = streamer.loadModel(filename, optimized) && streamer.getOptimizeStats().acmrBefore > 0.0f &&
+                 streamer.getParseMemoryStats().arenaBytes > 0;
+    
+    size_t streamed = 0;
+    size_t batches = 0;
+    bool same = true;
+    streamer.streamModel(filename, [&](const std::vector<Triangle>& batch) {
+        ++batches;
+        for (const auto& triangle : batch) {
+            same = same && streamed < triangles.size() &&
+                   triangle.v0.x == triangles[streamed].v0.x && triangle.v2.z == triangles[streamed].v2.z &&
+                   materialName(streamer, triangle.materialId) == materialName(loader, triangles[streamed].materialId);
+            ++streamed;
+        }
+    }, 5);
+    same = same && streamed == triangles.size();
+    
+    std::cout << "批次数: " << batches << std::endl;
+    std::cout << "✓ 流式三角形与一次性加载一致: " << (same ? "通过" : "失败") << std::endl;
+    
+    const MeshOptimizeStats& optimizeStats = streamer.getOptimizeStats();
+    const ParseMemoryStats& parseStats = streamer.getParseMemoryStats();
+    reset = reset && optimizeStats.acmrBefore == 0.0f && optimizeStats.acmrAfter == 0.0f &&
+            parseStats.arenaBytes == 0 && parseStats.arrayBytes == 0 && parseStats.spareElements == 0;
+    std::cout << "✓ 流式加载清除上次加载的统计: " << (reset ? "通过" : "失败") << std::endl;
+    
+    // New usemtl names and a later mtllib grow the material table while the first triangles
+    // still wait in the batch; triangles kept from every batch must still find their material
+    {
+        std::ofstream out("stream_test_a.mtl");
+        out << "newmtl a\nNs 12\n";
+    }
+    {
+        std::ofstream out("stream_test_b.mtl");
+        out << "newmtl b\nNs 34\n";
+    }
+    {
+        std::ofstream out("stream_test.obj");
+        out << "mtllib stream_test_a.mtl\nv 0 0 0\nv 1 0 0\nv 0 1 0\nusemtl a\nf 1 2 3\n";
+        for (int i = 0; i < 40; ++i) {
+            out << "usemtl u" << i << "\nf 1 2 3\n";
+        }
+        out << "mtllib stream_test_b.mtl\nusemtl b\nf 1 2 3\nusemtl a\nf 1 2 3\n";
+    }
+    std::vector<Triangle> kept;
+    streamer.streamModel("stream_test.obj", [&](const std::vector<Triangle>& batch) {
+        kept.insert(kept.end(), batch.begin(), batch.end());
+    }, 1);
+    bool stable = kept.size() == 43;
+    size_t withMaterial = 0;
+    for (const auto& triangle : kept) {
+        const Material* material = triangle.getMaterial(streamer.getMaterials());
+        if (material == nullptr) {
+            continue;
+        }
+        ++withMaterial;
+        stable = stable && material->shininess == (material->name == "a" ? 12.0f : 34.0f);
+    }
+    stable = stable && withMaterial == 3 && kept[0].getMaterial(streamer.getMaterials())->name == "a" &&
+             kept[41].getMaterial(streamer.getMaterials())->name == "b";
+    for (const char* name : {"stream_test.obj", "stream_test_a.mtl", "stream_test_b.mtl"}) {
+        std::remove(name);
+    }
+    std::cout << "✓ 材质表增长后保留的三角形仍能找到材质: " << (stable ? "通过" : "失败") << std::endl;
+    return same && stable && reset;
+}
+
 /**
  * @brief Main test function
  * @param argc Command line argument count
@@ -279,6 +1492,102 @@ int main(int argc, char* argv[]) {
     } else {
         std::cout << "\n✗ 增强功能测试: 失败" << std::endl;
     }
+    
+    if (testIndexedMesh("../cube_with_textures.obj")) {
+        std::cout << "\n✓ 索引网格测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ 索引网格测试: 失败" << std::endl;
+    }
+    
+    if (testMeshOptimizer("../cube_with_textures.obj")) {
+        std::cout << "\n✓ 网格优化测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ 网格优化测试: 失败" << std::endl;
+    }
+    
+    if (testMeshSimplifier()) {
+        std::cout << "\n✓ LOD 生成测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ LOD 生成测试: 失败" << std::endl;
+    }
+    
+    if (testMeshletBuilder()) {
+        std::cout << "\n✓ Meshlet 测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ Meshlet 测试: 失败" << std::endl;
+    }
+    
+    if (testNormalGeneration("../smooth_cube.obj")) {
+        std::cout << "\n✓ 法线生成测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ 法线生成测试: 失败" << std::endl;
+    }
+    
+    if (testTangentGeneration("../cube_with_textures.obj")) {
+        std::cout << "\n✓ 切线生成测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ 切线生成测试: 失败" << std::endl;
+    }
+    
+    if (testGltfLoader()) {
+        std::cout << "\n✓ glTF 加载测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ glTF 加载测试: 失败" << std::endl;
+    }
+    
+    if (testPlyLoader()) {
+        std::cout << "\n✓ PLY 加载测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ PLY 加载测试: 失败" << std::endl;
+    }
+    
+    if (testArenaLoading("../cube_with_textures.obj")) {
+        std::cout << "\n✓ Arena 加载测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ Arena 加载测试: 失败" << std::endl;
+    }
+    
+    if (testFileWatcher()) {
+        std::cout << "\n✓ 文件监视测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ 文件监视测试: 失败" << std::endl;
+    }
+    
+    if (testMaterialCache()) {
+        std::cout << "\n✓ 共享材质缓存测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ 共享材质缓存测试: 失败" << std::endl;
+    }
+    
+    if (testPresizing()) {
+        std::cout << "\n✓ 预分配测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ 预分配测试: 失败" << std::endl;
+    }
+    
+    if (testMeshCache()) {
+        std::cout << "\n✓ 网格缓存测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ 网格缓存测试: 失败" << std::endl;
+    }
+    
+    if (testNumberParsing()) {
+        std::cout << "\n✓ 数字解析测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ 数字解析测试: 失败" << std::endl;
+    }
+    
+    if (testParallelParsing()) {
+        std::cout << "\n✓ 多线程解析一致性测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ 多线程解析一致性测试: 失败" << std::endl;
+    }
+    
+    if (testStreaming("../cube_with_textures.obj")) {
+        std::cout << "\n✓ 流式加载测试: 通过" << std::endl;
+    } else {
+        std::cout << "\n✗ 流式加载测试: 失败" << std::endl;
+    }
 
     std::cout << "\n[内存监控] 程序结束时内存: " << getMemoryUsageKB() << " KB" << std::endl;
     return 0;
@@ -13,4 +13,94 @@
 
 namespace Rasterizer {
 
+Rasterizer::Rasterizer(int width, int height)
+    : width(width)
+      , height(height)
+      , model(Eigen::Matrix4f::Identity())
+      , view(Eigen::Matrix4f::Identity())
+      , projection(Eigen::Matrix4f::Identity())
+{
+}
+
+void Rasterizer::set_viewport(int width, int height)
+{
+    this->width = width;
+    this->height = height;
+}
+
+void Rasterizer::set_model(const Eigen::Matrix4f& model)
+{
+    this->model = model;
+}
+
+void Rasterizer::set_view(const Eigen::Matrix4f& view)
+{
+    this->view = view;
+}
+
+void Rasterizer::set_projection(const Eigen::Matrix4f& projection)
+{
+    this->projection = projection;
+}
+
+Eigen::Matrix4f Rasterizer::get_mvp() const
+{
+    return projection * view * model;
+}
+
+Eigen::Matrix3f Rasterizer::get_normal_matrix() const
+{
+    return model.block<3, 3>(0, 0).inverse().transpose();
+}
+
+Eigen::Vector3f Rasterizer::get_eye_position() const
+{
+    // 视图矩阵的逆把相机原点变回世界空间
+    return view.inverse().block<3, 1>(0, 3);
+}
+
+bool Rasterizer::to_screen(const Eigen::Matrix4f& mvp, const Eigen::Vector3f& position, ScreenVertex& out) const
+{
+    Eigen::Vector4f clip = mvp * position.homogeneous();
+    if (clip.w() <= 1e-6f)
+    {
+        return false;
+    }
+    const float inv_w = 1.0f / clip.w();
+    // NDC -> 像素坐标，y 轴翻转为向下
+    out.x() = (clip.x() * inv_w + 1.0f) * 0.5f * static_cast<float>(width);
+    out.y() = (1.0f - clip.y() * inv_w) * 0.5f * static_cast<float>(height);
+    out.z() = clip.z() * inv_w;
+    out.w() = inv_w;
+    return true;
+}
+
+Eigen::Vector3f Rasterizer::unproject(const Eigen::Matrix4f& inv_view_projection, int x, int y, float depth) const
+{
+    Eigen::Vector4f ndc((static_cast<float>(x) + 0.5f) / static_cast<float>(width) * 2.0f - 1.0f,
+                        1.0f - (static_cast<float>(y) + 0.5f) / static_cast<float>(height) * 2.0f,
+                        depth,
+                        1.0f);
+    Eigen::Vector4f world = inv_view_projection * ndc;
+    return world.head<3>() / world.w();
+}
+
+bool Rasterizer::barycentric(const ScreenVertex& s0, const ScreenVertex& s1, const ScreenVertex& s2,
+                             int x, int y, Eigen::Vector3f& bary)
+{
+    const float area = (s1.x() - s0.x()) * (s2.y() - s0.y()) - (s1.y() - s0.y()) * (s2.x() - s0.x());
+    if (std::abs(area) < 1e-12f)
+    {
+        return false;
+    }
+    const float px = static_cast<float>(x) + 0.5f;
+    const float py = static_cast<float>(y) + 0.5f;
+    const float b0 = ((s2.x() - s1.x()) * (py - s1.y()) - (s2.y() - s1.y()) * (px - s1.x())) / area;
+    const float b1 = ((s0.x() - s2.x()) * (py - s2.y()) - (s0.y() - s2.y()) * (px - s2.x())) / area;
+    const float b2 = 1.0f - b0 - b1;
+    bary = Eigen::Vector3f(b0 * s0.w(), b1 * s1.w(), b2 * s2.w());
+    bary /= bary.sum();
+    return true;
+}
+
 } // Rasterizer
\ No newline at end of file
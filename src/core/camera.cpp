@@ -24,6 +24,16 @@ camera::camera(const Eigen::Vector3f& position, const Eigen::Vector3f& up, float
     update_camera_vectors();
 }
 
+Eigen::Matrix4f camera::get_view_matrix() const
+{
+    return utils::MVP::cal_view_matrix(position.cast<double>(), (position + front).cast<double>(),
+                                       up.cast<double>()).cast<float>();
+}
+
+Eigen::Matrix4f camera::get_projection_matrix(float aspect, float near, float far) const
+{
+    return utils::MVP::cal_projection_matrix(zoom, aspect, near, far).cast<float>();
+}
 
 void camera::update_camera_vectors()
 {
@@ -0,0 +1,159 @@
+/**
+ * @file cluster.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "core/cluster.h"
+#include "utils/parallel.h"
+#include <Eigen/Dense>
+#include <limits>
+
+namespace Rasterizer {
+
+namespace {
+
+Eigen::Vector3f ndc_to_view(const Eigen::Matrix4f& inv_projection, float x, float y, float z)
+{
+    Eigen::Vector4f p = inv_projection * Eigen::Vector4f(x, y, z, 1.0f);
+    return p.head<3>() / p.w();
+}
+
+} // namespace
+
+ClusterGrid::ClusterGrid(int tile_size, int slices)
+    : tile_size(tile_size)
+      , slices(slices)
+{
+}
+
+float ClusterGrid::slice_distance(int slice) const
+{
+    // 指数划分：near * (far / near)^(slice / slices)
+    return near_distance * std::pow(far_distance / near_distance, static_cast<float>(slice) / slices);
+}
+
+void ClusterGrid::build(int width, int height, const Eigen::Matrix4f& projection)
+{
+    clusters_x = (width + tile_size - 1) / tile_size;
+    clusters_y = (height + tile_size - 1) / tile_size;
+    const Eigen::Matrix4f inv_projection = projection.inverse();
+
+    // 近远平面距离，不依赖深度是正向还是反向
+    const float distance_a = -ndc_to_view(inv_projection, 0.0f, 0.0f, 1.0f).z();
+    const float distance_b = -ndc_to_view(inv_projection, 0.0f, 0.0f, -1.0f).z();
+    near_distance = std::max(std::min(distance_a, distance_b), 1e-4f);
+    far_distance = std::max(distance_a, distance_b);
+    slice_scale = static_cast<float>(slices) / std::log(far_distance / near_distance);
+
+    const size_t count = static_cast<size_t>(clusters_x) * clusters_y * slices;
+    bounds_min.resize(count);
+    bounds_max.resize(count);
+    offsets.assign(count + 1, 0);
+    slice_lights.resize(slices);
+
+    for (int cy = 0; cy < clusters_y; cy++)
+    {
+        for (int cx = 0; cx < clusters_x; cx++)
+        {
+            // tile 四个角的视线方向，缩放到 z = -1
+            const float left = static_cast<float>(cx * tile_size) / width * 2.0f - 1.0f;
+            const float right = static_cast<float>(std::min((cx + 1) * tile_size, width)) / width * 2.0f - 1.0f;
+            const float top = 1.0f - static_cast<float>(cy * tile_size) / height * 2.0f;
+            const float bottom = 1.0f - static_cast<float>(std::min((cy + 1) * tile_size, height)) / height * 2.0f;
+            Eigen::Vector3f rays[4] = {
+                ndc_to_view(inv_projection, left, bottom, 1.0f),
+                ndc_to_view(inv_projection, right, bottom, 1.0f),
+                ndc_to_view(inv_projection, right, top, 1.0f),
+                ndc_to_view(inv_projection, left, top, 1.0f)
+            };
+            for (auto& ray : rays)
+            {
+                ray /= -ray.z();
+            }
+
+            for (int slice = 0; slice < slices; slice++)
+            {
+                const float d0 = slice_distance(slice);
+                const float d1 = slice_distance(slice + 1);
+                Eigen::Vector3f box_min = Eigen::Vector3f::Constant(std::numeric_limits<float>::max());
+                Eigen::Vector3f box_max = Eigen::Vector3f::Constant(std::numeric_limits<float>::lowest());
+                for (const auto& ray : rays)
+                {
+                    box_min = box_min.cwiseMin(ray * d0).cwiseMin(ray * d1);
+                    box_max = box_max.cwiseMax(ray * d0).cwiseMax(ray * d1);
+                }
+                const size_t index = (static_cast<size_t>(slice) * clusters_y + cy) * clusters_x + cx;
+                bounds_min[index] = box_min;
+                bounds_max[index] = box_max;
+            }
+        }
+    }
+}
+
+void ClusterGrid::assign_lights(const std::vector<Light>& lights, const Eigen::Matrix4f& view)
+{
+    // 光源位置变换到视空间
+    std::vector<Light> view_lights(lights);
+    for (auto& light : view_lights)
+    {
+        light.position = (view * light.position.homogeneous()).head<3>();
+    }
+
+    const size_t clusters_per_slice = static_cast<size_t>(clusters_x) * clusters_y;
+    utils::parallel_for(static_cast<size_t>(slices), [&](size_t slice)
+    {
+        const float d0 = slice_distance(static_cast<int>(slice));
+        const float d1 = slice_distance(static_cast<int>(slice) + 1);
+
+        // 先按深度筛出可能影响这一层的光源
+        std::vector<uint32_t> candidates;
+        for (size_t i = 0; i < view_lights.size(); i++)
+        {
+            const Light& light = view_lights[i];
+            const float distance = -light.position.z();
+            if (light.type == LightType::Directional ||
+                (distance + light.range >= d0 && distance - light.range <= d1))
+            {
+                candidates.push_back(static_cast<uint32_t>(i));
+            }
+        }
+
+        std::vector<uint32_t>& result = slice_lights[slice];
+        result.clear();
+        const size_t first = slice * clusters_per_slice;
+        for (size_t cluster = first; cluster < first + clusters_per_slice; cluster++)
+        {
+            uint32_t count = 0;
+            for (uint32_t i : candidates)
+            {
+                if (light_affects_box(view_lights[i], bounds_min[cluster], bounds_max[cluster]))
+                {
+                    result.push_back(i);
+                    count++;
+                }
+            }
+            offsets[cluster + 1] = count;
+        }
+    });
+
+    // 前缀和得到每个 cluster 的起始位置，各层结果按顺序拼接
+    offsets[0] = 0;
+    for (size_t i = 1; i < offsets.size(); i++)
+    {
+        offsets[i] += offsets[i - 1];
+    }
+    light_indices.resize(offsets.back());
+    utils::parallel_for(static_cast<size_t>(slices), [&](size_t slice)
+    {
+        std::copy(slice_lights[slice].begin(), slice_lights[slice].end(),
+                  light_indices.begin() + offsets[slice * clusters_per_slice]);
+    });
+}
+
+} // Rasterizer
@@ -0,0 +1,276 @@
+/**
+ * @file deferred.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "core/deferred.h"
+#include "core/shader.h"
+#include "utils/parallel.h"
+#include <algorithm>
+#include <limits>
+
+namespace Rasterizer {
+
+DeferredRenderer::DeferredRenderer(int width, int height)
+    : rasterizer(width, height)
+      , ambient(Eigen::Vector3f::Constant(0.1f))
+      , background(Eigen::Vector3f::Zero())
+{
+    gbuffer.resize(width, height);
+    color_buffer.resize(static_cast<size_t>(width) * height, Eigen::Vector3f::Zero());
+}
+
+void DeferredRenderer::clear()
+{
+    const int width = rasterizer.get_width();
+    const int height = rasterizer.get_height();
+    ambient_colors.clear();
+    ambient_slots.clear();
+    if (gbuffer.width != width || gbuffer.height != height)
+    {
+        gbuffer.resize(width, height);
+        color_buffer.resize(static_cast<size_t>(width) * height);
+        return;
+    }
+    gbuffer.clear();
+}
+
+void DeferredRenderer::geometry_pass(const std::vector<Triangle>& triangles, const std::vector<Material>& materials,
+                                     const TextureMap* textures)
+{
+    const Transform transform = current_transform();
+    for (const auto& triangle : triangles)
+    {
+        ScreenVertex s[3];
+        if (!project(triangle, transform, s))
+        {
+            continue;
+        }
+        // 材质常量每个三角形只取一次
+        const MaterialState state = material_state(shader::triangle_material(triangle, materials),
+                                                   shader::diffuse_texture(triangle, materials, textures));
+        rasterize(triangle, s, transform, state);
+    }
+}
+
+void DeferredRenderer::geometry_pass(const DrawBatchList& batches)
+{
+    if (batches.get_triangles() == nullptr)
+    {
+        return;
+    }
+    const auto& triangles = *batches.get_triangles();
+    const auto& order = batches.get_order();
+    const Transform transform = current_transform();
+    for (const auto& batch : batches.get_batches())
+    {
+        const MaterialState state = material_state(*batch.material, batch.texture);
+        for (uint32_t i = batch.first; i < batch.first + batch.count; i++)
+        {
+            const Triangle& triangle = triangles[order[i]];
+            ScreenVertex s[3];
+            if (project(triangle, transform, s))
+            {
+                rasterize(triangle, s, transform, state);
+            }
+        }
+    }
+}
+
+DeferredRenderer::Transform DeferredRenderer::current_transform() const
+{
+    return {rasterizer.get_mvp(), rasterizer.get_model(), rasterizer.get_normal_matrix()};
+}
+
+DeferredRenderer::MaterialState DeferredRenderer::material_state(const Material& material, const Texture* texture)
+{
+    MaterialState state;
+    state.diffuse = Eigen::Vector3f(material.diffuse[0], material.diffuse[1], material.diffuse[2]);
+    state.ambient = ambient_slot(Eigen::Vector3f(material.ambient[0], material.ambient[1], material.ambient[2]));
+    state.specular = pack_rgba8(Eigen::Vector3f(material.specular[0], material.specular[1], material.specular[2]),
+                                encode_shininess(material.shininess));
+    state.texture = texture;
+    return state;
+}
+
+uint32_t DeferredRenderer::ambient_slot(const Eigen::Vector3f& color)
+{
+    const uint32_t key = pack_rgba8(color, 0);
+    auto it = ambient_slots.find(key);
+    if (it != ambient_slots.end())
+    {
+        return it->second;
+    }
+    uint32_t slot = 0;
+    if (ambient_colors.size() < MAX_AMBIENT_COLORS)
+    {
+        slot = static_cast<uint32_t>(ambient_colors.size());
+        ambient_colors.push_back(color);
+    }
+    else
+    {
+        // 表已满，使用最接近的颜色
+        for (uint32_t i = 1; i < ambient_colors.size(); i++)
+        {
+            if ((ambient_colors[i] - color).squaredNorm() < (ambient_colors[slot] - color).squaredNorm())
+            {
+                slot = i;
+            }
+        }
+    }
+    ambient_slots.emplace(key, slot);
+    return slot;
+}
+
+bool DeferredRenderer::project(const Triangle& triangle, const Transform& transform, ScreenVertex s[3]) const
+{
+    return rasterizer.to_screen(transform.mvp, Eigen::Vector3f(triangle.v0.x, triangle.v0.y, triangle.v0.z), s[0]) &&
+           rasterizer.to_screen(transform.mvp, Eigen::Vector3f(triangle.v1.x, triangle.v1.y, triangle.v1.z), s[1]) &&
+           rasterizer.to_screen(transform.mvp, Eigen::Vector3f(triangle.v2.x, triangle.v2.y, triangle.v2.z), s[2]);
+}
+
+void DeferredRenderer::rasterize(const Triangle& triangle, const ScreenVertex s[3], const Transform& transform,
+                                 const MaterialState& state)
+{
+    const int width = gbuffer.width;
+    const int height = gbuffer.height;
+
+    // 世界空间法线，没有顶点法线时使用面法线
+    Eigen::Vector3f n[3];
+    if (triangle.hasNormals)
+    {
+        n[0] = transform.normal_matrix * Eigen::Vector3f(triangle.n0.x, triangle.n0.y, triangle.n0.z);
+        n[1] = transform.normal_matrix * Eigen::Vector3f(triangle.n1.x, triangle.n1.y, triangle.n1.z);
+        n[2] = transform.normal_matrix * Eigen::Vector3f(triangle.n2.x, triangle.n2.y, triangle.n2.z);
+    }
+    else
+    {
+        Eigen::Vector3f w0 = (transform.model * Eigen::Vector4f(triangle.v0.x, triangle.v0.y, triangle.v0.z, 1.0f)).head<3>();
+        Eigen::Vector3f w1 = (transform.model * Eigen::Vector4f(triangle.v1.x, triangle.v1.y, triangle.v1.z, 1.0f)).head<3>();
+        Eigen::Vector3f w2 = (transform.model * Eigen::Vector4f(triangle.v2.x, triangle.v2.y, triangle.v2.z, 1.0f)).head<3>();
+        n[0] = n[1] = n[2] = (w1 - w0).cross(w2 - w0);
+    }
+
+    Rasterizer::rasterize_triangle(s[0], s[1], s[2], 0, 0, width, height,
+        [&](int x, int y, float z, const Eigen::Vector3f& bary)
+        {
+            const size_t index = static_cast<size_t>(y) * width + x;
+            // 深度测试，同时丢弃近远平面之外的像素
+            if (z <= gbuffer.depth[index] || z > 1.0f || z < -1.0f)
+            {
+                return;
+            }
+            gbuffer.depth[index] = z;
+
+            Eigen::Vector3f normal = (bary[0] * n[0] + bary[1] * n[1] + bary[2] * n[2]).normalized();
+            gbuffer.normal[index] = encode_octahedral(normal);
+
+            Eigen::Vector3f albedo = state.diffuse;
+            if (state.texture != nullptr)
+            {
+                const float u = bary[0] * triangle.t0.u + bary[1] * triangle.t1.u + bary[2] * triangle.t2.u;
+                const float v = bary[0] * triangle.t0.v + bary[1] * triangle.t1.v + bary[2] * triangle.t2.v;
+                albedo = albedo.cwiseProduct(state.texture->sample(u, v));
+            }
+            gbuffer.albedo[index] = pack_rgba8(albedo, state.ambient);
+            gbuffer.specular[index] = state.specular;
+        });
+}
+
+void DeferredRenderer::lighting_pass(const std::vector<Light>& lights)
+{
+    const Eigen::Matrix4f inv_view_projection = (rasterizer.get_projection() * rasterizer.get_view()).inverse();
+    const Eigen::Vector3f eye = rasterizer.get_eye_position();
+    const int tiles_x = (gbuffer.width + TILE_SIZE - 1) / TILE_SIZE;
+    const int tiles_y = (gbuffer.height + TILE_SIZE - 1) / TILE_SIZE;
+
+    tile_lights.resize(static_cast<size_t>(tiles_x) * tiles_y);
+    utils::parallel_for(static_cast<size_t>(tiles_x) * tiles_y, [&](size_t tile)
+    {
+        shade_tile(static_cast<int>(tile % tiles_x), static_cast<int>(tile / tiles_x),
+                   lights, inv_view_projection, eye, tile_lights[tile]);
+    });
+}
+
+void DeferredRenderer::shade_tile(int tile_x, int tile_y, const std::vector<Light>& lights,
+                                  const Eigen::Matrix4f& inv_view_projection, const Eigen::Vector3f& eye,
+                                  std::vector<const Light*>& tile_lights)
+{
+    const int x_begin = tile_x * TILE_SIZE;
+    const int y_begin = tile_y * TILE_SIZE;
+    const int x_end = std::min(x_begin + TILE_SIZE, gbuffer.width);
+    const int y_end = std::min(y_begin + TILE_SIZE, gbuffer.height);
+
+    // 还原 tile 内各像素的世界坐标并求包围盒
+    Eigen::Vector3f positions[TILE_SIZE * TILE_SIZE];
+    Eigen::Vector3f box_min = Eigen::Vector3f::Constant(std::numeric_limits<float>::max());
+    Eigen::Vector3f box_max = Eigen::Vector3f::Constant(std::numeric_limits<float>::lowest());
+    bool any_geometry = false;
+    for (int y = y_begin; y < y_end; y++)
+    {
+        for (int x = x_begin; x < x_end; x++)
+        {
+            const float depth = gbuffer.depth[static_cast<size_t>(y) * gbuffer.width + x];
+            if (depth == GBuffer::EMPTY_DEPTH)
+            {
+                continue;
+            }
+            Eigen::Vector3f& position = positions[(y - y_begin) * TILE_SIZE + (x - x_begin)];
+            position = rasterizer.unproject(inv_view_projection, x, y, depth);
+            box_min = box_min.cwiseMin(position);
+            box_max = box_max.cwiseMax(position);
+            any_geometry = true;
+        }
+    }
+
+    // 剔除影响范围与包围盒不相交的光源
+    tile_lights.clear();
+    if (any_geometry)
+    {
+        for (const auto& light : lights)
+        {
+            if (light_affects_box(light, box_min, box_max))
+            {
+                tile_lights.push_back(&light);
+            }
+        }
+    }
+
+    for (int y = y_begin; y < y_end; y++)
+    {
+        for (int x = x_begin; x < x_end; x++)
+        {
+            const size_t index = static_cast<size_t>(y) * gbuffer.width + x;
+            if (gbuffer.depth[index] == GBuffer::EMPTY_DEPTH)
+            {
+                color_buffer[index] = background;
+                continue;
+            }
+
+            const uint32_t albedo = gbuffer.albedo[index];
+            const uint32_t specular = gbuffer.specular[index];
+            Surface surface;
+            surface.position = positions[(y - y_begin) * TILE_SIZE + (x - x_begin)];
+            surface.normal = decode_octahedral(gbuffer.normal[index]);
+            surface.albedo = unpack_rgb8(albedo);
+            surface.ambient = ambient_colors[albedo >> 24];
+            surface.specular = unpack_rgb8(specular);
+            surface.shininess = decode_shininess(specular >> 24);
+
+            Eigen::Vector3f color = shader::ambient(surface, ambient);
+            for (const Light* light : tile_lights)
+            {
+                color += shader::blinn_phong(surface, *light, eye);
+            }
+            color_buffer[index] = color;
+        }
+    }
+}
+
+} // Rasterizer
@@ -0,0 +1,154 @@
+/**
+ * @file draw_batch.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "core/draw_batch.h"
+#include "core/shader.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace Rasterizer {
+
+namespace {
+
+constexpr int PERMUTATION_SHIFT = 24;
+constexpr uint32_t SLOT_MASK = (1u << PERMUTATION_SHIFT) - 1;
+
+/**
+ * @brief 材质序号对应的着色状态
+ */
+struct MaterialSlot {
+    const Material* material;
+    const Texture* texture;  // 有纹理坐标的三角形使用的纹理
+    bool texture_resolved;   // 纹理只在第一次遇到有纹理坐标的三角形时查找
+};
+
+} // namespace
+
+void DrawBatchList::clear()
+{
+    triangles = nullptr;
+    materials = nullptr;
+    textures = nullptr;
+    batches.clear();
+    order.clear();
+    unsorted_state_changes = 0;
+}
+
+void DrawBatchList::build(const std::vector<Triangle>& triangles, const std::vector<Material>& materials,
+                          const TextureMap* textures)
+{
+    clear();
+    this->triangles = &triangles;
+    this->materials = &materials;
+    this->textures = textures;
+    if (triangles.empty())
+    {
+        return;
+    }
+
+    // 每个三角形的排序键，材质与上一个三角形相同时不查表
+    std::vector<uint32_t> keys(triangles.size());
+    std::vector<MaterialSlot> slots;
+    std::unordered_map<const Material*, uint32_t> slot_ids;
+    const Material* last_material = nullptr;
+    uint32_t slot = 0;
+    for (size_t i = 0; i < triangles.size(); i++)
+    {
+        const Triangle& triangle = triangles[i];
+        const Material* material = &shader::triangle_material(triangle, materials);
+        if (material != last_material || slots.empty())
+        {
+            auto inserted = slot_ids.emplace(material, static_cast<uint32_t>(slots.size()));
+            if (inserted.second)
+            {
+                slots.push_back({material, nullptr, false});
+            }
+            slot = inserted.first->second;
+            last_material = material;
+        }
+
+        uint32_t permutation = triangle.hasNormals ? SHADER_VERTEX_NORMALS : SHADER_DEFAULT;
+        if (triangle.hasTextures)
+        {
+            MaterialSlot& state = slots[slot];
+            if (!state.texture_resolved)
+            {
+                state.texture = shader::diffuse_texture(triangle, materials, textures);
+                state.texture_resolved = true;
+            }
+            if (state.texture != nullptr)
+            {
+                permutation |= SHADER_TEXTURED;
+            }
+        }
+        keys[i] = (permutation << PERMUTATION_SHIFT) | (slot & SLOT_MASK);
+        if (i == 0 || keys[i] != keys[i - 1])
+        {
+            unsorted_state_changes++;
+        }
+    }
+
+    // 统计每个键的三角形数，不同的键通常只有几十个
+    std::unordered_map<uint32_t, uint32_t> batch_ids;
+    uint32_t last_key = keys[0];
+    uint32_t* last_count = nullptr;
+    for (uint32_t key : keys)
+    {
+        if (last_count == nullptr || key != last_key)
+        {
+            auto inserted = batch_ids.emplace(key, 0u);
+            if (inserted.second)
+            {
+                DrawBatch batch;
+                batch.key = key;
+                batch.permutation = static_cast<uint8_t>(key >> PERMUTATION_SHIFT);
+                batch.material = slots[key & SLOT_MASK].material;
+                batch.texture = (batch.permutation & SHADER_TEXTURED) ? slots[key & SLOT_MASK].texture : nullptr;
+                batch.first = 0;
+                batch.count = 0;
+                batches.push_back(batch);
+            }
+            last_key = key;
+            last_count = &inserted.first->second;
+        }
+        ++*last_count;
+    }
+
+    // 批次按键排序后求前缀和，再稳定地分发三角形下标
+    std::sort(batches.begin(), batches.end(), [](const DrawBatch& a, const DrawBatch& b)
+    {
+        return a.key < b.key;
+    });
+    uint32_t first = 0;
+    for (uint32_t b = 0; b < batches.size(); b++)
+    {
+        uint32_t& entry = batch_ids[batches[b].key];
+        batches[b].first = first;
+        batches[b].count = entry;
+        first += entry;
+        entry = batches[b].first;  // 之后作为写入位置
+    }
+
+    order.resize(triangles.size());
+    last_key = keys[0];
+    uint32_t* cursor = &batch_ids[last_key];
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        if (keys[i] != last_key)
+        {
+            last_key = keys[i];
+            cursor = &batch_ids[last_key];
+        }
+        order[(*cursor)++] = static_cast<uint32_t>(i);
+    }
+}
+
+} // Rasterizer
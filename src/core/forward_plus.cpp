@@ -0,0 +1,460 @@
+/**
+ * @file forward_plus.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "core/forward_plus.h"
+#include "core/shader.h"
+#include "utils/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Rasterizer {
+
+namespace {
+
+constexpr float EMPTY_DEPTH = -std::numeric_limits<float>::infinity();
+
+/**
+ * @brief NDC 坐标变换到视空间
+ */
+Eigen::Vector3f ndc_to_view(const Eigen::Matrix4f& inv_projection, float x, float y, float z)
+{
+    Eigen::Vector4f p = inv_projection * Eigen::Vector4f(x, y, z, 1.0f);
+    return p.head<3>() / p.w();
+}
+
+} // namespace
+
+ForwardPlusRenderer::ForwardPlusRenderer(int width, int height)
+    : rasterizer(width, height)
+      , cluster_projection(Eigen::Matrix4f::Zero())
+      , cluster_width(0)
+      , cluster_height(0)
+      , ambient(Eigen::Vector3f::Constant(0.1f))
+      , background(Eigen::Vector3f::Zero())
+      , light_culling(LightCulling::Tiled)
+      , tiles_x(0)
+      , tiles_y(0)
+{
+    resize_buffers();
+}
+
+void ForwardPlusRenderer::resize_buffers()
+{
+    const int width = rasterizer.get_width();
+    const int height = rasterizer.get_height();
+    tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+    tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+    const size_t tiles = static_cast<size_t>(tiles_x) * tiles_y;
+    tile_bins.resize(tiles);
+    tile_lights.resize(tiles);
+    tile_depth_min.resize(tiles);
+    tile_depth_max.resize(tiles);
+    depth.resize(static_cast<size_t>(width) * height);
+    color_buffer.resize(static_cast<size_t>(width) * height);
+}
+
+void ForwardPlusRenderer::clear()
+{
+    draws.clear();
+    if (depth.size() != static_cast<size_t>(rasterizer.get_width()) * rasterizer.get_height())
+    {
+        resize_buffers();
+    }
+}
+
+void ForwardPlusRenderer::draw(const std::vector<Triangle>& triangles, const std::vector<Material>& materials,
+                               const Eigen::Matrix4f& model, const TextureMap* textures)
+{
+    rasterizer.set_model(model);
+    Draw record;
+    record.triangles = &triangles;
+    record.materials = &materials;
+    record.textures = textures;
+    record.batches = nullptr;
+    record.model = model;
+    record.normal_matrix = rasterizer.get_normal_matrix();
+    draws.push_back(record);
+}
+
+void ForwardPlusRenderer::draw(const DrawBatchList& batches, const Eigen::Matrix4f& model)
+{
+    if (batches.get_triangles() == nullptr)
+    {
+        return;
+    }
+    rasterizer.set_model(model);
+    Draw record;
+    record.triangles = batches.get_triangles();
+    record.materials = batches.get_materials();
+    record.textures = batches.get_textures();
+    record.batches = &batches;
+    record.model = model;
+    record.normal_matrix = rasterizer.get_normal_matrix();
+    draws.push_back(record);
+}
+
+void ForwardPlusRenderer::render(const std::vector<Light>& lights)
+{
+    bin_triangles();
+
+    const size_t tiles = static_cast<size_t>(tiles_x) * tiles_y;
+    utils::parallel_for(tiles, [&](size_t tile)
+    {
+        depth_prepass(static_cast<int>(tile));
+    });
+
+    if (light_culling == LightCulling::Tiled)
+    {
+        const Eigen::Matrix4f inv_projection = rasterizer.get_projection().inverse();
+        utils::parallel_for(tiles, [&](size_t tile)
+        {
+            cull_lights(static_cast<int>(tile), lights, inv_projection);
+        });
+    }
+    else if (light_culling == LightCulling::Clustered)
+    {
+        // cluster 包围盒只在投影或视口改变时重建
+        if (cluster_width != rasterizer.get_width() || cluster_height != rasterizer.get_height() ||
+            cluster_projection != rasterizer.get_projection())
+        {
+            cluster_width = rasterizer.get_width();
+            cluster_height = rasterizer.get_height();
+            cluster_projection = rasterizer.get_projection();
+            cluster_grid.build(cluster_width, cluster_height, cluster_projection);
+        }
+        cluster_grid.assign_lights(lights, rasterizer.get_view());
+    }
+
+    // 视空间深度 = -(view 第三行 . 世界坐标)
+    const Eigen::Vector4f view_depth_row = -rasterizer.get_view().row(2).transpose();
+    const Eigen::Vector3f eye = rasterizer.get_eye_position();
+    utils::parallel_for(tiles, [&](size_t tile)
+    {
+        shade(static_cast<int>(tile), lights, eye, view_depth_row);
+    });
+}
+
+void ForwardPlusRenderer::bin_triangles()
+{
+    screen_triangles.clear();
+    for (auto& bin : tile_bins)
+    {
+        bin.clear();
+    }
+
+    for (size_t d = 0; d < draws.size(); d++)
+    {
+        const Draw& draw = draws[d];
+        rasterizer.set_model(draw.model);
+        const Eigen::Matrix4f mvp = rasterizer.get_mvp();
+        const auto& triangles = *draw.triangles;
+        ScreenTriangle screen;
+        screen.draw = static_cast<uint32_t>(d);
+        if (draw.batches == nullptr)
+        {
+            screen.batch = NO_BATCH;
+            for (size_t i = 0; i < triangles.size(); i++)
+            {
+                screen.triangle = static_cast<uint32_t>(i);
+                bin_triangle(screen, triangles[i], mvp);
+            }
+            continue;
+        }
+
+        // 按批次顺序分箱，每个 tile 的三角形列表也按批次排列
+        const auto& batches = draw.batches->get_batches();
+        const auto& order = draw.batches->get_order();
+        for (uint32_t b = 0; b < batches.size(); b++)
+        {
+            screen.batch = b;
+            for (uint32_t i = batches[b].first; i < batches[b].first + batches[b].count; i++)
+            {
+                screen.triangle = order[i];
+                bin_triangle(screen, triangles[order[i]], mvp);
+            }
+        }
+    }
+}
+
+void ForwardPlusRenderer::bin_triangle(const ScreenTriangle& screen_in, const Triangle& triangle,
+                                       const Eigen::Matrix4f& mvp)
+{
+    ScreenTriangle screen = screen_in;
+    if (!rasterizer.to_screen(mvp, Eigen::Vector3f(triangle.v0.x, triangle.v0.y, triangle.v0.z), screen.s[0]) ||
+        !rasterizer.to_screen(mvp, Eigen::Vector3f(triangle.v1.x, triangle.v1.y, triangle.v1.z), screen.s[1]) ||
+        !rasterizer.to_screen(mvp, Eigen::Vector3f(triangle.v2.x, triangle.v2.y, triangle.v2.z), screen.s[2]))
+    {
+        return;
+    }
+
+    // 屏幕包围盒覆盖的 tile
+    const float width = static_cast<float>(rasterizer.get_width());
+    const float height = static_cast<float>(rasterizer.get_height());
+    const float min_x = std::min({screen.s[0].x(), screen.s[1].x(), screen.s[2].x()});
+    const float max_x = std::max({screen.s[0].x(), screen.s[1].x(), screen.s[2].x()});
+    const float min_y = std::min({screen.s[0].y(), screen.s[1].y(), screen.s[2].y()});
+    const float max_y = std::max({screen.s[0].y(), screen.s[1].y(), screen.s[2].y()});
+    if (max_x < 0.0f || max_y < 0.0f || min_x >= width || min_y >= height)
+    {
+        return;
+    }
+    const int tx0 = std::max(0, static_cast<int>(min_x) / TILE_SIZE);
+    const int tx1 = std::min(tiles_x - 1, static_cast<int>(max_x) / TILE_SIZE);
+    const int ty0 = std::max(0, static_cast<int>(min_y) / TILE_SIZE);
+    const int ty1 = std::min(tiles_y - 1, static_cast<int>(max_y) / TILE_SIZE);
+
+    const uint32_t index = static_cast<uint32_t>(screen_triangles.size());
+    screen_triangles.push_back(screen);
+    for (int ty = ty0; ty <= ty1; ty++)
+    {
+        for (int tx = tx0; tx <= tx1; tx++)
+        {
+            tile_bins[static_cast<size_t>(ty) * tiles_x + tx].push_back(index);
+        }
+    }
+}
+
+void ForwardPlusRenderer::depth_prepass(int tile)
+{
+    const int width = rasterizer.get_width();
+    const int x_begin = (tile % tiles_x) * TILE_SIZE;
+    const int y_begin = (tile / tiles_x) * TILE_SIZE;
+    const int x_end = std::min(x_begin + TILE_SIZE, width);
+    const int y_end = std::min(y_begin + TILE_SIZE, rasterizer.get_height());
+
+    for (int y = y_begin; y < y_end; y++)
+    {
+        std::fill_n(depth.begin() + static_cast<size_t>(y) * width + x_begin, x_end - x_begin, EMPTY_DEPTH);
+    }
+    for (uint32_t index : tile_bins[tile])
+    {
+        const ScreenTriangle& screen = screen_triangles[index];
+        Rasterizer::rasterize_depth(screen.s[0], screen.s[1], screen.s[2], x_begin, y_begin, x_end, y_end,
+            [&](int x, int y, float z)
+            {
+                float& stored = depth[static_cast<size_t>(y) * width + x];
+                if (z > stored && z <= 1.0f && z >= -1.0f)
+                {
+                    stored = z;
+                }
+            });
+    }
+
+    // tile 的深度范围
+    float depth_min = std::numeric_limits<float>::max();
+    float depth_max = std::numeric_limits<float>::lowest();
+    for (int y = y_begin; y < y_end; y++)
+    {
+        for (int x = x_begin; x < x_end; x++)
+        {
+            const float z = depth[static_cast<size_t>(y) * width + x];
+            if (z != EMPTY_DEPTH)
+            {
+                depth_min = std::min(depth_min, z);
+                depth_max = std::max(depth_max, z);
+            }
+        }
+    }
+    tile_depth_min[tile] = depth_min;
+    tile_depth_max[tile] = depth_max;
+}
+
+void ForwardPlusRenderer::cull_lights(int tile, const std::vector<Light>& lights,
+                                      const Eigen::Matrix4f& inv_projection)
+{
+    std::vector<uint32_t>& result = tile_lights[tile];
+    result.clear();
+    if (tile_depth_min[tile] > tile_depth_max[tile])
+    {
+        // tile 内没有几何体
+        return;
+    }
+
+    const float width = static_cast<float>(rasterizer.get_width());
+    const float height = static_cast<float>(rasterizer.get_height());
+    const int x_begin = (tile % tiles_x) * TILE_SIZE;
+    const int y_begin = (tile / tiles_x) * TILE_SIZE;
+    const int x_end = std::min(x_begin + TILE_SIZE, rasterizer.get_width());
+    const int y_end = std::min(y_begin + TILE_SIZE, rasterizer.get_height());
+
+    // tile 四个角在视空间中的方向（相机位于原点）
+    const float left = static_cast<float>(x_begin) / width * 2.0f - 1.0f;
+    const float right = static_cast<float>(x_end) / width * 2.0f - 1.0f;
+    const float top = 1.0f - static_cast<float>(y_begin) / height * 2.0f;
+    const float bottom = 1.0f - static_cast<float>(y_end) / height * 2.0f;
+    const float plane_z = tile_depth_max[tile];
+    const Eigen::Vector3f corners[4] = {
+        ndc_to_view(inv_projection, left, bottom, plane_z),
+        ndc_to_view(inv_projection, right, bottom, plane_z),
+        ndc_to_view(inv_projection, right, top, plane_z),
+        ndc_to_view(inv_projection, left, top, plane_z)
+    };
+    const Eigen::Vector3f center = (corners[0] + corners[1] + corners[2] + corners[3]) * 0.25f;
+
+    // 过原点的四个侧面，法线朝向 tile 内部
+    Eigen::Vector3f planes[4];
+    for (int i = 0; i < 4; i++)
+    {
+        planes[i] = corners[i].cross(corners[(i + 1) % 4]).normalized();
+        if (planes[i].dot(center) < 0.0f)
+        {
+            planes[i] = -planes[i];
+        }
+    }
+
+    // 深度范围换算为到相机的距离
+    const float distance_a = -ndc_to_view(inv_projection, 0.0f, 0.0f, tile_depth_min[tile]).z();
+    const float distance_b = -ndc_to_view(inv_projection, 0.0f, 0.0f, tile_depth_max[tile]).z();
+    const float near_distance = std::min(distance_a, distance_b);
+    const float far_distance = std::max(distance_a, distance_b);
+
+    const Eigen::Matrix4f& view = rasterizer.get_view();
+    for (size_t i = 0; i < lights.size(); i++)
+    {
+        const Light& light = lights[i];
+        if (light.type == LightType::Directional)
+        {
+            result.push_back(static_cast<uint32_t>(i));
+            continue;
+        }
+
+        const Eigen::Vector3f position = (view * light.position.homogeneous()).head<3>();
+        const float distance = -position.z();
+        if (distance + light.range < near_distance || distance - light.range > far_distance)
+        {
+            continue;
+        }
+        bool inside = true;
+        for (const auto& plane : planes)
+        {
+            if (plane.dot(position) < -light.range)
+            {
+                inside = false;
+                break;
+            }
+        }
+        if (inside)
+        {
+            result.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+void ForwardPlusRenderer::shade(int tile, const std::vector<Light>& lights, const Eigen::Vector3f& eye,
+                                const Eigen::Vector4f& view_depth_row)
+{
+    const int width = rasterizer.get_width();
+    const int x_begin = (tile % tiles_x) * TILE_SIZE;
+    const int y_begin = (tile / tiles_x) * TILE_SIZE;
+    const int x_end = std::min(x_begin + TILE_SIZE, width);
+    const int y_end = std::min(y_begin + TILE_SIZE, rasterizer.get_height());
+
+    for (int y = y_begin; y < y_end; y++)
+    {
+        std::fill_n(color_buffer.begin() + static_cast<size_t>(y) * width + x_begin, x_end - x_begin, background);
+    }
+
+    // 片元的光源列表
+    const uint32_t* tile_begin = tile_lights[tile].data();
+    const uint32_t* tile_end = tile_begin + tile_lights[tile].size();
+    Surface material_surface;
+    const Texture* texture = nullptr;
+    uint32_t current_draw = NO_BATCH;
+    uint32_t current_batch = NO_BATCH;
+    for (uint32_t index : tile_bins[tile])
+    {
+        const ScreenTriangle& screen = screen_triangles[index];
+        const Draw& draw = draws[screen.draw];
+        const Triangle& triangle = (*draw.triangles)[screen.triangle];
+
+        // 三角形设置：世界空间位置、法线和材质
+        Eigen::Vector3f positions[3] = {
+            (draw.model * Eigen::Vector4f(triangle.v0.x, triangle.v0.y, triangle.v0.z, 1.0f)).head<3>(),
+            (draw.model * Eigen::Vector4f(triangle.v1.x, triangle.v1.y, triangle.v1.z, 1.0f)).head<3>(),
+            (draw.model * Eigen::Vector4f(triangle.v2.x, triangle.v2.y, triangle.v2.z, 1.0f)).head<3>()
+        };
+        Eigen::Vector3f normals[3];
+        if (triangle.hasNormals)
+        {
+            normals[0] = draw.normal_matrix * Eigen::Vector3f(triangle.n0.x, triangle.n0.y, triangle.n0.z);
+            normals[1] = draw.normal_matrix * Eigen::Vector3f(triangle.n1.x, triangle.n1.y, triangle.n1.z);
+            normals[2] = draw.normal_matrix * Eigen::Vector3f(triangle.n2.x, triangle.n2.y, triangle.n2.z);
+        }
+        else
+        {
+            normals[0] = normals[1] = normals[2] = (positions[1] - positions[0]).cross(positions[2] - positions[0]);
+        }
+        if (screen.batch == NO_BATCH)
+        {
+            shader::apply_material(shader::triangle_material(triangle, *draw.materials), material_surface);
+            texture = shader::diffuse_texture(triangle, *draw.materials, draw.textures);
+            current_batch = NO_BATCH;
+        }
+        else if (screen.batch != current_batch || screen.draw != current_draw)
+        {
+            // 批次切换时才重新设置材质
+            const DrawBatch& batch = draw.batches->get_batches()[screen.batch];
+            shader::apply_material(*batch.material, material_surface);
+            texture = batch.texture;
+            current_draw = screen.draw;
+            current_batch = screen.batch;
+        }
+
+        Rasterizer::rasterize_triangle(screen.s[0], screen.s[1], screen.s[2], x_begin, y_begin, x_end, y_end,
+            [&](int x, int y, float z, const Eigen::Vector3f& bary)
+            {
+                const size_t pixel = static_cast<size_t>(y) * width + x;
+                // 深度预渲染之后只有可见片元能通过相等测试
+                if (z != depth[pixel])
+                {
+                    return;
+                }
+                Surface surface = material_surface;
+                surface.position = bary[0] * positions[0] + bary[1] * positions[1] + bary[2] * positions[2];
+                surface.normal = (bary[0] * normals[0] + bary[1] * normals[1] + bary[2] * normals[2]).normalized();
+                if (texture != nullptr)
+                {
+                    const float u = bary[0] * triangle.t0.u + bary[1] * triangle.t1.u + bary[2] * triangle.t2.u;
+                    const float v = bary[0] * triangle.t0.v + bary[1] * triangle.t1.v + bary[2] * triangle.t2.v;
+                    surface.albedo = surface.albedo.cwiseProduct(texture->sample(u, v));
+                }
+
+                Eigen::Vector3f color = shader::ambient(surface, ambient);
+                if (light_culling == LightCulling::None)
+                {
+                    for (const auto& light : lights)
+                    {
+                        color += shader::blinn_phong(surface, light, eye);
+                    }
+                }
+                else
+                {
+                    const uint32_t* begin = tile_begin;
+                    const uint32_t* end = tile_end;
+                    if (light_culling == LightCulling::Clustered)
+                    {
+                        const float distance = view_depth_row.dot(surface.position.homogeneous());
+                        const uint32_t cluster = cluster_grid.cluster_index(x, y, distance);
+                        begin = cluster_grid.lights_begin(cluster);
+                        end = cluster_grid.lights_end(cluster);
+                    }
+                    for (const uint32_t* light = begin; light != end; ++light)
+                    {
+                        color += shader::blinn_phong(surface, lights[*light], eye);
+                    }
+                }
+                color_buffer[pixel] = color;
+            });
+    }
+}
+
+} // Rasterizer
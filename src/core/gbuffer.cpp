@@ -0,0 +1,113 @@
+/**
+ * @file gbuffer.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "core/gbuffer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Rasterizer {
+
+void GBuffer::resize(int width, int height)
+{
+    this->width = width;
+    this->height = height;
+    const size_t size = static_cast<size_t>(width) * height;
+    normal.resize(size);
+    albedo.resize(size);
+    specular.resize(size);
+    depth.resize(size);
+    clear();
+}
+
+void GBuffer::clear()
+{
+    // 只有深度需要清空，光照阶段会跳过空像素，不会读取其它属性
+    std::fill(depth.begin(), depth.end(), EMPTY_DEPTH);
+}
+
+namespace {
+
+float sign_not_zero(float v)
+{
+    return v >= 0.0f ? 1.0f : -1.0f;
+}
+
+uint32_t to_snorm16(float v)
+{
+    const float clamped = std::clamp(v, -1.0f, 1.0f);
+    return static_cast<uint16_t>(static_cast<int16_t>(std::lround(clamped * 32767.0f)));
+}
+
+float from_snorm16(uint32_t bits)
+{
+    return std::max(static_cast<float>(static_cast<int16_t>(bits & 0xFFFF)) / 32767.0f, -1.0f);
+}
+
+uint32_t to_unorm8(float v)
+{
+    return static_cast<uint32_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+}
+
+} // namespace
+
+uint32_t encode_octahedral(const Eigen::Vector3f& n)
+{
+    // 投影到八面体 |x| + |y| + |z| = 1，下半球折叠到外侧的三角形
+    const float l1 = std::abs(n.x()) + std::abs(n.y()) + std::abs(n.z());
+    float x = n.x() / l1;
+    float y = n.y() / l1;
+    if (n.z() < 0.0f)
+    {
+        const float fx = (1.0f - std::abs(y)) * sign_not_zero(x);
+        const float fy = (1.0f - std::abs(x)) * sign_not_zero(y);
+        x = fx;
+        y = fy;
+    }
+    return to_snorm16(x) | (to_snorm16(y) << 16);
+}
+
+Eigen::Vector3f decode_octahedral(uint32_t packed)
+{
+    const float x = from_snorm16(packed);
+    const float y = from_snorm16(packed >> 16);
+    Eigen::Vector3f n(x, y, 1.0f - std::abs(x) - std::abs(y));
+    if (n.z() < 0.0f)
+    {
+        n.x() = (1.0f - std::abs(y)) * sign_not_zero(x);
+        n.y() = (1.0f - std::abs(x)) * sign_not_zero(y);
+    }
+    return n.normalized();
+}
+
+uint32_t pack_rgba8(const Eigen::Vector3f& color, uint32_t alpha)
+{
+    return to_unorm8(color.x()) | (to_unorm8(color.y()) << 8) | (to_unorm8(color.z()) << 16) | (alpha << 24);
+}
+
+Eigen::Vector3f unpack_rgb8(uint32_t packed)
+{
+    return Eigen::Vector3f(static_cast<float>(packed & 0xFF),
+                           static_cast<float>((packed >> 8) & 0xFF),
+                           static_cast<float>((packed >> 16) & 0xFF)) / 255.0f;
+}
+
+uint32_t encode_shininess(float shininess)
+{
+    return to_unorm8(std::sqrt(std::max(shininess, 0.0f) / 1000.0f));
+}
+
+float decode_shininess(uint32_t code)
+{
+    const float v = static_cast<float>(code) / 255.0f;
+    return v * v * 1000.0f;
+}
+
+} // Rasterizer
@@ -0,0 +1,238 @@
+/**
+ * @file hot_reload.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 
+ * @version 0.1
+ * @date 2026/10/19
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "core/hot_reload.h"
+#include <cstring>
+#include <utility>
+
+namespace Rasterizer {
+
+namespace {
+
+// 后台线程每次等待文件变化的时长，也是 stop 最长的等待时间
+constexpr int POLL_INTERVAL_MS = 100;
+
+bool same_material(const Material& a, const Material& b)
+{
+    return a.name == b.name && a.defined == b.defined && a.shininess == b.shininess &&
+           std::memcmp(a.ambient, b.ambient, sizeof(a.ambient)) == 0 &&
+           std::memcmp(a.diffuse, b.diffuse, sizeof(a.diffuse)) == 0 &&
+           std::memcmp(a.specular, b.specular, sizeof(a.specular)) == 0 &&
+           a.diffuseTexture == b.diffuseTexture;
+}
+
+} // namespace
+
+std::shared_ptr<ModelSnapshot> make_snapshot(const std::shared_ptr<const ModelLoader>& loader)
+{
+    auto snapshot = std::make_shared<ModelSnapshot>();
+    snapshot->geometry = loader;
+    snapshot->materials = std::shared_ptr<const std::vector<Material>>(loader, &loader->getMaterials());
+    snapshot->triangles = std::shared_ptr<const std::vector<Triangle>>(loader, &loader->getTriangles());
+    return snapshot;
+}
+
+ModelReloader::ModelReloader(std::string path, const LoadOptions& options, TextureDecoder decoder)
+    : path(std::move(path))
+      , options(options)
+      , decoder(std::move(decoder))
+{
+}
+
+ModelReloader::~ModelReloader()
+{
+    stop();
+}
+
+bool ModelReloader::load()
+{
+    std::lock_guard<std::mutex> lock(update_mutex);
+    // 先监视 OBJ，加载期间的修改也会被下一次 update 发现
+    watcher.watch(path);
+    auto loader = std::make_shared<ModelLoader>();
+    if (!loader->loadModel(path, options))
+    {
+        set_error("无法加载 " + path);
+        return false;
+    }
+
+    auto next = make_snapshot(loader);
+    ReloadResult result;
+    next->textures = build_textures(*loader, *next->materials, nullptr, {}, result);
+    const std::shared_ptr<const ModelSnapshot> previous = current();
+    next->version = previous ? previous->version + 1 : 1;
+    watch_files(*loader, *next->materials);
+    snapshot.store(std::move(next));
+    set_error("");
+    return true;
+}
+
+ReloadResult ModelReloader::update(int timeout_ms)
+{
+    std::lock_guard<std::mutex> lock(update_mutex);
+    ReloadResult result;
+    const std::shared_ptr<const ModelSnapshot> previous = current();
+    if (!previous)
+    {
+        return result;
+    }
+    std::unordered_set<std::string> changed;
+    for (const std::string& file : watcher.poll(timeout_ms))
+    {
+        changed.insert(FileWatcher::normalize(file));
+    }
+    if (changed.empty())
+    {
+        return result;
+    }
+
+    bool materials_changed = false;
+    for (const std::string& source : previous->geometry->getMaterialSources())
+    {
+        materials_changed = materials_changed || changed.count(FileWatcher::normalize(source)) != 0;
+    }
+
+    auto next = std::make_shared<ModelSnapshot>();
+    if (changed.count(FileWatcher::normalize(path)) != 0)
+    {
+        auto loader = std::make_shared<ModelLoader>();
+        if (!loader->loadModel(path, options))
+        {
+            // 多半是文件还没写完，保留旧快照等待下一次修改
+            result.failed = true;
+            set_error("无法加载 " + path);
+            return result;
+        }
+        next = make_snapshot(loader);
+        result.geometry = true;
+    }
+    else if (materials_changed)
+    {
+        // 几何体不变，只换材质表；三角形只保存 MaterialId，直接共享
+        next->geometry = previous->geometry;
+        next->materials = std::make_shared<const std::vector<Material>>(previous->geometry->reloadMaterials());
+        next->triangles = previous->triangles;
+        result.materials = true;
+    }
+    else
+    {
+        next->geometry = previous->geometry;
+        next->materials = previous->materials;
+        next->triangles = previous->triangles;
+    }
+
+    const std::vector<Material>& old_table = *previous->materials;
+    const std::vector<Material>& new_table = *next->materials;
+    for (size_t i = 0; i < new_table.size(); i++)
+    {
+        if (i >= old_table.size() || !same_material(old_table[i], new_table[i]))
+        {
+            result.changed_materials++;
+        }
+    }
+    next->textures = build_textures(*next->geometry, new_table, previous.get(), changed, result);
+    if (!result.published())
+    {
+        // 例如没有材质使用的纹理文件
+        return result;
+    }
+    next->version = previous->version + 1;
+    watch_files(*next->geometry, new_table);
+    snapshot.store(std::move(next));
+    set_error("");
+    return result;
+}
+
+void ModelReloader::start(std::function<void(const ReloadResult&)> on_reload)
+{
+    stop();
+    running = true;
+    worker = std::thread([this, on_reload = std::move(on_reload)]()
+    {
+        while (running)
+        {
+            const ReloadResult result = update(POLL_INTERVAL_MS);
+            if (result.published() && on_reload)
+            {
+                on_reload(result);
+            }
+        }
+    });
+}
+
+void ModelReloader::stop()
+{
+    running = false;
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+std::string ModelReloader::get_last_error() const
+{
+    std::lock_guard<std::mutex> lock(error_mutex);
+    return last_error;
+}
+
+TextureMap ModelReloader::build_textures(const ModelLoader& geometry, const std::vector<Material>& materials,
+                                         const ModelSnapshot* previous,
+                                         const std::unordered_set<std::string>& changed_files,
+                                         ReloadResult& result) const
+{
+    TextureMap textures;
+    for (const Material& material : materials)
+    {
+        if (!material.defined || !material.hasDiffuseTexture() || textures.count(material.diffuseTexture) != 0)
+        {
+            continue;
+        }
+        const std::string file = material.getFullTexturePath(geometry.getBasePath());
+        // 路径相同且文件没有变化的纹理直接沿用，像素在两份快照之间共享
+        if (previous != nullptr && changed_files.count(FileWatcher::normalize(file)) == 0)
+        {
+            auto it = previous->textures.find(material.diffuseTexture);
+            if (it != previous->textures.end())
+            {
+                textures.emplace(material.diffuseTexture, it->second);
+                result.reused_textures++;
+                continue;
+            }
+        }
+        textures.emplace(material.diffuseTexture, decoder ? decoder(file) : Texture());
+        result.decoded_textures++;
+    }
+    return textures;
+}
+
+void ModelReloader::watch_files(const ModelLoader& geometry, const std::vector<Material>& materials)
+{
+    watcher.watch(path);
+    for (const std::string& source : geometry.getMaterialSources())
+    {
+        watcher.watch(source);
+    }
+    for (const Material& material : materials)
+    {
+        if (material.defined && material.hasDiffuseTexture())
+        {
+            watcher.watch(material.getFullTexturePath(geometry.getBasePath()));
+        }
+    }
+}
+
+void ModelReloader::set_error(const std::string& message)
+{
+    std::lock_guard<std::mutex> lock(error_mutex);
+    last_error = message;
+}
+
+} // Rasterizer
@@ -0,0 +1,60 @@
+/**
+ * @file light.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "core/light.h"
+#include <cmath>
+#include "utils/MVP.h"
+
+namespace Rasterizer {
+
+size_t LightList::add_point_light(const Eigen::Vector3f& position, const Eigen::Vector3f& color,
+                                  float intensity, float range)
+{
+    Light light;
+    light.type = LightType::Point;
+    light.position = position;
+    light.color = color;
+    light.intensity = intensity;
+    light.range = range;
+    lights.push_back(light);
+    return lights.size() - 1;
+}
+
+size_t LightList::add_spot_light(const Eigen::Vector3f& position, const Eigen::Vector3f& direction,
+                                 const Eigen::Vector3f& color, float intensity, float range,
+                                 float inner_angle, float outer_angle)
+{
+    Light light;
+    light.type = LightType::Spot;
+    light.position = position;
+    light.direction = direction.normalized();
+    light.color = color;
+    light.intensity = intensity;
+    light.range = range;
+    light.cos_inner = static_cast<float>(std::cos(inner_angle * M_PI / 180.0));
+    light.cos_outer = static_cast<float>(std::cos(outer_angle * M_PI / 180.0));
+    lights.push_back(light);
+    return lights.size() - 1;
+}
+
+size_t LightList::add_directional_light(const Eigen::Vector3f& direction, const Eigen::Vector3f& color,
+                                        float intensity)
+{
+    Light light;
+    light.type = LightType::Directional;
+    light.direction = direction.normalized();
+    light.color = color;
+    light.intensity = intensity;
+    lights.push_back(light);
+    return lights.size() - 1;
+}
+
+} // Rasterizer
@@ -0,0 +1,69 @@
+/**
+ * @file lod.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "core/lod.h"
+#include <algorithm>
+#include <limits>
+
+namespace Rasterizer {
+
+void LodModel::build(const LodChain& chain, const IndexedMesh& mesh)
+{
+    this->chain = chain;
+    levels.clear();
+    levels.reserve(chain.levels.size());
+    for (size_t i = 0; i < chain.levels.size(); i++)
+    {
+        levels.push_back(chain.getTriangles(mesh, i));
+    }
+    // 只保留误差和包围球，索引已经展开到 levels 中
+    for (LodLevel& level : this->chain.levels)
+    {
+        level.indices.clear();
+        level.indices.shrink_to_fit();
+        level.submeshes.clear();
+    }
+}
+
+float LodModel::pixels_per_unit(const Rasterizer& rasterizer, const Eigen::Matrix4f& model) const
+{
+    const Eigen::Matrix4f& projection = rasterizer.get_projection();
+    const float half_height = 0.5f * static_cast<float>(rasterizer.get_height());
+    // 模型矩阵的最大缩放，误差和半径都按它放大
+    const Eigen::Matrix3f linear = model.block<3, 3>(0, 0);
+    const float scale = std::max({linear.col(0).norm(), linear.col(1).norm(), linear.col(2).norm()});
+
+    // 正交投影与距离无关
+    if (projection(3, 2) == 0.0f)
+    {
+        return half_height * projection(1, 1) * scale;
+    }
+
+    const Eigen::Vector4f center = model * Eigen::Vector4f(chain.center[0], chain.center[1], chain.center[2], 1.0f);
+    const float distance = (center.head<3>() - rasterizer.get_eye_position()).norm() - chain.radius * scale;
+    // 相机在包围球内时按近处处理，使用最细的层次
+    if (distance <= std::numeric_limits<float>::epsilon())
+    {
+        return std::numeric_limits<float>::max();
+    }
+    return half_height * projection(1, 1) * scale / distance;
+}
+
+size_t LodModel::select(const Rasterizer& rasterizer, const Eigen::Matrix4f& model, float max_pixel_error) const
+{
+    if (levels.empty())
+    {
+        return 0;
+    }
+    return chain.selectLevel(pixels_per_unit(rasterizer, model), max_pixel_error);
+}
+
+} // Rasterizer
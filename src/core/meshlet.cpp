@@ -0,0 +1,223 @@
+/**
+ * @file meshlet.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "core/meshlet.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Rasterizer {
+
+void MeshletModel::build(const MeshletMesh& meshlets, const IndexedMesh& mesh)
+{
+    this->meshlets = meshlets.meshlets;
+    triangles.clear();
+    triangles.reserve(meshlets.triangles.size() / 3);
+    for (const Meshlet& meshlet : meshlets.meshlets)
+    {
+        Triangle triangle;
+        triangle.hasTextures = mesh.hasTexCoords;
+        triangle.hasNormals = mesh.hasNormals;
+        triangle.materialId = meshlet.material;
+        const uint32_t* vertices = &meshlets.vertices[meshlet.vertexOffset];
+        const uint8_t* corners = &meshlets.triangles[meshlet.triangleOffset];
+        for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+        {
+            const MeshVertex v0 = mesh.vertex(vertices[corners[t * 3]]);
+            const MeshVertex v1 = mesh.vertex(vertices[corners[t * 3 + 1]]);
+            const MeshVertex v2 = mesh.vertex(vertices[corners[t * 3 + 2]]);
+            triangle.v0 = v0.position;
+            triangle.v1 = v1.position;
+            triangle.v2 = v2.position;
+            triangle.t0 = v0.texCoord;
+            triangle.t1 = v1.texCoord;
+            triangle.t2 = v2.texCoord;
+            triangle.n0 = v0.normal;
+            triangle.n1 = v1.normal;
+            triangle.n2 = v2.normal;
+            triangles.push_back(triangle);
+        }
+    }
+}
+
+void DepthPyramid::build(const std::vector<float>& depth, int width, int height)
+{
+    levels.resize(1);
+    levels[0] = {width, height, depth};
+    while (levels.back().width > 1 || levels.back().height > 1)
+    {
+        const Level& fine = levels.back();
+        Level coarse;
+        coarse.width = (fine.width + 1) / 2;
+        coarse.height = (fine.height + 1) / 2;
+        coarse.depth.resize(static_cast<size_t>(coarse.width) * coarse.height);
+        for (int y = 0; y < coarse.height; y++)
+        {
+            // 奇数尺寸的最后一行 / 列只有一个子纹素
+            const int y0 = y * 2;
+            const int y1 = std::min(y0 + 1, fine.height - 1);
+            for (int x = 0; x < coarse.width; x++)
+            {
+                const int x0 = x * 2;
+                const int x1 = std::min(x0 + 1, fine.width - 1);
+                coarse.depth[static_cast<size_t>(y) * coarse.width + x] = std::min(
+                    std::min(fine.depth[static_cast<size_t>(y0) * fine.width + x0],
+                             fine.depth[static_cast<size_t>(y0) * fine.width + x1]),
+                    std::min(fine.depth[static_cast<size_t>(y1) * fine.width + x0],
+                             fine.depth[static_cast<size_t>(y1) * fine.width + x1]));
+            }
+        }
+        levels.push_back(std::move(coarse));
+    }
+}
+
+float DepthPyramid::farthest(int x_begin, int y_begin, int x_end, int y_end) const
+{
+    // 矩形在选中的层上最多覆盖 3x3 个纹素
+    const int extent = std::max(x_end - x_begin, y_end - y_begin);
+    size_t level = 0;
+    while ((extent >> level) > 1 && level + 1 < levels.size())
+    {
+        level++;
+    }
+    const Level& data = levels[level];
+    const int shift = static_cast<int>(level);
+    const int x0 = std::max(x_begin >> shift, 0);
+    const int y0 = std::max(y_begin >> shift, 0);
+    const int x1 = std::min(x_end >> shift, data.width - 1);
+    const int y1 = std::min(y_end >> shift, data.height - 1);
+    float result = std::numeric_limits<float>::infinity();
+    for (int y = y0; y <= y1; y++)
+    {
+        for (int x = x0; x <= x1; x++)
+        {
+            result = std::min(result, data.depth[static_cast<size_t>(y) * data.width + x]);
+        }
+    }
+    return result;
+}
+
+void MeshletCuller::begin(const Rasterizer& rasterizer, const Eigen::Matrix4f& model, uint8_t culling,
+                          const DepthPyramid* pyramid)
+{
+    this->rasterizer = &rasterizer;
+    this->culling = culling;
+    this->pyramid = pyramid != nullptr && !pyramid->empty() ? pyramid : nullptr;
+    model_view = rasterizer.get_view() * model;
+
+    // Gribb-Hartmann：MVP 的行组合出模型空间的六个裁剪平面
+    const Eigen::Matrix4f mvp = rasterizer.get_projection() * model_view;
+    for (int i = 0; i < 3; i++)
+    {
+        planes[i * 2] = (mvp.row(3) + mvp.row(i)).transpose();
+        planes[i * 2 + 1] = (mvp.row(3) - mvp.row(i)).transpose();
+    }
+    for (Eigen::Vector4f& plane : planes)
+    {
+        const float length = plane.head<3>().norm();
+        if (length > 0.0f)
+        {
+            plane /= length;
+        }
+    }
+
+    const Eigen::Matrix3f linear = model.block<3, 3>(0, 0);
+    const float scales[3] = {linear.col(0).norm(), linear.col(1).norm(), linear.col(2).norm()};
+    scale = std::max({scales[0], scales[1], scales[2]});
+    // 法线锥只在相似变换下保持角度
+    const float min_scale = std::min({scales[0], scales[1], scales[2]});
+    if (min_scale < scale * 0.999f)
+    {
+        this->culling = static_cast<uint8_t>(this->culling & ~CULL_BACKFACE);
+    }
+    const Eigen::Vector4f eye_model = model.inverse() * rasterizer.get_eye_position().homogeneous();
+    eye[0] = eye_model.x();
+    eye[1] = eye_model.y();
+    eye[2] = eye_model.z();
+}
+
+bool MeshletCuller::visible(const Meshlet& meshlet, MeshletCullStats& stats) const
+{
+    stats.meshlets++;
+    const Eigen::Vector3f center(meshlet.center[0], meshlet.center[1], meshlet.center[2]);
+    if (culling & CULL_FRUSTUM)
+    {
+        for (const Eigen::Vector4f& plane : planes)
+        {
+            if (plane.head<3>().dot(center) + plane.w() < -meshlet.radius)
+            {
+                stats.frustum_culled++;
+                return false;
+            }
+        }
+    }
+    if ((culling & CULL_BACKFACE) && MeshletBuilder::isBackfacing(meshlet, eye))
+    {
+        stats.backface_culled++;
+        return false;
+    }
+    if ((culling & CULL_OCCLUSION) && pyramid != nullptr && occluded(center, meshlet.radius))
+    {
+        stats.occlusion_culled++;
+        return false;
+    }
+    stats.triangles += meshlet.triangleCount;
+    return true;
+}
+
+bool MeshletCuller::occluded(const Eigen::Vector3f& center, float radius) const
+{
+    const Eigen::Vector3f view_center = (model_view * center.homogeneous()).head<3>();
+    const float view_radius = radius * scale;
+    const Eigen::Matrix4f& projection = rasterizer->get_projection();
+
+    // 视空间包围盒的 8 个角点投影后的矩形包含整个球；有角点在相机后方时无法判断
+    float min_x = std::numeric_limits<float>::max();
+    float min_y = std::numeric_limits<float>::max();
+    float max_x = std::numeric_limits<float>::lowest();
+    float max_y = std::numeric_limits<float>::lowest();
+    for (int corner = 0; corner < 8; corner++)
+    {
+        const Eigen::Vector3f offset((corner & 1) ? view_radius : -view_radius,
+                                     (corner & 2) ? view_radius : -view_radius,
+                                     (corner & 4) ? view_radius : -view_radius);
+        ScreenVertex screen;
+        if (!rasterizer->to_screen(projection, view_center + offset, screen))
+        {
+            return false;
+        }
+        min_x = std::min(min_x, screen.x());
+        min_y = std::min(min_y, screen.y());
+        max_x = std::max(max_x, screen.x());
+        max_y = std::max(max_y, screen.y());
+    }
+    const int width = rasterizer->get_width();
+    const int height = rasterizer->get_height();
+    if (max_x < 0.0f || max_y < 0.0f || min_x >= static_cast<float>(width) || min_y >= static_cast<float>(height))
+    {
+        return false;  // 屏幕外的部分交给视锥测试
+    }
+
+    // 球上离相机最近的点（视空间 z 最大）的深度，深度越大越近
+    ScreenVertex nearest;
+    if (!rasterizer->to_screen(projection, view_center + Eigen::Vector3f(0.0f, 0.0f, view_radius), nearest) ||
+        nearest.z() > 1.0f)
+    {
+        return false;
+    }
+    const float farthest = pyramid->farthest(std::max(static_cast<int>(std::floor(min_x)), 0),
+                                             std::max(static_cast<int>(std::floor(min_y)), 0),
+                                             std::min(static_cast<int>(std::ceil(max_x)), width - 1),
+                                             std::min(static_cast<int>(std::ceil(max_y)), height - 1));
+    return nearest.z() < farthest;
+}
+
+} // Rasterizer
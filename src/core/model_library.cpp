@@ -0,0 +1,294 @@
+/**
+ * @file model_library.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 
+ * @version 0.1
+ * @date 2026/10/19
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "core/model_library.h"
+#include <chrono>
+#include <exception>
+#include <utility>
+#include <FileWatcher.h>
+#include "utils/parallel.h"
+
+namespace Rasterizer {
+
+ModelLibrary::ModelLibrary(const LoadOptions& options, TextureDecoder decoder, unsigned int threads)
+    : options(options)
+      , decoder(std::move(decoder))
+{
+    const unsigned int count = threads != 0 ? threads : utils::worker_count();
+    workers.reserve(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        workers.emplace_back([this]() { work(); });
+    }
+}
+
+ModelLibrary::~ModelLibrary()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        pending -= queue.size();
+        queue.clear();
+    }
+    work_ready.notify_all();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ModelLibrary::set_callback(ModelCallback callback)
+{
+    this->callback = std::move(callback);
+}
+
+size_t ModelLibrary::add(const std::string& path)
+{
+    size_t index;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        index = entries.size();
+        entries.emplace_back();
+        entries.back().status.path = path;
+        queue.push_back(index);
+        pending++;
+    }
+    work_ready.notify_one();
+    return index;
+}
+
+size_t ModelLibrary::add(const std::vector<std::string>& paths)
+{
+    size_t first;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        first = entries.size();
+        for (const std::string& path : paths)
+        {
+            queue.push_back(entries.size());
+            entries.emplace_back();
+            entries.back().status.path = path;
+        }
+        pending += paths.size();
+    }
+    work_ready.notify_all();
+    return first;
+}
+
+void ModelLibrary::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    all_done.wait(lock, [this]() { return pending == 0; });
+}
+
+size_t ModelLibrary::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+ModelStatus ModelLibrary::status(size_t index) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.at(index).status;
+}
+
+std::shared_ptr<const ModelSnapshot> ModelLibrary::model(size_t index) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.at(index).model;
+}
+
+LibraryStats ModelLibrary::stats() const
+{
+    LibraryStats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.models = entries.size();
+        for (const Entry& entry : entries)
+        {
+            stats.loaded += entry.status.state == ModelState::Loaded ? 1 : 0;
+            stats.failed += entry.status.state == ModelState::Failed ? 1 : 0;
+        }
+    }
+    stats.material_files = material_cache.size();
+    stats.shared_material_files = material_cache.reuses();
+    std::lock_guard<std::mutex> lock(texture_mutex);
+    stats.textures = textures.size();
+    stats.shared_textures = texture_reuses;
+    return stats;
+}
+
+void ModelLibrary::work()
+{
+    for (;;)
+    {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            work_ready.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty())
+            {
+                return;
+            }
+            index = queue.front();
+            queue.pop_front();
+        }
+        load(index);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending--;
+            if (pending == 0)
+            {
+                all_done.notify_all();
+            }
+        }
+    }
+}
+
+void ModelLibrary::load(size_t index)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const auto elapsed = [&start]()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    std::string path;
+    update_status(index, [&path](ModelStatus& status)
+    {
+        status.state = ModelState::Parsing;
+        path = status.path;
+    });
+
+    try
+    {
+        // 并行来自同时加载多个模型，单个模型不再拆分线程
+        auto loader = std::make_shared<ModelLoader>();
+        loader->setThreadCount(1);
+        loader->setMaterialCache(&material_cache);
+        if (!loader->loadModel(path, options))
+        {
+            update_status(index, [&](ModelStatus& status)
+            {
+                status.state = ModelState::Failed;
+                status.error = "无法加载 " + path;
+                status.seconds = elapsed();
+            });
+            return;
+        }
+        std::shared_ptr<ModelSnapshot> snapshot = make_snapshot(loader);
+        snapshot->version = 1;
+
+        // 纹理表的键是材质中写的文件名，同名只解码一次
+        std::vector<std::pair<std::string, std::string>> needed;
+        for (const Material& material : *snapshot->materials)
+        {
+            if (!material.defined || !material.hasDiffuseTexture() ||
+                !snapshot->textures.emplace(material.diffuseTexture, Texture()).second)
+            {
+                continue;
+            }
+            needed.emplace_back(material.diffuseTexture, material.getFullTexturePath(loader->getBasePath()));
+        }
+        update_status(index, [&needed](ModelStatus& status)
+        {
+            status.state = ModelState::Decoding;
+            status.textures_total = needed.size();
+        });
+        for (const auto& [name, file] : needed)
+        {
+            bool shared = false;
+            Texture texture = acquire_texture(file, shared);
+            const bool missing = texture.empty();
+            snapshot->textures[name] = std::move(texture);
+            update_status(index, [shared, missing](ModelStatus& status)
+            {
+                status.textures_ready++;
+                status.shared_textures += shared ? 1 : 0;
+                status.missing_textures += missing ? 1 : 0;
+            });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries[index].model = std::move(snapshot);
+        }
+        update_status(index, [&](ModelStatus& status)
+        {
+            status.state = ModelState::Loaded;
+            status.seconds = elapsed();
+        });
+    }
+    catch (const std::exception& error)
+    {
+        update_status(index, [&](ModelStatus& status)
+        {
+            status.state = ModelState::Failed;
+            status.error = error.what();
+            status.seconds = elapsed();
+        });
+    }
+}
+
+Texture ModelLibrary::acquire_texture(const std::string& file, bool& shared)
+{
+    const std::string key = FileWatcher::normalize(file);
+    std::promise<Texture> promise;
+    std::shared_future<Texture> pending_texture;
+    {
+        std::lock_guard<std::mutex> lock(texture_mutex);
+        auto it = textures.find(key);
+        if (it != textures.end())
+        {
+            texture_reuses++;
+            pending_texture = it->second;
+        }
+        else
+        {
+            textures.emplace(key, promise.get_future().share());
+        }
+    }
+    shared = pending_texture.valid();
+    if (shared)
+    {
+        // 其他模型正在（或已经）解码这张纹理
+        return pending_texture.get();
+    }
+
+    Texture texture;
+    try
+    {
+        texture = decoder ? decoder(file) : Texture();
+    }
+    catch (...)
+    {
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+    promise.set_value(texture);
+    return texture;
+}
+
+void ModelLibrary::update_status(size_t index, const std::function<void(ModelStatus&)>& change)
+{
+    ModelStatus status;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        change(entries[index].status);
+        status = entries[index].status;
+    }
+    if (callback)
+    {
+        callback(index, status);
+    }
+}
+
+} // Rasterizer
@@ -10,3 +10,96 @@
  */
 
 #include "core/shader.h"
+#include "core/shadow.h"
+#include <algorithm>
+#include <cmath>
+
+Eigen::Vector3f shader::blinn_phong(const Rasterizer::Surface& surface,
+                                    const Rasterizer::Light& light,
+                                    const Eigen::Vector3f& eye)
+{
+    Eigen::Vector3f to_light;
+    float radiance = light.intensity;
+    if (light.type == Rasterizer::LightType::Directional)
+    {
+        to_light = -light.direction;
+    }
+    else
+    {
+        to_light = light.position - surface.position;
+        const float distance = to_light.norm();
+        if (distance >= light.range || distance <= 1e-6f)
+        {
+            return Eigen::Vector3f::Zero();
+        }
+        to_light /= distance;
+        radiance *= Rasterizer::light_attenuation(distance, light.range);
+
+        if (light.type == Rasterizer::LightType::Spot)
+        {
+            // 内外锥之间平滑过渡
+            const float cos_angle = -to_light.dot(light.direction);
+            if (cos_angle <= light.cos_outer)
+            {
+                return Eigen::Vector3f::Zero();
+            }
+            const float t = std::clamp((cos_angle - light.cos_outer) /
+                                       std::max(light.cos_inner - light.cos_outer, 1e-6f), 0.0f, 1.0f);
+            radiance *= t * t * (3.0f - 2.0f * t);
+        }
+    }
+
+    const float n_dot_l = surface.normal.dot(to_light);
+    if (n_dot_l <= 0.0f)
+    {
+        return Eigen::Vector3f::Zero();
+    }
+    if (light.shadow_map != nullptr)
+    {
+        radiance *= light.shadow_map->visibility(surface.position, surface.normal);
+        if (radiance <= 0.0f)
+        {
+            return Eigen::Vector3f::Zero();
+        }
+    }
+
+    // 半程向量
+    Eigen::Vector3f to_eye = (eye - surface.position).normalized();
+    Eigen::Vector3f half = (to_light + to_eye).normalized();
+    const float n_dot_h = std::max(surface.normal.dot(half), 0.0f);
+
+    Eigen::Vector3f diffuse = surface.albedo * n_dot_l;
+    Eigen::Vector3f specular = surface.specular * std::pow(n_dot_h, surface.shininess);
+    return (diffuse + specular).cwiseProduct(light.color) * radiance;
+}
+
+void shader::apply_material(const Material& material, Rasterizer::Surface& surface)
+{
+    surface.ambient = Eigen::Vector3f(material.ambient[0], material.ambient[1], material.ambient[2]);
+    surface.albedo = Eigen::Vector3f(material.diffuse[0], material.diffuse[1], material.diffuse[2]);
+    surface.specular = Eigen::Vector3f(material.specular[0], material.specular[1], material.specular[2]);
+    surface.shininess = material.shininess;
+}
+
+const Material& shader::triangle_material(const Triangle& triangle, const std::vector<Material>& materials)
+{
+    static const Material default_material;
+    const Material* material = triangle.getMaterial(materials);
+    return material != nullptr ? *material : default_material;
+}
+
+const Rasterizer::Texture* shader::diffuse_texture(const Triangle& triangle,
+                                                   const std::vector<Material>& materials,
+                                                   const Rasterizer::TextureMap* textures)
+{
+    if (textures == nullptr || !triangle.hasTextures || !triangle.hasDiffuseTexture(materials))
+    {
+        return nullptr;
+    }
+    auto it = textures->find(triangle.getDiffuseTexture(materials));
+    if (it == textures->end() || it->second.empty())
+    {
+        return nullptr;
+    }
+    return &it->second;
+}
@@ -0,0 +1,255 @@
+/**
+ * @file shadow.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "core/shadow.h"
+#include "core/Rasterizer.h"
+#include "utils/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Rasterizer {
+
+namespace {
+
+constexpr float EMPTY_DEPTH = -std::numeric_limits<float>::infinity();
+
+Eigen::Vector3f ndc_to_view(const Eigen::Matrix4f& inv_projection, float x, float y, float z)
+{
+    Eigen::Vector4f p = inv_projection * Eigen::Vector4f(x, y, z, 1.0f);
+    return p.head<3>() / p.w();
+}
+
+} // namespace
+
+CascadedShadowMap::CascadedShadowMap(int resolution, int cascade_count)
+    : resolution(resolution)
+      , cascade_count(std::clamp(cascade_count, 1, MAX_CASCADES))
+      , stride(resolution + 2 * BORDER)
+      , view_depth_row(Eigen::Vector4f::Zero())
+{
+    for (int i = 0; i < this->cascade_count; i++)
+    {
+        cascades[i].view_projection = Eigen::Matrix4f::Identity();
+        cascades[i].depth.assign(static_cast<size_t>(stride) * stride, EMPTY_DEPTH);
+    }
+}
+
+void CascadedShadowMap::set_pcf_radius(int radius)
+{
+    pcf_radius = std::clamp(radius, 0, MAX_PCF_RADIUS);
+}
+
+void CascadedShadowMap::update(const Eigen::Matrix4f& view, const Eigen::Matrix4f& projection,
+                               const Eigen::Vector3f& light_direction)
+{
+    const Eigen::Matrix4f inv_projection = projection.inverse();
+    const Eigen::Matrix4f inv_view = view.inverse();
+    view_depth_row = -view.row(2).transpose();
+
+    // 相机近远平面距离
+    const float distance_a = -ndc_to_view(inv_projection, 0.0f, 0.0f, 1.0f).z();
+    const float distance_b = -ndc_to_view(inv_projection, 0.0f, 0.0f, -1.0f).z();
+    const float near_distance = std::max(std::min(distance_a, distance_b), 1e-4f);
+    float far_distance = std::max(distance_a, distance_b);
+    if (shadow_distance > 0.0f)
+    {
+        far_distance = std::min(far_distance, shadow_distance);
+    }
+
+    // 视锥四条棱的方向，缩放到 z = -1
+    Eigen::Vector3f rays[4] = {
+        ndc_to_view(inv_projection, -1.0f, -1.0f, 1.0f),
+        ndc_to_view(inv_projection, 1.0f, -1.0f, 1.0f),
+        ndc_to_view(inv_projection, 1.0f, 1.0f, 1.0f),
+        ndc_to_view(inv_projection, -1.0f, 1.0f, 1.0f)
+    };
+    for (auto& ray : rays)
+    {
+        ray /= -ray.z();
+    }
+
+    // 光源空间的旋转（光源朝 -z 方向看）
+    const Eigen::Vector3f direction = light_direction.normalized();
+    const Eigen::Vector3f up = std::abs(direction.y()) > 0.99f ? Eigen::Vector3f::UnitX() : Eigen::Vector3f::UnitY();
+    const Eigen::Matrix4f light_view = utils::MVP::cal_view_matrix(
+        Eigen::Vector3d::Zero(), direction.cast<double>(), up.cast<double>()).cast<float>();
+
+    float split_near = near_distance;
+    for (int i = 0; i < cascade_count; i++)
+    {
+        // 对数划分和均匀划分按 split_lambda 混合
+        const float t = static_cast<float>(i + 1) / cascade_count;
+        const float log_split = near_distance * std::pow(far_distance / near_distance, t);
+        const float uniform_split = near_distance + (far_distance - near_distance) * t;
+        const float split_far = split_lambda * log_split + (1.0f - split_lambda) * uniform_split;
+
+        // 子视锥的包围球，在视空间计算，半径与相机朝向无关
+        Eigen::Vector3f corners[8];
+        Eigen::Vector3f center = Eigen::Vector3f::Zero();
+        for (int c = 0; c < 4; c++)
+        {
+            corners[c] = rays[c] * split_near;
+            corners[c + 4] = rays[c] * split_far;
+            center += corners[c] + corners[c + 4];
+        }
+        center /= 8.0f;
+        float radius = 0.0f;
+        for (const auto& corner : corners)
+        {
+            radius = std::max(radius, (corner - center).norm());
+        }
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        // 包围球中心按 texel 对齐，相机平移时深度图内容只会整 texel 移动
+        Cascade& cascade = cascades[i];
+        cascade.split_far = split_far;
+        cascade.texel_size = 2.0f * radius / resolution;
+        Eigen::Vector3f light_center = (light_view * (inv_view * center.homogeneous())).head<3>();
+        light_center.x() = std::floor(light_center.x() / cascade.texel_size) * cascade.texel_size;
+        light_center.y() = std::floor(light_center.y() / cascade.texel_size) * cascade.texel_size;
+
+        const Eigen::Matrix4f orthographic = utils::MVP::cal_orthographic_matrix(
+            light_center.x() - radius, light_center.x() + radius,
+            light_center.y() - radius, light_center.y() + radius,
+            -(light_center.z() + radius), -(light_center.z() - radius)).cast<float>();
+        cascade.view_projection = orthographic * light_view;
+
+        split_near = split_far;
+    }
+}
+
+void CascadedShadowMap::draw(const std::vector<Triangle>& triangles, const Eigen::Matrix4f& model)
+{
+    draws.push_back({&triangles, model});
+}
+
+void CascadedShadowMap::render()
+{
+    // 级联数通常少于线程数，每个级联再按行带划分
+    const int bands = std::max(1, static_cast<int>(utils::worker_count()) / cascade_count);
+    const int band_height = (resolution + bands - 1) / bands;
+    utils::parallel_for(static_cast<size_t>(cascade_count) * bands, [&](size_t task)
+    {
+        const int cascade = static_cast<int>(task) / bands;
+        const int band = static_cast<int>(task) % bands;
+        const int y_begin = BORDER + band * band_height;
+        const int y_end = std::min(y_begin + band_height, BORDER + resolution);
+        if (y_begin < y_end)
+        {
+            render_band(cascade, y_begin, y_end);
+        }
+    });
+}
+
+void CascadedShadowMap::render_band(int index, int y_begin, int y_end)
+{
+    Cascade& cascade = cascades[index];
+    std::fill(cascade.depth.begin() + static_cast<size_t>(y_begin) * stride,
+              cascade.depth.begin() + static_cast<size_t>(y_end) * stride, EMPTY_DEPTH);
+
+    const float half = 0.5f * static_cast<float>(resolution);
+    for (const auto& draw : draws)
+    {
+        const Eigen::Matrix4f mvp = cascade.view_projection * draw.model;
+        for (const auto& triangle : *draw.triangles)
+        {
+            // 正交投影 w 恒为 1，直接换算到 texel 坐标
+            ScreenVertex s[3];
+            const ::Vertex* v[3] = {&triangle.v0, &triangle.v1, &triangle.v2};
+            for (int k = 0; k < 3; k++)
+            {
+                const Eigen::Vector4f p = mvp * Eigen::Vector4f(v[k]->x, v[k]->y, v[k]->z, 1.0f);
+                s[k] = ScreenVertex((p.x() + 1.0f) * half + BORDER, (1.0f - p.y()) * half + BORDER, p.z(), 1.0f);
+            }
+            if (std::max({s[0].y(), s[1].y(), s[2].y()}) < static_cast<float>(y_begin) ||
+                std::min({s[0].y(), s[1].y(), s[2].y()}) >= static_cast<float>(y_end))
+            {
+                continue;
+            }
+
+            Rasterizer::rasterize_depth(s[0], s[1], s[2], BORDER, y_begin, BORDER + resolution, y_end,
+                [&](int x, int y, float z)
+                {
+                    // 光源近平面之前的遮挡物钳制到近平面
+                    if (z < -1.0f)
+                    {
+                        return;
+                    }
+                    float& stored = cascade.depth[static_cast<size_t>(y) * stride + x];
+                    stored = std::max(stored, std::min(z, 1.0f));
+                });
+        }
+    }
+}
+
+int CascadedShadowMap::select_cascade(const Eigen::Vector3f& position) const
+{
+    const float distance = view_depth_row.dot(position.homogeneous());
+    for (int i = 0; i < cascade_count; i++)
+    {
+        if (distance <= cascades[i].split_far)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+float CascadedShadowMap::visibility(const Eigen::Vector3f& position, const Eigen::Vector3f& normal) const
+{
+    const int index = select_cascade(position);
+    if (index < 0)
+    {
+        return 1.0f;
+    }
+    const Cascade& cascade = cascades[index];
+
+    // 沿法线偏移后投影到深度图
+    const Eigen::Vector3f offset = position + normal * (normal_bias * cascade.texel_size);
+    const Eigen::Vector4f p = cascade.view_projection * offset.homogeneous();
+    if (p.x() < -1.0f || p.x() > 1.0f || p.y() < -1.0f || p.y() > 1.0f)
+    {
+        return 1.0f;
+    }
+    const float reference = std::min(p.z(), 1.0f) + depth_bias;
+
+    // 相对 texel 中心的坐标
+    const float half = 0.5f * static_cast<float>(resolution);
+    const float tx = (p.x() + 1.0f) * half + BORDER - 0.5f;
+    const float ty = (1.0f - p.y()) * half + BORDER - 0.5f;
+    const int x0 = static_cast<int>(std::floor(tx));
+    const int y0 = static_cast<int>(std::floor(ty));
+    const float fx = tx - static_cast<float>(x0);
+    const float fy = ty - static_cast<float>(y0);
+
+    // (2r + 2)^2 个 texel 的比较结果按双线性权重求和，边缘 texel 权重为小数部分
+    using Weights = Eigen::Array<float, Eigen::Dynamic, 1, 0, 2 * MAX_PCF_RADIUS + 2, 1>;
+    using Block = Eigen::Array<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor,
+                               2 * MAX_PCF_RADIUS + 2, 2 * MAX_PCF_RADIUS + 2>;
+    const int size = 2 * pcf_radius + 2;
+    Weights wx = Weights::Ones(size);
+    Weights wy = Weights::Ones(size);
+    wx[0] = 1.0f - fx;
+    wx[size - 1] = fx;
+    wy[0] = 1.0f - fy;
+    wy[size - 1] = fy;
+
+    // 边框保证窗口不会越界
+    const float* origin = cascade.depth.data() + static_cast<size_t>(y0 - pcf_radius) * stride + (x0 - pcf_radius);
+    Eigen::Map<const Block, 0, Eigen::OuterStride<>> window(origin, size, size, Eigen::OuterStride<>(stride));
+    const Block lit = (window <= reference).cast<float>();
+    const float sum = wy.matrix().dot(lit.matrix() * wx.matrix());
+    const float kernel = static_cast<float>(2 * pcf_radius + 1);
+    return sum / (kernel * kernel);
+}
+
+} // Rasterizer
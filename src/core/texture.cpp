@@ -0,0 +1,62 @@
+/**
+ * @file texture.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "core/texture.h"
+#include <cmath>
+
+namespace Rasterizer {
+
+Texture::Texture(int width, int height, int channels, const unsigned char* pixels)
+    : width(width)
+      , height(height)
+      , channels(channels)
+      , data(std::make_shared<const std::vector<unsigned char>>(pixels, pixels + static_cast<size_t>(width) * height * channels))
+{
+}
+
+Eigen::Vector3f Texture::texel(int x, int y) const
+{
+    // 重复寻址
+    x %= width;
+    y %= height;
+    if (x < 0) x += width;
+    if (y < 0) y += height;
+    const unsigned char* p = data->data() + (static_cast<size_t>(y) * width + x) * channels;
+    if (channels < 3)
+    {
+        // 灰度图
+        return Eigen::Vector3f::Constant(p[0] / 255.0f);
+    }
+    return Eigen::Vector3f(p[0], p[1], p[2]) / 255.0f;
+}
+
+Eigen::Vector3f Texture::sample(float u, float v) const
+{
+    if (empty())
+    {
+        return Eigen::Vector3f::Ones();
+    }
+    // 纹理坐标 v 向上，而图像第一行在顶部
+    const float fx = u * static_cast<float>(width) - 0.5f;
+    const float fy = (1.0f - v) * static_cast<float>(height) - 0.5f;
+    const float x0 = std::floor(fx);
+    const float y0 = std::floor(fy);
+    const float tx = fx - x0;
+    const float ty = fy - y0;
+    const int ix = static_cast<int>(x0);
+    const int iy = static_cast<int>(y0);
+
+    Eigen::Vector3f top = texel(ix, iy) * (1.0f - tx) + texel(ix + 1, iy) * tx;
+    Eigen::Vector3f bottom = texel(ix, iy + 1) * (1.0f - tx) + texel(ix + 1, iy + 1) * tx;
+    return top * (1.0f - ty) + bottom * ty;
+}
+
+} // Rasterizer
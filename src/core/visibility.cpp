@@ -0,0 +1,240 @@
+/**
+ * @file visibility.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#include "core/visibility.h"
+#include "core/shader.h"
+#include "utils/parallel.h"
+#include <algorithm>
+#include <limits>
+
+namespace Rasterizer {
+
+namespace {
+
+constexpr float EMPTY_DEPTH = -std::numeric_limits<float>::infinity();
+
+} // namespace
+
+VisibilityRenderer::VisibilityRenderer(int width, int height)
+    : rasterizer(width, height)
+      , ambient(Eigen::Vector3f::Constant(0.1f))
+      , background(Eigen::Vector3f::Zero())
+{
+    clear();
+}
+
+void VisibilityRenderer::clear()
+{
+    const size_t size = static_cast<size_t>(rasterizer.get_width()) * rasterizer.get_height();
+    draws.clear();
+    ids.assign(size, EMPTY_ID);
+    depth.assign(size, EMPTY_DEPTH);
+    color_buffer.resize(size);
+    depth_pyramid.clear();
+    depth_pyramid_valid = false;
+    meshlet_stats = MeshletCullStats();
+}
+
+uint32_t VisibilityRenderer::add_draw(const std::vector<Triangle>& triangles, const std::vector<Material>& materials,
+                                      const Eigen::Matrix4f& model, const TextureMap* textures)
+{
+    if (draws.size() >= MAX_DRAWS || triangles.size() > TRIANGLE_ID_MASK)
+    {
+        return EMPTY_ID;
+    }
+
+    rasterizer.set_model(model);
+    Draw record;
+    record.triangles = &triangles;
+    record.materials = &materials;
+    record.textures = textures;
+    record.model = model;
+    record.mvp = rasterizer.get_mvp();
+    record.normal_matrix = rasterizer.get_normal_matrix();
+    draws.push_back(record);
+    return static_cast<uint32_t>(draws.size() - 1);
+}
+
+void VisibilityRenderer::rasterize(const Triangle& triangle, const Eigen::Matrix4f& mvp, uint32_t id)
+{
+    ScreenVertex s0, s1, s2;
+    if (!rasterizer.to_screen(mvp, Eigen::Vector3f(triangle.v0.x, triangle.v0.y, triangle.v0.z), s0) ||
+        !rasterizer.to_screen(mvp, Eigen::Vector3f(triangle.v1.x, triangle.v1.y, triangle.v1.z), s1) ||
+        !rasterizer.to_screen(mvp, Eigen::Vector3f(triangle.v2.x, triangle.v2.y, triangle.v2.z), s2))
+    {
+        return;
+    }
+
+    // 只写深度和 ID，不插值任何属性
+    const int width = rasterizer.get_width();
+    Rasterizer::rasterize_depth(s0, s1, s2, 0, 0, width, rasterizer.get_height(),
+        [&](int x, int y, float z)
+        {
+            const size_t index = static_cast<size_t>(y) * width + x;
+            if (z <= depth[index] || z > 1.0f || z < -1.0f)
+            {
+                return;
+            }
+            depth[index] = z;
+            ids[index] = id;
+        });
+}
+
+bool VisibilityRenderer::draw(const std::vector<Triangle>& triangles, const std::vector<Material>& materials,
+                              const Eigen::Matrix4f& model, const TextureMap* textures)
+{
+    const uint32_t draw_id = add_draw(triangles, materials, model, textures);
+    if (draw_id == EMPTY_ID)
+    {
+        return false;
+    }
+    const Eigen::Matrix4f& mvp = draws.back().mvp;
+    for (size_t i = 0; i < triangles.size(); i++)
+    {
+        rasterize(triangles[i], mvp, pack_id(draw_id, static_cast<uint32_t>(i)));
+    }
+    depth_pyramid_valid = false;
+    return true;
+}
+
+bool VisibilityRenderer::draw(const MeshletModel& meshlets, const std::vector<Material>& materials,
+                              const Eigen::Matrix4f& model, const TextureMap* textures, uint8_t culling)
+{
+    const std::vector<Triangle>& triangles = meshlets.get_triangles();
+    const uint32_t draw_id = add_draw(triangles, materials, model, textures);
+    if (draw_id == EMPTY_ID)
+    {
+        return false;
+    }
+
+    // 之前的 draw 改变了深度缓冲时才重建金字塔
+    if ((culling & CULL_OCCLUSION) && !depth_pyramid_valid)
+    {
+        depth_pyramid.build(depth, rasterizer.get_width(), rasterizer.get_height());
+        depth_pyramid_valid = true;
+    }
+    MeshletCuller culler;
+    culler.begin(rasterizer, model, culling, (culling & CULL_OCCLUSION) ? &depth_pyramid : nullptr);
+
+    const Eigen::Matrix4f& mvp = draws.back().mvp;
+    for (const Meshlet& meshlet : meshlets.get_meshlets())
+    {
+        if (!culler.visible(meshlet, meshlet_stats))
+        {
+            continue;
+        }
+        const uint32_t first = meshlet.triangleOffset / 3;
+        for (uint32_t i = first; i < first + meshlet.triangleCount; i++)
+        {
+            rasterize(triangles[i], mvp, pack_id(draw_id, i));
+        }
+        depth_pyramid_valid = false;
+    }
+    return true;
+}
+
+void VisibilityRenderer::resolve(const std::vector<Light>& lights)
+{
+    const Eigen::Vector3f eye = rasterizer.get_eye_position();
+    const int tiles_x = (rasterizer.get_width() + TILE_SIZE - 1) / TILE_SIZE;
+    const int tiles_y = (rasterizer.get_height() + TILE_SIZE - 1) / TILE_SIZE;
+
+    utils::parallel_for(static_cast<size_t>(tiles_x) * tiles_y, [&](size_t tile)
+    {
+        resolve_tile(static_cast<int>(tile % tiles_x), static_cast<int>(tile / tiles_x), lights, eye);
+    });
+}
+
+void VisibilityRenderer::resolve_tile(int tile_x, int tile_y, const std::vector<Light>& lights,
+                                      const Eigen::Vector3f& eye)
+{
+    const int width = rasterizer.get_width();
+    const int x_begin = tile_x * TILE_SIZE;
+    const int y_begin = tile_y * TILE_SIZE;
+    const int x_end = std::min(x_begin + TILE_SIZE, width);
+    const int y_end = std::min(y_begin + TILE_SIZE, rasterizer.get_height());
+
+    // 相邻像素大多属于同一个三角形，缓存上一次的三角形设置
+    uint32_t cached_id = EMPTY_ID;
+    const Triangle* triangle = nullptr;
+    const Texture* texture = nullptr;
+    ScreenVertex s[3];
+    Eigen::Vector3f positions[3];
+    Eigen::Vector3f normals[3] = {Eigen::Vector3f::Zero(), Eigen::Vector3f::Zero(), Eigen::Vector3f::Zero()};
+    Surface material_surface;
+
+    for (int y = y_begin; y < y_end; y++)
+    {
+        for (int x = x_begin; x < x_end; x++)
+        {
+            const size_t index = static_cast<size_t>(y) * width + x;
+            const uint32_t id = ids[index];
+            if (id == EMPTY_ID)
+            {
+                color_buffer[index] = background;
+                continue;
+            }
+
+            if (id != cached_id)
+            {
+                cached_id = id;
+                const Draw& draw = draws[id >> TRIANGLE_ID_BITS];
+                triangle = &(*draw.triangles)[id & TRIANGLE_ID_MASK];
+                const ::Vertex* v[3] = {&triangle->v0, &triangle->v1, &triangle->v2};
+                for (int i = 0; i < 3; i++)
+                {
+                    Eigen::Vector3f p(v[i]->x, v[i]->y, v[i]->z);
+                    rasterizer.to_screen(draw.mvp, p, s[i]);
+                    positions[i] = (draw.model * p.homogeneous()).head<3>();
+                }
+                if (triangle->hasNormals)
+                {
+                    normals[0] = draw.normal_matrix * Eigen::Vector3f(triangle->n0.x, triangle->n0.y, triangle->n0.z);
+                    normals[1] = draw.normal_matrix * Eigen::Vector3f(triangle->n1.x, triangle->n1.y, triangle->n1.z);
+                    normals[2] = draw.normal_matrix * Eigen::Vector3f(triangle->n2.x, triangle->n2.y, triangle->n2.z);
+                }
+                else
+                {
+                    normals[0] = normals[1] = normals[2] =
+                        (positions[1] - positions[0]).cross(positions[2] - positions[0]);
+                }
+                shader::apply_material(shader::triangle_material(*triangle, *draw.materials), material_surface);
+                texture = shader::diffuse_texture(*triangle, *draw.materials, draw.textures);
+            }
+
+            Eigen::Vector3f bary;
+            if (!Rasterizer::barycentric(s[0], s[1], s[2], x, y, bary))
+            {
+                color_buffer[index] = background;
+                continue;
+            }
+
+            Surface surface = material_surface;
+            surface.position = bary[0] * positions[0] + bary[1] * positions[1] + bary[2] * positions[2];
+            surface.normal = (bary[0] * normals[0] + bary[1] * normals[1] + bary[2] * normals[2]).normalized();
+            if (texture != nullptr)
+            {
+                const float u = bary[0] * triangle->t0.u + bary[1] * triangle->t1.u + bary[2] * triangle->t2.u;
+                const float v = bary[0] * triangle->t0.v + bary[1] * triangle->t1.v + bary[2] * triangle->t2.v;
+                surface.albedo = surface.albedo.cwiseProduct(texture->sample(u, v));
+            }
+
+            Eigen::Vector3f color = shader::ambient(surface, ambient);
+            for (const auto& light : lights)
+            {
+                color += shader::blinn_phong(surface, light, eye);
+            }
+            color_buffer[index] = color;
+        }
+    }
+}
+
+} // Rasterizer
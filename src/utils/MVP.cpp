@@ -57,3 +57,14 @@ Eigen::Matrix4d MVP::cal_projection_matrix(const double& fov, const double& aspe
         0, 0, -1, 0;
     return projection;
 }
+
+Eigen::Matrix4d MVP::cal_orthographic_matrix(const double& left, const double& right, const double& bottom,
+                                             const double& top, const double& near, const double& far)
+{
+    Eigen::Matrix4d orthographic;
+    orthographic << 2 / (right - left), 0, 0, -(right + left) / (right - left),
+        0, 2 / (top - bottom), 0, -(top + bottom) / (top - bottom),
+        0, 0, 2 / (far - near), (far + near) / (far - near),
+        0, 0, 0, 1;
+    return orthographic;
+}
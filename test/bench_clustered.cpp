@@ -0,0 +1,151 @@
+/**
+ * @file bench_clustered.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 光源剔除性能对比：逐片元遍历所有光源 / tile 剔除 / cluster 剔除
+ * @version 0.1
+ * @date 2026/10/18
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ * 用法：bench_clustered [width] [height]
+ * 场景是一条很长的走廊（地面 + 两侧立柱），深度范围大，tile 剔除在这种场景下效果较差。
+ * 请使用 Release 构建运行。
+ */
+
+#include "core/forward_plus.h"
+#include "utils/MVP.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+using namespace Rasterizer;
+
+namespace {
+
+void add_quad(std::vector<Triangle>& triangles, const Eigen::Vector3f& a, const Eigen::Vector3f& b,
+              const Eigen::Vector3f& c, const Eigen::Vector3f& d)
+{
+    const Eigen::Vector3f n = (b - a).cross(c - a).normalized();
+    const Eigen::Vector3f corners[2][3] = {{a, b, c}, {a, c, d}};
+    for (const auto& corner : corners)
+    {
+        Triangle triangle;
+        triangle.v0 = {corner[0].x(), corner[0].y(), corner[0].z()};
+        triangle.v1 = {corner[1].x(), corner[1].y(), corner[1].z()};
+        triangle.v2 = {corner[2].x(), corner[2].y(), corner[2].z()};
+        triangle.n0 = triangle.n1 = triangle.n2 = {n.x(), n.y(), n.z()};
+        triangle.hasNormals = true;
+        triangles.push_back(triangle);
+    }
+}
+
+/**
+ * @brief 走廊场景：沿 -z 方向长 length 的地面，两侧每隔 2 个单位一根立柱
+ */
+std::vector<Triangle> build_corridor(float length)
+{
+    std::vector<Triangle> triangles;
+    for (float z = 0.0f; z > -length; z -= 2.0f)
+    {
+        add_quad(triangles, {-6.0f, 0.0f, z}, {6.0f, 0.0f, z}, {6.0f, 0.0f, z - 2.0f}, {-6.0f, 0.0f, z - 2.0f});
+        for (float x : {-4.0f, 4.0f})
+        {
+            // 立柱只有朝向走廊中间和朝向相机的两个面
+            const float inner = x < 0.0f ? x + 0.5f : x - 0.5f;
+            const float outer = x < 0.0f ? x - 0.5f : x + 0.5f;
+            const float front = z - 0.5f;
+            const float back = z - 1.5f;
+            if (x < 0.0f)
+            {
+                add_quad(triangles, {inner, 0.0f, front}, {inner, 0.0f, back}, {inner, 4.0f, back}, {inner, 4.0f, front});
+            }
+            else
+            {
+                add_quad(triangles, {inner, 0.0f, back}, {inner, 0.0f, front}, {inner, 4.0f, front}, {inner, 4.0f, back});
+            }
+            add_quad(triangles, {outer, 0.0f, front}, {inner, 0.0f, front}, {inner, 4.0f, front}, {outer, 4.0f, front});
+        }
+    }
+    return triangles;
+}
+
+double render_seconds(ForwardPlusRenderer& renderer, const std::vector<Triangle>& triangles,
+                      const std::vector<Light>& lights, int frames)
+{
+    double best = 0.0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        renderer.clear();
+        renderer.draw(triangles, {}, Eigen::Matrix4f::Identity());
+        renderer.render(lights);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = frame == 0 ? seconds : std::min(best, seconds);
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int width = argc > 1 ? std::atoi(argv[1]) : 320;
+    const int height = argc > 2 ? std::atoi(argv[2]) : 240;
+    const float length = 200.0f;
+
+    const std::vector<Triangle> triangles = build_corridor(length);
+    const Eigen::Matrix4f view = utils::MVP::cal_view_matrix({0.0, 2.0, 2.0}, {0.0, 1.5, -10.0}, {0.0, 1.0, 0.0})
+        .cast<float>();
+    const Eigen::Matrix4f projection = utils::MVP::cal_projection_matrix(60.0, static_cast<double>(width) / height,
+                                                                         0.1, length)
+        .cast<float>();
+
+    ForwardPlusRenderer renderer(width, height);
+    renderer.get_rasterizer().set_view(view);
+    renderer.get_rasterizer().set_projection(projection);
+
+    std::cout << "triangles: " << triangles.size() << ", resolution: " << width << "x" << height << "\n";
+    std::cout << std::setw(8) << "lights" << std::setw(14) << "brute (ms)" << std::setw(14) << "tiled (ms)"
+        << std::setw(16) << "clustered (ms)" << std::setw(12) << "max diff" << "\n";
+
+    std::mt19937 rng(2025);
+    std::uniform_real_distribution<float> random_x(-5.5f, 5.5f);
+    std::uniform_real_distribution<float> random_y(0.2f, 3.5f);
+    std::uniform_real_distribution<float> random_z(-length, 0.0f);
+    std::uniform_real_distribution<float> random_color(0.2f, 1.0f);
+
+    for (int count : {1000, 2000, 5000, 10000})
+    {
+        LightList lights;
+        for (int i = 0; i < count; i++)
+        {
+            lights.add_point_light({random_x(rng), random_y(rng), random_z(rng)},
+                                   {random_color(rng), random_color(rng), random_color(rng)}, 4.0f, 2.0f);
+        }
+        lights.add_directional_light({0.3f, -1.0f, -0.2f}, {0.2f, 0.2f, 0.25f}, 1.0f);
+
+        renderer.set_light_culling(ForwardPlusRenderer::LightCulling::None);
+        const double brute = render_seconds(renderer, triangles, lights.get_lights(), 1);
+        const std::vector<Eigen::Vector3f> reference = renderer.get_color_buffer();
+
+        renderer.set_light_culling(ForwardPlusRenderer::LightCulling::Tiled);
+        const double tiled = render_seconds(renderer, triangles, lights.get_lights(), 3);
+
+        renderer.set_light_culling(ForwardPlusRenderer::LightCulling::Clustered);
+        const double clustered = render_seconds(renderer, triangles, lights.get_lights(), 3);
+
+        float max_diff = 0.0f;
+        for (size_t i = 0; i < reference.size(); i++)
+        {
+            max_diff = std::max(max_diff, (reference[i] - renderer.get_color_buffer()[i]).cwiseAbs().maxCoeff());
+        }
+
+        std::cout << std::setw(8) << count << std::fixed << std::setprecision(2)
+            << std::setw(14) << brute * 1000.0 << std::setw(14) << tiled * 1000.0
+            << std::setw(16) << clustered * 1000.0 << std::setw(12) << std::scientific << std::setprecision(1)
+            << max_diff << std::defaultfloat << "\n";
+    }
+    return 0;
+}
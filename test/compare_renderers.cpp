@@ -0,0 +1,483 @@
+/**
+ * @file compare_renderers.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief 各渲染路径与前向着色的一致性检查
+ * @version 0.1
+ * @date 2026/10/19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 用法：compare_renderers
+ * 同一个场景分别用延迟渲染、visibility buffer、Forward+（tile / cluster 剔除）渲染，
+ * 逐像素与前向着色（Forward+ 不剔除光源，每个片元遍历所有光源）比较，带阴影和不带阴影各一次。
+ * 另外检查 G-buffer 编码、visibility ID 的上限、Forward+ 的深度相等测试和级联阴影。
+ * 任何一项失败时返回 1，不需要窗口。
+ */
+
+#include "core/deferred.h"
+#include "core/forward_plus.h"
+#include "core/gbuffer.h"
+#include "core/shadow.h"
+#include "core/visibility.h"
+#include "utils/MVP.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+using namespace Rasterizer;
+
+namespace {
+
+constexpr int WIDTH = 160;
+constexpr int HEIGHT = 120;
+constexpr float SHADOW_DISTANCE = 20.0f;
+
+// 允许的最大逐像素误差：visibility buffer 和 Forward+ 只有浮点误差，
+// 延迟渲染的误差来自 G-buffer 的 8 位颜色、8 位光泽度和 16 位法线
+constexpr float EXACT_TOLERANCE = 1e-5f;
+constexpr float VISIBILITY_TOLERANCE = 1e-3f;
+constexpr float DEFERRED_TOLERANCE = 0.01f;
+
+bool report(const std::string& name, bool passed)
+{
+    std::cout << (passed ? "✓ " : "✗ ") << name << ": " << (passed ? "通过" : "失败") << std::endl;
+    return passed;
+}
+
+void add_quad(std::vector<Triangle>& triangles, const Eigen::Vector3f& a, const Eigen::Vector3f& b,
+              const Eigen::Vector3f& c, const Eigen::Vector3f& d, const Eigen::Vector3f& n, MaterialId material)
+{
+    const Eigen::Vector3f corners[2][3] = {{a, b, c}, {a, c, d}};
+    const TextureCoord uvs[2][3] = {{{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}}, {{0.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}}};
+    for (int i = 0; i < 2; i++)
+    {
+        Triangle triangle;
+        triangle.v0 = {corners[i][0].x(), corners[i][0].y(), corners[i][0].z()};
+        triangle.v1 = {corners[i][1].x(), corners[i][1].y(), corners[i][1].z()};
+        triangle.v2 = {corners[i][2].x(), corners[i][2].y(), corners[i][2].z()};
+        triangle.n0 = triangle.n1 = triangle.n2 = {n.x(), n.y(), n.z()};
+        triangle.t0 = uvs[i][0];
+        triangle.t1 = uvs[i][1];
+        triangle.t2 = uvs[i][2];
+        triangle.hasNormals = true;
+        triangle.hasTextures = true;
+        triangle.materialId = material;
+        triangles.push_back(triangle);
+    }
+}
+
+/**
+ * @brief 立在地面上的立方体，不含底面（与地面重合）
+ */
+void add_box(std::vector<Triangle>& triangles, const Eigen::Vector3f& center, float half, MaterialId material)
+{
+    const float x0 = center.x() - half, x1 = center.x() + half;
+    const float z0 = center.z() - half, z1 = center.z() + half;
+    const float y1 = 2.0f * half;
+    add_quad(triangles, {x0, y1, z1}, {x1, y1, z1}, {x1, y1, z0}, {x0, y1, z0}, Eigen::Vector3f::UnitY(), material);
+    add_quad(triangles, {x0, 0.0f, z1}, {x1, 0.0f, z1}, {x1, y1, z1}, {x0, y1, z1}, Eigen::Vector3f::UnitZ(), material);
+    add_quad(triangles, {x1, 0.0f, z0}, {x0, 0.0f, z0}, {x0, y1, z0}, {x1, y1, z0}, -Eigen::Vector3f::UnitZ(), material);
+    add_quad(triangles, {x1, 0.0f, z1}, {x1, 0.0f, z0}, {x1, y1, z0}, {x1, y1, z1}, Eigen::Vector3f::UnitX(), material);
+    add_quad(triangles, {x0, 0.0f, z0}, {x0, 0.0f, z1}, {x0, y1, z1}, {x0, y1, z0}, -Eigen::Vector3f::UnitX(), material);
+}
+
+Material make_material(const std::string& name, const Eigen::Vector3f& ka, const Eigen::Vector3f& kd,
+                       const Eigen::Vector3f& ks, float ns)
+{
+    Material material;
+    material.name = name;
+    material.defined = true;
+    for (int i = 0; i < 3; i++)
+    {
+        material.ambient[i] = ka[i];
+        material.diffuse[i] = kd[i];
+        material.specular[i] = ks[i];
+    }
+    material.shininess = ns;
+    return material;
+}
+
+/**
+ * @brief 测试场景：地面、三个材质不同的立方体和一块贴了棋盘格纹理的竖板
+ * @details 每个材质的 Ka 都与 Kd 不同，环境光项用错颜色时会直接表现为误差
+ */
+struct Scene {
+    std::vector<Triangle> triangles;
+    std::vector<Material> materials;
+    TextureMap textures;
+    LightList lights;
+    Eigen::Matrix4f view;
+    Eigen::Matrix4f projection;
+    Eigen::Vector3f light_direction;
+    Eigen::Vector3f ambient;
+    Eigen::Vector3f background;
+};
+
+Scene build_scene()
+{
+    Scene scene;
+    scene.materials.push_back(make_material("ground", {0.3f, 0.25f, 0.2f}, {0.6f, 0.6f, 0.55f}, {0.1f, 0.1f, 0.1f}, 8.0f));
+    scene.materials.push_back(make_material("red", {0.4f, 0.05f, 0.05f}, {0.8f, 0.15f, 0.1f}, {0.5f, 0.5f, 0.5f}, 32.0f));
+    scene.materials.push_back(make_material("blue", {0.0f, 0.1f, 0.5f}, {0.1f, 0.2f, 0.7f}, {0.3f, 0.3f, 0.4f}, 96.0f));
+    scene.materials.push_back(make_material("gold", {0.5f, 0.4f, 0.1f}, {0.7f, 0.55f, 0.2f}, {0.8f, 0.7f, 0.3f}, 250.0f));
+    Material checker = make_material("checker", {0.2f, 0.2f, 0.2f}, {0.9f, 0.9f, 0.9f}, {0.0f, 0.0f, 0.0f}, 1.0f);
+    checker.diffuseTexture = "checker.png";
+    scene.materials.push_back(checker);
+
+    std::vector<unsigned char> pixels;
+    for (int y = 0; y < 8; y++)
+    {
+        for (int x = 0; x < 8; x++)
+        {
+            const bool dark = (x + y) % 2 == 0;
+            pixels.insert(pixels.end(), {static_cast<unsigned char>(dark ? 40 : 230),
+                                         static_cast<unsigned char>(dark ? 60 : 210),
+                                         static_cast<unsigned char>(dark ? 90 : 180)});
+        }
+    }
+    scene.textures["checker.png"] = Texture(8, 8, 3, pixels.data());
+
+    add_quad(scene.triangles, {-6.0f, 0.0f, 6.0f}, {6.0f, 0.0f, 6.0f}, {6.0f, 0.0f, -6.0f}, {-6.0f, 0.0f, -6.0f},
+             Eigen::Vector3f::UnitY(), 0);
+    add_box(scene.triangles, {-1.5f, 0.0f, 0.0f}, 0.6f, 1);
+    add_box(scene.triangles, {1.2f, 0.0f, -1.0f}, 0.8f, 2);
+    add_box(scene.triangles, {0.3f, 0.0f, 1.6f}, 0.35f, 3);
+    add_quad(scene.triangles, {-3.0f, 0.0f, -3.0f}, {0.0f, 0.0f, -3.5f}, {0.0f, 2.5f, -3.5f}, {-3.0f, 2.5f, -3.0f},
+             Eigen::Vector3f(0.164f, 0.0f, 0.986f).normalized(), 4);
+
+    scene.lights.add_point_light({-2.0f, 1.5f, 2.0f}, {1.0f, 0.8f, 0.6f}, 6.0f, 6.0f);
+    scene.lights.add_point_light({2.5f, 1.0f, 1.0f}, {0.4f, 0.6f, 1.0f}, 5.0f, 4.0f);
+    scene.lights.add_point_light({0.0f, 3.0f, -2.0f}, {0.9f, 0.9f, 0.9f}, 4.0f, 5.0f);
+    scene.lights.add_spot_light({0.0f, 4.0f, 3.0f}, Eigen::Vector3f(0.0f, -1.0f, -0.8f).normalized(),
+                                {1.0f, 1.0f, 0.8f}, 8.0f, 12.0f, 15.0f, 30.0f);
+    scene.light_direction = Eigen::Vector3f(0.4f, -1.0f, 0.3f).normalized();
+    scene.lights.add_directional_light(scene.light_direction, {0.6f, 0.6f, 0.55f}, 1.0f);
+
+    scene.view = utils::MVP::cal_view_matrix({0.0, 3.5, 6.5}, {0.0, 0.5, 0.0}, {0.0, 1.0, 0.0}).cast<float>();
+    scene.projection = utils::MVP::cal_projection_matrix(60.0, static_cast<double>(WIDTH) / HEIGHT, 0.1, 50.0)
+        .cast<float>();
+    scene.ambient = Eigen::Vector3f(0.25f, 0.25f, 0.3f);
+    scene.background = Eigen::Vector3f(0.05f, 0.05f, 0.1f);
+    return scene;
+}
+
+float max_difference(const std::vector<Eigen::Vector3f>& a, const std::vector<Eigen::Vector3f>& b)
+{
+    if (a.size() != b.size())
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+    float result = 0.0f;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        result = std::max(result, (a[i] - b[i]).cwiseAbs().maxCoeff());
+    }
+    return result;
+}
+
+std::vector<Eigen::Vector3f> render_forward_plus(const Scene& scene, const std::vector<Triangle>& triangles,
+                                                 const std::vector<Light>& lights,
+                                                 ForwardPlusRenderer::LightCulling culling)
+{
+    ForwardPlusRenderer renderer(WIDTH, HEIGHT);
+    renderer.get_rasterizer().set_view(scene.view);
+    renderer.get_rasterizer().set_projection(scene.projection);
+    renderer.set_ambient(scene.ambient);
+    renderer.set_background(scene.background);
+    renderer.set_light_culling(culling);
+    renderer.clear();
+    renderer.draw(triangles, scene.materials, Eigen::Matrix4f::Identity(), &scene.textures);
+    renderer.render(lights);
+    return renderer.get_color_buffer();
+}
+
+std::vector<Eigen::Vector3f> render_deferred(const Scene& scene, const std::vector<Light>& lights)
+{
+    DeferredRenderer renderer(WIDTH, HEIGHT);
+    renderer.get_rasterizer().set_model(Eigen::Matrix4f::Identity());
+    renderer.get_rasterizer().set_view(scene.view);
+    renderer.get_rasterizer().set_projection(scene.projection);
+    renderer.set_ambient(scene.ambient);
+    renderer.set_background(scene.background);
+    renderer.clear();
+    renderer.geometry_pass(scene.triangles, scene.materials, &scene.textures);
+    renderer.lighting_pass(lights);
+    return renderer.get_color_buffer();
+}
+
+/**
+ * @param empty_draws 场景之前先登记的空绘制数，用于把场景的 draw ID 推到上限
+ */
+std::vector<Eigen::Vector3f> render_visibility(const Scene& scene, const std::vector<Light>& lights,
+                                               uint32_t empty_draws = 0, bool* ids_valid = nullptr)
+{
+    static const std::vector<Triangle> no_triangles;
+    VisibilityRenderer renderer(WIDTH, HEIGHT);
+    renderer.get_rasterizer().set_view(scene.view);
+    renderer.get_rasterizer().set_projection(scene.projection);
+    renderer.set_ambient(scene.ambient);
+    renderer.set_background(scene.background);
+    renderer.clear();
+    bool valid = true;
+    for (uint32_t i = 0; i < empty_draws; i++)
+    {
+        valid = renderer.draw(no_triangles, scene.materials, Eigen::Matrix4f::Identity()) && valid;
+    }
+    valid = renderer.draw(scene.triangles, scene.materials, Eigen::Matrix4f::Identity(), &scene.textures) && valid;
+    renderer.resolve(lights);
+    if (ids_valid != nullptr)
+    {
+        *ids_valid = valid;
+    }
+    return renderer.get_color_buffer();
+}
+
+/**
+ * @brief 场景三角形渲染级联阴影贴图，并把平行光的 shadow_map 指向它
+ */
+void render_shadow_map(const Scene& scene, CascadedShadowMap& shadow_map, std::vector<Light>& lights)
+{
+    shadow_map.set_shadow_distance(SHADOW_DISTANCE);
+    shadow_map.update(scene.view, scene.projection, scene.light_direction);
+    shadow_map.clear();
+    shadow_map.draw(scene.triangles, Eigen::Matrix4f::Identity());
+    shadow_map.render();
+    for (auto& light : lights)
+    {
+        if (light.type == LightType::Directional)
+        {
+            light.shadow_map = &shadow_map;
+        }
+    }
+}
+
+bool compare_paths(const Scene& scene, const std::vector<Light>& lights, const std::string& label)
+{
+    const auto forward = render_forward_plus(scene, scene.triangles, lights, ForwardPlusRenderer::LightCulling::None);
+    const float tiled = max_difference(forward, render_forward_plus(scene, scene.triangles, lights,
+                                                                    ForwardPlusRenderer::LightCulling::Tiled));
+    const float clustered = max_difference(forward, render_forward_plus(scene, scene.triangles, lights,
+                                                                        ForwardPlusRenderer::LightCulling::Clustered));
+    const float visibility = max_difference(forward, render_visibility(scene, lights));
+    const float deferred = max_difference(forward, render_deferred(scene, lights));
+    std::cout << "  " << label << " 最大逐像素误差：tile " << tiled << "，cluster " << clustered
+              << "，visibility " << visibility << "，延迟 " << deferred << std::endl;
+
+    bool passed = true;
+    passed = report(label + " Forward+ tile 剔除与前向着色一致", tiled <= EXACT_TOLERANCE) && passed;
+    passed = report(label + " Forward+ cluster 剔除与前向着色一致", clustered <= EXACT_TOLERANCE) && passed;
+    passed = report(label + " visibility buffer 与前向着色一致", visibility <= VISIBILITY_TOLERANCE) && passed;
+    passed = report(label + " 延迟渲染与前向着色一致", deferred <= DEFERRED_TOLERANCE) && passed;
+    return passed;
+}
+
+bool test_gbuffer_encoding()
+{
+    std::mt19937 rng(2025);
+    std::normal_distribution<float> gaussian;
+    std::vector<Eigen::Vector3f> normals = {
+        Eigen::Vector3f::UnitX(), -Eigen::Vector3f::UnitX(), Eigen::Vector3f::UnitY(), -Eigen::Vector3f::UnitY(),
+        Eigen::Vector3f::UnitZ(), -Eigen::Vector3f::UnitZ(), Eigen::Vector3f(1.0f, 1.0f, -1.0f).normalized(),
+        Eigen::Vector3f(-1.0f, 0.0f, -1.0f).normalized(), Eigen::Vector3f(0.0f, -1.0f, -1e-6f).normalized()
+    };
+    for (int i = 0; i < 10000; i++)
+    {
+        normals.push_back(Eigen::Vector3f(gaussian(rng), gaussian(rng), gaussian(rng)).normalized());
+    }
+    float normal_error = 0.0f;
+    for (const auto& n : normals)
+    {
+        normal_error = std::max(normal_error, (decode_octahedral(encode_octahedral(n)) - n).norm());
+    }
+
+    // 8 位颜色：k / 255 精确还原，其余值误差不超过半个量化步长，超出 [0, 1] 的分量被截断
+    bool colors_exact = true;
+    for (int k = 0; k < 256; k++)
+    {
+        const float v = static_cast<float>(k) / 255.0f;
+        colors_exact = colors_exact && unpack_rgb8(pack_rgba8(Eigen::Vector3f(v, v, v))) == Eigen::Vector3f(v, v, v);
+    }
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    float color_error = 0.0f;
+    for (int i = 0; i < 10000; i++)
+    {
+        const Eigen::Vector3f color(unit(rng), unit(rng), unit(rng));
+        color_error = std::max(color_error, (unpack_rgb8(pack_rgba8(color)) - color).cwiseAbs().maxCoeff());
+    }
+    const bool clamped = unpack_rgb8(pack_rgba8(Eigen::Vector3f(-0.5f, 1.5f, 0.0f))) == Eigen::Vector3f(0.0f, 1.0f, 0.0f);
+    const bool alpha_kept = (pack_rgba8(Eigen::Vector3f(1.0f, 1.0f, 1.0f), 200) >> 24) == 200 &&
+        (pack_rgba8(Eigen::Vector3f::Zero(), 0) >> 24) == 0;
+    const bool shininess = decode_shininess(encode_shininess(0.0f)) == 0.0f &&
+        decode_shininess(encode_shininess(1000.0f)) == 1000.0f &&
+        std::abs(decode_shininess(encode_shininess(32.0f)) - 32.0f) < 1.0f;
+
+    std::cout << "  八面体法线最大误差 " << normal_error << "，RGBA8 最大误差 " << color_error << std::endl;
+    bool passed = true;
+    passed = report("八面体法线编码往返", normal_error < 1e-4f) && passed;
+    passed = report("RGBA8 颜色编码往返", colors_exact && color_error <= 0.5f / 255.0f + 1e-6f && clamped) && passed;
+    passed = report("RGBA8 的 A 通道原样保存", alpha_kept) && passed;
+    passed = report("光泽度 8 位编码", shininess) && passed;
+    return passed;
+}
+
+bool test_visibility_ids(const Scene& scene, const std::vector<Light>& lights,
+                         const std::vector<Eigen::Vector3f>& forward)
+{
+    using VR = VisibilityRenderer;
+    const uint32_t last = VR::pack_id(VR::MAX_DRAWS - 1, VR::TRIANGLE_ID_MASK);
+    const bool packing = last != VR::EMPTY_ID && (last >> VR::TRIANGLE_ID_BITS) == VR::MAX_DRAWS - 1 &&
+        (last & VR::TRIANGLE_ID_MASK) == VR::TRIANGLE_ID_MASK && VR::pack_id(0, 0) == 0;
+
+    // 场景作为最后一个允许的绘制（draw ID 为 MAX_DRAWS - 1），结果与只画场景时相同
+    bool ids_valid = false;
+    const auto at_limit = render_visibility(scene, lights, VR::MAX_DRAWS - 1, &ids_valid);
+    const float difference = max_difference(forward, at_limit);
+
+    // 超出上限的绘制被拒绝
+    bool rejected = false;
+    render_visibility(scene, lights, VR::MAX_DRAWS, &rejected);
+
+    bool passed = true;
+    passed = report("visibility ID 打包到 MAX_DRAWS 和 TRIANGLE_ID_MASK", packing) && passed;
+    passed = report("draw ID 为 MAX_DRAWS - 1 时着色正确", ids_valid && difference <= VISIBILITY_TOLERANCE) && passed;
+    passed = report("超过 MAX_DRAWS 的绘制返回 false", !rejected) && passed;
+    return passed;
+}
+
+bool test_forward_plus_prepass(const Scene& scene, const std::vector<Light>& lights,
+                               const std::vector<Eigen::Vector3f>& forward)
+{
+    // 背景设成着色不可能得到的颜色，有深度但仍是背景色的像素说明没有片元通过深度相等测试
+    const Eigen::Vector3f sentinel(-1.0f, -1.0f, -1.0f);
+    ForwardPlusRenderer renderer(WIDTH, HEIGHT);
+    renderer.get_rasterizer().set_view(scene.view);
+    renderer.get_rasterizer().set_projection(scene.projection);
+    renderer.set_ambient(scene.ambient);
+    renderer.set_background(sentinel);
+    renderer.set_light_culling(ForwardPlusRenderer::LightCulling::Tiled);
+    renderer.clear();
+    renderer.draw(scene.triangles, scene.materials, Eigen::Matrix4f::Identity(), &scene.textures);
+    renderer.render(lights);
+    size_t covered = 0;
+    size_t unshaded = 0;
+    for (size_t i = 0; i < renderer.get_depth_buffer().size(); i++)
+    {
+        if (renderer.get_depth_buffer()[i] != -std::numeric_limits<float>::infinity())
+        {
+            covered++;
+            unshaded += renderer.get_color_buffer()[i] == sentinel;
+        }
+    }
+
+    // 三角形倒序提交：预渲染保证只有最近的片元着色，结果与提交顺序无关
+    std::vector<Triangle> reversed(scene.triangles.rbegin(), scene.triangles.rend());
+    const float difference = max_difference(forward, render_forward_plus(scene, reversed, lights,
+                                                                         ForwardPlusRenderer::LightCulling::None));
+
+    std::cout << "  覆盖像素 " << covered << "，未着色 " << unshaded << "，倒序提交误差 " << difference << std::endl;
+    bool passed = true;
+    passed = report("Forward+ 每个有深度的像素都通过深度相等测试", covered > 0 && unshaded == 0) && passed;
+    passed = report("Forward+ 结果与三角形提交顺序无关", difference <= EXACT_TOLERANCE) && passed;
+    return passed;
+}
+
+bool test_cascaded_shadow_map(const Scene& scene)
+{
+    CascadedShadowMap shadow_map(1024, 4);
+    std::vector<Light> lights = scene.lights.get_lights();
+    render_shadow_map(scene, shadow_map, lights);
+
+    // 级联按距离递增，最后一级到阴影距离为止
+    bool splits = true;
+    for (int i = 1; i < shadow_map.get_cascade_count(); i++)
+    {
+        splits = splits && shadow_map.get_cascade(i).split_far > shadow_map.get_cascade(i - 1).split_far &&
+            shadow_map.get_cascade(i).texel_size >= shadow_map.get_cascade(i - 1).texel_size;
+    }
+    splits = splits && std::abs(shadow_map.get_cascade(shadow_map.get_cascade_count() - 1).split_far -
+                                SHADOW_DISTANCE) < 1e-3f;
+
+    // 沿视线方向取点，级联下标单调不减，从 0 开始，超出阴影距离后为 -1
+    const Eigen::Matrix4f inv_view = scene.view.inverse();
+    const Eigen::Vector3f eye = inv_view.col(3).head<3>();
+    const Eigen::Vector3f forward = -inv_view.col(2).head<3>().normalized();
+    bool selection = shadow_map.select_cascade(eye + forward * 0.2f) == 0;
+    int previous = 0;
+    for (float distance = 0.2f; distance < SHADOW_DISTANCE; distance += 0.25f)
+    {
+        const int cascade = shadow_map.select_cascade(eye + forward * distance);
+        selection = selection && cascade >= previous;
+        previous = cascade;
+    }
+    selection = selection && previous == shadow_map.get_cascade_count() - 1 &&
+        shadow_map.select_cascade(eye + forward * (SHADOW_DISTANCE + 1.0f)) == -1;
+
+    // 大立方体（中心 (1.2, 0, -1)，高 1.6）顶面中心沿光线落到地面的点在阴影中，远离立方体的地面受光
+    const Eigen::Vector3f top(1.2f, 1.6f, -1.0f);
+    const Eigen::Vector3f shadowed = top + scene.light_direction * (top.y() / -scene.light_direction.y());
+    const Eigen::Vector3f up = Eigen::Vector3f::UnitY();
+    const bool occlusion = shadow_map.visibility(shadowed, up) == 0.0f &&
+        shadow_map.visibility({-4.0f, 0.0f, 4.0f}, up) == 1.0f;
+
+    // 从阴影中心沿 x 方向穿过阴影边缘，PCF 半径越大过渡带越宽，过渡带内可见度单调不减
+    auto soft_samples = [&](int radius, bool& monotonic)
+    {
+        shadow_map.set_pcf_radius(radius);
+        int count = 0;
+        float last = 0.0f;
+        monotonic = true;
+        for (float x = 0.0f; x < 2.0f; x += 0.005f)
+        {
+            const float v = shadow_map.visibility(shadowed + Eigen::Vector3f(x, 0.0f, 0.0f), up);
+            monotonic = monotonic && v >= last - 1e-4f && v >= 0.0f && v <= 1.0f;
+            last = v;
+            count += v > 0.0f && v < 1.0f;
+        }
+        return count;
+    };
+    bool sharp_monotonic = false;
+    bool soft_monotonic = false;
+    const int sharp = soft_samples(0, sharp_monotonic);
+    const int soft = soft_samples(3, soft_monotonic);
+
+    std::cout << "  PCF 半径 0 过渡采样 " << sharp << "，半径 3 过渡采样 " << soft << std::endl;
+    bool passed = true;
+    passed = report("级联划分按距离递增", splits) && passed;
+    passed = report("级联选择沿视线单调，超出阴影距离为 -1", selection) && passed;
+    passed = report("阴影遮挡判断", occlusion) && passed;
+    passed = report("PCF 过渡带随半径变宽且单调", sharp_monotonic && soft_monotonic && soft > sharp) && passed;
+    return passed;
+}
+
+} // namespace
+
+int main()
+{
+    const Scene scene = build_scene();
+    bool passed = true;
+
+    std::cout << "场景三角形 " << scene.triangles.size() << "，分辨率 " << WIDTH << "x" << HEIGHT << std::endl;
+    passed = test_gbuffer_encoding() && passed;
+
+    const std::vector<Light>& lights = scene.lights.get_lights();
+    passed = compare_paths(scene, lights, "无阴影") && passed;
+
+    CascadedShadowMap shadow_map(1024, 4);
+    std::vector<Light> shadowed_lights = lights;
+    render_shadow_map(scene, shadow_map, shadowed_lights);
+    passed = compare_paths(scene, shadowed_lights, "级联阴影") && passed;
+    const auto unshadowed = render_forward_plus(scene, scene.triangles, lights, ForwardPlusRenderer::LightCulling::None);
+    const auto shadowed = render_forward_plus(scene, scene.triangles, shadowed_lights,
+                                              ForwardPlusRenderer::LightCulling::None);
+    passed = report("阴影改变了画面", max_difference(unshadowed, shadowed) > 0.05f) && passed;
+
+    passed = test_visibility_ids(scene, lights, unshadowed) && passed;
+    passed = test_forward_plus_prepass(scene, lights, unshadowed) && passed;
+    passed = test_cascaded_shadow_map(scene) && passed;
+
+    std::cout << (passed ? "\n✓ 渲染路径一致性测试: 通过" : "\n✗ 渲染路径一致性测试: 失败") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,380 @@
+/**
+ * @file test_reload.cpp
+ * @author dion (hduer_zdy@outlook.com)
+ * @brief ModelReloader 和 ModelLibrary 的测试
+ * @version 0.1
+ * @date 2026/10/19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 用法：test_reload
+ * 在当前目录下的 reload_test/ 中生成 OBJ、MTL 和纹理文件，纹理由一个只计数、不读文件的
+ * 解码函数“解码”，从调用次数判断哪些纹理被重新解码、哪些被共享。
+ * 任何一项失败时返回 1，不需要窗口。
+ */
+
+#include "core/hot_reload.h"
+#include "core/model_library.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Rasterizer;
+
+namespace {
+
+const std::filesystem::path DIRECTORY = "reload_test";
+
+// 等待文件变化的最长时间，正常情况下 inotify 立即报告
+constexpr int UPDATE_TIMEOUT_MS = 2000;
+
+bool report(const std::string& name, bool passed)
+{
+    std::cout << (passed ? "✓ " : "✗ ") << name << ": " << (passed ? "通过" : "失败") << std::endl;
+    return passed;
+}
+
+std::string file_path(const std::string& name)
+{
+    return (DIRECTORY / name).string();
+}
+
+void write_file(const std::string& name, const std::string& text)
+{
+    std::ofstream out(file_path(name), std::ios::binary);
+    out << text;
+}
+
+/**
+ * @brief 记录调用次数的纹理解码函数
+ * @details 每次调用返回一张新的 1x1 纹理（像素为调用序号），文件名为 missing.png 时返回空纹理。
+ * 可以让每次解码等待一段时间，或者阻塞到 release 为止，用来制造并发。
+ */
+class CountingDecoder {
+public:
+    explicit CountingDecoder(int delay_ms = 0) : delay_ms(delay_ms) {}
+
+    TextureDecoder decoder()
+    {
+        return [this](const std::string& path) { return decode(path); };
+    }
+
+    int calls(const std::string& name) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = counts.find(name);
+        return it != counts.end() ? it->second : 0;
+    }
+
+    int total() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        int sum = 0;
+        for (const auto& [name, count] : counts)
+        {
+            sum += count;
+        }
+        return sum;
+    }
+
+    /**
+     * @brief 之后的解码阻塞到 release 为止
+     */
+    void block() { blocked = true; }
+    void release() { blocked = false; }
+    bool waiting() const { return inside > 0; }
+
+private:
+    mutable std::mutex mutex;
+    std::map<std::string, int> counts;     // 文件名到调用次数
+    int delay_ms;
+    std::atomic<bool> blocked{false};
+    std::atomic<int> inside{0};
+
+    Texture decode(const std::string& path)
+    {
+        const std::string name = std::filesystem::path(path).filename().string();
+        int call;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            call = ++counts[name];
+        }
+        inside++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+        while (blocked)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        inside--;
+        if (name == "missing.png")
+        {
+            return Texture();
+        }
+        const unsigned char pixel[3] = {static_cast<unsigned char>(call), 0, 0};
+        return Texture(1, 1, 3, pixel);
+    }
+};
+
+const std::string RELOAD_MTL =
+    "newmtl red\nKd 1 0 0\nmap_Kd a.png\n\nnewmtl green\nKd 0 1 0\nmap_Kd b.png\n";
+const std::string RELOAD_OBJ =
+    "mtllib scene.mtl\nv 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\nvt 0 0\nvt 1 0\nvt 0 1\nvt 1 1\n"
+    "usemtl red\nf 1/1 2/2 3/3\nusemtl green\nf 2/2 4/4 3/3\n";
+
+bool same_pixels(const TextureMap& a, const TextureMap& b, const std::string& name)
+{
+    return a.count(name) != 0 && b.count(name) != 0 && a.at(name).data == b.at(name).data;
+}
+
+bool test_reloader()
+{
+    std::cout << "\n=== 热重载测试 ===" << std::endl;
+    write_file("scene.obj", RELOAD_OBJ);
+    write_file("scene.mtl", RELOAD_MTL);
+    write_file("a.png", "a");
+    write_file("b.png", "b");
+
+    CountingDecoder decoder;
+    ModelReloader reloader(file_path("scene.obj"), LoadOptions(), decoder.decoder());
+    const bool loaded = reloader.load();
+    const auto first = reloader.current();
+    bool passed = report("首次加载解码所有纹理", loaded && first && first->version == 1 &&
+                         first->triangles->size() == 2 && first->textures.size() == 2 &&
+                         decoder.calls("a.png") == 1 && decoder.calls("b.png") == 1);
+    if (!loaded)
+    {
+        return false;
+    }
+    passed = report("没有变化时不发布", !reloader.update(0).published() && reloader.current() == first) && passed;
+
+    // 只改纹理：只重新解码这张纹理，几何体、材质表和另一张纹理沿用
+    write_file("a.png", "a2");
+    const ReloadResult texture_only = reloader.update(UPDATE_TIMEOUT_MS);
+    const auto second = reloader.current();
+    passed = report("只改纹理时只解码这张纹理",
+                    texture_only.published() && !texture_only.geometry && !texture_only.materials &&
+                    texture_only.decoded_textures == 1 && texture_only.reused_textures == 1 &&
+                    decoder.calls("a.png") == 2 && decoder.calls("b.png") == 1 && second->version == 2) && passed;
+    passed = report("未变化的部分与上一份快照共享",
+                    second->geometry == first->geometry && second->materials == first->materials &&
+                    second->triangles == first->triangles && same_pixels(first->textures, second->textures, "b.png") &&
+                    !same_pixels(first->textures, second->textures, "a.png")) && passed;
+
+    // 只改 MTL：换颜色和一张纹理的路径，三角形沿用，只解码新路径的纹理
+    write_file("c.png", "c");
+    write_file("scene.mtl", "newmtl red\nKd 0.5 0 0\nmap_Kd a.png\n\nnewmtl green\nKd 0 1 0\nmap_Kd c.png\n");
+    const ReloadResult material_only = reloader.update(UPDATE_TIMEOUT_MS);
+    const auto third = reloader.current();
+    bool recolored = false;
+    for (const Material& material : *third->materials)
+    {
+        recolored = recolored || (material.name == "red" && material.diffuse[0] == 0.5f);
+    }
+    passed = report("只改 MTL 时不重新解析 OBJ",
+                    material_only.published() && !material_only.geometry && material_only.materials &&
+                    material_only.changed_materials == 2 && third->geometry == first->geometry &&
+                    third->triangles == first->triangles && third->materials != second->materials &&
+                    recolored && third->version == 3) && passed;
+    passed = report("只改 MTL 时只解码路径变化的纹理",
+                    material_only.decoded_textures == 1 && material_only.reused_textures == 1 &&
+                    decoder.calls("c.png") == 1 && decoder.calls("a.png") == 2 &&
+                    same_pixels(second->textures, third->textures, "a.png") && third->textures.count("b.png") == 0) &&
+        passed;
+    passed = report("旧快照不受重载影响", first->textures.count("b.png") == 1 && second->version == 2) && passed;
+
+    // 改 OBJ：重新解析，纹理文件没有变化，全部沿用
+    write_file("scene.obj", RELOAD_OBJ + "f 1/1 4/4 3/3\n");
+    const ReloadResult geometry = reloader.update(UPDATE_TIMEOUT_MS);
+    const auto fourth = reloader.current();
+    passed = report("改 OBJ 时重新解析几何体",
+                    geometry.published() && geometry.geometry && fourth->triangles->size() == 3 &&
+                    fourth->geometry != first->geometry && geometry.changed_materials == 0 && fourth->version == 4) &&
+        passed;
+    passed = report("改 OBJ 时纹理全部沿用",
+                    geometry.decoded_textures == 0 && geometry.reused_textures == 2 && decoder.total() == 4 &&
+                    same_pixels(third->textures, fourth->textures, "a.png") &&
+                    same_pixels(third->textures, fourth->textures, "c.png")) && passed;
+
+    // OBJ 被替换为指向不存在文件的符号链接，无法打开：保留旧快照，恢复后再次重载
+    std::filesystem::create_symlink("absent.obj", DIRECTORY / "scene.obj.tmp");
+    std::filesystem::rename(DIRECTORY / "scene.obj.tmp", DIRECTORY / "scene.obj");
+    const ReloadResult broken = reloader.update(UPDATE_TIMEOUT_MS);
+    passed = report("加载失败时保留旧快照",
+                    broken.failed && !broken.published() && reloader.current() == fourth &&
+                    !reloader.get_last_error().empty()) && passed;
+    std::filesystem::remove(DIRECTORY / "scene.obj");
+    write_file("scene.obj", RELOAD_OBJ);
+    const ReloadResult recovered = reloader.update(UPDATE_TIMEOUT_MS);
+    passed = report("文件恢复后重新发布",
+                    recovered.geometry && !recovered.failed && reloader.current()->version == 5 &&
+                    reloader.current()->triangles->size() == 2 && reloader.get_last_error().empty()) && passed;
+    return passed;
+}
+
+const std::string LIBRARY_MTL =
+    "newmtl stone\nmap_Kd stone.png\n\nnewmtl wood\nmap_Kd wood.png\n\nnewmtl ghost\nmap_Kd missing.png\n";
+
+std::vector<std::string> write_library_models(int count)
+{
+    write_file("library.mtl", LIBRARY_MTL);
+    std::vector<std::string> paths;
+    for (int i = 0; i < count; i++)
+    {
+        const std::string name = "model" + std::to_string(i) + ".obj";
+        write_file(name, "mtllib library.mtl\nv 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 0 1\n"
+                         "usemtl stone\nf 1/1 2/2 3/3\nusemtl wood\nf 1/1 3/3 2/2\nusemtl ghost\nf 2/2 1/1 3/3\n");
+        paths.push_back(file_path(name));
+    }
+    return paths;
+}
+
+/**
+ * @brief 回调收到的状态，按模型序号记录
+ */
+struct StatusLog {
+    std::mutex mutex;
+    std::map<size_t, std::vector<ModelStatus>> updates;
+
+    ModelCallback callback()
+    {
+        return [this](size_t index, const ModelStatus& status)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            updates[index].push_back(status);
+        };
+    }
+};
+
+/**
+ * @brief 一个加载成功的模型的回调顺序：Parsing、Decoding（每就绪一张纹理一次）、Loaded
+ */
+bool progress_in_order(const std::vector<ModelStatus>& updates, size_t textures)
+{
+    if (updates.size() != textures + 3 || updates.front().state != ModelState::Parsing ||
+        updates.back().state != ModelState::Loaded)
+    {
+        return false;
+    }
+    for (size_t i = 1; i + 1 < updates.size(); i++)
+    {
+        if (updates[i].state != ModelState::Decoding || updates[i].textures_total != textures ||
+            updates[i].textures_ready != i - 1)
+        {
+            return false;
+        }
+    }
+    return updates.back().textures_ready == textures;
+}
+
+bool test_library()
+{
+    std::cout << "\n=== 模型库测试 ===" << std::endl;
+    const int models = 6;
+    std::vector<std::string> paths = write_library_models(models);
+    paths.push_back(file_path("absent.obj"));
+
+    // 解码较慢，多个模型同时需要同一张纹理时后到的要等待先到的
+    CountingDecoder decoder(30);
+    StatusLog log;
+    ModelLibrary library(LoadOptions(), decoder.decoder(), 4);
+    library.set_callback(log.callback());
+    const size_t first = library.add(paths);
+    library.wait();
+
+    bool shared = first == 0 && library.size() == paths.size();
+    size_t shared_count = 0;
+    for (int i = 0; i < models; i++)
+    {
+        const ModelStatus status = library.status(i);
+        const auto model = library.model(i);
+        shared = shared && status.state == ModelState::Loaded && model && status.textures_total == 3 &&
+            status.textures_ready == 3 && status.missing_textures == 1 && model->textures.size() == 3 &&
+            same_pixels(model->textures, library.model(0)->textures, "stone.png") &&
+            same_pixels(model->textures, library.model(0)->textures, "wood.png") &&
+            model->textures.at("missing.png").empty();
+        shared_count += status.shared_textures;
+    }
+    const LibraryStats stats = library.stats();
+    bool passed = report("并发加载时每张纹理只解码一次",
+                         shared && decoder.calls("stone.png") == 1 && decoder.calls("wood.png") == 1 &&
+                         decoder.calls("missing.png") == 1 && stats.textures == 3);
+    passed = report("模型之间共享纹理和 MTL",
+                    shared_count == 3 * models - 3 && stats.shared_textures == shared_count &&
+                    stats.material_files == 1 && stats.shared_material_files == models - 1) && passed;
+
+    const ModelStatus missing = library.status(models);
+    passed = report("无法加载的模型报告失败",
+                    missing.state == ModelState::Failed && !missing.error.empty() && !library.model(models) &&
+                    stats.loaded == models && stats.failed == 1) && passed;
+
+    bool progress = log.updates.size() == paths.size();
+    for (int i = 0; i < models; i++)
+    {
+        progress = progress && progress_in_order(log.updates[i], 3);
+    }
+    const auto& failed_updates = log.updates[models];
+    progress = progress && failed_updates.size() == 2 && failed_updates[0].state == ModelState::Parsing &&
+        failed_updates[1].state == ModelState::Failed && failed_updates[1].finished();
+    passed = report("进度回调按 解析、解码、完成 的顺序报告", progress) && passed;
+    return passed;
+}
+
+bool test_library_shutdown()
+{
+    std::cout << "\n=== 模型库析构测试 ===" << std::endl;
+    const std::vector<std::string> paths = write_library_models(4);
+
+    // 一个工作线程，第一个模型阻塞在解码中，其余三个还在排队
+    CountingDecoder decoder;
+    decoder.block();
+    StatusLog log;
+    auto library = std::make_unique<ModelLibrary>(LoadOptions(), decoder.decoder(), 1);
+    library->set_callback(log.callback());
+    library->add(paths);
+    while (!decoder.waiting())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::atomic<bool> destroyed{false};
+    std::thread destroyer([&]()
+    {
+        library.reset();
+        destroyed = true;
+    });
+    // 析构先清空队列，再等待正在加载的模型
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const bool waited = !destroyed;
+    decoder.release();
+    destroyer.join();
+
+    bool passed = report("析构等待正在加载的模型",
+                         waited && destroyed && progress_in_order(log.updates[0], 3));
+    passed = report("析构丢弃排队的模型，不再回调",
+                    log.updates.size() == 1 && decoder.total() == 3) && passed;
+    return passed;
+}
+
+} // namespace
+
+int main()
+{
+    std::filesystem::remove_all(DIRECTORY);
+    std::filesystem::create_directories(DIRECTORY);
+    bool passed = true;
+    passed = test_reloader() && passed;
+    passed = test_library() && passed;
+    passed = test_library_shutdown() && passed;
+    std::filesystem::remove_all(DIRECTORY);
+
+    std::cout << (passed ? "\n✓ 热重载与模型库测试: 通过" : "\n✗ 热重载与模型库测试: 失败") << std::endl;
+    return passed ? 0 : 1;
+}